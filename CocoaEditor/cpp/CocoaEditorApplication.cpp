@@ -2,11 +2,16 @@
 #include "Gui/ImGuiHeader.h"
 #include "EditorWindows/InspectorWindow.h"
 #include "nativeScripting/SourceFileWatcher.h"
+#include "util/EditorCache.h"
 
 #include "CocoaEditorApplication.h"
 #include "LevelEditorSceneInitializer.h"
 #include "ImGuiLayer.h"
 #include "cocoa/file/IFile.h"
+#include "cocoa/file/AsyncIO.h"
+#include "cocoa/core/ImportCache.h"
+#include "cocoa/core/JobSystem.h"
+#include "cocoa/scenes/SceneWriter.h"
 #include "cocoa/util/Settings.h"
 #include "cocoa/systems/RenderSystem.h"
 
@@ -38,6 +43,8 @@ namespace Cocoa
 		Settings::General::s_CurrentProject = projectPath + (std::string(filename) + ".cprj");
 		Settings::General::s_CurrentScene = projectPath + "scenes" + "NewScene.cocoa";
 		Settings::General::s_WorkingDirectory = Settings::General::s_CurrentProject.GetDirectory(-1);
+		ImportCache::Destroy();
+		ImportCache::Init(projectPath + ".importCache");
 
 		json saveData = {
 			{"ProjectPath", Settings::General::s_CurrentProject.Filepath()},
@@ -72,7 +79,14 @@ namespace Cocoa
 			{"ImGuiConfig", Settings::General::s_ImGuiConfigPath.Filepath()}
 		};
 
-		IFile::WriteFile(saveData.dump(4).c_str(), Settings::General::s_EditorSaveData);
+		CPath editorSaveData = Settings::General::s_EditorSaveData;
+		AsyncIO::WriteAsync(editorSaveData, saveData.dump(4), [editorSaveData](bool success)
+		{
+			if (!success)
+			{
+				Log::Warning("Failed to save editor data to '%s'", editorSaveData.Filepath());
+			}
+		});
 	}
 
 	bool EditorLayer::LoadEditorData(const CPath& path)
@@ -80,7 +94,7 @@ namespace Cocoa
 		File* editorData = IFile::OpenFile(path);
 		if (editorData->m_Data.size() > 0)
 		{
-			json j = json::parse(editorData->m_Data);
+			json j = json::parse(editorData->m_Data.begin(), editorData->m_Data.end());
 			if (!j["EditorStyle"].is_null())
 			{
 				Settings::General::s_EditorStyleData = CPath(j["EditorStyle"], false);
@@ -109,7 +123,14 @@ namespace Cocoa
 			{"WorkingDirectory", Settings::General::s_CurrentProject.GetDirectory(-1) }
 		};
 
-		IFile::WriteFile(saveData.dump(4).c_str(), Settings::General::s_CurrentProject);
+		CPath projectPath = Settings::General::s_CurrentProject;
+		AsyncIO::WriteAsync(projectPath, saveData.dump(4), [projectPath](bool success)
+		{
+			if (!success)
+			{
+				Log::Warning("Failed to save project '%s'", projectPath.Filepath());
+			}
+		});
 
 		SaveEditorData();
 	}
@@ -120,11 +141,13 @@ namespace Cocoa
 		File* projectData = IFile::OpenFile(Settings::General::s_CurrentProject);
 		if (projectData->m_Data.size() > 0)
 		{
-			json j = json::parse(projectData->m_Data);
+			json j = json::parse(projectData->m_Data.begin(), projectData->m_Data.end());
 			if (!j["CurrentScene"].is_null())
 			{
 				Settings::General::s_CurrentScene = CPath(j["CurrentScene"], false);
 				Settings::General::s_WorkingDirectory = CPath(j["WorkingDirectory"], false);
+				ImportCache::Destroy();
+				ImportCache::Init(Settings::General::s_WorkingDirectory + ".importCache");
 
 				CocoaEditor* application = (CocoaEditor*)Application::Get();
 				application->GetEditorLayer()->m_Scene->Load(Settings::General::s_CurrentScene);
@@ -250,8 +273,10 @@ namespace Cocoa
 		Cocoa::AssetManager::Init(0);
 		Cocoa::IFileDialog::Init();
 		Cocoa::IFile::Init();
+		Cocoa::JobSystem::Init();
+		Cocoa::AsyncIO::Init();
+		Cocoa::SceneWriter::Init();
 		Cocoa::ProjectWizard::Init();
-		Cocoa::Physics2D::Init();
 		Cocoa::Input::Init();
 
 		m_EditorLayer = new EditorLayer(nullptr);
@@ -266,6 +291,12 @@ namespace Cocoa
 	void CocoaEditor::Shutdown()
 	{
 		// Engine shutdown sequence
+		Cocoa::EditorCache::Destroy();
+		Cocoa::JobSystem::Destroy();
+		Cocoa::SceneWriter::Destroy();
+		Cocoa::ImportCache::Destroy();
+		// Finishes any project saves that are still queued
+		Cocoa::AsyncIO::Destroy();
 		Cocoa::IFileDialog::Destroy();
 		Cocoa::IFile::Destroy();
 	}
@@ -10,7 +10,10 @@
 #include "cocoa/core/Core.h"
 #include "cocoa/util/CMath.h"
 #include "cocoa/core/Entity.h"
+#include "cocoa/components/TransformHierarchy.h"
 #include "cocoa/commands/ICommand.h"
+#include "cocoa/commands/CommandHistory.h"
+#include "cocoa/scenes/ComponentCodec.h"
 
 namespace Cocoa
 {
@@ -46,7 +49,7 @@ namespace Cocoa
 		}
 	}
 
-	void Gizmo::GizmoManipulateTranslate(Transform& transform, const glm::vec3& originalDragClickPos, const glm::vec3& mouseOffset, Camera* camera)
+	void Gizmo::GizmoManipulateTranslate(const entt::registry& registry, Transform& transform, const glm::vec3& originalDragClickPos, const glm::vec3& mouseOffset, Camera* camera)
 	{
 		glm::vec3 mousePosWorld = CMath::Vector3From2(camera->ScreenToOrtho());
 		glm::vec3 startToMouse = mousePosWorld - originalDragClickPos;
@@ -65,6 +68,8 @@ namespace Cocoa
 			newPos = startToMouse + originalDragClickPos - mouseOffset;
 		}
 
+		// The drag happens in world space, the transform stores its position relative to its parent
+		newPos = TransformHierarchy::WorldToLocal(registry, transform, newPos);
 		CommandHistory::AddCommand(new ChangeVec3Command(transform.m_Position, newPos));
 	}
 
@@ -150,10 +155,11 @@ namespace Cocoa
 			if (m_MouseDragging && m_ActiveGizmo >= 0)
 			{
 				Log::Assert((m_ActiveGizmo >= 0 && m_ActiveGizmo < 6), "Active gizmo out of array bounds.");
+				CommandHistory::SetTarget(activeEntity.GetID(), SceneComponents::Bit<Transform>());
 				switch (m_Mode)
 				{
 				case GizmoMode::Translate:
-					m_Gizmos[m_ActiveGizmo].GizmoManipulateTranslate(entityTransform, m_OriginalDragClickPos, m_MouseOffset, m_Camera);
+					m_Gizmos[m_ActiveGizmo].GizmoManipulateTranslate(m_Scene->GetRegistry(), entityTransform, m_OriginalDragClickPos, m_MouseOffset, m_Camera);
 					break;
 				case GizmoMode::Rotate:
 					m_Gizmos[m_ActiveGizmo].GizmoManipulateRotate(entityTransform, m_OriginalDragClickPos, m_MouseOffset, m_Camera);
@@ -162,6 +168,7 @@ namespace Cocoa
 					m_Gizmos[m_ActiveGizmo].GizmoManipulateScale(entityTransform, m_OriginalDragClickPos, m_OriginalScale, m_Camera);
 					break;
 				}
+				CommandHistory::ClearTarget();
 			}
 
 			int start = 0;
@@ -178,7 +185,7 @@ namespace Cocoa
 			{
 				Gizmo& gizmo = m_Gizmos[i];
 				float cameraZoom = m_Camera->GetZoom() * 2;
-				gizmo.m_Position = entityTransform.m_Position + gizmo.m_Offset * cameraZoom;
+				gizmo.m_Position = entityTransform.m_WorldPosition + gizmo.m_Offset * cameraZoom;
 				glm::vec3 boxPos = gizmo.m_Position + CMath::Vector3From2(gizmo.m_Box2D.m_Offset) * cameraZoom;
 				if (!m_MouseDragging && Physics2D::PointInBox(mousePosWorld, gizmo.m_Box2D.m_HalfSize * cameraZoom, boxPos, gizmo.m_SpriteRotation))
 				{
@@ -259,7 +266,7 @@ namespace Cocoa
 				const Transform& transform = selectedEntity.GetComponent<Transform>();
 				m_ActiveGizmo = m_HotGizmo;
 				m_MouseDragging = true;
-				m_MouseOffset = CMath::Vector3From2(mousePosWorld) - transform.m_Position;
+				m_MouseOffset = CMath::Vector3From2(mousePosWorld) - transform.m_WorldPosition;
 				m_OriginalScale = transform.m_Scale;
 			}
 			else
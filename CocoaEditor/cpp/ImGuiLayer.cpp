@@ -5,6 +5,7 @@
 #include "AssetWizard.h"
 #include "EditorWindows/InspectorWindow.h"
 #include "EditorWindows/SceneHeirarchyWindow.h"
+#include "EditorWindows/SystemsWindow.h"
 #include "Gui/ImGuiExtended.h"
 #include "Util/Settings.h"
 #include "FontAwesome.h"
@@ -110,6 +111,15 @@ namespace Cocoa
 		}
 	}
 
+	void ImGuiLayer::SetScene(Scene* scene)
+	{
+		m_Scene = scene;
+		m_AssetWindow.SetScene(scene);
+		m_MenuBar->SetScene(scene);
+		// The selection holds entities of the old scene
+		InspectorWindow::ClearAllEntities();
+	}
+
 	void ImGuiLayer::BeginFrame()
 	{
 		// Start ImGui frame
@@ -124,7 +134,8 @@ namespace Cocoa
 			AssetWizard::ImGui();
 			m_AssetWindow.ImGui();
 			InspectorWindow::ImGui();
-			SceneHeirarchyWindow::ImGui();
+			SceneHeirarchyWindow::ImGui(m_Scene);
+			SystemsWindow::ImGui(m_Scene);
 		}
 		else
 		{
@@ -163,7 +174,6 @@ namespace Cocoa
 			{
 				if (!isPlaying)
 				{
-					m_Scene->Save(Settings::General::s_EngineAssetsPath + "tmp.jade");
 					m_Scene->Play();
 					isPlaying = true;
 				}
@@ -174,7 +184,8 @@ namespace Cocoa
 				if (isPlaying)
 				{
 					m_Scene->Stop();
-					m_Scene->Load(Settings::General::s_EngineAssetsPath + "tmp.jade");
+					// Entities spawned during play are gone again
+					InspectorWindow::ClearAllEntities();
 					isPlaying = false;
 				}
 				ImGui::EndMenu();
@@ -282,7 +293,7 @@ namespace Cocoa
 		File* styleData = IFile::OpenFile(filepath);
 		if (styleData->m_Data.size() > 0)
 		{
-			json j = json::parse(styleData->m_Data);
+			json j = json::parse(styleData->m_Data.begin(), styleData->m_Data.end());
 			JsonExtended::AssignIfNotNull(j["Colors"]["MainBgLight0"], Settings::EditorStyle::s_MainBgLight0);
 			JsonExtended::AssignIfNotNull(j["Colors"]["MainBg"], Settings::EditorStyle::s_MainBg);
 			JsonExtended::AssignIfNotNull(j["Colors"]["MainBgDark0"], Settings::EditorStyle::s_MainBgDark0);
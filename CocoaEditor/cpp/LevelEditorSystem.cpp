@@ -12,6 +12,7 @@
 #include "CocoaEditorApplication.h"
 #include "EditorWindows/InspectorWindow.h"
 #include "cocoa/systems/ScriptSystem.h"
+#include "cocoa/scenes/SceneReader.h"
 
 #include <string>
 #include <imgui.h>
@@ -33,26 +34,7 @@ namespace Cocoa
 	{
 		tmpScriptDll = Settings::General::s_EngineExeDirectory + CPath("ScriptModuleTmp.dll");
 		scriptDll = Settings::General::s_EngineExeDirectory + CPath("ScriptModule.dll");
-		auto view = m_Scene->GetRegistry().view<Transform>();
 		initImGui = false;
-		for (Entity entity : view)
-		{
-			//Transform& transform = entity.GetComponent<Transform>();
-			//if (!transform.m_Previous.IsNull())
-			//{
-			//	Transform& prevTransform = transform.m_Previous.GetComponent<Transform>();
-			//	prevTransform.m_Next = entity;
-
-			//	if (!transform.m_Parent.IsNull())
-			//	{
-			//		Transform& parentTransform = transform.m_Parent.GetComponent<Transform>();
-			//		if (!transform.m_First.IsNull())
-			//		{
-			//			parentTransform.m_First = entity;
-			//		}
-			//	}
-			//}
-		}
 	}
 
 	void LevelEditorSystem::EditorUpdate(float dt)
@@ -68,7 +50,13 @@ namespace Cocoa
 
 		if (IFile::IsFile(tmpScriptDll))
 		{
-			m_Scene->Save(Settings::General::s_CurrentScene);
+			// Script components only live as long as the module that knows their types, they're kept in
+			// memory over the swap
+			json scripts = {
+				{"Size", 0},
+				{"Components", {}}
+			};
+			m_ScriptSystem->SaveScripts(scripts);
 			EditorLayer::SaveProject();
 			m_ScriptSystem->FreeScriptLibrary();
 
@@ -79,11 +67,22 @@ namespace Cocoa
 			{
 				m_ScriptSystem->m_InitImGui(ImGui::GetCurrentContext());
 			}
-			m_Scene->LoadScriptsOnly(Settings::General::s_CurrentScene);
+			SceneReader::InsertScripts(scripts, m_Scene, m_ScriptSystem);
 
 			IFile::DeleteFile(tmpScriptDll);
 		}
 
+		// Only the entities edited since the last save are written, so this is cheap even for big scenes
+		m_AutosaveTimer += dt;
+		if (Settings::General::s_AutosaveInterval > 0.0f && m_AutosaveTimer >= Settings::General::s_AutosaveInterval)
+		{
+			m_AutosaveTimer = 0.0f;
+			if (!m_Scene->IsPlaying() && m_Scene->HasUnsavedChanges())
+			{
+				m_Scene->SaveChanges(Settings::General::s_CurrentScene);
+			}
+		}
+
 		if (m_IsDragging)
 		{
 			Camera* camera = m_Scene->GetCamera();
@@ -163,7 +162,7 @@ namespace Cocoa
 
 			if (e.GetKeyCode() == COCOA_KEY_S)
 			{
-				m_Scene->Save(Settings::General::s_CurrentScene);
+				m_Scene->SaveChanges(Settings::General::s_CurrentScene);
 				EditorLayer::SaveProject();
 			}
 
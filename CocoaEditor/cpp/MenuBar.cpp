@@ -14,6 +14,9 @@
 #include "cocoa/util/Settings.h"
 #include "cocoa/core/Application.h"
 #include "cocoa/file/IFile.h"
+#include "cocoa/scenes/SceneWriter.h"
+#include "cocoa/scenes/SceneBinary.h"
+#include "cocoa/scenes/WorldPartition.h"
 
 namespace Cocoa
 {
@@ -99,13 +102,35 @@ namespace Cocoa
 				if (CImGui::MenuButton("Save Scene As"))
 				{
 					FileDialogResult result{};
-					if (IFileDialog::GetSaveFileName(".", result, { {"Jade Scenes *.jade", "*.jade"}, {"All Files", "*.*"} }, ".jade"))
+					if (IFileDialog::GetSaveFileName(".", result, { {"Jade Scenes *.jade", "*.jade"}, {"Binary Scenes *.cocoabin", "*.cocoabin"}, {"All Files", "*.*"} }, ".jade"))
 					{
 						Settings::General::s_CurrentScene = result.filepath;
 						m_Scene->Save(result.filepath);
 					}
 				}
 
+				if (CImGui::MenuButton("Partition Scene"))
+				{
+					// Cells are written next to the scene file, which has to be saved without the entities they took
+					if (m_Scene->GetPartition()->Build(Settings::General::s_CurrentScene))
+					{
+						m_Scene->Save(Settings::General::s_CurrentScene);
+					}
+				}
+
+				if (CImGui::MenuButton("Convert Scene"))
+				{
+					// Binary scenes are converted to JSON and JSON scenes to binary
+					FileDialogResult input{};
+					FileDialogResult output{};
+					if (IFileDialog::GetOpenFileName(".", input, { {"All Files", "*.*"} }) &&
+						IFileDialog::GetSaveFileName(".", output, { {"All Files", "*.*"} }))
+					{
+						SceneWriter::Flush();
+						SceneBinary::ConvertFile(CPath(input.filepath), CPath(output.filepath));
+					}
+				}
+
 				ImGui::EndMenu();
 			}
 
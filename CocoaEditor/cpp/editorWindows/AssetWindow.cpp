@@ -2,7 +2,9 @@
 #include "Gui/ImGuiExtended.h"
 #include "FontAwesome.h"
 #include "Util/Settings.h"
+#include "util/EditorCache.h"
 #include "CocoaEditorApplication.h"
+#include "LevelEditorSceneInitializer.h"
 
 #include "cocoa/core/AssetManager.h"
 #include "cocoa/file/IFile.h"
@@ -87,8 +89,8 @@ namespace Cocoa
 
 	void AssetWindow::ShowTextureBrowser()
 	{
-		std::vector<std::shared_ptr<Texture>> textures = AssetManager::GetAllAssets<Texture>(AssetManager::GetScene());
-		for (auto tex : textures)
+		const std::vector<std::shared_ptr<Texture>>& textures = EditorCache::GetTextures();
+		for (const auto& tex : textures)
 		{
 			if (tex->IsDefault())
 			{
@@ -119,22 +121,22 @@ namespace Cocoa
 			FileDialogResult result;
 			if (IFileDialog::GetOpenFileName(initialPath, result))
 			{
-				AssetManager::LoadTextureFromFile(CPath(result.filepath));
+				AssetManager::ImportTexture(CPath(result.filepath));
 			}
 		}
 	}
 
 	void AssetWindow::ShowSceneBrowser()
 	{
-		auto sceneFiles = IFile::GetFilesInDir(Settings::General::s_WorkingDirectory + "scenes");
+		const std::vector<CPath>& sceneFiles = EditorCache::GetSceneFiles();
 		int sceneCount = 0;
-		for (auto scene : sceneFiles)
+		for (const CPath& scene : sceneFiles)
 		{
 			ImGui::PushID(sceneCount++);
 			if (IconButton(ICON_FA_FILE, scene.Filename(), m_ButtonSize))
 			{
 				m_Scene->Save(Settings::General::s_CurrentScene);
-				m_Scene->Load(scene);
+				Application::Get()->ChangeSceneAsync(new LevelEditorSceneInitializer(), scene);
 			}
 			ImGui::SameLine();
 			ImGui::PopID();
@@ -150,14 +152,15 @@ namespace Cocoa
 			m_Scene->Save(Settings::General::s_CurrentScene);
 			CocoaEditor* editor = static_cast<CocoaEditor*>(Application::Get());
 			editor->GetEditorLayer()->SaveProject();
+			EditorCache::InvalidateDirectories();
 		}
 	}
 
 	void AssetWindow::ShowScriptBrowser()
 	{
-		auto scriptFiles = IFile::GetFilesInDir(Settings::General::s_WorkingDirectory + "scripts");
+		const std::vector<CPath>& scriptFiles = EditorCache::GetScriptFiles();
 		int scriptCount = 0;
-		for (auto script : scriptFiles)
+		for (const CPath& script : scriptFiles)
 		{
 			ImGui::PushID(scriptCount++);
 			if (IconButton(ICON_FA_FILE, script.Filename(), m_ButtonSize))
@@ -175,6 +178,7 @@ namespace Cocoa
 			std::string scriptName = newScriptName;
 			IFile::CopyFile(IFile::GetSpecialAppFolder() + "CocoaEngine" + "DefaultScript.cpp", CPath(Settings::General::s_CurrentProject.GetDirectory(-1)) + "scripts", newScriptName);
 			IFile::CopyFile(IFile::GetSpecialAppFolder() + "CocoaEngine" + "DefaultScript.h", CPath(Settings::General::s_CurrentProject.GetDirectory(-1)) + "scripts", newScriptName);
+			EditorCache::InvalidateDirectories();
 		}
 	}
 }
\ No newline at end of file
@@ -6,19 +6,25 @@
 #include "Gui/ImGuiExtended.h"
 #include "FontAwesome.h"
 #include "nativeScripting/SourceFileWatcher.h"
+#include "util/EditorCache.h"
 
 #include "cocoa/components/components.h"
 #include "cocoa/components/Transform.h"
 #include "cocoa/physics2d/Physics2DSystem.h"
 #include "cocoa/renderer/DebugDraw.h"
 #include "cocoa/systems/ScriptSystem.h"
+#include "cocoa/commands/CommandHistory.h"
+#include "cocoa/scenes/ComponentCodec.h"
 
 namespace Cocoa
 {
 	std::vector<Entity> InspectorWindow::s_ActiveEntities = std::vector<Entity>();
 	ScriptSystem* InspectorWindow::s_ScriptSystem = nullptr;
 
-	static const char* stringBuffer[100];
+	// Built in components followed by the script classes, only rebuilt when the classes change
+	static std::vector<const char*> componentNames;
+	static bool componentNamesValid = false;
+	static uint32 componentNamesVersion = 0;
 
 	void InspectorWindow::ImGui()
 	{
@@ -46,22 +52,45 @@ namespace Cocoa
 			doCircle &= entity.HasComponent<Circle>();
 		}
 
+		// Every edit made in a panel marks that component of the entity dirty for the next delta save
+		uint32 activeEntity = s_ActiveEntities[0].GetID();
 		if (doTransform)
+		{
+			CommandHistory::SetTarget(activeEntity, SceneComponents::Bit<Transform>());
 			ImGuiTransform(s_ActiveEntities[0].GetComponent<Transform>());
+		}
 		if (doSpriteRenderer)
+		{
+			CommandHistory::SetTarget(activeEntity, SceneComponents::Bit<SpriteRenderer>());
 			ImGuiSpriteRenderer(s_ActiveEntities[0].GetComponent<SpriteRenderer>());
+		}
 		if (doRigidbody2D)
+		{
+			CommandHistory::SetTarget(activeEntity, SceneComponents::Bit<Rigidbody2D>());
 			ImGuiRigidbody2D(s_ActiveEntities[0].GetComponent<Rigidbody2D>());
+		}
 		if (doBox2D)
+		{
+			CommandHistory::SetTarget(activeEntity, SceneComponents::Bit<Box2D>());
 			ImGuiBox2D(s_ActiveEntities[0].GetComponent<Box2D>());
+		}
 		if (doAABB)
+		{
+			CommandHistory::SetTarget(activeEntity, SceneComponents::Bit<AABB>());
 			ImGuiAABB(s_ActiveEntities[0].GetComponent<AABB>());
+		}
+		CommandHistory::ClearTarget();
 		if (doCircle)
 			ImGuiCircle(s_ActiveEntities[0].GetComponent<Circle>());
 		if (s_ScriptSystem)
+		{
+			CommandHistory::SetTarget(activeEntity, Scene::SCRIPT_CHANGES);
 			s_ScriptSystem->ImGui(s_ActiveEntities[0]);
+			CommandHistory::ClearTarget();
+		}
 
 		ImGuiAddComponentButton();
+		CommandHistory::ClearTarget();
 		ImGui::End();
 	}
 
@@ -95,19 +124,19 @@ namespace Cocoa
 	// =====================================================================
 	void InspectorWindow::ImGuiAddComponentButton()
 	{
-		const std::vector<UClass> classes = SourceFileWatcher::GetClasses();
-		int size = classes.size() + 4;
-		auto classIter = classes.begin();
-		for (int i = 4; i < classes.size() + 4; i++)
+		const std::vector<UClass>& classes = EditorCache::GetScriptClasses();
+		if (!componentNamesValid || componentNamesVersion != EditorCache::GetScriptClassesVersion())
 		{
-			stringBuffer[i] = classIter->m_ClassName.c_str();
-			classIter++;
+			componentNames = { "Sprite Renderer", "Rigidbody2D", "Box Collider2D", "Circle Collider2D" };
+			for (const UClass& clazz : classes)
+			{
+				componentNames.push_back(clazz.m_ClassName.c_str());
+			}
+			componentNamesVersion = EditorCache::GetScriptClassesVersion();
+			componentNamesValid = true;
 		}
-
-		stringBuffer[0] = "Sprite Renderer";
-		stringBuffer[1] = "Rigidbody2D";
-		stringBuffer[2] = "Box Collider2D";
-		stringBuffer[3] = "Circle Collider2D";
+		const char** stringBuffer = componentNames.data();
+		int size = (int)componentNames.size();
 
 		Entity activeEntity = s_ActiveEntities[0];
 		int itemPressed = 0;
@@ -117,12 +146,15 @@ namespace Cocoa
 			{
 			case 0:
 				activeEntity.AddComponent<SpriteRenderer>();
+				CommandHistory::SetTarget(activeEntity.GetID(), SceneComponents::Bit<SpriteRenderer>());
 				break;
 			case 1:
 				activeEntity.AddComponent<Rigidbody2D>();
+				CommandHistory::SetTarget(activeEntity.GetID(), SceneComponents::Bit<Rigidbody2D>());
 				break;
 			case 2:
 				activeEntity.AddComponent<Box2D>();
+				CommandHistory::SetTarget(activeEntity.GetID(), SceneComponents::Bit<Box2D>());
 				break;
 			case 3:
 				activeEntity.AddComponent<Circle>();
@@ -132,6 +164,7 @@ namespace Cocoa
 				{
 					Log::Info("Adding component %s from inspector tp %d", stringBuffer[itemPressed], entt::to_integral(activeEntity.GetRawEntity()));
 					s_ScriptSystem->AddComponentFromString(stringBuffer[itemPressed], activeEntity.GetRawEntity(), activeEntity.GetRegistry());
+					CommandHistory::SetTarget(activeEntity.GetID(), Scene::SCRIPT_CHANGES);
 				}
 				else
 				{
@@ -139,6 +172,7 @@ namespace Cocoa
 				}
 				break;
 			}
+			CommandHistory::NotifyTargetChanged();
 		}
 	}
 
@@ -187,6 +221,7 @@ namespace Cocoa
 					IM_ASSERT(payload->DataSize == sizeof(int));
 					int textureResourceId = *(const int*)payload->Data;
 					spr.m_Sprite.m_Texture = textureResourceId;
+					CommandHistory::NotifyTargetChanged();
 				}
 				ImGui::EndDragDropTarget();
 			}
@@ -211,8 +246,10 @@ namespace Cocoa
 			std::array<const char*, 3> items = { "Dynamic", "Kinematic", "Static" };
 			CImGui::UndoableCombo<BodyType2D>(rb.m_BodyType, "Body Type:", &items[0], (int)items.size());
 
-			CImGui::Checkbox("Continous: ##0", &rb.m_ContinuousCollision);
-			CImGui::Checkbox("Fixed Rotation##1", &rb.m_FixedRotation);
+			if (CImGui::Checkbox("Continous: ##0", &rb.m_ContinuousCollision))
+				CommandHistory::NotifyTargetChanged();
+			if (CImGui::Checkbox("Fixed Rotation##1", &rb.m_FixedRotation))
+				CommandHistory::NotifyTargetChanged();
 			CImGui::UndoableDragFloat("Linear Damping: ##2", rb.m_LinearDamping);
 			CImGui::UndoableDragFloat("Angular Damping: ##3", rb.m_AngularDamping);
 			CImGui::UndoableDragFloat("Mass: ##4", rb.m_Mass);
@@ -252,7 +289,7 @@ namespace Cocoa
 
 			// Draw box highlight
 			const Transform& transform = s_ActiveEntities[0].GetComponent<Transform>();
-			DebugDraw::AddBox2D(CMath::Vector2From3(transform.m_Position), box.m_HalfSize * 2.0f * CMath::Vector2From3(transform.m_Scale), transform.m_EulerRotation.z);
+			DebugDraw::AddBox2D(CMath::Vector2From3(transform.m_WorldPosition), box.m_HalfSize * 2.0f * CMath::Vector2From3(transform.m_WorldScale), transform.m_WorldRotation);
 		}
 	}
 
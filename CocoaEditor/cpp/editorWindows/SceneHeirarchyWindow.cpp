@@ -1,70 +1,117 @@
 #include "EditorWindows/SceneHeirarchyWindow.h"
+#include "EditorWindows/InspectorWindow.h"
 #include "Gui/ImGuiExtended.h"
 
 #include "cocoa/core/Entity.h"
 #include "cocoa/components/Transform.h"
+#include "cocoa/components/TransformHierarchy.h"
+#include "cocoa/scenes/ComponentCodec.h"
 #include "FontAwesome.h"
 
 namespace Cocoa
 {
-	Scene* SceneHeirarchyWindow::s_CurrentScene = nullptr;
+	static const char* ENTITY_PAYLOAD = "ENTITY_ID";
 
-	void SceneHeirarchyWindow::SetScene(Scene* scene)
-	{
-		s_CurrentScene = scene;
-	}
-
-	void SceneHeirarchyWindow::ImGui()
+	void SceneHeirarchyWindow::ImGui(Scene* scene)
 	{
 		ImGui::Begin(ICON_FA_PROJECT_DIAGRAM " Scene");
-		//int index = 0;
-		//auto view = s_CurrentScene->GetRegistry().view<Transform>();
-		//for (Entity entity : view)
-		//{
-		//	Transform& transform = entity.GetComponent<Transform>();
-		//	if (transform.m_Parent.IsNull())
-		//	{
-		//		DoTreeNode(index, transform);
-		//	}
-		//}
+
+		// Rebuilt every frame, the tree only has to be right for as long as it is on screen
+		entt::registry& registry = scene->GetRegistry();
+		std::unordered_map<entt::entity, std::vector<entt::entity>> children;
+		std::vector<entt::entity> roots;
+		auto view = registry.view<Transform>();
+		for (entt::entity entity : view)
+		{
+			entt::entity parent = view.get(entity).m_Parent;
+			if (parent != entt::null && registry.valid(parent) && registry.has<Transform>(parent))
+			{
+				children[parent].push_back(entity);
+			}
+			else
+			{
+				roots.push_back(entity);
+			}
+		}
+
+		for (entt::entity root : roots)
+		{
+			DoTreeNode(scene, root, children);
+		}
+
+		// Dropping an entity below the tree makes it a root again
+		ImVec2 remaining = ImGui::GetContentRegionAvail();
+		if (remaining.x > 0.0f && remaining.y > 0.0f)
+		{
+			ImGui::InvisibleButton("##SceneRoot", remaining);
+			AcceptEntityDrop(scene, entt::null);
+		}
 		ImGui::End();
 	}
 
-	void SceneHeirarchyWindow::DoTreeNode(int& index, const Transform& transform)
+	void SceneHeirarchyWindow::DoTreeNode(Scene* scene, entt::entity entity, const std::unordered_map<entt::entity, std::vector<entt::entity>>& children)
 	{
-		//static bool isDark = true;
-		//std::string str = transform.m_Name;
-		//std::string res = str + "##" + std::to_string(index);
-		//index++;
+		const EntityName* name = scene->GetRegistry().try_get<EntityName>(entity);
+		auto entityChildren = children.find(entity);
+		bool hasChildren = entityChildren != children.end();
 
-		//Entity next = transform.m_Next;
-		//while (!next.IsNull())
-		//{
-		//	const Transform& transform2 = next.GetComponent<Transform>();
-		//	std::string str2 = transform2.m_Name;
-		//	std::string res2 = str2 + "##" + std::to_string(index);
-		//	index++;
+		ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_FramePadding | ImGuiTreeNodeFlags_SpanAvailWidth | ImGuiTreeNodeFlags_OpenOnArrow;
+		if (!hasChildren)
+		{
+			flags |= ImGuiTreeNodeFlags_Leaf;
+		}
+		if (InspectorWindow::GetActiveEntity().GetRawEntity() == entity)
+		{
+			flags |= ImGuiTreeNodeFlags_Selected;
+		}
 
-		//	if (ImGui::TreeNodeEx(res2.c_str(), ImGuiTreeNodeFlags_FramePadding | ImGuiTreeNodeFlags_SpanAvailWidth))
-		//	{
-		//		if (!transform2.m_First.IsNull())
-		//		{
-		//			const Transform& childTrans = transform2.m_First.GetComponent<Transform>();
-		//			DoTreeNode(index, childTrans);
-		//		}
-		//		ImGui::TreePop();
-		//	}
-		//	next = transform2.m_Next;
-		//}
+		uint32 id = (uint32)entt::to_integral(entity);
+		std::string displayName = name != nullptr ? std::string(name->m_Name) : "Entity " + std::to_string(id);
+		std::string label = displayName + "##" + std::to_string(id);
+		bool open = ImGui::TreeNodeEx(label.c_str(), flags);
+		if (ImGui::IsItemClicked())
+		{
+			InspectorWindow::ClearAllEntities();
+			InspectorWindow::AddEntity(Entity(entity, scene));
+		}
+
+		if (ImGui::BeginDragDropSource())
+		{
+			ImGui::SetDragDropPayload(ENTITY_PAYLOAD, &id, sizeof(uint32));
+			ImGui::Text("%s", displayName.c_str());
+			ImGui::EndDragDropSource();
+		}
+		AcceptEntityDrop(scene, entity);
+
+		if (open)
+		{
+			if (hasChildren)
+			{
+				for (entt::entity child : entityChildren->second)
+				{
+					DoTreeNode(scene, child, children);
+				}
+			}
+			ImGui::TreePop();
+		}
+	}
+
+	void SceneHeirarchyWindow::AcceptEntityDrop(Scene* scene, entt::entity newParent)
+	{
+		if (!ImGui::BeginDragDropTarget())
+		{
+			return;
+		}
 
-		//if (ImGui::TreeNodeEx(res.c_str(), ImGuiTreeNodeFlags_FramePadding | ImGuiTreeNodeFlags_SpanAvailWidth))
-		//{
-		//	if (!transform.m_First.IsNull())
-		//	{
-		//		const Transform& firstTransform = transform.m_First.GetComponent<Transform>();
-		//		DoTreeNode(index, firstTransform);
-		//	}
-		//	ImGui::TreePop();
-		//}
+		if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload(ENTITY_PAYLOAD))
+		{
+			entt::entity dropped = entt::entity(*(const uint32*)payload->Data);
+			entt::registry& registry = scene->GetRegistry();
+			if (registry.valid(dropped) && TransformHierarchy::SetParent(registry, dropped, newParent))
+			{
+				scene->MarkDirty(dropped, SceneComponents::Bit<Transform>());
+			}
+		}
+		ImGui::EndDragDropTarget();
 	}
-}
\ No newline at end of file
+}
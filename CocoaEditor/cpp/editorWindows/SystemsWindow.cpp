@@ -0,0 +1,77 @@
+#include "EditorWindows/SystemsWindow.h"
+#include "Gui/ImGuiExtended.h"
+#include "FontAwesome.h"
+
+#include "cocoa/systems/System.h"
+
+namespace Cocoa
+{
+	static const char* DescribeAccess(const SystemAccess& access)
+	{
+		if (access.m_Exclusive)
+		{
+			return "Exclusive";
+		}
+		if (access.m_Reads.size() == 0 && access.m_Writes.size() == 0)
+		{
+			return "None";
+		}
+		return "Components";
+	}
+
+	void SystemsWindow::ImGui(Scene* scene)
+	{
+		ImGui::Begin(ICON_FA_STOPWATCH " Systems");
+		const std::vector<SystemNode>& nodes = scene->GetScheduler().GetNodes();
+		if (nodes.size() == 0)
+		{
+			ImGui::Text("Systems only update in play mode.");
+			ImGui::End();
+			return;
+		}
+
+		float total = 0.0f;
+		ImGui::Columns(4, "SystemsColumns");
+		ImGui::Text("System");
+		ImGui::NextColumn();
+		ImGui::Text("Thread");
+		ImGui::NextColumn();
+		ImGui::Text("Avg ms (last)");
+		ImGui::NextColumn();
+		ImGui::Text("Waits on");
+		ImGui::NextColumn();
+		ImGui::Separator();
+
+		for (const SystemNode& node : nodes)
+		{
+			ImGui::Text("%s", node.m_System->GetName());
+			if (ImGui::IsItemHovered())
+			{
+				ImGui::SetTooltip("%s, %d reads, %d writes", DescribeAccess(node.m_Access), (int)node.m_Access.m_Reads.size(), (int)node.m_Access.m_Writes.size());
+			}
+			ImGui::NextColumn();
+
+			ImGui::Text("%s", node.m_Access.m_MainThread ? "Main" : "Worker");
+			ImGui::NextColumn();
+
+			ImGui::Text("%.3f (%.3f)", node.m_AverageMilliseconds, node.m_LastMilliseconds);
+			total += node.m_AverageMilliseconds;
+			ImGui::NextColumn();
+
+			if (node.m_Dependencies.size() == 0)
+			{
+				ImGui::Text("-");
+			}
+			for (int dependency : node.m_Dependencies)
+			{
+				ImGui::Text("%s", nodes[dependency].m_System->GetName());
+			}
+			ImGui::NextColumn();
+		}
+
+		ImGui::Columns(1);
+		ImGui::Separator();
+		ImGui::Text("Sum of system times: %.3f ms", total);
+		ImGui::End();
+	}
+}
@@ -325,7 +325,7 @@ namespace Cocoa
 
 			file << " (it.key() == \"" << uclass.m_ClassName.c_str() << "\")\n";
 			file << "\t\t\t{\n";
-			file << "\t\t\t\t" << uclass.m_ClassName.c_str() << "& comp = registry.emplace<" << uclass.m_ClassName.c_str() << ">(e);\n";
+			file << "\t\t\t\t" << uclass.m_ClassName.c_str() << "& comp = registry.emplace_or_replace<" << uclass.m_ClassName.c_str() << ">(e);\n";
 			file << "\t\t\t\tLoadScript({ comp }, comp, j);\n";
 			file << "\t\t\t}\n";
 
@@ -402,6 +402,17 @@ namespace Cocoa
 
 		file << "\t\t}\n";
 
+		// Remove Scripts function
+		file << "\t\tvoid RemoveScripts(entt::entity entity, entt::registry& registry)\n";
+		file << "\t\t{\n";
+
+		for (auto uclass : m_Classes)
+		{
+			file << "\t\t\tregistry.remove_if_exists<" << uclass.m_ClassName.c_str() << ">(entity);\n";
+		}
+
+		file << "\t\t}\n";
+
 		// Tabs function
 		file << "\n"
 		"		int tabs = 0;\n"
@@ -8,9 +8,13 @@ namespace Cocoa
 	ScriptScanner::ScriptScanner(const CPath& filepath)
 		: m_Filepath(filepath)
 	{
-		File* fileHandle = IFile::OpenFile(filepath);
-		m_FileContents = fileHandle->m_Data;
-		IFile::CloseFile(fileHandle);
+		m_File = IFile::OpenFile(filepath);
+		m_FileContents = m_File->m_Data;
+	}
+
+	ScriptScanner::~ScriptScanner()
+	{
+		IFile::CloseFile(m_File);
 	}
 
 	std::vector<Token> ScriptScanner::ScanTokens()
@@ -102,7 +106,7 @@ namespace Cocoa
 	{
 		while (IsAlphaNumeric(Peek()) || Peek() == '_') Advance();
 
-		std::string text = m_FileContents.substr(m_Start, m_Cursor - m_Start);
+		std::string text = std::string(m_FileContents.substr(m_Start, m_Cursor - m_Start));
 		TokenType type = TokenType::IDENTIFIER;
 		auto iter = keywords.find(text);
 		if (iter != keywords.end())
@@ -167,7 +171,7 @@ namespace Cocoa
 			}
 		}
 
-		return Token{ m_Line, m_Column, TokenType::NUMBER, m_FileContents.substr(m_Start, m_Cursor - m_Start) };
+		return Token{ m_Line, m_Column, TokenType::NUMBER, std::string(m_FileContents.substr(m_Start, m_Cursor - m_Start)) };
 	}
 
 	Token ScriptScanner::String()
@@ -190,7 +194,7 @@ namespace Cocoa
 
 		Advance();
 
-		std::string value = m_FileContents.substr(m_Start, m_Cursor - m_Start);
+		std::string value = std::string(m_FileContents.substr(m_Start, m_Cursor - m_Start));
 		return Token{ m_Column, m_Line, TokenType::STRING_LITERAL, value };
 	}
 
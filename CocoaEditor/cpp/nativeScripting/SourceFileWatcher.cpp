@@ -9,6 +9,9 @@
 #include "nativeScripting/ScriptParser.h"
 #include "nativeScripting/CodeGenerators.h"
 
+#include <atomic>
+#include <mutex>
+
 namespace Cocoa
 {
 	static void RunPremake();
@@ -16,6 +19,8 @@ namespace Cocoa
 	static CPath rootDir = "";
 	static CPath projectPremakeLua = "";
 	static auto classes = std::vector<UClass>();
+	static std::mutex classesMutex;
+	static std::atomic<uint32> classesVersion{ 0 };
 	static bool fileModified = false;
 	static bool runningPremake = false;
 
@@ -30,6 +35,17 @@ namespace Cocoa
 		return classes;
 	}
 
+	std::vector<UClass> SourceFileWatcher::CopyClasses()
+	{
+		std::lock_guard<std::mutex> lock(classesMutex);
+		return classes;
+	}
+
+	uint32 SourceFileWatcher::GetClassesVersion()
+	{
+		return classesVersion;
+	}
+
 	static bool IsHeaderFile(const CPath& file)
 	{
 		return strcmp(file.FileExt(), ".h") == 0 || strcmp(file.FileExt(), ".hpp") == 0;
@@ -72,6 +88,7 @@ namespace Cocoa
 
 	static void MergeNewClasses(std::vector<UClass>& classesToMerge, const CPath& filepath)
 	{
+		std::lock_guard<std::mutex> lock(classesMutex);
 		for (auto clazz : classesToMerge)
 		{
 			auto c = FindClass(clazz, classes);
@@ -87,16 +104,19 @@ namespace Cocoa
 			}
 		}
 
-		for (auto classIter = classes.begin(); classIter != classes.end(); classIter++)
+		for (auto classIter = classes.begin(); classIter != classes.end();)
 		{
-			if (classIter->m_FullFilepath == filepath)
+			if (classIter->m_FullFilepath == filepath && FindClass(*classIter, classesToMerge) == classesToMerge.end())
+			{
+				classIter = classes.erase(classIter);
+			}
+			else
 			{
-				if (FindClass(*classIter, classesToMerge) == classesToMerge.end())
-				{
-					classIter = classes.erase(classIter);
-				}
+				classIter++;
 			}
 		}
+
+		classesVersion++;
 	}
 
 	static void GenerateInitFiles()
@@ -140,10 +160,23 @@ namespace Cocoa
 		}
 	}
 
-	static void FileChanged(const CPath& file)
+	static void FilesChanged(const std::vector<FileSystemEvent>& events)
 	{
-		CPath generatedDirPath = file.GetDirectory(-1) + "generated";
-		if (ProcessFile(rootDir + CPath(file), rootDir + generatedDirPath))
+		// Regenerate everything in the batch first so premake only runs once per save
+		bool processedFile = false;
+		for (const FileSystemEvent& event : events)
+		{
+			if (event.m_Type == FileSystemEventType::Deleted)
+			{
+				continue;
+			}
+
+			CPath file = rootDir + event.m_Path;
+			CPath generatedDirPath = event.m_Path.GetDirectory(-1) + "generated";
+			processedFile = ProcessFile(file, rootDir + generatedDirPath) || processedFile;
+		}
+
+		if (processedFile)
 		{
 			RunPremake();
 		}
@@ -191,12 +224,11 @@ namespace Cocoa
 			| NotifyFilters::FileName
 			| NotifyFilters::DirectoryName;
 
-		m_FileWatcher.m_Filter = "*.h";
+		// ProcessFile picks out the headers itself, a "*.h" filter would also drop .hpp files
+		m_FileWatcher.m_Filter = "";
 		m_FileWatcher.m_IncludeSubdirectories = true;
 
-		m_FileWatcher.m_OnChanged = FileChanged;
-		m_FileWatcher.m_OnCreated = FileChanged;
-		m_FileWatcher.m_OnRenamed = FileChanged;
+		m_FileWatcher.m_OnBatch = FilesChanged;
 
 		m_FileWatcher.Start();
 	}
@@ -0,0 +1,133 @@
+#include "util/EditorCache.h"
+#include "nativeScripting/SourceFileWatcher.h"
+
+#include "cocoa/core/AssetManager.h"
+#include "cocoa/file/FileSystemWatcher.h"
+#include "cocoa/file/IFile.h"
+#include "cocoa/util/Settings.h"
+
+#include <atomic>
+
+namespace Cocoa
+{
+	struct DirectoryListing
+	{
+		const char* m_Subdirectory;
+		FileSystemWatcher::OnBatch m_OnChanged;
+
+		// The working directory the listing was built for, a project change restarts the watcher
+		CPath m_WorkingDirectory;
+		bool m_Started = false;
+		// Set from the watcher thread
+		std::atomic<bool> m_Dirty{ true };
+		std::vector<CPath> m_Files;
+		FileSystemWatcher m_Watcher;
+	};
+
+	static void SceneDirectoryChanged(const std::vector<FileSystemEvent>& events);
+	static void ScriptDirectoryChanged(const std::vector<FileSystemEvent>& events);
+
+	static DirectoryListing sceneListing{ "scenes", SceneDirectoryChanged };
+	static DirectoryListing scriptListing{ "scripts", ScriptDirectoryChanged };
+
+	static std::vector<std::shared_ptr<Texture>> textures;
+	static bool texturesValid = false;
+	static uint32 texturesVersion = 0;
+
+	static std::vector<UClass> scriptClasses;
+	static bool scriptClassesValid = false;
+	static uint32 scriptClassesVersion = 0;
+
+	static void SceneDirectoryChanged(const std::vector<FileSystemEvent>& events)
+	{
+		sceneListing.m_Dirty = true;
+	}
+
+	static void ScriptDirectoryChanged(const std::vector<FileSystemEvent>& events)
+	{
+		scriptListing.m_Dirty = true;
+	}
+
+	static const std::vector<CPath>& GetFiles(DirectoryListing& listing)
+	{
+		const CPath& workingDirectory = Settings::General::s_WorkingDirectory;
+		if (!listing.m_Started || !listing.m_WorkingDirectory.Equals(workingDirectory))
+		{
+			listing.m_Watcher.Stop();
+			listing.m_Started = true;
+			listing.m_WorkingDirectory = workingDirectory;
+			listing.m_Dirty = true;
+
+			listing.m_Watcher.m_Path = workingDirectory + listing.m_Subdirectory;
+			listing.m_Watcher.m_NotifyFilters = NotifyFilters::FileName;
+			listing.m_Watcher.m_IncludeSubdirectories = false;
+			listing.m_Watcher.m_OnBatch = listing.m_OnChanged;
+			if (IFile::IsDirectory(listing.m_Watcher.m_Path))
+			{
+				listing.m_Watcher.Start();
+			}
+		}
+
+		if (listing.m_Dirty.exchange(false))
+		{
+			listing.m_Files = IFile::GetFilesInDir(listing.m_Watcher.m_Path);
+		}
+
+		return listing.m_Files;
+	}
+
+	void EditorCache::Destroy()
+	{
+		sceneListing.m_Watcher.Stop();
+		sceneListing.m_Started = false;
+		scriptListing.m_Watcher.Stop();
+		scriptListing.m_Started = false;
+	}
+
+	const std::vector<CPath>& EditorCache::GetSceneFiles()
+	{
+		return GetFiles(sceneListing);
+	}
+
+	const std::vector<CPath>& EditorCache::GetScriptFiles()
+	{
+		return GetFiles(scriptListing);
+	}
+
+	void EditorCache::InvalidateDirectories()
+	{
+		sceneListing.m_Dirty = true;
+		scriptListing.m_Dirty = true;
+	}
+
+	const std::vector<std::shared_ptr<Texture>>& EditorCache::GetTextures()
+	{
+		// The version also changes when the current scene does
+		if (!texturesValid || texturesVersion != AssetManager::GetVersion())
+		{
+			textures = AssetManager::GetAllAssets<Texture>(AssetManager::GetScene());
+			texturesVersion = AssetManager::GetVersion();
+			texturesValid = true;
+		}
+
+		return textures;
+	}
+
+	const std::vector<UClass>& EditorCache::GetScriptClasses()
+	{
+		uint32 version = SourceFileWatcher::GetClassesVersion();
+		if (!scriptClassesValid || scriptClassesVersion != version)
+		{
+			scriptClasses = SourceFileWatcher::CopyClasses();
+			scriptClassesVersion = version;
+			scriptClassesValid = true;
+		}
+
+		return scriptClasses;
+	}
+
+	uint32 EditorCache::GetScriptClassesVersion()
+	{
+		return scriptClassesVersion;
+	}
+}
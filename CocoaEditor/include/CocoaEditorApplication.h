@@ -15,7 +15,6 @@ namespace Cocoa
 	public:
 		EditorLayer(Scene* scene);
 
-		inline void SetScene(Scene* scene) { this->m_Scene = scene; }
 		virtual void OnAttach() override;
 		virtual void OnUpdate(float dt) override;
 		virtual void OnRender() override;
@@ -31,7 +31,7 @@ namespace Cocoa
 
         inline bool GizmoIsActive() { return m_Active; }
         void Render(Camera* camera);
-        void GizmoManipulateTranslate(Transform& transform, const glm::vec3& originalDragClickPos, const glm::vec3& mouseOffset, Camera* camera);
+        void GizmoManipulateTranslate(const entt::registry& registry, Transform& transform, const glm::vec3& originalDragClickPos, const glm::vec3& mouseOffset, Camera* camera);
         void GizmoManipulateRotate(Transform& transform, const glm::vec3& startPos, const glm::vec3& mouseOffset, Camera* camera);
         void GizmoManipulateScale(Transform& transform, const glm::vec3& originalDragClickPos, const glm::vec3& originalScale, Camera* camera);
 
@@ -22,6 +22,7 @@ namespace Cocoa
 
         virtual void OnAttach() override;
         virtual void OnEvent(Event& e) override;
+        virtual void SetScene(Scene* scene) override;
         void BeginFrame();
         void EndFrame();
 
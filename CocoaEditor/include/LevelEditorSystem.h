@@ -32,6 +32,7 @@ namespace Cocoa
 
 		float m_KeyDebounceTime = 0.1f;
 		float m_KeyDebounceLeft = 0.0f;
+		float m_AutosaveTimer = 0.0f;
 
 		bool m_IsDragging = false;
 		bool m_ControlModifierPressed = false;
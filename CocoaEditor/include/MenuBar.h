@@ -13,6 +13,7 @@ namespace Cocoa
             : m_Scene(scene) {}
 
         void ImGui();
+        inline void SetScene(Scene* scene) { m_Scene = scene; }
 
     private:
         void SettingsWindow();
@@ -18,6 +18,7 @@ namespace Cocoa
 	public:
 		AssetWindow(Scene* scene);
 		void ImGui();
+		inline void SetScene(Scene* scene) { m_Scene = scene; }
 
 	private:
 		void ShowMenuBar();
@@ -6,14 +6,10 @@ namespace Cocoa
 	class SceneHeirarchyWindow
 	{
 	public:
-		static void SetScene(Scene* scene);
-
-		static void ImGui();
-
-	private:
-		static void DoTreeNode(int& index, const Transform& transform);
+		static void ImGui(Scene* scene);
 
 	private:
-		static Scene* s_CurrentScene;
+		static void DoTreeNode(Scene* scene, entt::entity entity, const std::unordered_map<entt::entity, std::vector<entt::entity>>& children);
+		static void AcceptEntityDrop(Scene* scene, entt::entity newParent);
 	};
-}
\ No newline at end of file
+}
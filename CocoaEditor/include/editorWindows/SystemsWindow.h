@@ -0,0 +1,12 @@
+#pragma once
+#include "cocoa/scenes/Scene.h"
+
+namespace Cocoa
+{
+	// Debug view of the system scheduler: what every system declared, what it waits on and how long it took
+	class SystemsWindow
+	{
+	public:
+		static void ImGui(Scene* scene);
+	};
+}
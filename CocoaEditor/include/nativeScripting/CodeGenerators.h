@@ -231,6 +231,26 @@ namespace Cocoa
 			}
 			source << "\t\t}\n";
 
+			// Generate Remove Scripts function
+			source << "\n";
+			source << "\t\textern \"C\" COCOA_SCRIPT void RemoveScripts(entt::entity entity)\n";
+			source << "\t\t{\n";
+			source << "\t\t\tif (!registry.valid(entity)) return;\n";
+
+			numVisited = 0;
+			for (auto clazz : classes)
+			{
+				if (!visitedSourceFile(clazz))
+				{
+					std::string namespaceName = "Reflect" + ScriptParser::GetFilenameAsClassName(clazz.m_FullFilepath.GetFilenameWithoutExt());
+					source << "\t\t\t" << namespaceName.c_str() << "::RemoveScripts(entity, registry);\n";
+
+					visitedClassBuffer[numVisited] = clazz.m_FullFilepath;
+					numVisited++;
+				}
+			}
+			source << "\t\t}\n";
+
 			source << "\t}\n";
 			source << "}\n";
 
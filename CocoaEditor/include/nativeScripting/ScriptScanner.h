@@ -3,6 +3,7 @@
 #include "cocoa/core/Core.h"
 
 #include "cocoa/file/CPath.h"
+#include "cocoa/file/IFile.h"
 
 namespace Cocoa
 {
@@ -39,6 +40,9 @@ namespace Cocoa
 	{
 	public:
 		ScriptScanner(const CPath& filepath);
+		~ScriptScanner();
+		ScriptScanner(const ScriptScanner&) = delete;
+		ScriptScanner& operator=(const ScriptScanner&) = delete;
 
 		std::vector<Token> ScanTokens();
 
@@ -79,7 +83,9 @@ namespace Cocoa
 			{ "struct",      TokenType::STRUCT_KW }
 		};
 
-		std::string m_FileContents;
+		// Points into m_File, which stays open for the lifetime of the scanner
+		File* m_File;
+		std::string_view m_FileContents;
 		CPath m_Filepath;
 
 		int m_Cursor = 0;
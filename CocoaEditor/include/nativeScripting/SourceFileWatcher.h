@@ -17,6 +17,10 @@ namespace Cocoa
 		~SourceFileWatcher() { m_FileWatcher.Stop(); }
 
 		static const std::vector<UClass>& GetClasses();
+		// The classes are updated from the file watcher thread, these are safe to use from the editor.
+		// The version changes every time the classes do
+		static std::vector<UClass> CopyClasses();
+		static uint32 GetClassesVersion();
 
 	private:
 		void StartFileWatcher();
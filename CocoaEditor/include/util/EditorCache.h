@@ -0,0 +1,31 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/file/CPath.h"
+#include "cocoa/renderer/Texture.h"
+
+#include "nativeScripting/ScriptParser.h"
+
+namespace Cocoa
+{
+	// Listings shown by the editor panels every frame. They're only rebuilt when a FileSystemWatcher,
+	// the AssetManager or the SourceFileWatcher reports a change, so an idle frame doesn't touch the
+	// disk or allocate. Everything here is for the main thread only
+	class EditorCache
+	{
+	public:
+		// Stops the directory watchers
+		static void Destroy();
+
+		// Files directly inside the working directory's scenes and scripts folders
+		static const std::vector<CPath>& GetSceneFiles();
+		static const std::vector<CPath>& GetScriptFiles();
+		// For changes the editor makes itself, so they show up without waiting on the watcher
+		static void InvalidateDirectories();
+
+		static const std::vector<std::shared_ptr<Texture>>& GetTextures();
+
+		static const std::vector<UClass>& GetScriptClasses();
+		// Changes whenever GetScriptClasses does, for callers that build their own data from it
+		static uint32 GetScriptClassesVersion();
+	};
+}
@@ -6,9 +6,15 @@ namespace Cocoa
 	int CommandHistory::m_CommandSize = 0;
 	int CommandHistory::m_CommandPtr = 0;
 
+	uint32 CommandHistory::s_TargetEntity = std::numeric_limits<uint32>::max();
+	uint32 CommandHistory::s_TargetMask = 0;
+	std::function<void(uint32, uint32)> CommandHistory::s_ChangeCallback = nullptr;
+
 	void CommandHistory::AddCommand(ICommand* cmd)
 	{
+		cmd->SetTarget(s_TargetEntity, s_TargetMask);
 		cmd->execute();
+		NotifyChanged(cmd);
 
 		if (m_CommandPtr < m_CommandSize - 1)
 		{
@@ -47,6 +53,7 @@ namespace Cocoa
 		if (m_CommandPtr >= 0)
 		{
 			m_Commands[m_CommandPtr]->undo();
+			NotifyChanged(m_Commands[m_CommandPtr]);
 			m_CommandPtr--;
 		}
 	}
@@ -57,7 +64,41 @@ namespace Cocoa
 		if (redoCommand < m_CommandSize && redoCommand >= 0)
 		{
 			m_Commands[redoCommand]->execute();
+			NotifyChanged(m_Commands[redoCommand]);
 			m_CommandPtr++;
 		}
 	}
+
+	void CommandHistory::SetTarget(uint32 entity, uint32 componentMask)
+	{
+		s_TargetEntity = entity;
+		s_TargetMask = componentMask;
+	}
+
+	void CommandHistory::ClearTarget()
+	{
+		s_TargetEntity = std::numeric_limits<uint32>::max();
+		s_TargetMask = 0;
+	}
+
+	void CommandHistory::SetChangeCallback(std::function<void(uint32 entity, uint32 componentMask)> callback)
+	{
+		s_ChangeCallback = callback;
+	}
+
+	void CommandHistory::NotifyTargetChanged()
+	{
+		if (s_ChangeCallback && s_TargetMask != 0)
+		{
+			s_ChangeCallback(s_TargetEntity, s_TargetMask);
+		}
+	}
+
+	void CommandHistory::NotifyChanged(ICommand* cmd)
+	{
+		if (s_ChangeCallback && cmd->GetTargetMask() != 0)
+		{
+			s_ChangeCallback(cmd->GetTargetEntity(), cmd->GetTargetMask());
+		}
+	}
 }
\ No newline at end of file
@@ -0,0 +1,270 @@
+#include "cocoa/components/TransformHierarchy.h"
+#include "cocoa/util/CMath.h"
+#include "cocoa/util/Log.h"
+
+namespace Cocoa
+{
+	struct WorldPose
+	{
+		glm::vec3 m_Position;
+		glm::vec3 m_Scale;
+		float m_Rotation;
+	};
+
+	static WorldPose LocalPose(const Transform& transform)
+	{
+		return { transform.m_Position, transform.m_Scale, transform.m_EulerRotation.z };
+	}
+
+	// Same as multiplying the parent's translate * rotate * scale matrix with the local one, without building
+	// either. Rotation and scale stay plain 2D values, a rotated parent with a non uniform scale would skew
+	// its children, which sprites can't show anyway
+	static WorldPose Compose(const WorldPose& parent, const Transform& local)
+	{
+		glm::vec2 offset = glm::vec2(local.m_Position.x * parent.m_Scale.x, local.m_Position.y * parent.m_Scale.y);
+		if (parent.m_Rotation != 0.0f)
+		{
+			CMath::Rotate(offset, parent.m_Rotation, glm::vec2(0.0f));
+		}
+
+		WorldPose pose;
+		pose.m_Position = parent.m_Position + glm::vec3(offset.x, offset.y, local.m_Position.z * parent.m_Scale.z);
+		pose.m_Scale = parent.m_Scale * local.m_Scale;
+		pose.m_Rotation = parent.m_Rotation + local.m_EulerRotation.z;
+		return pose;
+	}
+
+	// Undoes Compose for the position, turning a world position into one relative to parent
+	static glm::vec3 Decompose(const WorldPose& parent, const glm::vec3& worldPosition)
+	{
+		glm::vec3 offset = worldPosition - parent.m_Position;
+		glm::vec2 planar = glm::vec2(offset.x, offset.y);
+		if (parent.m_Rotation != 0.0f)
+		{
+			CMath::Rotate(planar, -parent.m_Rotation, glm::vec2(0.0f));
+		}
+
+		glm::vec3 scale = parent.m_Scale;
+		return glm::vec3(
+			scale.x != 0.0f ? planar.x / scale.x : 0.0f,
+			scale.y != 0.0f ? planar.y / scale.y : 0.0f,
+			scale.z != 0.0f ? offset.z / scale.z : 0.0f);
+	}
+
+	// Stores pose as the world data and remembers whether that changed anything
+	static void SetWorld(Transform& transform, const WorldPose& pose)
+	{
+		transform.m_WorldChanged = transform.m_WorldPosition != pose.m_Position || transform.m_WorldScale != pose.m_Scale ||
+			transform.m_WorldRotation != pose.m_Rotation;
+		transform.m_WorldPosition = pose.m_Position;
+		transform.m_WorldScale = pose.m_Scale;
+		transform.m_WorldRotation = pose.m_Rotation;
+	}
+
+	// Turns a child into a root that stays where it was last drawn. Its local values were relative to a parent
+	// that's gone, so the cached world data is the only pose left to keep
+	static void MakeRoot(Transform& transform)
+	{
+		transform.m_Parent = entt::null;
+		transform.m_Position = transform.m_WorldPosition;
+		transform.m_Scale = transform.m_WorldScale;
+		transform.m_EulerRotation.z = transform.m_WorldRotation;
+		SetWorld(transform, LocalPose(transform));
+	}
+
+	// Same as the cached world data, but built from the local values right now instead of at the last Update
+	static WorldPose ComputeWorld(const entt::registry& registry, entt::entity entity)
+	{
+		// Loops are only cut at the next Update, so don't follow one forever until then
+		std::vector<entt::entity> chain;
+		size_t maxDepth = registry.size<Transform>();
+		while (entity != entt::null && registry.valid(entity) && registry.has<Transform>(entity) && chain.size() <= maxDepth)
+		{
+			chain.push_back(entity);
+			entity = registry.get<Transform>(entity).m_Parent;
+		}
+
+		WorldPose pose = { glm::vec3(0.0f), glm::vec3(1.0f), 0.0f };
+		for (auto it = chain.rbegin(); it != chain.rend(); it++)
+		{
+			pose = Compose(pose, registry.get<Transform>(*it));
+		}
+		return pose;
+	}
+
+	void TransformHierarchy::Update(entt::registry& registry)
+	{
+		// Roots only copy their local values, straight over the pool
+		auto view = registry.view<Transform>();
+		Transform* transforms = view.raw();
+		size_t childCount = 0;
+		for (size_t i = 0; i < view.size(); i++)
+		{
+			Transform& transform = transforms[i];
+			if (transform.m_Parent != entt::null)
+			{
+				childCount++;
+				continue;
+			}
+
+			SetWorld(transform, LocalPose(transform));
+		}
+
+		// The list only goes stale when a parent changes, which UpdateChildren notices on the way
+		if (childCount != m_Children.size())
+		{
+			Rebuild(registry);
+		}
+		if (!UpdateChildren(registry))
+		{
+			Rebuild(registry);
+			UpdateChildren(registry);
+		}
+
+		// Matrices are the expensive part, so only entities that asked for them and moved pay for them. A
+		// matrix added to an entity that stays put still needs building once
+		registry.view<TransformMatrix, Transform>().each([](TransformMatrix& matrix, const Transform& transform)
+		{
+			if (!transform.m_WorldChanged && !matrix.m_Stale)
+			{
+				return;
+			}
+
+			matrix.m_Stale = false;
+			matrix.m_ModelMatrix = glm::translate(glm::mat4(1.0f), transform.m_WorldPosition);
+			matrix.m_ModelMatrix = glm::rotate(matrix.m_ModelMatrix, glm::radians(transform.m_WorldRotation), glm::vec3(0, 0, 1));
+			matrix.m_ModelMatrix = glm::scale(matrix.m_ModelMatrix, transform.m_WorldScale);
+			matrix.m_InverseModelMatrix = glm::inverse(matrix.m_ModelMatrix);
+		});
+	}
+
+	bool TransformHierarchy::UpdateChildren(entt::registry& registry)
+	{
+		for (const ChildNode& node : m_Children)
+		{
+			Transform* transform = registry.try_get<Transform>(node.m_Entity);
+			if (transform == nullptr || transform->m_Parent != node.m_Parent || !registry.valid(node.m_Parent))
+			{
+				return false;
+			}
+
+			const Transform* parent = registry.try_get<Transform>(node.m_Parent);
+			if (parent == nullptr)
+			{
+				return false;
+			}
+
+			WorldPose parentPose = { parent->m_WorldPosition, parent->m_WorldScale, parent->m_WorldRotation };
+			SetWorld(*transform, Compose(parentPose, *transform));
+		}
+
+		return true;
+	}
+
+	void TransformHierarchy::Rebuild(entt::registry& registry)
+	{
+		m_Children.clear();
+		auto view = registry.view<Transform>();
+		for (entt::entity entity : view)
+		{
+			Transform& transform = view.get(entity);
+			if (transform.m_Parent == entt::null)
+			{
+				continue;
+			}
+
+			// Children of destroyed entities become roots where they are
+			if (!registry.valid(transform.m_Parent) || !registry.has<Transform>(transform.m_Parent))
+			{
+				MakeRoot(transform);
+				continue;
+			}
+
+			m_Children.push_back({ entity, transform.m_Parent, 0 });
+		}
+
+		for (ChildNode& node : m_Children)
+		{
+			// A chain longer than the number of children can only be a loop, which gets cut here
+			entt::entity ancestor = node.m_Parent;
+			uint32 depth = 1;
+			while (ancestor != entt::null && depth <= m_Children.size())
+			{
+				ancestor = registry.get<Transform>(ancestor).m_Parent;
+				depth++;
+			}
+
+			if (ancestor != entt::null)
+			{
+				Log::Warning("Transform hierarchy has a loop, entity %d is made a root.", entt::to_integral(node.m_Entity));
+				MakeRoot(registry.get<Transform>(node.m_Entity));
+				node.m_Entity = entt::null;
+				continue;
+			}
+			node.m_Depth = depth;
+		}
+
+		m_Children.erase(std::remove_if(m_Children.begin(), m_Children.end(), [](const ChildNode& node) { return node.m_Entity == entt::null; }), m_Children.end());
+		std::stable_sort(m_Children.begin(), m_Children.end(), [](const ChildNode& a, const ChildNode& b) { return a.m_Depth < b.m_Depth; });
+	}
+
+	bool TransformHierarchy::IsDescendantOf(const entt::registry& registry, entt::entity entity, entt::entity ancestor)
+	{
+		size_t steps = 0;
+		size_t maxSteps = registry.size<Transform>();
+		while (entity != entt::null && registry.valid(entity) && registry.has<Transform>(entity) && steps <= maxSteps)
+		{
+			entity = registry.get<Transform>(entity).m_Parent;
+			if (entity == ancestor)
+			{
+				return true;
+			}
+			steps++;
+		}
+
+		return false;
+	}
+
+	bool TransformHierarchy::SetParent(entt::registry& registry, entt::entity child, entt::entity parent)
+	{
+		if (parent != entt::null && (parent == child || IsDescendantOf(registry, parent, child)))
+		{
+			Log::Warning("Cannot parent entity %d to itself or one of its children.", entt::to_integral(child));
+			return false;
+		}
+
+		WorldPose childPose = ComputeWorld(registry, child);
+		WorldPose parentPose = parent != entt::null ? ComputeWorld(registry, parent) : WorldPose{ glm::vec3(0.0f), glm::vec3(1.0f), 0.0f };
+
+		Transform& transform = registry.get<Transform>(child);
+		transform.m_Parent = parent;
+		transform.m_Position = Decompose(parentPose, childPose.m_Position);
+		transform.m_EulerRotation.z = childPose.m_Rotation - parentPose.m_Rotation;
+		transform.m_Scale = glm::vec3(
+			parentPose.m_Scale.x != 0.0f ? childPose.m_Scale.x / parentPose.m_Scale.x : childPose.m_Scale.x,
+			parentPose.m_Scale.y != 0.0f ? childPose.m_Scale.y / parentPose.m_Scale.y : childPose.m_Scale.y,
+			parentPose.m_Scale.z != 0.0f ? childPose.m_Scale.z / parentPose.m_Scale.z : childPose.m_Scale.z);
+		return true;
+	}
+
+	glm::vec3 TransformHierarchy::WorldToLocal(const entt::registry& registry, const Transform& transform, const glm::vec3& worldPosition)
+	{
+		const Transform* parent = transform.m_Parent != entt::null && registry.valid(transform.m_Parent)
+			? registry.try_get<Transform>(transform.m_Parent)
+			: nullptr;
+		if (parent == nullptr)
+		{
+			return worldPosition;
+		}
+
+		return Decompose({ parent->m_WorldPosition, parent->m_WorldScale, parent->m_WorldRotation }, worldPosition);
+	}
+
+	float TransformHierarchy::WorldToLocalRotation(const entt::registry& registry, const Transform& transform, float worldRotation)
+	{
+		const Transform* parent = transform.m_Parent != entt::null && registry.valid(transform.m_Parent)
+			? registry.try_get<Transform>(transform.m_Parent)
+			: nullptr;
+		return parent != nullptr ? worldRotation - parent->m_WorldRotation : worldRotation;
+	}
+}
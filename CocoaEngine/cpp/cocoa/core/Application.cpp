@@ -4,6 +4,11 @@
 #include "cocoa/core/Application.h"
 #include "cocoa/renderer/DebugDraw.h"
 #include "cocoa/core/Entity.h"
+#include "cocoa/file/AsyncIO.h"
+#include "cocoa/core/JobSystem.h"
+#include "cocoa/core/AssetManager.h"
+#include "cocoa/scenes/Scene.h"
+#include "cocoa/scenes/SceneWriter.h"
 
 namespace Cocoa
 {
@@ -41,6 +46,13 @@ namespace Cocoa
 			float dt = time - m_LastFrameTime;
 			m_LastFrameTime = time;
 
+			AsyncIO::DispatchCompletions();
+			JobSystem::DispatchMainThread();
+			if (m_StreamingScene != nullptr && m_StreamingCounter.IsDone())
+			{
+				FinishSceneChange();
+			}
+
 			BeginFrame();
 			for (Layer* layer : m_Layers)
 			{
@@ -127,9 +139,59 @@ namespace Cocoa
 		this->m_CurrentScene = new Scene(sceneInitializer);
 		this->m_CurrentScene->Init();
 		this->m_CurrentScene->Start();
-		
-		Entity::SetScene(this->m_CurrentScene);
-		DebugDraw::Init(this->m_CurrentScene);
+		this->m_CurrentScene->Activate();
+	}
+
+	void Application::ChangeSceneAsync(SceneInitializer* sceneInitializer, const CPath& filename)
+	{
+		if (m_StreamingScene != nullptr)
+		{
+			Log::Warning("Already loading scene '%s', ignoring '%s'.", m_StreamingFilename.Filepath(), filename.Filepath());
+			delete sceneInitializer;
+			return;
+		}
+
+		Log::Info("Streaming scene %s", filename.Filepath());
+		// The file may still be waiting on the writer, e.g. the current scene saved right before this
+		SceneWriter::Flush();
+
+		Scene* scene = new Scene(sceneInitializer);
+		m_StreamingScene = scene;
+		m_StreamingFilename = filename;
+		if (JobSystem::IsInitialized())
+		{
+			JobSystem::Submit([scene, filename]()
+			{
+				scene->Stream(filename);
+			}, &m_StreamingCounter);
+		}
+		else
+		{
+			scene->Stream(filename);
+		}
+	}
+
+	void Application::FinishSceneChange()
+	{
+		// The old scene lets go of its assets first, anything the new one shares stays resident
+		AssetManager::ReleaseSceneAssets();
+		if (m_CurrentScene != nullptr)
+		{
+			delete m_CurrentScene;
+		}
+
+		m_CurrentScene = m_StreamingScene;
+		m_StreamingScene = nullptr;
+		m_CurrentScene->Init();
+		m_CurrentScene->Start();
+		m_CurrentScene->FinishStreaming();
+		m_CurrentScene->Activate();
+		AssetManager::UnloadUnreferenced();
+
+		for (Layer* layer : m_Layers)
+		{
+			layer->SetScene(m_CurrentScene);
+		}
 	}
 
 	void Application::Stop()
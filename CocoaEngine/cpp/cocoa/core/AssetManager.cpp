@@ -3,6 +3,7 @@
 #include "cocoa/renderer/Texture.h"
 #include "cocoa/file/IFile.h"
 #include "cocoa/util/JsonExtended.h"
+#include "cocoa/core/ImportCache.h"
 
 namespace Cocoa
 {
@@ -47,17 +48,26 @@ namespace Cocoa
 	}
 
 	std::shared_ptr<Asset> AssetManager::GetAsset(const CPath& path)
+	{
+		if (path.Size() == 0)
+		{
+			return std::shared_ptr<Asset>(new NullAsset());
+		}
+
+		// Find rather than Intern, a miss shouldn't grow the path table
+		return FindAsset(PathTable::Find(IFile::GetAbsolutePath(path)));
+	}
+
+	std::shared_ptr<Asset> AssetManager::FindAsset(PathId absolutePath)
 	{
 		AssetManager* manager = Get();
-		auto assetsIt = manager->m_Assets.find(manager->m_CurrentScene);
-		if (assetsIt != manager->m_Assets.end())
+		auto pathsIt = manager->m_AssetIdsByPath.find(manager->m_CurrentScene);
+		if (!absolutePath.IsNull() && pathsIt != manager->m_AssetIdsByPath.end())
 		{
-			for (auto asset = assetsIt->second.begin(); asset != assetsIt->second.end(); asset++)
+			auto idIt = pathsIt->second.find(absolutePath);
+			if (idIt != pathsIt->second.end())
 			{
-				if (asset->second->GetPath() == path)
-				{
-					return asset->second;
-				}
+				return GetAsset(idIt->second);
 			}
 		}
 
@@ -68,26 +78,48 @@ namespace Cocoa
 	{
 		AssetManager* manager = Get();
 
-		std::shared_ptr<Asset> assetExists = GetAsset(path);
+		CPath absPath = IFile::GetAbsolutePath(path);
+		PathId pathId = PathTable::Intern(absPath);
+		std::shared_ptr<Asset> assetExists = FindAsset(pathId);
 		if (!assetExists->IsNull())
 		{
-			Log::Warning("Tried to load asset that has already been loaded.");
-			return std::shared_ptr<Asset>(new NullAsset());
+			// The asset is still resident (it may be shared with a previous scene), so just take
+			// another reference instead of reloading it from disk
+			if (!assetExists->m_IsDefault)
+			{
+				assetExists->m_RefCount++;
+			}
+			return assetExists;
 		}
 
-		CPath absPath = IFile::GetAbsolutePath(path);
 		std::shared_ptr<Texture> newAsset = std::make_shared<Texture>(absPath.Filepath(), isDefault);
 
 		auto& assets = manager->m_Assets[manager->m_CurrentScene];
 
-		uint32 newId = (uint32)assets.size();
+		// Use a running counter rather than the container size, assets can be unloaded individually
+		// so the size no longer guarantees a unique id
+		uint32 newId = manager->m_ResourceCount++;
 
 		newAsset->SetResourceId(newId);
+		newAsset->m_RefCount = isDefault ? 0 : 1;
 		assets.insert({ newId, newAsset });
+		manager->m_AssetIdsByPath[manager->m_CurrentScene][pathId] = newId;
+		manager->m_Version++;
 		newAsset->Load();
 		return newAsset;
 	}
 
+	std::shared_ptr<Asset> AssetManager::ImportTexture(const CPath& path)
+	{
+		std::shared_ptr<Asset> asset = FindAsset(PathTable::Intern(IFile::GetAbsolutePath(path)));
+		if (!asset->IsNull() && (asset->m_IsDefault || asset->m_RefCount > 0))
+		{
+			return asset;
+		}
+
+		return LoadTextureFromFile(path);
+	}
+
 	void AssetManager::Clear()
 	{
 		AssetManager* manager = Get();
@@ -105,12 +137,75 @@ namespace Cocoa
 		}
 
 		manager->m_Assets.clear();
+		manager->m_AssetIdsByPath.clear();
+		manager->m_Version++;
 	}
 
-	std::unordered_map<uint32, uint32> AssetManager::LoadFrom(const json& j)
+	void AssetManager::ReleaseSceneAssets()
+	{
+		AssetManager* manager = Get();
+		auto assetsIt = manager->m_Assets.find(manager->m_CurrentScene);
+		if (assetsIt == manager->m_Assets.end())
+		{
+			return;
+		}
+
+		for (auto assetIt = assetsIt->second.begin(); assetIt != assetsIt->second.end(); assetIt++)
+		{
+			std::shared_ptr<Asset>& asset = assetIt->second;
+			if (!asset->m_IsDefault && asset->m_RefCount > 0)
+			{
+				asset->m_RefCount--;
+			}
+		}
+	}
+
+	void AssetManager::UnloadUnreferenced()
 	{
 		AssetManager* manager = Get();
+		auto assetsIt = manager->m_Assets.find(manager->m_CurrentScene);
+		if (assetsIt == manager->m_Assets.end())
+		{
+			return;
+		}
+
+		auto& assets = assetsIt->second;
+		auto& assetIdsByPath = manager->m_AssetIdsByPath[manager->m_CurrentScene];
+		for (auto assetIt = assets.begin(); assetIt != assets.end();)
+		{
+			std::shared_ptr<Asset>& asset = assetIt->second;
+			if (!asset->m_IsDefault && asset->m_RefCount == 0)
+			{
+				if (!asset->IsNull())
+				{
+					asset->Unload();
+				}
+				assetIdsByPath.erase(PathTable::Find(asset->GetPath()));
+				assetIt = assets.erase(assetIt);
+				manager->m_Version++;
+			}
+			else
+			{
+				assetIt++;
+			}
+		}
+	}
 
+	std::unordered_map<uint32, uint32> AssetManager::LoadFrom(const json& j)
+	{
+		ImportCache::ResetStats();
+		std::unordered_map<uint32, uint32> resourceIDMap = LoadAssetList(j, false);
+		ImportCache::LogStats("scene load");
+		return resourceIDMap;
+	}
+
+	std::unordered_map<uint32, uint32> AssetManager::ResolveFrom(const json& j)
+	{
+		return LoadAssetList(j, true);
+	}
+
+	std::unordered_map<uint32, uint32> AssetManager::LoadAssetList(const json& j, bool reuseResident)
+	{
 		std::unordered_map<uint32, uint32> resourceIDMap{};
 
 		uint32 scene = -1;
@@ -143,7 +238,7 @@ namespace Cocoa
 						break;
 					case Asset::AssetType::Texture:
 					{
-						std::shared_ptr<Asset> tex = LoadTextureFromFile(path);
+						std::shared_ptr<Asset> tex = reuseResident ? ImportTexture(path) : LoadTextureFromFile(path);
 						resourceIDMap.insert({resourceId, tex->GetResourceId()});
 					}
 					break;
@@ -165,13 +260,14 @@ namespace Cocoa
 		AssetManager* manager = Get();
 
 		res["SceneID"] = manager->m_CurrentScene;
-		auto assetList = manager->m_Assets[manager->m_CurrentScene];
+		const auto& assetList = manager->m_Assets[manager->m_CurrentScene];
 
 		int assetCount = 0;
 		
 		for (auto assetIt = assetList.begin(); assetIt != assetList.end(); assetIt++)
 		{
-			if (!assetIt->second->m_IsDefault)
+			// Assets waiting to be unloaded are no longer part of this scene
+			if (!assetIt->second->m_IsDefault && assetIt->second->m_RefCount > 0)
 			{
 				json assetSerialized = assetIt->second->Serialize();
 				if (assetSerialized["Type"] != 0)
@@ -187,6 +283,38 @@ namespace Cocoa
 		return res;
 	}
 
+	json AssetManager::Serialize(const std::vector<uint32>& resourceIds)
+	{
+		json res;
+
+		AssetManager* manager = Get();
+
+		res["SceneID"] = manager->m_CurrentScene;
+		const auto& assetList = manager->m_Assets[manager->m_CurrentScene];
+
+		int assetCount = 0;
+		for (uint32 resourceId : resourceIds)
+		{
+			std::string key = std::to_string(resourceId);
+			auto assetIt = assetList.find(resourceId);
+			if (assetIt == assetList.end() || assetIt->second->m_IsDefault || (res.contains("AssetList") && res["AssetList"].contains(key)))
+			{
+				continue;
+			}
+
+			json assetSerialized = assetIt->second->Serialize();
+			if (assetSerialized["Type"] != 0)
+			{
+				assetCount++;
+				res["AssetList"][key] = assetSerialized;
+			}
+		}
+
+		res["AssetCount"] = assetCount;
+
+		return res;
+	}
+
 	json Asset::Serialize()
 	{
 		Asset::AssetType type = Asset::AssetType::None;
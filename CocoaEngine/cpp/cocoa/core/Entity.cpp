@@ -4,34 +4,21 @@
 namespace Cocoa
 {
 	Entity Entity::Null = Entity();
-	Scene* Entity::s_Scene = nullptr;
 
 	Entity::Entity(entt::entity handle, Scene* scene)
-		: m_EntityHandle(handle)
+		: m_EntityHandle(handle), m_Scene(scene)
 	{
-		Log::Assert((s_Scene != nullptr), "Scene cannot be null to construct an entity. Did you forget to initialize entity at scene change?");
+		Log::Assert((scene != nullptr), "Scene cannot be null to construct an entity.");
 	}
 
-	Entity::Entity(const entt::entity& other)
+	Entity::Entity(entt::entity handle)
+		: m_EntityHandle(handle), m_Scene(nullptr)
 	{
-		Log::Assert((s_Scene != nullptr), "Scene cannot be null to construct an entity. Did you forget to initialize entity at scene change?");
-		m_EntityHandle = other;
-	}
-
-	Entity::Entity(entt::entity& other)
-	{
-		Log::Assert((s_Scene != nullptr), "Scene cannot be null to construct an entity. Did you forget to initialize entity at scene change?");
-		m_EntityHandle = other;
 	}
 
 	Entity::Entity()
+		: m_EntityHandle(entt::null), m_Scene(nullptr)
 	{
-		m_EntityHandle = entt::null;
-	}
-
-	void Entity::SetScene(Scene* scene)
-	{
-		s_Scene = scene;
 	}
 
 	bool Entity::operator==(const Entity& other) const
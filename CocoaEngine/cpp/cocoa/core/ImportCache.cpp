@@ -0,0 +1,367 @@
+#include "cocoa/core/ImportCache.h"
+#include "cocoa/file/IFile.h"
+#include "cocoa/file/PackArchive.h"
+#include "cocoa/util/Compression.h"
+#include "cocoa/util/JsonExtended.h"
+#include "cocoa/util/Log.h"
+
+namespace Cocoa
+{
+	struct TextureCacheHeader
+	{
+		uint32 m_Magic;
+		uint32 m_ImporterVersion;
+		uint64 m_ContentHash;
+		uint32 m_PathLength;
+		int32 m_Width;
+		int32 m_Height;
+		int32 m_Channels;
+		float m_BoundingBox[6];
+		uint64 m_PixelSize;
+		uint64 m_CompressedSize;
+	};
+
+	static const uint32 TEXTURE_CACHE_MAGIC = 0x58544943; // 'CITX'
+	static const uint32 INDEX_VERSION = 1;
+	static const uint32 MAX_CACHED_PATH_LENGTH = 32768;
+
+	// Sizes in the header come from disk, anything that doesn't add up is treated as a miss rather than trusted
+	static bool IsValidHeader(const TextureCacheHeader& header)
+	{
+		if (header.m_Magic != TEXTURE_CACHE_MAGIC || header.m_Width <= 0 || header.m_Height <= 0 ||
+			header.m_Channels <= 0 || header.m_Channels > 4 ||
+			header.m_PathLength > MAX_CACHED_PATH_LENGTH)
+		{
+			return false;
+		}
+
+		uint64 expectedPixelSize = (uint64)header.m_Width * (uint64)header.m_Height * (uint64)header.m_Channels;
+		return header.m_PixelSize == expectedPixelSize && header.m_PixelSize <= (uint64)INT32_MAX &&
+			header.m_CompressedSize <= (uint64)Compression::Lz4CompressBound((int)header.m_PixelSize);
+	}
+
+	ImportCache* ImportCache::s_Instance = nullptr;
+	ImportCacheStats ImportCache::s_Stats = ImportCacheStats();
+
+	void ImportCache::Init(const CPath& cacheDirectory, uint64 maxSizeBytes)
+	{
+		Log::Assert(s_Instance == nullptr, "Import cache is already initialized. Destroy it before switching projects.");
+		IFile::CreateDirIfNotExists(cacheDirectory);
+
+		s_Instance = new ImportCache(cacheDirectory, maxSizeBytes);
+		s_Instance->LoadIndex();
+		ResetStats();
+	}
+
+	void ImportCache::Destroy()
+	{
+		if (s_Instance == nullptr)
+		{
+			return;
+		}
+
+		Evict();
+		s_Instance->SaveIndex();
+		delete s_Instance;
+		s_Instance = nullptr;
+	}
+
+	bool ImportCache::LoadTexture(const CPath& source, std::string_view sourceData, TextureImportData& outData)
+	{
+		if (s_Instance == nullptr)
+		{
+			return false;
+		}
+
+		std::string entryName = s_Instance->GetEntryName(source, ".ctex");
+		if (s_Instance->m_Index.find(entryName) == s_Instance->m_Index.end())
+		{
+			s_Stats.m_Misses++;
+			return false;
+		}
+
+		std::ifstream inStream(s_Instance->GetEntryPath(entryName).Filepath(), std::ios::in | std::ios::binary);
+		TextureCacheHeader header;
+		if (!inStream.is_open() || !inStream.read((char*)&header, sizeof(TextureCacheHeader)) || !IsValidHeader(header))
+		{
+			s_Instance->RemoveEntry(entryName);
+			s_Stats.m_Misses++;
+			return false;
+		}
+
+		std::string cachedPath(header.m_PathLength, '\0');
+		inStream.read(&cachedPath[0], header.m_PathLength);
+		if (header.m_ImporterVersion != TEXTURE_IMPORTER_VERSION || header.m_ContentHash != HashContent(sourceData) ||
+			cachedPath != PackArchive::NormalizePath(source.Filepath()))
+		{
+			s_Stats.m_Stale++;
+			s_Stats.m_Misses++;
+			return false;
+		}
+
+		std::string compressed((size_t)header.m_CompressedSize, '\0');
+		if (!inStream.read(&compressed[0], compressed.size()))
+		{
+			s_Instance->RemoveEntry(entryName);
+			s_Stats.m_Misses++;
+			return false;
+		}
+
+		uint8* pixels = (uint8*)malloc((size_t)header.m_PixelSize);
+		if (pixels == nullptr)
+		{
+			s_Stats.m_Misses++;
+			return false;
+		}
+
+		int size = Compression::Lz4Decompress((const uint8*)compressed.data(), (int)compressed.size(), pixels, (int)header.m_PixelSize);
+		if (size != (int)header.m_PixelSize)
+		{
+			free(pixels);
+			s_Instance->RemoveEntry(entryName);
+			s_Stats.m_Misses++;
+			return false;
+		}
+
+		outData.m_Width = header.m_Width;
+		outData.m_Height = header.m_Height;
+		outData.m_Channels = header.m_Channels;
+		outData.m_BoundingBox.m_Size = glm::vec2(header.m_BoundingBox[0], header.m_BoundingBox[1]);
+		outData.m_BoundingBox.m_HalfSize = glm::vec2(header.m_BoundingBox[2], header.m_BoundingBox[3]);
+		outData.m_BoundingBox.m_Offset = glm::vec2(header.m_BoundingBox[4], header.m_BoundingBox[5]);
+		outData.m_Pixels = pixels;
+
+		s_Instance->Touch(entryName, sizeof(TextureCacheHeader) + header.m_PathLength + header.m_CompressedSize);
+		s_Stats.m_Hits++;
+		s_Stats.m_BytesRead += sizeof(TextureCacheHeader) + header.m_PathLength + header.m_CompressedSize;
+		return true;
+	}
+
+	void ImportCache::StoreTexture(const CPath& source, std::string_view sourceData, const TextureImportData& data)
+	{
+		if (s_Instance == nullptr || data.m_Pixels == nullptr)
+		{
+			return;
+		}
+
+		std::string normalizedPath = PackArchive::NormalizePath(source.Filepath());
+		uint64 pixelSize = (uint64)data.m_Width * (uint64)data.m_Height * (uint64)data.m_Channels;
+		std::string compressed;
+		compressed.resize(Compression::Lz4CompressBound((int)pixelSize));
+		int compressedSize = Compression::Lz4Compress(data.m_Pixels, (int)pixelSize, (uint8*)&compressed[0], (int)compressed.size());
+
+		TextureCacheHeader header = {};
+		header.m_Magic = TEXTURE_CACHE_MAGIC;
+		header.m_ImporterVersion = TEXTURE_IMPORTER_VERSION;
+		header.m_ContentHash = HashContent(sourceData);
+		header.m_PathLength = (uint32)normalizedPath.size();
+		header.m_Width = data.m_Width;
+		header.m_Height = data.m_Height;
+		header.m_Channels = data.m_Channels;
+		header.m_BoundingBox[0] = data.m_BoundingBox.m_Size.x;
+		header.m_BoundingBox[1] = data.m_BoundingBox.m_Size.y;
+		header.m_BoundingBox[2] = data.m_BoundingBox.m_HalfSize.x;
+		header.m_BoundingBox[3] = data.m_BoundingBox.m_HalfSize.y;
+		header.m_BoundingBox[4] = data.m_BoundingBox.m_Offset.x;
+		header.m_BoundingBox[5] = data.m_BoundingBox.m_Offset.y;
+		header.m_PixelSize = pixelSize;
+		header.m_CompressedSize = (uint64)compressedSize;
+
+		std::string entryName = s_Instance->GetEntryName(source, ".ctex");
+		std::ofstream outStream(s_Instance->GetEntryPath(entryName).Filepath(), std::ios::out | std::ios::binary | std::ios::trunc);
+		outStream.write((const char*)&header, sizeof(TextureCacheHeader));
+		outStream.write(normalizedPath.data(), normalizedPath.size());
+		outStream.write(compressed.data(), compressedSize);
+		outStream.close();
+		if (outStream.fail())
+		{
+			Log::Warning("Failed to write import cache entry for '%s'.", source.Filepath());
+			s_Instance->RemoveEntry(entryName);
+			return;
+		}
+
+		uint64 entrySize = sizeof(TextureCacheHeader) + normalizedPath.size() + (uint64)compressedSize;
+		s_Instance->Touch(entryName, entrySize);
+		s_Stats.m_BytesWritten += entrySize;
+		Evict();
+	}
+
+	void ImportCache::Evict()
+	{
+		if (s_Instance == nullptr || s_Instance->m_TotalSize <= s_Instance->m_MaxSize)
+		{
+			return;
+		}
+
+		std::vector<std::pair<uint64, std::string>> entriesByAge;
+		entriesByAge.reserve(s_Instance->m_Index.size());
+		for (const auto& [name, entry] : s_Instance->m_Index)
+		{
+			entriesByAge.emplace_back(entry.m_LastUsed, name);
+		}
+		std::sort(entriesByAge.begin(), entriesByAge.end());
+
+		// Evict down to 3/4 of the budget so a full cache doesn't evict on every single store
+		uint64 target = s_Instance->m_MaxSize - s_Instance->m_MaxSize / 4;
+		for (const auto& [lastUsed, name] : entriesByAge)
+		{
+			if (s_Instance->m_TotalSize <= target)
+			{
+				break;
+			}
+
+			s_Instance->RemoveEntry(name);
+			s_Stats.m_Evictions++;
+		}
+	}
+
+	void ImportCache::Clear()
+	{
+		if (s_Instance == nullptr)
+		{
+			return;
+		}
+
+		while (s_Instance->m_Index.size() > 0)
+		{
+			s_Instance->RemoveEntry(s_Instance->m_Index.begin()->first);
+		}
+		s_Instance->SaveIndex();
+	}
+
+	const ImportCacheStats& ImportCache::GetStats()
+	{
+		return s_Stats;
+	}
+
+	void ImportCache::ResetStats()
+	{
+		s_Stats = ImportCacheStats();
+	}
+
+	void ImportCache::LogStats(const char* label)
+	{
+		if (s_Instance == nullptr || s_Stats.m_Hits + s_Stats.m_Misses == 0)
+		{
+			return;
+		}
+
+		Log::Info("Import cache (%s): %d hits, %d misses (%d stale), %d evicted, %dKB read, %dKB written, %dKB of %dKB in use.",
+			label, s_Stats.m_Hits, s_Stats.m_Misses, s_Stats.m_Stale, s_Stats.m_Evictions,
+			(int)(s_Stats.m_BytesRead / 1024), (int)(s_Stats.m_BytesWritten / 1024),
+			(int)(s_Instance->m_TotalSize / 1024), (int)(s_Instance->m_MaxSize / 1024));
+
+		// Only the entries used so far need to survive a crash, so this is a good point to persist the index
+		if (s_Instance->m_IndexDirty)
+		{
+			s_Instance->SaveIndex();
+		}
+	}
+
+	uint64 ImportCache::HashContent(std::string_view data)
+	{
+		// 64 bit FNV-1a over 8 byte words, the tail is mixed in a byte at a time
+		uint64 hash = 14695981039346656037ull;
+		size_t i = 0;
+		for (; i + sizeof(uint64) <= data.size(); i += sizeof(uint64))
+		{
+			uint64 word;
+			std::memcpy(&word, data.data() + i, sizeof(uint64));
+			hash ^= word;
+			hash *= 1099511628211ull;
+		}
+		for (; i < data.size(); i++)
+		{
+			hash ^= (uint8)data[i];
+			hash *= 1099511628211ull;
+		}
+		hash ^= (uint64)data.size();
+		return hash;
+	}
+
+	void ImportCache::LoadIndex()
+	{
+		File* indexFile = IFile::OpenFile(m_Directory + "index.json");
+		if (indexFile->m_Data.size() > 0)
+		{
+			json j = json::parse(indexFile->m_Data.begin(), indexFile->m_Data.end(), nullptr, false);
+			uint32 version = 0;
+			if (!j.is_discarded())
+			{
+				JsonExtended::AssignIfNotNull(j["Version"], version);
+			}
+
+			if (version == INDEX_VERSION)
+			{
+				JsonExtended::AssignIfNotNull(j["UseCounter"], m_UseCounter);
+				for (auto it = j["Entries"].begin(); it != j["Entries"].end(); ++it)
+				{
+					IndexEntry entry;
+					JsonExtended::AssignIfNotNull(it.value()["Size"], entry.m_Size);
+					JsonExtended::AssignIfNotNull(it.value()["LastUsed"], entry.m_LastUsed);
+					m_Index[it.key()] = entry;
+					m_TotalSize += entry.m_Size;
+				}
+			}
+		}
+		IFile::CloseFile(indexFile);
+
+		// Anything on disk the index doesn't know about was left behind by a crash or an old format
+		for (const CPath& file : IFile::GetFilesInDir(m_Directory))
+		{
+			if (strcmp(file.Filename(), "index.json") != 0 && m_Index.find(file.Filename()) == m_Index.end())
+			{
+				IFile::DeleteFile(file);
+			}
+		}
+	}
+
+	void ImportCache::SaveIndex()
+	{
+		json j;
+		j["Version"] = INDEX_VERSION;
+		j["UseCounter"] = m_UseCounter;
+		j["Entries"] = json::object();
+		for (const auto& [name, entry] : m_Index)
+		{
+			j["Entries"][name] = { {"Size", entry.m_Size}, {"LastUsed", entry.m_LastUsed} };
+		}
+
+		IFile::WriteFile(j.dump(4).c_str(), m_Directory + "index.json");
+		m_IndexDirty = false;
+	}
+
+	void ImportCache::Touch(const std::string& entryName, uint64 size)
+	{
+		IndexEntry& entry = m_Index[entryName];
+		m_TotalSize = m_TotalSize - entry.m_Size + size;
+		entry.m_Size = size;
+		entry.m_LastUsed = ++m_UseCounter;
+		m_IndexDirty = true;
+	}
+
+	void ImportCache::RemoveEntry(const std::string& entryName)
+	{
+		auto iter = m_Index.find(entryName);
+		if (iter != m_Index.end())
+		{
+			m_TotalSize -= iter->second.m_Size;
+			m_Index.erase(iter);
+			m_IndexDirty = true;
+		}
+
+		IFile::DeleteFile(GetEntryPath(entryName));
+	}
+
+	std::string ImportCache::GetEntryName(const CPath& source, const char* extension) const
+	{
+		char name[32];
+		snprintf(name, sizeof(name), "%016llx", (unsigned long long)PackArchive::HashPath(PackArchive::NormalizePath(source.Filepath())));
+		return std::string(name) + extension;
+	}
+
+	CPath ImportCache::GetEntryPath(const std::string& entryName) const
+	{
+		return m_Directory + entryName;
+	}
+}
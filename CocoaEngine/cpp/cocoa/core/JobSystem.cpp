@@ -0,0 +1,360 @@
+#include "cocoa/core/JobSystem.h"
+#include "cocoa/util/Log.h"
+
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+namespace Cocoa
+{
+	struct Job
+	{
+		JobFunction m_Function;
+		JobCounter* m_Counter = nullptr;
+		bool m_MainThread = false;
+	};
+
+	// Owners push and pop at the back, thieves take from the front. Jobs are tiny next to the cost of
+	// what they run, so a lock per deque is cheap enough, and it is only ever contended while stealing
+	struct WorkerQueue
+	{
+		std::mutex m_Mutex;
+		std::deque<Job*> m_Jobs;
+	};
+
+	struct JobSystemState
+	{
+		std::vector<std::thread> m_Workers;
+		std::vector<std::unique_ptr<WorkerQueue>> m_Queues;
+		// Spreads jobs submitted from outside the pool over the workers
+		std::atomic<uint32> m_NextQueue{ 0 };
+		// Jobs sitting in a worker queue, idle workers sleep while this is zero
+		std::atomic<int32> m_QueuedJobs{ 0 };
+		// Jobs submitted that haven't finished yet, held back ones included
+		std::atomic<int32> m_UnfinishedJobs{ 0 };
+
+		std::mutex m_SleepMutex;
+		std::condition_variable m_SleepCondition;
+		bool m_Stopping = false;
+
+		std::thread::id m_MainThread;
+		std::mutex m_MainMutex;
+		std::vector<Job*> m_MainJobs;
+	};
+
+	JobSystemState* JobSystem::s_Instance = nullptr;
+
+	// Index of the queue the current thread owns, -1 for threads outside the pool
+	static thread_local int s_WorkerIndex = -1;
+
+	static void Enqueue(JobSystemState* state, Job* job)
+	{
+		if (job->m_MainThread)
+		{
+			std::lock_guard<std::mutex> lock(state->m_MainMutex);
+			state->m_MainJobs.push_back(job);
+			return;
+		}
+
+		int index = s_WorkerIndex >= 0
+			? s_WorkerIndex
+			: (int)(state->m_NextQueue.fetch_add(1, std::memory_order_relaxed) % state->m_Queues.size());
+		{
+			std::lock_guard<std::mutex> lock(state->m_Queues[index]->m_Mutex);
+			state->m_Queues[index]->m_Jobs.push_back(job);
+		}
+		state->m_QueuedJobs.fetch_add(1, std::memory_order_release);
+
+		// Taking the lock makes sure a worker that just found nothing to do is either still awake to see
+		// the new job or already waiting for the notify
+		{
+			std::lock_guard<std::mutex> lock(state->m_SleepMutex);
+		}
+		state->m_SleepCondition.notify_one();
+	}
+
+	static Job* TakeJob(JobSystemState* state, int ownIndex)
+	{
+		Job* job = nullptr;
+		if (ownIndex >= 0)
+		{
+			WorkerQueue& queue = *state->m_Queues[ownIndex];
+			std::lock_guard<std::mutex> lock(queue.m_Mutex);
+			if (queue.m_Jobs.size() > 0)
+			{
+				job = queue.m_Jobs.back();
+				queue.m_Jobs.pop_back();
+			}
+		}
+
+		// Start stealing right after our own queue, so thieves don't all pile onto the first worker
+		int queueCount = (int)state->m_Queues.size();
+		int start = ownIndex >= 0 ? ownIndex + 1 : (int)(state->m_NextQueue.load(std::memory_order_relaxed) % queueCount);
+		for (int i = 0; job == nullptr && i < queueCount; i++)
+		{
+			int index = (start + i) % queueCount;
+			if (index == ownIndex)
+			{
+				continue;
+			}
+
+			WorkerQueue& queue = *state->m_Queues[index];
+			std::lock_guard<std::mutex> lock(queue.m_Mutex);
+			if (queue.m_Jobs.size() > 0)
+			{
+				job = queue.m_Jobs.front();
+				queue.m_Jobs.pop_front();
+			}
+		}
+
+		if (job != nullptr)
+		{
+			state->m_QueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+		}
+		return job;
+	}
+
+	// Takes a queued job submitted with counter, from anywhere in any queue. Threads outside the pool only
+	// help with the work they're waiting for, a long unrelated job would stall them
+	static Job* TakeJobFor(JobSystemState* state, const JobCounter* counter)
+	{
+		for (const std::unique_ptr<WorkerQueue>& queue : state->m_Queues)
+		{
+			std::lock_guard<std::mutex> lock(queue->m_Mutex);
+			auto it = std::find_if(queue->m_Jobs.begin(), queue->m_Jobs.end(), [counter](const Job* job) { return job->m_Counter == counter; });
+			if (it != queue->m_Jobs.end())
+			{
+				Job* job = *it;
+				queue->m_Jobs.erase(it);
+				state->m_QueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+				return job;
+			}
+		}
+
+		return nullptr;
+	}
+
+	void JobSystem::RunJob(Job* job)
+	{
+		JobSystemState* state = s_Instance;
+		job->m_Function();
+
+		if (JobCounter* counter = job->m_Counter)
+		{
+			std::vector<Job*> released;
+			{
+				std::lock_guard<std::mutex> lock(counter->m_Mutex);
+				if (counter->m_Count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				{
+					released.swap(counter->m_Waiting);
+				}
+			}
+
+			for (Job* waiting : released)
+			{
+				Enqueue(state, waiting);
+			}
+		}
+
+		delete job;
+		state->m_UnfinishedJobs.fetch_sub(1, std::memory_order_acq_rel);
+	}
+
+	void JobSystem::WorkerMain(JobSystemState* state, int index)
+	{
+		s_WorkerIndex = index;
+		while (true)
+		{
+			if (Job* job = TakeJob(state, index))
+			{
+				RunJob(job);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(state->m_SleepMutex);
+			state->m_SleepCondition.wait(lock, [state]()
+			{
+				return state->m_Stopping || state->m_QueuedJobs.load(std::memory_order_acquire) > 0;
+			});
+
+			if (state->m_Stopping && state->m_QueuedJobs.load(std::memory_order_acquire) <= 0)
+			{
+				return;
+			}
+		}
+	}
+
+	void JobSystem::SubmitJob(JobFunction&& function, JobCounter* counter, JobCounter* dependency, bool mainThread)
+	{
+		JobSystemState* state = s_Instance;
+		Log::Assert(state != nullptr, "JobSystem never initialized.");
+		Job* job = new Job();
+		job->m_Function = std::move(function);
+		job->m_Counter = counter;
+		job->m_MainThread = mainThread;
+
+		state->m_UnfinishedJobs.fetch_add(1, std::memory_order_relaxed);
+		if (counter != nullptr)
+		{
+			counter->m_Count.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		if (dependency != nullptr)
+		{
+			std::lock_guard<std::mutex> lock(dependency->m_Mutex);
+			if (dependency->m_Count.load(std::memory_order_acquire) > 0)
+			{
+				dependency->m_Waiting.push_back(job);
+				return;
+			}
+		}
+
+		Enqueue(state, job);
+	}
+
+	void JobSystem::Init(int numWorkers)
+	{
+		Log::Assert(s_Instance == nullptr, "JobSystem already initialized.");
+		if (numWorkers <= 0)
+		{
+			numWorkers = std::max((int)std::thread::hardware_concurrency() - 1, 1);
+		}
+
+		s_Instance = new JobSystemState();
+		s_Instance->m_MainThread = std::this_thread::get_id();
+		for (int i = 0; i < numWorkers; i++)
+		{
+			s_Instance->m_Queues.emplace_back(std::make_unique<WorkerQueue>());
+		}
+		for (int i = 0; i < numWorkers; i++)
+		{
+			s_Instance->m_Workers.emplace_back(WorkerMain, s_Instance, i);
+		}
+	}
+
+	void JobSystem::Destroy()
+	{
+		if (s_Instance == nullptr)
+		{
+			return;
+		}
+
+		// Main thread jobs can release worker jobs and the other way round, so help out until nothing is left
+		while (s_Instance->m_UnfinishedJobs.load(std::memory_order_acquire) > 0)
+		{
+			DispatchMainThread();
+			if (Job* job = TakeJob(s_Instance, -1))
+			{
+				RunJob(job);
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(s_Instance->m_SleepMutex);
+			s_Instance->m_Stopping = true;
+		}
+		s_Instance->m_SleepCondition.notify_all();
+		for (std::thread& worker : s_Instance->m_Workers)
+		{
+			worker.join();
+		}
+
+		delete s_Instance;
+		s_Instance = nullptr;
+	}
+
+	int JobSystem::GetWorkerCount()
+	{
+		return s_Instance != nullptr ? (int)s_Instance->m_Workers.size() : 0;
+	}
+
+	void JobSystem::Submit(JobFunction job, JobCounter* counter, JobCounter* dependency)
+	{
+		SubmitJob(std::move(job), counter, dependency, false);
+	}
+
+	void JobSystem::SubmitMainThread(JobFunction job, JobCounter* counter, JobCounter* dependency)
+	{
+		SubmitJob(std::move(job), counter, dependency, true);
+	}
+
+	void JobSystem::ParallelFor(size_t begin, size_t end, size_t grainSize, const std::function<void(size_t first, size_t last)>& fn)
+	{
+		if (end <= begin)
+		{
+			return;
+		}
+
+		size_t count = end - begin;
+		grainSize = std::max(grainSize, (size_t)1);
+		if (s_Instance == nullptr || count <= grainSize)
+		{
+			fn(begin, end);
+			return;
+		}
+
+		// A few ranges per thread, so stealing can even out ranges that take longer than others
+		size_t maxRanges = (size_t)(GetWorkerCount() + 1) * 4;
+		size_t rangeCount = std::min((count + grainSize - 1) / grainSize, maxRanges);
+		size_t rangeSize = (count + rangeCount - 1) / rangeCount;
+
+		JobCounter counter;
+		for (size_t first = begin + rangeSize; first < end; first += rangeSize)
+		{
+			size_t last = std::min(first + rangeSize, end);
+			Submit([&fn, first, last]() { fn(first, last); }, &counter);
+		}
+
+		fn(begin, std::min(begin + rangeSize, end));
+		Wait(counter);
+	}
+
+	void JobSystem::Wait(JobCounter& counter)
+	{
+		bool mainThread = s_Instance != nullptr && std::this_thread::get_id() == s_Instance->m_MainThread;
+		while (!counter.IsDone())
+		{
+			if (mainThread)
+			{
+				DispatchMainThread();
+			}
+
+			Log::Assert(s_Instance != nullptr, "JobSystem never initialized.");
+			Job* job = s_WorkerIndex >= 0 ? TakeJob(s_Instance, s_WorkerIndex) : TakeJobFor(s_Instance, &counter);
+			if (job != nullptr)
+			{
+				RunJob(job);
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		// The job that finished the counter may still hold its lock, the caller is free to destroy it after this
+		std::lock_guard<std::mutex> lock(counter.m_Mutex);
+	}
+
+	void JobSystem::DispatchMainThread()
+	{
+		if (s_Instance == nullptr)
+		{
+			return;
+		}
+
+		std::vector<Job*> jobs;
+		{
+			std::lock_guard<std::mutex> lock(s_Instance->m_MainMutex);
+			jobs.swap(s_Instance->m_MainJobs);
+		}
+
+		for (Job* job : jobs)
+		{
+			RunJob(job);
+		}
+	}
+}
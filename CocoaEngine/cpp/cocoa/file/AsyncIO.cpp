@@ -0,0 +1,834 @@
+#include "cocoa/file/AsyncIO.h"
+#include "cocoa/util/Log.h"
+
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Cocoa
+{
+	enum class AsyncIOType : uint8
+	{
+		Read,
+		Write
+	};
+
+	struct AsyncIOOperation
+	{
+		AsyncIOType m_Type;
+		CPath m_Path;
+		std::string m_WriteData;
+		File* m_File = nullptr;
+		bool m_Success = false;
+	};
+
+	struct AsyncIOJob
+	{
+		std::vector<AsyncIOOperation> m_Operations;
+		IOPriority m_Priority = IOPriority::Normal;
+		// Runs on the worker as soon as the I/O finishes, this is what fulfils futures
+		std::function<void(AsyncIOJob&)> m_OnFinished;
+		// Runs on the main thread from DispatchCompletions
+		std::function<void(AsyncIOJob&)> m_OnComplete;
+	};
+
+	// Files read on a worker are always buffered. A mapping would just move the page faults onto
+	// whichever thread reads the data, which defeats the point of reading it in the background.
+	static File* CreateBufferedFile(uint64 size)
+	{
+		File* file = new File();
+		file->m_Buffer.resize((size_t)size);
+		return file;
+	}
+
+	static void FinishBufferedFile(File* file, uint64 bytesRead, bool success)
+	{
+		file->m_Buffer.resize(success ? (size_t)bytesRead : 0);
+		file->m_Data = file->m_Buffer;
+		file->m_Size = (uint32)file->m_Buffer.size();
+		file->m_Open = success;
+	}
+
+	// Packed files are already in memory, so they are handed out as a view without touching the disk
+	static bool ReadMountedFile(AsyncIOOperation* operation)
+	{
+		std::string_view mountedData;
+		if (!IFile::GetMountedFile(operation->m_Path, mountedData))
+		{
+			return false;
+		}
+
+		File* file = new File();
+		file->m_Data = mountedData;
+		file->m_Size = (uint32)mountedData.size();
+		file->m_Open = true;
+		operation->m_File = file;
+		operation->m_Success = true;
+		return true;
+	}
+
+	// ===================================================================================
+	// Backends
+	// ===================================================================================
+	class AsyncIOBackend
+	{
+	public:
+		virtual ~AsyncIOBackend() {}
+		virtual void Execute(const std::vector<AsyncIOOperation*>& operations) = 0;
+		virtual const char* GetName() const = 0;
+	};
+
+	class BlockingIOBackend : public AsyncIOBackend
+	{
+	public:
+		virtual void Execute(const std::vector<AsyncIOOperation*>& operations) override
+		{
+			for (AsyncIOOperation* operation : operations)
+			{
+				if (operation->m_Type == AsyncIOType::Read)
+				{
+					if (ReadMountedFile(operation))
+					{
+						continue;
+					}
+
+					std::ifstream inStream(operation->m_Path.Filepath(), std::ios::in | std::ios::binary | std::ios::ate);
+					uint64 size = inStream.is_open() ? (uint64)inStream.tellg() : 0;
+					operation->m_File = CreateBufferedFile(size);
+					inStream.seekg(0, std::ios::beg);
+					operation->m_Success = inStream.is_open() && (size == 0 || inStream.read(&operation->m_File->m_Buffer[0], size));
+					FinishBufferedFile(operation->m_File, size, operation->m_Success);
+				}
+				else
+				{
+					operation->m_Success = IFile::WriteFileAtomic(operation->m_WriteData, operation->m_Path);
+				}
+			}
+		}
+
+		virtual const char* GetName() const override { return "Thread Pool"; }
+	};
+
+#ifdef __linux__
+	// Reads and writes larger than this are split, the kernel caps a single request just under 2GB anyway
+	static const uint64 MAX_IO_SIZE = 1 << 30;
+
+	// Talks to the kernel through the raw syscalls, liburing is not a dependency of the engine
+	class IoUringBackend : public AsyncIOBackend
+	{
+	public:
+		static IoUringBackend* Create(uint32 entries)
+		{
+			IoUringBackend* backend = new IoUringBackend();
+			if (!backend->Setup(entries))
+			{
+				delete backend;
+				return nullptr;
+			}
+			return backend;
+		}
+
+		virtual ~IoUringBackend()
+		{
+			if (m_Sqes != nullptr) munmap(m_Sqes, m_SqesSize);
+			if (m_CqRing != nullptr && m_CqRing != m_SqRing) munmap(m_CqRing, m_CqRingSize);
+			if (m_SqRing != nullptr) munmap(m_SqRing, m_SqRingSize);
+			if (m_RingFd >= 0) close(m_RingFd);
+		}
+
+		virtual void Execute(const std::vector<AsyncIOOperation*>& operations) override
+		{
+			std::vector<PendingOperation> pending;
+			std::deque<size_t> readyToSubmit;
+			pending.reserve(operations.size());
+			for (AsyncIOOperation* operation : operations)
+			{
+				PendingOperation op = { operation, -1, 0, 0, nullptr };
+				if (operation->m_Type == AsyncIOType::Read)
+				{
+					if (ReadMountedFile(operation))
+					{
+						continue;
+					}
+
+					struct stat fileStat;
+					op.m_Fd = open(operation->m_Path.Filepath(), O_RDONLY | O_CLOEXEC);
+					if (op.m_Fd < 0 || fstat(op.m_Fd, &fileStat) != 0)
+					{
+						operation->m_File = CreateBufferedFile(0);
+						Finish(op, false);
+						continue;
+					}
+
+					op.m_Size = (uint64)fileStat.st_size;
+					operation->m_File = CreateBufferedFile(op.m_Size);
+					op.m_Buffer = op.m_Size > 0 ? &operation->m_File->m_Buffer[0] : nullptr;
+				}
+				else
+				{
+					// Same contract as IFile::WriteFileAtomic, the temp file is renamed over the original once it's complete
+					op.m_Fd = open(GetTempFilepath(operation).c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+					if (op.m_Fd < 0)
+					{
+						Finish(op, false);
+						continue;
+					}
+
+					op.m_Size = operation->m_WriteData.size();
+					op.m_Buffer = &operation->m_WriteData[0];
+				}
+
+				if (op.m_Size == 0)
+				{
+					Finish(op, true);
+					continue;
+				}
+
+				readyToSubmit.push_back(pending.size());
+				pending.push_back(op);
+			}
+
+			uint32 inFlight = 0;
+			uint32 unconsumed = 0;
+			// Set after EBUSY, the next call only waits so the completions can be reaped before submitting again
+			bool cqBusy = false;
+			while (readyToSubmit.size() > 0 || inFlight > 0 || unconsumed > 0)
+			{
+				// Fill as much of the submission queue as we can, the whole batch goes to the kernel in one call.
+				// Never have more operations out than the completion queue holds, kernels without
+				// IORING_FEAT_NODROP throw away completions that don't fit
+				uint32 tail = *m_SqTail;
+				uint32 head = __atomic_load_n(m_SqHead, __ATOMIC_ACQUIRE);
+				uint32 cqEntries = *m_CqEntries;
+				uint32 queued = 0;
+				while (!cqBusy && readyToSubmit.size() > 0 && tail - head < m_SqEntries && inFlight + unconsumed + queued < cqEntries)
+				{
+					size_t index = readyToSubmit.front();
+					readyToSubmit.pop_front();
+					PendingOperation& op = pending[index];
+
+					uint32 slot = tail & *m_SqMask;
+					io_uring_sqe* sqe = &m_Sqes[slot];
+					std::memset(sqe, 0, sizeof(io_uring_sqe));
+					sqe->opcode = op.m_Operation->m_Type == AsyncIOType::Read ? IORING_OP_READ : IORING_OP_WRITE;
+					sqe->fd = op.m_Fd;
+					sqe->addr = (uint64)(uintptr_t)(op.m_Buffer + op.m_Offset);
+					sqe->len = (uint32)std::min<uint64>(op.m_Size - op.m_Offset, MAX_IO_SIZE);
+					sqe->off = op.m_Offset;
+					sqe->user_data = index;
+					m_SqArray[slot] = slot;
+					tail++;
+					queued++;
+				}
+				__atomic_store_n(m_SqTail, tail, __ATOMIC_RELEASE);
+
+				uint32 toSubmit = cqBusy ? 0 : queued + unconsumed;
+				uint32 waitFor = (inFlight + toSubmit) > 0 ? 1 : 0;
+				int consumed = (int)syscall(__NR_io_uring_enter, m_RingFd, toSubmit, waitFor, IORING_ENTER_GETEVENTS, nullptr, 0);
+				if (consumed < 0)
+				{
+					unconsumed += queued;
+					// EBUSY means completions are backed up, only reaping them clears it. Without anything in
+					// flight there's nothing to reap and it would never clear
+					if (errno == EINTR || errno == EAGAIN || (errno == EBUSY && inFlight > 0))
+					{
+						cqBusy = errno == EBUSY;
+						continue;
+					}
+
+					// The ring is unusable, finish everything that's left the slow way
+					Log::Warning("io_uring_enter failed (%d), falling back to blocking I/O for this batch.", errno);
+					FinishBlocking(pending);
+					return;
+				}
+				cqBusy = false;
+				unconsumed = unconsumed + queued - (uint32)consumed;
+				inFlight += (uint32)consumed;
+
+				uint32 cqHead = *m_CqHead;
+				uint32 cqTail = __atomic_load_n(m_CqTail, __ATOMIC_ACQUIRE);
+				for (; cqHead != cqTail; cqHead++)
+				{
+					io_uring_cqe* cqe = &m_Cqes[cqHead & *m_CqMask];
+					PendingOperation& op = pending[(size_t)cqe->user_data];
+					int result = cqe->res;
+					inFlight--;
+
+					if (result == -EINTR || result == -EAGAIN)
+					{
+						readyToSubmit.push_back((size_t)cqe->user_data);
+					}
+					else if (result < 0)
+					{
+						Finish(op, false);
+					}
+					else if (result == 0)
+					{
+						// The file shrank underneath us, keep what we got. A zero length write is an error
+						Finish(op, op.m_Operation->m_Type == AsyncIOType::Read);
+					}
+					else
+					{
+						op.m_Offset += (uint64)result;
+						if (op.m_Offset < op.m_Size)
+						{
+							readyToSubmit.push_back((size_t)cqe->user_data);
+						}
+						else
+						{
+							Finish(op, true);
+						}
+					}
+				}
+				__atomic_store_n(m_CqHead, cqHead, __ATOMIC_RELEASE);
+			}
+		}
+
+		virtual const char* GetName() const override { return "io_uring"; }
+
+	private:
+		struct PendingOperation
+		{
+			AsyncIOOperation* m_Operation;
+			int m_Fd;
+			uint64 m_Offset;
+			uint64 m_Size;
+			char* m_Buffer;
+		};
+
+		bool Setup(uint32 entries)
+		{
+			io_uring_params params;
+			std::memset(&params, 0, sizeof(params));
+			m_RingFd = (int)syscall(__NR_io_uring_setup, entries, &params);
+			if (m_RingFd < 0)
+			{
+				return false;
+			}
+
+			m_SqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32);
+			m_CqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+			bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+			if (singleMap)
+			{
+				m_SqRingSize = m_CqRingSize = std::max(m_SqRingSize, m_CqRingSize);
+			}
+
+			void* sqRing = mmap(nullptr, m_SqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFd, IORING_OFF_SQ_RING);
+			if (sqRing == MAP_FAILED)
+			{
+				return false;
+			}
+			m_SqRing = (uint8*)sqRing;
+
+			if (singleMap)
+			{
+				m_CqRing = m_SqRing;
+			}
+			else
+			{
+				void* cqRing = mmap(nullptr, m_CqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFd, IORING_OFF_CQ_RING);
+				if (cqRing == MAP_FAILED)
+				{
+					return false;
+				}
+				m_CqRing = (uint8*)cqRing;
+			}
+
+			m_SqesSize = params.sq_entries * sizeof(io_uring_sqe);
+			void* sqes = mmap(nullptr, m_SqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFd, IORING_OFF_SQES);
+			if (sqes == MAP_FAILED)
+			{
+				return false;
+			}
+			m_Sqes = (io_uring_sqe*)sqes;
+
+			m_SqEntries = params.sq_entries;
+			m_SqHead = (uint32*)(m_SqRing + params.sq_off.head);
+			m_SqTail = (uint32*)(m_SqRing + params.sq_off.tail);
+			m_SqMask = (uint32*)(m_SqRing + params.sq_off.ring_mask);
+			m_SqArray = (uint32*)(m_SqRing + params.sq_off.array);
+			m_CqHead = (uint32*)(m_CqRing + params.cq_off.head);
+			m_CqTail = (uint32*)(m_CqRing + params.cq_off.tail);
+			m_CqMask = (uint32*)(m_CqRing + params.cq_off.ring_mask);
+			m_CqEntries = (uint32*)(m_CqRing + params.cq_off.ring_entries);
+			m_Cqes = (io_uring_cqe*)(m_CqRing + params.cq_off.cqes);
+			return SupportsReadWrite();
+		}
+
+		// IORING_OP_READ and IORING_OP_WRITE only exist from 5.6 on, older rings set up fine and then fail
+		// every operation. The probe arrived in 5.6 as well, so on those kernels the register call fails
+		bool SupportsReadWrite()
+		{
+			std::vector<uint8> probeBuffer(sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op), 0);
+			io_uring_probe* probe = (io_uring_probe*)probeBuffer.data();
+			if (syscall(__NR_io_uring_register, m_RingFd, IORING_REGISTER_PROBE, probe, 256) < 0)
+			{
+				return false;
+			}
+
+			auto isSupported = [probe](uint8 opcode)
+			{
+				return opcode <= probe->last_op && (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED) != 0;
+			};
+			return isSupported(IORING_OP_READ) && isSupported(IORING_OP_WRITE);
+		}
+
+		static std::string GetTempFilepath(const AsyncIOOperation* operation)
+		{
+			return std::string(operation->m_Path.Filepath()) + ".tmp";
+		}
+
+		void Finish(PendingOperation& op, bool success)
+		{
+			bool isWrite = op.m_Operation->m_Type == AsyncIOType::Write;
+			if (op.m_Fd >= 0)
+			{
+				success = success && (!isWrite || fsync(op.m_Fd) == 0);
+				close(op.m_Fd);
+				op.m_Fd = -1;
+			}
+
+			if (isWrite)
+			{
+				std::string tmpFilepath = GetTempFilepath(op.m_Operation);
+				success = success && rename(tmpFilepath.c_str(), op.m_Operation->m_Path.Filepath()) == 0;
+				if (!success)
+				{
+					unlink(tmpFilepath.c_str());
+				}
+			}
+
+			op.m_Operation->m_Success = success;
+			if (!isWrite)
+			{
+				FinishBufferedFile(op.m_Operation->m_File, op.m_Offset, success);
+			}
+		}
+
+		void FinishBlocking(std::vector<PendingOperation>& pending)
+		{
+			for (PendingOperation& op : pending)
+			{
+				if (op.m_Fd < 0)
+				{
+					continue;
+				}
+
+				bool isRead = op.m_Operation->m_Type == AsyncIOType::Read;
+				while (op.m_Offset < op.m_Size)
+				{
+					ssize_t result = isRead
+						? pread(op.m_Fd, op.m_Buffer + op.m_Offset, op.m_Size - op.m_Offset, op.m_Offset)
+						: pwrite(op.m_Fd, op.m_Buffer + op.m_Offset, op.m_Size - op.m_Offset, op.m_Offset);
+					if (result < 0 && errno == EINTR)
+					{
+						continue;
+					}
+					if (result <= 0)
+					{
+						break;
+					}
+					op.m_Offset += (uint64)result;
+				}
+				Finish(op, op.m_Offset == op.m_Size);
+			}
+		}
+
+	private:
+		int m_RingFd = -1;
+		uint32 m_SqEntries = 0;
+
+		uint8* m_SqRing = nullptr;
+		size_t m_SqRingSize = 0;
+		uint32* m_SqHead = nullptr;
+		uint32* m_SqTail = nullptr;
+		uint32* m_SqMask = nullptr;
+		uint32* m_SqArray = nullptr;
+		io_uring_sqe* m_Sqes = nullptr;
+		size_t m_SqesSize = 0;
+
+		uint8* m_CqRing = nullptr;
+		size_t m_CqRingSize = 0;
+		uint32* m_CqHead = nullptr;
+		uint32* m_CqTail = nullptr;
+		uint32* m_CqMask = nullptr;
+		uint32* m_CqEntries = nullptr;
+		io_uring_cqe* m_Cqes = nullptr;
+	};
+#endif
+
+	static AsyncIOBackend* CreateBackend()
+	{
+#ifdef __linux__
+		// Kernels without io_uring (or with it disabled by policy) fail the setup call, ones too old for the
+		// opcodes we use fail the probe
+		if (AsyncIOBackend* backend = IoUringBackend::Create(64))
+		{
+			return backend;
+		}
+#endif
+		return new BlockingIOBackend();
+	}
+
+	// ===================================================================================
+	// Async IO service
+	// ===================================================================================
+	struct AsyncIOState
+	{
+		std::vector<std::thread> m_Workers;
+		std::mutex m_QueueMutex;
+		std::condition_variable m_QueueCondition;
+		std::condition_variable m_IdleCondition;
+		std::deque<AsyncIOJob*> m_Queues[(int)IOPriority::Length];
+		int m_ActiveStreamingWorkers = 0;
+		int m_MaxStreamingWorkers = 1;
+		int m_JobsInFlight = 0;
+		bool m_Stopping = false;
+		const char* m_BackendName = "None";
+
+		std::mutex m_CompletionMutex;
+		std::vector<AsyncIOJob*> m_Completed;
+
+		// Writes to a path share its temp file, so they run one at a time in the order they were issued. A path
+		// is in here while one of its writes is queued or running, later writes wait in its list until that one
+		// has been renamed into place. Guarded by m_QueueMutex
+		std::unordered_map<std::string, std::deque<AsyncIOJob*>> m_PendingWrites;
+	};
+
+	AsyncIOState* AsyncIO::s_Instance = nullptr;
+
+	// Requests of the same priority that are queued together are handed to the backend together
+	static const size_t MAX_BATCH_SIZE = 32;
+
+	static int PickQueue(AsyncIOState* state)
+	{
+		for (int i = 0; i < (int)IOPriority::Length; i++)
+		{
+			if (state->m_Queues[i].size() == 0)
+			{
+				continue;
+			}
+
+			if (i == (int)IOPriority::Streaming && state->m_ActiveStreamingWorkers >= state->m_MaxStreamingWorkers)
+			{
+				continue;
+			}
+
+			return i;
+		}
+
+		return -1;
+	}
+
+	static bool IsWrite(const AsyncIOJob* job)
+	{
+		return job->m_Operations.size() == 1 && job->m_Operations[0].m_Type == AsyncIOType::Write;
+	}
+
+	// Called with m_QueueMutex held once a write has finished, hands the next write to the same path to a worker
+	static void ReleaseWritePath(AsyncIOState* state, const std::string& path)
+	{
+		auto iter = state->m_PendingWrites.find(path);
+		if (iter == state->m_PendingWrites.end())
+		{
+			return;
+		}
+
+		if (iter->second.size() == 0)
+		{
+			state->m_PendingWrites.erase(iter);
+			return;
+		}
+
+		AsyncIOJob* next = iter->second.front();
+		iter->second.pop_front();
+		state->m_Queues[(int)next->m_Priority].push_back(next);
+		state->m_QueueCondition.notify_one();
+	}
+
+	static void WorkerMain(AsyncIOState* state)
+	{
+		std::unique_ptr<AsyncIOBackend> backend(CreateBackend());
+		{
+			std::lock_guard<std::mutex> lock(state->m_QueueMutex);
+			state->m_BackendName = backend->GetName();
+		}
+
+		std::vector<AsyncIOJob*> batch;
+		std::vector<AsyncIOOperation*> operations;
+		std::vector<std::string> finishedWrites;
+		while (true)
+		{
+			int queueIndex = -1;
+			{
+				std::unique_lock<std::mutex> lock(state->m_QueueMutex);
+				state->m_QueueCondition.wait(lock, [state]() { return state->m_Stopping || PickQueue(state) >= 0; });
+
+				// Queued work is always drained before the workers shut down
+				queueIndex = PickQueue(state);
+				if (queueIndex < 0)
+				{
+					return;
+				}
+
+				std::deque<AsyncIOJob*>& queue = state->m_Queues[queueIndex];
+				while (queue.size() > 0 && batch.size() < MAX_BATCH_SIZE)
+				{
+					batch.push_back(queue.front());
+					queue.pop_front();
+				}
+
+				if (queueIndex == (int)IOPriority::Streaming)
+				{
+					state->m_ActiveStreamingWorkers++;
+				}
+			}
+
+			for (AsyncIOJob* job : batch)
+			{
+				for (AsyncIOOperation& operation : job->m_Operations)
+				{
+					operations.push_back(&operation);
+				}
+			}
+			backend->Execute(operations);
+
+			for (AsyncIOJob* job : batch)
+			{
+				if (IsWrite(job))
+				{
+					finishedWrites.push_back(job->m_Operations[0].m_Path.Filepath());
+				}
+
+				if (job->m_OnFinished)
+				{
+					job->m_OnFinished(*job);
+				}
+
+				if (job->m_OnComplete)
+				{
+					std::lock_guard<std::mutex> lock(state->m_CompletionMutex);
+					state->m_Completed.push_back(job);
+				}
+				else
+				{
+					delete job;
+				}
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(state->m_QueueMutex);
+				if (queueIndex == (int)IOPriority::Streaming)
+				{
+					state->m_ActiveStreamingWorkers--;
+					// A streaming slot just opened up
+					state->m_QueueCondition.notify_one();
+				}
+				for (const std::string& path : finishedWrites)
+				{
+					ReleaseWritePath(state, path);
+				}
+				state->m_JobsInFlight -= (int)batch.size();
+				if (state->m_JobsInFlight == 0)
+				{
+					state->m_IdleCondition.notify_all();
+				}
+			}
+
+			batch.clear();
+			operations.clear();
+			finishedWrites.clear();
+		}
+	}
+
+	static void Enqueue(AsyncIOState* state, AsyncIOJob* job)
+	{
+		{
+			std::lock_guard<std::mutex> lock(state->m_QueueMutex);
+			state->m_JobsInFlight++;
+			if (IsWrite(job))
+			{
+				auto iter = state->m_PendingWrites.find(job->m_Operations[0].m_Path.Filepath());
+				if (iter != state->m_PendingWrites.end())
+				{
+					// Runs once the write before it is done, see ReleaseWritePath
+					iter->second.push_back(job);
+					return;
+				}
+				state->m_PendingWrites.emplace(job->m_Operations[0].m_Path.Filepath(), std::deque<AsyncIOJob*>());
+			}
+			state->m_Queues[(int)job->m_Priority].push_back(job);
+		}
+		state->m_QueueCondition.notify_one();
+	}
+
+	static AsyncIOJob* CreateJob(AsyncIOType type, const CPath& filepath, IOPriority priority)
+	{
+		Log::Assert(AsyncIO::IsInitialized(), "AsyncIO never initialized.");
+		AsyncIOJob* job = new AsyncIOJob();
+		job->m_Priority = priority;
+		job->m_Operations.push_back(AsyncIOOperation{ type, filepath });
+		return job;
+	}
+
+	void AsyncIO::Init(int numWorkers)
+	{
+		Log::Assert(s_Instance == nullptr, "AsyncIO already initialized.");
+		s_Instance = new AsyncIOState();
+		numWorkers = std::max(numWorkers, 1);
+		s_Instance->m_MaxStreamingWorkers = std::max(numWorkers - 1, 1);
+		for (int i = 0; i < numWorkers; i++)
+		{
+			s_Instance->m_Workers.emplace_back(WorkerMain, s_Instance);
+		}
+	}
+
+	void AsyncIO::Destroy()
+	{
+		if (s_Instance == nullptr)
+		{
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(s_Instance->m_QueueMutex);
+			s_Instance->m_Stopping = true;
+		}
+		s_Instance->m_QueueCondition.notify_all();
+		for (std::thread& worker : s_Instance->m_Workers)
+		{
+			worker.join();
+		}
+
+		// Pending callbacks still own files that need closing
+		DispatchCompletions();
+		delete s_Instance;
+		s_Instance = nullptr;
+	}
+
+	std::future<File*> AsyncIO::ReadAsync(const CPath& filepath, IOPriority priority)
+	{
+		AsyncIOJob* job = CreateJob(AsyncIOType::Read, filepath, priority);
+		std::shared_ptr<std::promise<File*>> promise = std::make_shared<std::promise<File*>>();
+		job->m_OnFinished = [promise](AsyncIOJob& job) { promise->set_value(job.m_Operations[0].m_File); };
+
+		std::future<File*> result = promise->get_future();
+		Enqueue(s_Instance, job);
+		return result;
+	}
+
+	void AsyncIO::ReadAsync(const CPath& filepath, AsyncReadCallback callback, IOPriority priority)
+	{
+		AsyncIOJob* job = CreateJob(AsyncIOType::Read, filepath, priority);
+		job->m_OnComplete = [callback](AsyncIOJob& job)
+		{
+			File* file = job.m_Operations[0].m_File;
+			callback(file);
+			IFile::CloseFile(file);
+		};
+		Enqueue(s_Instance, job);
+	}
+
+	void AsyncIO::ReadBatchAsync(const std::vector<CPath>& filepaths, AsyncBatchReadCallback callback, IOPriority priority)
+	{
+		Log::Assert(IsInitialized(), "AsyncIO never initialized.");
+		AsyncIOJob* job = new AsyncIOJob();
+		job->m_Priority = priority;
+		job->m_Operations.reserve(filepaths.size());
+		for (const CPath& filepath : filepaths)
+		{
+			job->m_Operations.push_back(AsyncIOOperation{ AsyncIOType::Read, filepath });
+		}
+
+		job->m_OnComplete = [callback](AsyncIOJob& job)
+		{
+			std::vector<File*> files;
+			files.reserve(job.m_Operations.size());
+			for (AsyncIOOperation& operation : job.m_Operations)
+			{
+				files.push_back(operation.m_File);
+			}
+
+			callback(files);
+			for (File* file : files)
+			{
+				IFile::CloseFile(file);
+			}
+		};
+		Enqueue(s_Instance, job);
+	}
+
+	std::future<bool> AsyncIO::WriteAsync(const CPath& filepath, std::string data, IOPriority priority)
+	{
+		AsyncIOJob* job = CreateJob(AsyncIOType::Write, filepath, priority);
+		job->m_Operations[0].m_WriteData = std::move(data);
+		std::shared_ptr<std::promise<bool>> promise = std::make_shared<std::promise<bool>>();
+		job->m_OnFinished = [promise](AsyncIOJob& job) { promise->set_value(job.m_Operations[0].m_Success); };
+
+		std::future<bool> result = promise->get_future();
+		Enqueue(s_Instance, job);
+		return result;
+	}
+
+	void AsyncIO::WriteAsync(const CPath& filepath, std::string data, AsyncWriteCallback callback, IOPriority priority)
+	{
+		AsyncIOJob* job = CreateJob(AsyncIOType::Write, filepath, priority);
+		job->m_Operations[0].m_WriteData = std::move(data);
+		job->m_OnComplete = [callback](AsyncIOJob& job) { callback(job.m_Operations[0].m_Success); };
+		Enqueue(s_Instance, job);
+	}
+
+	void AsyncIO::DispatchCompletions()
+	{
+		if (s_Instance == nullptr)
+		{
+			return;
+		}
+
+		std::vector<AsyncIOJob*> completed;
+		{
+			std::lock_guard<std::mutex> lock(s_Instance->m_CompletionMutex);
+			completed.swap(s_Instance->m_Completed);
+		}
+
+		for (AsyncIOJob* job : completed)
+		{
+			job->m_OnComplete(*job);
+			delete job;
+		}
+	}
+
+	void AsyncIO::WaitIdle()
+	{
+		if (s_Instance == nullptr)
+		{
+			return;
+		}
+
+		std::unique_lock<std::mutex> lock(s_Instance->m_QueueMutex);
+		s_Instance->m_IdleCondition.wait(lock, []() { return s_Instance->m_JobsInFlight == 0; });
+	}
+
+	const char* AsyncIO::GetBackendName()
+	{
+		if (s_Instance == nullptr)
+		{
+			return "None";
+		}
+
+		std::lock_guard<std::mutex> lock(s_Instance->m_QueueMutex);
+		return s_Instance->m_BackendName;
+	}
+}
@@ -6,58 +6,42 @@ namespace Cocoa
 {
 #ifdef _WIN32
 	char CPath::PATH_SEPARATOR = Win32CPath::GetPathSeparator();
+#else
+	char CPath::PATH_SEPARATOR = '/';
 #endif
 
-	CPath::CPath(std::string path, bool forceLinuxStylePath)
+	CPath::CPath(const std::string& path, bool forceLinuxStylePath)
+		: CPath(forceLinuxStylePath)
 	{
-		m_PathSeparator = CPath::PATH_SEPARATOR;
-		if (forceLinuxStylePath)
-		{
-			m_PathSeparator = '/';
-		}
-
 		Init(path.c_str(), (int)path.size());
 	}
 
 	CPath::CPath(const char* path, bool forceLinuxStylePath)
+		: CPath(forceLinuxStylePath)
 	{
-		m_PathSeparator = CPath::PATH_SEPARATOR;
-		if (forceLinuxStylePath)
-		{
-			m_PathSeparator = '/';
-		}
-
-		int pathSize = 0;
-		if (path != nullptr)
-		{
-			for (const char* iter = path; *iter != '\0'; iter++)
-			{
-				pathSize++;
-			}
-		}
-
-		Init(path, pathSize);
+		Init(path, path != nullptr ? (int)strlen(path) : 0);
 	}
 
 	CPath::CPath(const CPath& other)
+		: CPath()
 	{
-		m_PathSeparator = other.m_PathSeparator;
-		m_Filepath = other.m_Filepath;
-		m_FilenameOffset = other.m_FilenameOffset;
-		m_FileExtOffset = other.m_FileExtOffset;
+		CopyFrom(other);
 	}
 
 	void CPath::Init(const char* path, int pathSize)
 	{
+		m_Size = 0;
+		m_Data[0] = '\0';
+		m_Hash = HASH_SEED;
+		m_FileExtOffset = 0;
+		m_FilenameOffset = 0;
 		if (pathSize == 0)
 		{
-			m_Filepath = "";
-			m_FileExtOffset = 0;
-			m_FilenameOffset = 0;
 			return;
 		}
 
-		char* sanitizedPath = new char[pathSize];
+		// Sanitizing only ever shrinks the path, so it can be written straight into our own storage
+		Reserve(pathSize);
 		int lastPathSeparator = -1;
 		int stringIndex = 0;
 		int pathIndex = 0;
@@ -67,11 +51,11 @@ namespace Cocoa
 		for (const char* iter = path; iter != iterEnd; iter++)
 		{
 			char c = *iter;
-			if (c == '.' && stringIndex > 0 && sanitizedPath[stringIndex - 1] != '.')
+			if (c == '.' && stringIndex > 0 && path[stringIndex - 1] != '.')
 			{
 				lastDot = pathIndex;
 			}
-			else if (c == '.' && stringIndex > 0 && sanitizedPath[stringIndex - 1] == '.')
+			else if (c == '.' && stringIndex > 0 && path[stringIndex - 1] == '.')
 			{
 				// We have a double dot ..
 				// If .. is at the end of the path or .. is followed by a path separator '/'
@@ -85,51 +69,112 @@ namespace Cocoa
 				}
 			}
 
-			if (IsSeparator(c) && (stringIndex == 0 || stringIndex == 1 || !IsSeparator(sanitizedPath[stringIndex - 1])))
+			if (IsSeparator(c) && (stringIndex == 0 || stringIndex == 1 || !IsSeparator(path[stringIndex - 1])))
 			{
-				sanitizedPath[pathIndex] = m_PathSeparator;
+				m_Data[pathIndex] = m_PathSeparator;
 				lastPathSeparator = pathIndex;
 				pathIndex++;
 			}
 			else if (!IsSeparator(c))
 			{
-				sanitizedPath[pathIndex] = c;
+				m_Data[pathIndex] = c;
 				pathIndex++;
 			}
 
 			stringIndex++;
 		}
 
-		m_Filepath = std::string(sanitizedPath, pathIndex);
+		m_Data[pathIndex] = '\0';
+		m_Size = pathIndex;
+		m_Hash = HashBytes(HASH_SEED, m_Data, m_Size);
 		m_FilenameOffset = lastPathSeparator >= -1 && lastPathSeparator != pathIndex
 			? lastPathSeparator + 1 : pathIndex;
 		m_FileExtOffset = (lastDot == -1 || lastDot < lastPathSeparator || lastPathSeparator == lastDot - 1)
 			? pathIndex : lastDot;
+	}
 
-		delete[] sanitizedPath;
+	void CPath::Reserve(int capacity)
+	{
+		if (capacity <= m_Capacity)
+		{
+			return;
+		}
+
+		// Grow geometrically so repeated joins onto a long path stay cheap
+		int newCapacity = std::max(capacity, m_Capacity * 2);
+		char* newData = (char*)malloc(newCapacity + 1);
+		memcpy(newData, m_Data, m_Size + 1);
+		if (m_Data != m_Inline)
+		{
+			free(m_Data);
+		}
+
+		m_Data = newData;
+		m_Capacity = newCapacity;
 	}
 
-	CPath::CPath(CPath&& other) noexcept
-		: m_Filepath(std::move(other.m_Filepath))
+	void CPath::Append(const char* data, int size)
+	{
+		Reserve(m_Size + size);
+		memcpy(m_Data + m_Size, data, size);
+		m_Size += size;
+		m_Data[m_Size] = '\0';
+		m_Hash = HashBytes(m_Hash, data, size);
+	}
+
+	void CPath::CopyFrom(const CPath& other)
 	{
 		m_PathSeparator = other.m_PathSeparator;
+		m_Size = 0;
+		Reserve(other.m_Size);
+		memcpy(m_Data, other.m_Data, other.m_Size + 1);
+		m_Size = other.m_Size;
+		m_Hash = other.m_Hash;
 		m_FilenameOffset = other.m_FilenameOffset;
 		m_FileExtOffset = other.m_FileExtOffset;
 	}
 
-	CPath& CPath::operator=(CPath&& other) noexcept
+	void CPath::MoveFrom(CPath& other)
 	{
-		if (this != &other)
+		if (other.m_Data == other.m_Inline)
 		{
-			// Free the existing resource
+			CopyFrom(other);
+			return;
+		}
 
-			// Copy the data pointers from other to here
-			m_PathSeparator = other.m_PathSeparator;
-			m_Filepath = std::move(other.m_Filepath);
-			m_FileExtOffset = other.m_FileExtOffset;
-			m_FilenameOffset = other.m_FilenameOffset;
+		// Steal the heap block and leave other as an empty path
+		if (m_Data != m_Inline)
+		{
+			free(m_Data);
+		}
+		m_PathSeparator = other.m_PathSeparator;
+		m_Data = other.m_Data;
+		m_Size = other.m_Size;
+		m_Capacity = other.m_Capacity;
+		m_Hash = other.m_Hash;
+		m_FilenameOffset = other.m_FilenameOffset;
+		m_FileExtOffset = other.m_FileExtOffset;
+
+		other.m_Data = other.m_Inline;
+		other.m_Data[0] = '\0';
+		other.m_Size = 0;
+		other.m_Capacity = INLINE_CAPACITY - 1;
+		other.m_Hash = HASH_SEED;
+		other.m_FilenameOffset = 0;
+		other.m_FileExtOffset = 0;
+	}
 
-			// Release the data pointers from source, so destructor does not free multiple times
+	CPath::CPath(CPath&& other) noexcept
+		: CPath()
+	{
+		MoveFrom(other);
+	}
+
+	CPath& CPath::operator=(CPath&& other) noexcept
+	{
+		if (this != &other)
+		{
+			MoveFrom(other);
 		}
 
 		return *this;
@@ -139,10 +184,7 @@ namespace Cocoa
 	{
 		if (&other != this)
 		{
-			m_PathSeparator = other.m_PathSeparator;
-			m_Filepath = other.m_Filepath;
-			m_FilenameOffset = other.m_FilenameOffset;
-			m_FileExtOffset = other.m_FileExtOffset;
+			CopyFrom(other);
 		}
 
 		return *this;
@@ -152,10 +194,7 @@ namespace Cocoa
 	{
 		if (&other != this)
 		{
-			m_PathSeparator = other.m_PathSeparator;
-			m_Filepath = other.m_Filepath;
-			m_FilenameOffset = other.m_FilenameOffset;
-			m_FileExtOffset = other.m_FileExtOffset;
+			CopyFrom(other);
 		}
 
 		return *this;
@@ -163,9 +202,13 @@ namespace Cocoa
 
 	CPath::~CPath()
 	{
+		if (m_Data != m_Inline)
+		{
+			free(m_Data);
+		}
 	}
 
-	CPath CPath::operator+(std::string other) const
+	CPath CPath::operator+(const std::string& other) const
 	{
 		CPath copy = CPath(*this);
 		copy.Join(CPath(other));
@@ -191,64 +234,71 @@ namespace Cocoa
 		this->Join(other);
 	}
 
+	bool CPath::Equals(const CPath& other) const
+	{
+		return m_Hash == other.m_Hash && m_Size == other.m_Size && memcmp(m_Data, other.m_Data, m_Size) == 0;
+	}
+
 	bool CPath::operator==(const CPath& other) const
 	{
-		if (m_Filepath.size() == 0 || other.m_Filepath.size() == 0)
+		if (m_Size == 0 || other.m_Size == 0)
 		{
 			return false;
 		}
 
+		// Identical spellings are the same file, only differing ones need resolving
+		if (Equals(other))
+		{
+			return true;
+		}
+
 		CPath tmp1 = IFile::GetAbsolutePath(other);
 		CPath tmp2 = IFile::GetAbsolutePath(*this);
-		return strcmp(tmp1.m_Filepath.c_str(), tmp2.m_Filepath.c_str()) == 0;
+		return tmp1.Equals(tmp2);
 	}
 
 	char CPath::operator[](int index) const
 	{
-		return m_Filepath[index];
+		return m_Data[index];
 	}
 
 	bool CPath::Contains(const char* pathSegment) const
 	{
-		return m_Filepath.find(pathSegment) != std::string::npos;
+		return strstr(m_Data, pathSegment) != nullptr;
 	}
 
 	void CPath::Join(const CPath& other)
 	{
-		int newLength = (int)(other.m_Filepath.size() + m_Filepath.size());
-		bool needSeparator = false;
-		bool takeAwaySeparator = false;
-		if (!IsSeparator(other.m_Filepath[0]) && m_Filepath.size() > 0 && !IsSeparator(m_Filepath[m_Filepath.size() - 1]))
+		if (other.m_Size == 0)
 		{
-			needSeparator = true;
-			newLength++;
+			return;
 		}
-		else if (IsSeparator(other.m_Filepath[0]) && m_Filepath.size() > 0 && IsSeparator(m_Filepath[m_Filepath.size() - 1]))
+		else if (&other == this)
 		{
-			takeAwaySeparator = true;
-			newLength--;
+			// Appending may move our storage out from under other
+			CPath copy = other;
+			Join(copy);
+			return;
 		}
 
-		if (!needSeparator && !takeAwaySeparator)
+		if (!IsSeparator(other.m_Data[0]) && m_Size > 0 && !IsSeparator(m_Data[m_Size - 1]))
 		{
-			// If only one of the paths has a separator at the end or beginning, just str combine
-			// and return
-			this->m_Filepath += other.m_Filepath;
-			return;
+			Reserve(m_Size + 1 + other.m_Size);
+			Append(&m_PathSeparator, 1);
+			Append(other.m_Data, other.m_Size);
 		}
-
-		if (needSeparator)
+		else if (IsSeparator(other.m_Data[0]) && m_Size > 0 && IsSeparator(m_Data[m_Size - 1]))
 		{
-			this->m_Filepath += m_PathSeparator;
-			this->m_Filepath += other.m_Filepath;
+			Append(other.m_Data + 1, other.m_Size - 1);
 		}
-		else if (takeAwaySeparator)
+		else
 		{
-			this->m_Filepath += (other.m_Filepath.c_str() + 1);
+			// If only one of the paths has a separator at the end or beginning, just str combine
+			Append(other.m_Data, other.m_Size);
 		}
 
-		m_FilenameOffset = m_Filepath.size() - (other.m_Filepath.size() - other.m_FilenameOffset);
-		m_FileExtOffset = m_Filepath.size() - (other.m_Filepath.size() - other.m_FileExtOffset);
+		m_FilenameOffset = m_Size - (other.m_Size - other.m_FilenameOffset);
+		m_FileExtOffset = m_Size - (other.m_Size - other.m_FileExtOffset);
 	}
 
 	/*
@@ -264,19 +314,19 @@ namespace Cocoa
 	 */
 	std::string CPath::GetDirectory(int level) const
 	{
-		const char* startCopy = m_Filepath.c_str();
-		const char* endCopy = m_Filepath.c_str();
+		const char* startCopy = m_Data;
+		const char* endCopy = m_Data;
 		if (level < 0)
 		{
 
-			for (int i = (int)(m_Filepath.size() - 1); i >= 0; i--)
+			for (int i = m_Size - 1; i >= 0; i--)
 			{
-				if (IsSeparator(m_Filepath[i]))
+				if (IsSeparator(m_Data[i]))
 				{
 					level++;
 					if (level >= 0)
 					{
-						endCopy = &m_Filepath[i];
+						endCopy = &m_Data[i];
 						break;
 					}
 				}
@@ -284,17 +334,17 @@ namespace Cocoa
 		}
 		else
 		{
-			for (int i = 0; i < m_Filepath.size(); i++)
+			for (int i = 0; i < m_Size; i++)
 			{
-				if (IsSeparator(m_Filepath[i]))
+				if (IsSeparator(m_Data[i]))
 				{
 					level--;
 					if (level < 0)
 					{
-						endCopy = &m_Filepath[i];
-						if (IsFile() && endCopy == &m_Filepath[m_FilenameOffset])
+						endCopy = &m_Data[i];
+						if (IsFile() && endCopy == &m_Data[m_FilenameOffset])
 						{
-							endCopy = m_Filepath.c_str();
+							endCopy = m_Data;
 						}
 						break;
 					}
@@ -317,6 +367,6 @@ namespace Cocoa
 
 	std::string CPath::GetFilenameWithoutExt() const
 	{
-		return m_Filepath.substr(m_FilenameOffset, FilenameSize() - FileExtSize());
+		return std::string(m_Data + m_FilenameOffset, FilenameSize() - FileExtSize());
 	}
 }
\ No newline at end of file
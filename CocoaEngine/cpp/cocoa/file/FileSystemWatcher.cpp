@@ -1,8 +1,34 @@
 #include "cocoa/file/FileSystemWatcher.h"
+#include "cocoa/file/IFile.h"
 #include "cocoa/util/Log.h"
 
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <cerrno>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
 namespace Cocoa
 {
+#ifdef _WIN32
+	// Paths reported by ReadDirectoryChangesW use backslashes, so the paths we build have to as well
+	static const char WATCHER_PATH_SEPARATOR = '\\';
+#else
+	static const char WATCHER_PATH_SEPARATOR = '/';
+#endif
+
+	// A path that never stops changing is still flushed once it has been pending this many debounce windows
+	static const int MAX_DEBOUNCE_WINDOWS = 10;
+
+	static std::string JoinPath(const std::string& directory, const char* name)
+	{
+		return directory.size() == 0 ? std::string(name) : directory + WATCHER_PATH_SEPARATOR + name;
+	}
+
 	FileSystemWatcher::FileSystemWatcher()
 	{
 
@@ -10,9 +36,292 @@ namespace Cocoa
 
 	void FileSystemWatcher::Start()
 	{
+		// Watchers can be stopped and started again on a different path
+		m_EnableRaisingEvents = true;
+		m_PendingEvents.clear();
+		m_Snapshot.clear();
+#ifdef _WIN32
+		hStopEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+#elif defined(__linux__)
+		m_StopFd = eventfd(0, EFD_CLOEXEC);
+#endif
 		m_Thread = std::thread(&FileSystemWatcher::StartThread, this);
 	}
 
+	void FileSystemWatcher::Stop()
+	{
+		if (m_Thread.joinable())
+		{
+			m_EnableRaisingEvents = false;
+#ifdef _WIN32
+			SetEvent(hStopEvent);
+#elif defined(__linux__)
+			uint64 value = 1;
+			ssize_t written;
+			do
+			{
+				written = write(m_StopFd, &value, sizeof(value));
+			} while (written < 0 && errno == EINTR);
+
+			if (written != (ssize_t)sizeof(value))
+			{
+				// The thread only notices m_EnableRaisingEvents once poll returns, join waits for the next event
+				Log::Error("Failed to wake FileSystemWatcher '%s' to stop it", m_Path.Filepath());
+			}
+#endif
+			m_Thread.join();
+		}
+
+#ifdef _WIN32
+		if (hStopEvent != NULL)
+		{
+			CloseHandle(hStopEvent);
+			hStopEvent = NULL;
+		}
+#elif defined(__linux__)
+		if (m_StopFd >= 0)
+		{
+			close(m_StopFd);
+			m_StopFd = -1;
+		}
+#endif
+	}
+
+	// ===================================================================================
+	// Event coalescing, shared by every backend. All of this only runs on the watcher thread
+	// ===================================================================================
+	bool FileSystemWatcher::MatchesFilter(const std::string& path) const
+	{
+		if (m_Filter.size() == 0 || m_Filter == "*" || m_Filter == "*.*")
+		{
+			return true;
+		}
+
+		size_t separator = path.find_last_of("/\\");
+		std::string filename = separator == std::string::npos ? path : path.substr(separator + 1);
+		if (m_Filter[0] == '*')
+		{
+			size_t suffixSize = m_Filter.size() - 1;
+			return filename.size() >= suffixSize && filename.compare(filename.size() - suffixSize, suffixSize, m_Filter, 1, suffixSize) == 0;
+		}
+
+		return filename == m_Filter;
+	}
+
+	void FileSystemWatcher::QueueEvent(FileSystemEventType type, const std::string& path)
+	{
+		if (!MatchesFilter(path))
+		{
+			return;
+		}
+
+		auto now = std::chrono::steady_clock::now();
+		auto iter = m_PendingEvents.find(path);
+		if (iter == m_PendingEvents.end())
+		{
+			m_PendingEvents[path] = PendingEvent{ type, now, now };
+			return;
+		}
+
+		PendingEvent& pending = iter->second;
+		pending.m_LastSeen = now;
+		switch (pending.m_Type)
+		{
+		case FileSystemEventType::Created:
+			// Created and deleted again within the window, nobody needs to hear about it
+			if (type == FileSystemEventType::Deleted)
+			{
+				m_PendingEvents.erase(iter);
+			}
+			break;
+		case FileSystemEventType::Deleted:
+			// Editors commonly save by deleting and recreating, or by renaming a temp file over the original
+			pending.m_Type = type == FileSystemEventType::Deleted ? FileSystemEventType::Deleted : FileSystemEventType::Changed;
+			break;
+		case FileSystemEventType::Changed:
+		case FileSystemEventType::Renamed:
+			if (type == FileSystemEventType::Deleted || type == FileSystemEventType::Renamed)
+			{
+				pending.m_Type = type;
+			}
+			break;
+		}
+	}
+
+	void FileSystemWatcher::FlushEvents(bool force)
+	{
+		if (m_PendingEvents.size() == 0)
+		{
+			return;
+		}
+
+		auto now = std::chrono::steady_clock::now();
+		auto window = std::chrono::milliseconds(m_DebounceMilliseconds);
+		std::vector<std::pair<std::string, FileSystemEventType>> readyEvents;
+		for (auto iter = m_PendingEvents.begin(); iter != m_PendingEvents.end();)
+		{
+			const PendingEvent& pending = iter->second;
+			if (force || now - pending.m_LastSeen >= window || now - pending.m_FirstSeen >= window * MAX_DEBOUNCE_WINDOWS)
+			{
+				readyEvents.emplace_back(iter->first, pending.m_Type);
+				iter = m_PendingEvents.erase(iter);
+			}
+			else
+			{
+				iter++;
+			}
+		}
+
+		if (readyEvents.size() == 0)
+		{
+			return;
+		}
+
+		std::sort(readyEvents.begin(), readyEvents.end());
+		std::vector<FileSystemEvent> events;
+		events.reserve(readyEvents.size());
+		for (const auto& readyEvent : readyEvents)
+		{
+			FileSnapshot snapshot;
+			if (SnapshotFile(readyEvent.first, snapshot))
+			{
+				m_Snapshot[readyEvent.first] = snapshot;
+			}
+			else
+			{
+				m_Snapshot.erase(readyEvent.first);
+			}
+
+			events.push_back(FileSystemEvent{ readyEvent.second, CPath(readyEvent.first) });
+		}
+
+		DeliverEvents(events);
+	}
+
+	int FileSystemWatcher::GetFlushTimeout() const
+	{
+		if (m_PendingEvents.size() == 0)
+		{
+			return -1;
+		}
+
+		auto now = std::chrono::steady_clock::now();
+		auto window = std::chrono::milliseconds(m_DebounceMilliseconds);
+		auto nextFlush = std::chrono::steady_clock::time_point::max();
+		for (const auto& pending : m_PendingEvents)
+		{
+			nextFlush = std::min(nextFlush, std::min(pending.second.m_LastSeen + window, pending.second.m_FirstSeen + window * MAX_DEBOUNCE_WINDOWS));
+		}
+
+		// Round up, waking up a millisecond early would just mean waiting again
+		auto timeout = std::chrono::ceil<std::chrono::milliseconds>(nextFlush - now).count();
+		return (int)std::max<int64>(timeout, 0);
+	}
+
+	void FileSystemWatcher::DeliverEvents(const std::vector<FileSystemEvent>& events)
+	{
+		if (m_OnBatch != nullptr)
+		{
+			m_OnBatch(events);
+			return;
+		}
+
+		for (const FileSystemEvent& event : events)
+		{
+			switch (event.m_Type)
+			{
+			case FileSystemEventType::Created:
+				if (m_OnCreated != nullptr)
+				{
+					m_OnCreated(event.m_Path);
+				}
+				break;
+			case FileSystemEventType::Changed:
+				if (m_OnChanged != nullptr)
+				{
+					m_OnChanged(event.m_Path);
+				}
+				break;
+			case FileSystemEventType::Deleted:
+				if (m_OnDeleted != nullptr)
+				{
+					m_OnDeleted(event.m_Path);
+				}
+				break;
+			case FileSystemEventType::Renamed:
+				if (m_OnRenamed != nullptr)
+				{
+					m_OnRenamed(event.m_Path);
+				}
+				break;
+			}
+		}
+	}
+
+	void FileSystemWatcher::SnapshotDirectory(const std::string& relativeDirectory, std::unordered_map<std::string, FileSnapshot>& snapshot) const
+	{
+		CPath directory = relativeDirectory.size() == 0 ? m_Path : m_Path + CPath(relativeDirectory);
+		for (const CPath& file : IFile::GetFilesInDir(directory))
+		{
+			std::string path = JoinPath(relativeDirectory, file.Filename());
+			FileSnapshot fileSnapshot;
+			if (MatchesFilter(path) && SnapshotFile(path, fileSnapshot))
+			{
+				snapshot[path] = fileSnapshot;
+			}
+		}
+
+		if (m_IncludeSubdirectories)
+		{
+			for (const CPath& folder : IFile::GetFoldersInDir(directory))
+			{
+				SnapshotDirectory(JoinPath(relativeDirectory, folder.Filepath()), snapshot);
+			}
+		}
+	}
+
+	bool FileSystemWatcher::SnapshotFile(const std::string& path, FileSnapshot& outSnapshot) const
+	{
+		struct stat fileStat;
+		CPath fullPath = m_Path + CPath(path);
+		if (stat(fullPath.Filepath(), &fileStat) != 0 || (fileStat.st_mode & S_IFMT) != S_IFREG)
+		{
+			return false;
+		}
+
+		outSnapshot.m_ModifiedTime = (int64)fileStat.st_mtime;
+		outSnapshot.m_Size = (uint64)fileStat.st_size;
+		return true;
+	}
+
+	void FileSystemWatcher::Rescan()
+	{
+		Log::Warning("FileSystemWatcher '%s' dropped events, rescanning the directory.", m_Path.Filepath());
+
+		std::unordered_map<std::string, FileSnapshot> current;
+		SnapshotDirectory("", current);
+		for (const auto& file : m_Snapshot)
+		{
+			if (current.find(file.first) == current.end())
+			{
+				QueueEvent(FileSystemEventType::Deleted, file.first);
+			}
+		}
+
+		for (const auto& file : current)
+		{
+			auto previous = m_Snapshot.find(file.first);
+			if (previous == m_Snapshot.end())
+			{
+				QueueEvent(FileSystemEventType::Created, file.first);
+			}
+			else if (previous->second.m_ModifiedTime != file.second.m_ModifiedTime || previous->second.m_Size != file.second.m_Size)
+			{
+				QueueEvent(FileSystemEventType::Changed, file.first);
+			}
+		}
+	}
+
 #ifdef _WIN32
 	void FileSystemWatcher::StartThread()
 	{
@@ -31,149 +340,357 @@ namespace Cocoa
 			return;
 		}
 
-		// Set up notification flags 
+		// Set up notification flags
 		int flags = 0;
-		if (m_NotifyFilters && NotifyFilters::FileName)
+		if (m_NotifyFilters & NotifyFilters::FileName)
 		{
 			flags |= FILE_NOTIFY_CHANGE_FILE_NAME;
 		}
 
-		if (m_NotifyFilters && NotifyFilters::DirectoryName)
+		if (m_NotifyFilters & NotifyFilters::DirectoryName)
 		{
 			flags |= FILE_NOTIFY_CHANGE_DIR_NAME;
 		}
 
-		if (m_NotifyFilters && NotifyFilters::Attributes)
+		if (m_NotifyFilters & NotifyFilters::Attributes)
 		{
 			flags |= FILE_NOTIFY_CHANGE_ATTRIBUTES;
 		}
 
-		if (m_NotifyFilters && NotifyFilters::Size)
+		if (m_NotifyFilters & NotifyFilters::Size)
 		{
 			flags |= FILE_NOTIFY_CHANGE_SIZE;
 		}
 
-		if (m_NotifyFilters && NotifyFilters::LastWrite)
+		if (m_NotifyFilters & NotifyFilters::LastWrite)
 		{
 			flags |= FILE_NOTIFY_CHANGE_LAST_WRITE;
 		}
 
-		if (m_NotifyFilters && NotifyFilters::LastAccess)
+		if (m_NotifyFilters & NotifyFilters::LastAccess)
 		{
 			flags |= FILE_NOTIFY_CHANGE_LAST_ACCESS;
 		}
 
-		if (m_NotifyFilters && NotifyFilters::CreationTime)
+		if (m_NotifyFilters & NotifyFilters::CreationTime)
 		{
 			flags |= FILE_NOTIFY_CHANGE_CREATION;
 		}
 
-		if (m_NotifyFilters && NotifyFilters::Security)
+		if (m_NotifyFilters & NotifyFilters::Security)
 		{
 			flags |= FILE_NOTIFY_CHANGE_SECURITY;
 		}
 
 		char filename[MAX_PATH];
-		char buffer[2048];
+		// Has to be DWORD aligned. 64KB is the most ReadDirectoryChangesW will fill for network shares
+		DWORD buffer[16 * 1024];
 		DWORD bytesReturned;
 		FILE_NOTIFY_INFORMATION* pNotify;
 		int offset = 0;
-		OVERLAPPED pollingOverlap;
-		pollingOverlap.OffsetHigh = 0;
+		OVERLAPPED pollingOverlap = {};
 		pollingOverlap.hEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
 		if (pollingOverlap.hEvent == NULL)
 		{
 			Log::Error("Could not create event watcher for FileSystemWatcher '%s'", m_Path.Filepath());
+			CloseHandle(dirHandle);
 			return;
 		}
 
-		bool result = true;
 		HANDLE hEvents[2];
 		hEvents[0] = pollingOverlap.hEvent;
-		hEvents[1] = CreateEventA(NULL, TRUE, FALSE, NULL);
-		hStopEvent = hEvents[1];
+		hEvents[1] = hStopEvent;
+
+		SnapshotDirectory("", m_Snapshot);
+		bool result = ReadDirectoryChangesW(
+			dirHandle,                   // handle to the directory to be watched
+			&buffer,                     // pointer to the buffer to receive the read results
+			sizeof(buffer),              // length of lpBuffer
+			m_IncludeSubdirectories,     // flag for monitoring directory or directory tree
+			flags,
+			&bytesReturned,              // number of bytes returned
+			&pollingOverlap,             // pointer to structure needed for overlapped I/O
+			NULL
+		);
 
 		while (result && m_EnableRaisingEvents)
 		{
-			result = ReadDirectoryChangesW(
-				dirHandle,                   // handle to the directory to be watched
-				&buffer,                     // pointer to the buffer to receive the read results
-				sizeof(buffer),              // length of lpBuffer
-				m_IncludeSubdirectories,     // flag for monitoring directory or directory tree
-				flags,
-				&bytesReturned,              // number of bytes returned
-				&pollingOverlap,             // pointer to structure needed for overlapped I/O
-				NULL
-			);
-
-			DWORD event = WaitForMultipleObjects(2, hEvents, FALSE, INFINITE);
-			offset = 0;
-			int rename = 0;
-			char oldName[MAX_PATH];
-			char newName[MAX_PATH];
-
-			if (event == WAIT_OBJECT_0 + 1)
+			// Wake up when the next coalesced event is due even if nothing new has arrived
+			int timeout = GetFlushTimeout();
+			DWORD event = WaitForMultipleObjects(2, hEvents, FALSE, timeout < 0 ? INFINITE : (DWORD)timeout);
+			if (event == WAIT_TIMEOUT)
+			{
+				FlushEvents(false);
+				continue;
+			}
+
+			if (event != WAIT_OBJECT_0)
 			{
 				break;
 			}
 
-			do
+			if (!GetOverlappedResult(dirHandle, &pollingOverlap, &bytesReturned, FALSE) || bytesReturned == 0)
+			{
+				// The notification buffer overflowed and everything in it was dropped
+				Rescan();
+			}
+			else
 			{
-				pNotify = (FILE_NOTIFY_INFORMATION*)((char*)buffer + offset);
-				strcpy(filename, "");
-				int filenamelen = WideCharToMultiByte(CP_ACP, 0, pNotify->FileName, pNotify->FileNameLength / 2, filename, sizeof(filename), NULL, NULL);
-				filename[pNotify->FileNameLength / 2] = '\0';
-				switch (pNotify->Action)
+				offset = 0;
+				do
 				{
-				case FILE_ACTION_ADDED:
-					if (m_OnCreated != nullptr)
+					pNotify = (FILE_NOTIFY_INFORMATION*)((char*)buffer + offset);
+					int filenamelen = WideCharToMultiByte(CP_ACP, 0, pNotify->FileName, pNotify->FileNameLength / 2, filename, sizeof(filename) - 1, NULL, NULL);
+					filename[filenamelen] = '\0';
+					switch (pNotify->Action)
 					{
-						m_OnCreated(CPath(filename));
+					case FILE_ACTION_ADDED:
+						QueueEvent(FileSystemEventType::Created, filename);
+						break;
+					case FILE_ACTION_REMOVED:
+					case FILE_ACTION_RENAMED_OLD_NAME:
+						QueueEvent(FileSystemEventType::Deleted, filename);
+						break;
+					case FILE_ACTION_MODIFIED:
+						QueueEvent(FileSystemEventType::Changed, filename);
+						break;
+					case FILE_ACTION_RENAMED_NEW_NAME:
+						QueueEvent(FileSystemEventType::Renamed, filename);
+						break;
+					default:
+						Log::Error("Default error. Unknown file action '%d' for FileSystemWatcher '%s'", pNotify->Action, m_Path.Filepath());
+						break;
 					}
-					break;
-				case FILE_ACTION_REMOVED:
-					if (m_OnDeleted != nullptr)
+
+					offset += pNotify->NextEntryOffset;
+				} while (pNotify->NextEntryOffset);
+			}
+
+			FlushEvents(false);
+			ResetEvent(pollingOverlap.hEvent);
+			result = ReadDirectoryChangesW(dirHandle, &buffer, sizeof(buffer), m_IncludeSubdirectories, flags, &bytesReturned, &pollingOverlap, NULL);
+		}
+
+		// Anything still being debounced is delivered before Stop returns
+		FlushEvents(true);
+		CancelIo(dirHandle);
+		CloseHandle(pollingOverlap.hEvent);
+		CloseHandle(dirHandle);
+	}
+#elif defined(__linux__)
+	static uint32 GetInotifyMask(int notifyFilters, bool includeSubdirectories)
+	{
+		uint32 mask = IN_ONLYDIR;
+		if (notifyFilters & (NotifyFilters::FileName | NotifyFilters::DirectoryName))
+		{
+			mask |= IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+		}
+
+		if (includeSubdirectories)
+		{
+			// Needed to keep the watches in sync with the tree, whether or not anyone wants the events
+			mask |= IN_CREATE | IN_MOVED_FROM | IN_MOVED_TO;
+		}
+
+		if (notifyFilters & (NotifyFilters::Attributes | NotifyFilters::Security | NotifyFilters::CreationTime))
+		{
+			mask |= IN_ATTRIB;
+		}
+
+		if (notifyFilters & (NotifyFilters::Size | NotifyFilters::LastWrite))
+		{
+			mask |= IN_MODIFY | IN_CLOSE_WRITE;
+		}
+
+		// LastAccess is deliberately not mapped to IN_ACCESS. Every read of a watched file would raise an
+		// event, including the reads made by whatever is handling the callbacks
+		return mask;
+	}
+
+	void FileSystemWatcher::AddWatchRecursive(const std::string& relativeDirectory, bool queueExistingFiles)
+	{
+		CPath directory = relativeDirectory.size() == 0 ? m_Path : m_Path + CPath(relativeDirectory);
+		int watchDescriptor = inotify_add_watch(m_InotifyFd, directory.Filepath(), GetInotifyMask(m_NotifyFilters, m_IncludeSubdirectories));
+		if (watchDescriptor < 0)
+		{
+			Log::Warning("FileSystemWatcher could not watch directory '%s'", directory.Filepath());
+			return;
+		}
+		m_WatchDirectories[watchDescriptor] = relativeDirectory;
+
+		// Anything created in a new directory before its watch existed would otherwise be missed
+		if (queueExistingFiles && (m_NotifyFilters & NotifyFilters::FileName))
+		{
+			for (const CPath& file : IFile::GetFilesInDir(directory))
+			{
+				QueueEvent(FileSystemEventType::Created, JoinPath(relativeDirectory, file.Filename()));
+			}
+		}
+
+		if (m_IncludeSubdirectories)
+		{
+			for (const CPath& folder : IFile::GetFoldersInDir(directory))
+			{
+				AddWatchRecursive(JoinPath(relativeDirectory, folder.Filepath()), queueExistingFiles);
+			}
+		}
+	}
+
+	void FileSystemWatcher::RemoveWatchesUnder(const std::string& relativeDirectory)
+	{
+		std::string prefix = relativeDirectory + WATCHER_PATH_SEPARATOR;
+		for (auto iter = m_WatchDirectories.begin(); iter != m_WatchDirectories.end();)
+		{
+			if (relativeDirectory.size() == 0 || iter->second == relativeDirectory || iter->second.compare(0, prefix.size(), prefix) == 0)
+			{
+				inotify_rm_watch(m_InotifyFd, iter->first);
+				iter = m_WatchDirectories.erase(iter);
+			}
+			else
+			{
+				iter++;
+			}
+		}
+	}
+
+	void FileSystemWatcher::StartThread()
+	{
+		if (m_Path.Size() == 0)
+		{
+			return;
+		}
+
+		m_InotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (m_InotifyFd < 0)
+		{
+			Log::Error("Could not create inotify instance for FileSystemWatcher '%s'", m_Path.Filepath());
+			return;
+		}
+
+		AddWatchRecursive("", false);
+		if (m_WatchDirectories.size() == 0)
+		{
+			Log::Error("Invalid file access. Could not create FileSystemWatcher for '%s'", m_Path.Filepath());
+			close(m_InotifyFd);
+			m_InotifyFd = -1;
+			return;
+		}
+		SnapshotDirectory("", m_Snapshot);
+
+		alignas(inotify_event) char buffer[64 * 1024];
+		pollfd fds[2] = { { m_InotifyFd, POLLIN, 0 }, { m_StopFd, POLLIN, 0 } };
+		while (m_EnableRaisingEvents)
+		{
+			// Wake up when the next coalesced event is due even if nothing new has arrived
+			int result = poll(fds, 2, GetFlushTimeout());
+			if (result < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+
+				Log::Error("Polling failed for FileSystemWatcher '%s'", m_Path.Filepath());
+				break;
+			}
+
+			if (fds[1].revents & POLLIN)
+			{
+				break;
+			}
+
+			bool overflowed = false;
+			ssize_t length;
+			while ((length = read(m_InotifyFd, buffer, sizeof(buffer))) > 0)
+			{
+				const inotify_event* event = nullptr;
+				for (char* ptr = buffer; ptr < buffer + length; ptr += sizeof(inotify_event) + event->len)
+				{
+					event = (const inotify_event*)ptr;
+					if (event->mask & IN_Q_OVERFLOW)
 					{
-						m_OnDeleted(CPath(filename));
+						overflowed = true;
+						continue;
 					}
-					break;
-				case FILE_ACTION_MODIFIED:
-					if (m_OnChanged != nullptr)
+
+					auto watchDirectory = m_WatchDirectories.find(event->wd);
+					if (watchDirectory == m_WatchDirectories.end())
 					{
-						m_OnChanged(CPath(filename));
+						continue;
 					}
-					break;
-				case FILE_ACTION_RENAMED_OLD_NAME:
-					// Log::Info("The file was renamed and this is the old name: [%s]", filename);
-					break;
-				case FILE_ACTION_RENAMED_NEW_NAME:
-					if (m_OnRenamed != nullptr)
+
+					if (event->mask & IN_IGNORED)
 					{
-						m_OnRenamed(CPath(filename));
+						m_WatchDirectories.erase(watchDirectory);
+						continue;
 					}
-					break;
-				default:
-					Log::Error("Default error. Unknown file action '%d' for FileSystemWatcher '%s'", pNotify->Action, m_Path.Filepath());
-					break;
-				}
 
-				offset += pNotify->NextEntryOffset;
-			} while (pNotify->NextEntryOffset);
+					// Events about the watched directory itself carry no name
+					if (event->len == 0)
+					{
+						continue;
+					}
 
+					std::string path = JoinPath(watchDirectory->second, event->name);
+					bool isDirectory = (event->mask & IN_ISDIR) != 0;
+					bool isNameChange = (event->mask & (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO)) != 0;
+					if (isDirectory && m_IncludeSubdirectories)
+					{
+						if (event->mask & (IN_CREATE | IN_MOVED_TO))
+						{
+							AddWatchRecursive(path, true);
+						}
+						else if (event->mask & IN_MOVED_FROM)
+						{
+							RemoveWatchesUnder(path);
+						}
+					}
 
+					// Subdirectory watches force name events on, only pass along the ones that were asked for
+					if ((isDirectory && !(m_NotifyFilters & NotifyFilters::DirectoryName)) ||
+						(!isDirectory && isNameChange && !(m_NotifyFilters & NotifyFilters::FileName)))
+					{
+						continue;
+					}
+
+					FileSystemEventType type = FileSystemEventType::Changed;
+					if (event->mask & IN_CREATE)
+					{
+						type = FileSystemEventType::Created;
+					}
+					else if (event->mask & IN_MOVED_TO)
+					{
+						type = FileSystemEventType::Renamed;
+					}
+					else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+					{
+						type = FileSystemEventType::Deleted;
+					}
+					QueueEvent(type, path);
+				}
+			}
+
+			if (overflowed)
+			{
+				// Directories created while events were being dropped have no watch yet
+				RemoveWatchesUnder("");
+				AddWatchRecursive("", false);
+				Rescan();
+			}
+
+			FlushEvents(false);
 		}
 
-		CloseHandle(dirHandle);
+		// Anything still being debounced is delivered before Stop returns
+		FlushEvents(true);
+		close(m_InotifyFd);
+		m_InotifyFd = -1;
+		m_WatchDirectories.clear();
 	}
-
-	void FileSystemWatcher::Stop()
+#else
+	void FileSystemWatcher::StartThread()
 	{
-		if (m_EnableRaisingEvents)
-		{
-			m_EnableRaisingEvents = false;
-			SetEvent(hStopEvent);
-			m_Thread.join();
-		}
+		Log::Warning("FileSystemWatcher is not supported on this platform. Not watching '%s'", m_Path.Filepath());
 	}
 #endif
-}
\ No newline at end of file
+}
@@ -1,15 +1,23 @@
 #include "cocoa/file/IFile.h"
+#include "cocoa/file/PackArchive.h"
 #include "cocoa/util/Log.h"
 
 namespace Cocoa
 {
 	IFile* IFile::s_Instance = nullptr;
+	std::vector<IFile::MountedArchive> IFile::s_Mounts = std::vector<IFile::MountedArchive>();
+
+	IFile::~IFile()
+	{
+	}
 
 	void IFile::Init()
 	{
 		Log::Assert(s_Instance == nullptr, "IFile already initialized.");
 #ifdef _WIN32
 		s_Instance = Win32File::Create();
+#else
+		s_Instance = PosixFile::Create();
 #endif
 	}
 
@@ -21,7 +29,81 @@ namespace Cocoa
 
 	void IFile::Destroy()
 	{
+		UnmountAll();
 		delete s_Instance;
 		s_Instance = nullptr;
 	}
-}
\ No newline at end of file
+
+	File* IFile::OpenFile(const CPath& filename)
+	{
+		std::string_view mountedData;
+		if (GetMountedFile(filename, mountedData))
+		{
+			// The view points straight into the archive, which outlives any file opened from it
+			File* file = new File();
+			file->m_Filename = filename.Filepath();
+			file->m_Data = mountedData;
+			file->m_Size = (uint32)mountedData.size();
+			file->m_Open = true;
+			return file;
+		}
+
+		return Get()->ImplOpenFile(filename);
+	}
+
+	bool IFile::IsFile(const CPath& filepath)
+	{
+		std::string_view mountedData;
+		if (GetMountedFile(filepath, mountedData))
+		{
+			return true;
+		}
+
+		return Get()->ImplIsFile(filepath);
+	}
+
+	void IFile::Mount(PackArchive* archive, const CPath& mountPoint)
+	{
+		Log::Assert(archive != nullptr && archive->IsOpen(), "Cannot mount an archive that is not open.");
+
+		std::string normalizedMountPoint = PackArchive::NormalizePath(GetAbsolutePath(mountPoint).Filepath());
+		if (normalizedMountPoint.size() > 0 && normalizedMountPoint.back() != '/')
+		{
+			normalizedMountPoint += '/';
+		}
+
+		// Archives mounted later take priority over earlier ones
+		s_Mounts.insert(s_Mounts.begin(), MountedArchive{ normalizedMountPoint, archive });
+	}
+
+	void IFile::Unmount(PackArchive* archive)
+	{
+		s_Mounts.erase(std::remove_if(s_Mounts.begin(), s_Mounts.end(),
+			[archive](const MountedArchive& mount) { return mount.m_Archive == archive; }), s_Mounts.end());
+	}
+
+	void IFile::UnmountAll()
+	{
+		s_Mounts.clear();
+	}
+
+	bool IFile::GetMountedFile(const CPath& filepath, std::string_view& outData)
+	{
+		if (s_Mounts.size() == 0)
+		{
+			return false;
+		}
+
+		std::string normalizedPath = PackArchive::NormalizePath(GetAbsolutePath(filepath).Filepath());
+		for (const auto& mount : s_Mounts)
+		{
+			if (normalizedPath.compare(0, mount.m_MountPoint.size(), mount.m_MountPoint) == 0 &&
+				mount.m_Archive->Read(normalizedPath.substr(mount.m_MountPoint.size()), outData))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
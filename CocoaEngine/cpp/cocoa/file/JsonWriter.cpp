@@ -0,0 +1,221 @@
+#include "cocoa/file/JsonWriter.h"
+#include "cocoa/util/Log.h"
+
+#include <charconv>
+#include <cmath>
+
+namespace Cocoa
+{
+	static const int INDENT_SIZE = 4;
+
+	JsonWriter::JsonWriter(std::string& output, bool pretty)
+		: m_Output(output), m_Pretty(pretty), m_AfterKey(false)
+	{
+	}
+
+	void JsonWriter::BeginObject()
+	{
+		BeginScope('{');
+	}
+
+	void JsonWriter::EndObject()
+	{
+		EndScope('}');
+	}
+
+	void JsonWriter::BeginArray()
+	{
+		BeginScope('[');
+	}
+
+	void JsonWriter::EndArray()
+	{
+		EndScope(']');
+	}
+
+	void JsonWriter::Key(std::string_view key)
+	{
+		Log::Assert(m_Empty.size() > 0 && !m_AfterKey, "JsonWriter: key written outside of an object.");
+		if (!m_Empty.back())
+		{
+			m_Output.push_back(',');
+		}
+		m_Empty.back() = false;
+		NewLine();
+
+		WriteString(key);
+		m_Output.append(m_Pretty ? ": " : ":");
+		m_AfterKey = true;
+	}
+
+	void JsonWriter::Null()
+	{
+		BeginValue();
+		m_Output.append("null");
+	}
+
+	void JsonWriter::Bool(bool value)
+	{
+		BeginValue();
+		m_Output.append(value ? "true" : "false");
+	}
+
+	void JsonWriter::Int(int64 value)
+	{
+		BeginValue();
+		char buffer[24];
+		char* end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+		m_Output.append(buffer, end - buffer);
+	}
+
+	void JsonWriter::UInt(uint64 value)
+	{
+		BeginValue();
+		char buffer[24];
+		char* end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+		m_Output.append(buffer, end - buffer);
+	}
+
+	void JsonWriter::Float(double value)
+	{
+		BeginValue();
+		if (!std::isfinite(value))
+		{
+			m_Output.append("null");
+			return;
+		}
+
+		// Same shortest round trip formatting json::dump uses, so floats come out identical
+		char buffer[64];
+		char* end = nlohmann::detail::to_chars(buffer, buffer + sizeof(buffer), value);
+		m_Output.append(buffer, end - buffer);
+	}
+
+	void JsonWriter::String(std::string_view value)
+	{
+		BeginValue();
+		WriteString(value);
+	}
+
+	void JsonWriter::Value(const json& value)
+	{
+		switch (value.type())
+		{
+		case json::value_t::object:
+			BeginObject();
+			for (auto it = value.begin(); it != value.end(); it++)
+			{
+				Key(it.key());
+				Value(it.value());
+			}
+			EndObject();
+			break;
+		case json::value_t::array:
+			BeginArray();
+			for (const json& element : value)
+			{
+				Value(element);
+			}
+			EndArray();
+			break;
+		case json::value_t::string:
+			String(value.get_ref<const std::string&>());
+			break;
+		case json::value_t::boolean:
+			Bool(value.get<bool>());
+			break;
+		case json::value_t::number_integer:
+			Int(value.get<int64>());
+			break;
+		case json::value_t::number_unsigned:
+			UInt(value.get<uint64>());
+			break;
+		case json::value_t::number_float:
+			Float(value.get<double>());
+			break;
+		default:
+			Null();
+			break;
+		}
+	}
+
+	void JsonWriter::BeginValue()
+	{
+		if (m_AfterKey)
+		{
+			m_AfterKey = false;
+			return;
+		}
+
+		if (m_Empty.size() > 0)
+		{
+			if (!m_Empty.back())
+			{
+				m_Output.push_back(',');
+			}
+			m_Empty.back() = false;
+			NewLine();
+		}
+	}
+
+	void JsonWriter::BeginScope(char open)
+	{
+		BeginValue();
+		m_Output.push_back(open);
+		m_Empty.push_back(true);
+	}
+
+	void JsonWriter::EndScope(char close)
+	{
+		Log::Assert(m_Empty.size() > 0 && !m_AfterKey, "JsonWriter: unbalanced end of object or array.");
+		bool empty = m_Empty.back();
+		m_Empty.pop_back();
+		if (!empty)
+		{
+			NewLine();
+		}
+		m_Output.push_back(close);
+	}
+
+	void JsonWriter::NewLine()
+	{
+		if (m_Pretty)
+		{
+			m_Output.push_back('\n');
+			m_Output.append(m_Empty.size() * INDENT_SIZE, ' ');
+		}
+	}
+
+	void JsonWriter::WriteString(std::string_view str)
+	{
+		static const char* hexDigits = "0123456789abcdef";
+
+		m_Output.push_back('"');
+		for (char c : str)
+		{
+			switch (c)
+			{
+			case '"':  m_Output.append("\\\""); break;
+			case '\\': m_Output.append("\\\\"); break;
+			case '\b': m_Output.append("\\b"); break;
+			case '\f': m_Output.append("\\f"); break;
+			case '\n': m_Output.append("\\n"); break;
+			case '\r': m_Output.append("\\r"); break;
+			case '\t': m_Output.append("\\t"); break;
+			default:
+				if ((uint8)c < 0x20)
+				{
+					m_Output.append("\\u00");
+					m_Output.push_back(hexDigits[(uint8)c >> 4]);
+					m_Output.push_back(hexDigits[(uint8)c & 0xF]);
+				}
+				else
+				{
+					m_Output.push_back(c);
+				}
+				break;
+			}
+		}
+		m_Output.push_back('"');
+	}
+}
@@ -0,0 +1,331 @@
+#include "cocoa/file/PackArchive.h"
+#include "cocoa/util/Compression.h"
+#include "cocoa/util/Log.h"
+
+namespace Cocoa
+{
+	// ===================================================================================
+	// Pack Archive (reader)
+	// ===================================================================================
+	PackArchive::~PackArchive()
+	{
+		Close();
+	}
+
+	bool PackArchive::Open(const CPath& archivePath)
+	{
+		Close();
+
+		m_File = IFile::MapFile(archivePath);
+		if (!m_File->m_Open || m_File->m_Size < sizeof(PackHeader))
+		{
+			Log::Warning("Could not open pack archive '%s'.", archivePath.Filepath());
+			Close();
+			return false;
+		}
+
+		const PackHeader* header = (const PackHeader*)m_File->m_Data;
+		uint64 tocSize = (uint64)header->m_EntryCount * sizeof(PackEntry);
+		if (header->m_Magic != MAGIC || header->m_Version != VERSION)
+		{
+			Log::Warning("'%s' is not a version %d pack archive.", archivePath.Filepath(), VERSION);
+			Close();
+			return false;
+		}
+
+		if (header->m_TocOffset + tocSize > m_File->m_Size || header->m_TocOffset % alignof(PackEntry) != 0 ||
+			header->m_StringTableOffset + header->m_StringTableSize > m_File->m_Size)
+		{
+			Log::Warning("Pack archive '%s' is truncated or corrupt.", archivePath.Filepath());
+			Close();
+			return false;
+		}
+
+		m_Header = header;
+		m_Toc = (const PackEntry*)(m_File->m_Data + header->m_TocOffset);
+		m_StringTable = (const char*)(m_File->m_Data + header->m_StringTableOffset);
+		return true;
+	}
+
+	void PackArchive::Close()
+	{
+		IFile::Unmount(this);
+		if (m_File != nullptr)
+		{
+			IFile::UnmapFile(m_File);
+			m_File = nullptr;
+		}
+
+		m_Header = nullptr;
+		m_Toc = nullptr;
+		m_StringTable = nullptr;
+
+		std::lock_guard<std::mutex> lock(m_DecompressedMutex);
+		m_DecompressedEntries.clear();
+	}
+
+	const PackEntry* PackArchive::FindEntry(const std::string& path) const
+	{
+		if (!IsOpen())
+		{
+			return nullptr;
+		}
+
+		std::string normalizedPath = NormalizePath(path);
+		uint64 hash = HashPath(normalizedPath);
+
+		const PackEntry* begin = m_Toc;
+		const PackEntry* end = m_Toc + m_Header->m_EntryCount;
+		const PackEntry* entry = std::lower_bound(begin, end, hash,
+			[](const PackEntry& entry, uint64 hash) { return entry.m_PathHash < hash; });
+
+		// Walk every entry with this hash in case two paths collide
+		for (; entry != end && entry->m_PathHash == hash; entry++)
+		{
+			if (entry->m_PathOffset + (uint64)entry->m_PathLength <= m_Header->m_StringTableSize &&
+				normalizedPath.compare(0, std::string::npos, m_StringTable + entry->m_PathOffset, entry->m_PathLength) == 0)
+			{
+				return entry;
+			}
+		}
+
+		return nullptr;
+	}
+
+	std::string PackArchive::GetEntryPath(const PackEntry& entry) const
+	{
+		return std::string(m_StringTable + entry.m_PathOffset, entry.m_PathLength);
+	}
+
+	bool PackArchive::Read(const std::string& path, std::string_view& outData)
+	{
+		return Read(FindEntry(path), outData);
+	}
+
+	bool PackArchive::Read(const PackEntry* entry, std::string_view& outData)
+	{
+		if (entry == nullptr || entry->m_Offset + entry->m_Size > m_File->m_Size)
+		{
+			return false;
+		}
+
+		const uint8* data = m_File->m_Data + entry->m_Offset;
+		if (entry->m_Compression == PackCompression::None)
+		{
+			outData = std::string_view((const char*)data, (size_t)entry->m_Size);
+			return true;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_DecompressedMutex);
+			auto iter = m_DecompressedEntries.find(entry->m_Offset);
+			if (iter != m_DecompressedEntries.end())
+			{
+				outData = std::string_view(iter->second);
+				return true;
+			}
+		}
+
+		// Decompress outside the lock so other entries aren't held up. Two threads racing on the same entry
+		// both decompress it and the first one to insert wins
+		if (entry->m_Compression != PackCompression::Lz4)
+		{
+			Log::Warning("Unknown compression type %d in pack archive.", (int)entry->m_Compression);
+			return false;
+		}
+
+		std::string decompressed;
+		decompressed.resize((size_t)entry->m_UncompressedSize);
+		int size = Compression::Lz4Decompress(data, (int)entry->m_Size, (uint8*)&decompressed[0], (int)decompressed.size());
+		if (size != (int)entry->m_UncompressedSize)
+		{
+			Log::Warning("Failed to decompress '%s' from pack archive.", GetEntryPath(*entry).c_str());
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(m_DecompressedMutex);
+		auto iter = m_DecompressedEntries.emplace(entry->m_Offset, std::move(decompressed)).first;
+		outData = std::string_view(iter->second);
+		return true;
+	}
+
+	std::string PackArchive::NormalizePath(const std::string& path)
+	{
+		std::string result;
+		result.reserve(path.size());
+		for (size_t i = 0; i < path.size(); i++)
+		{
+			char c = path[i];
+			if (c == '\\')
+			{
+				c = '/';
+			}
+
+			// Collapse repeated separators and drop "./" segments
+			if (c == '/' && result.size() > 0 && result.back() == '/')
+			{
+				continue;
+			}
+			if (c == '.' && (result.size() == 0 || result.back() == '/') && i + 1 < path.size() && (path[i + 1] == '/' || path[i + 1] == '\\'))
+			{
+				i++;
+				continue;
+			}
+
+			result += (char)std::tolower((unsigned char)c);
+		}
+
+		return result;
+	}
+
+	uint64 PackArchive::HashPath(const std::string& normalizedPath)
+	{
+		// 64 bit FNV-1a
+		uint64 hash = 14695981039346656037ull;
+		for (char c : normalizedPath)
+		{
+			hash ^= (uint8)c;
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	// ===================================================================================
+	// Pack Archive Writer
+	// ===================================================================================
+	void PackArchiveWriter::AddFile(const CPath& filepath, const std::string& pathInArchive)
+	{
+		m_Files.push_back({ filepath, PackArchive::NormalizePath(pathInArchive) });
+	}
+
+	void PackArchiveWriter::AddDirectory(const CPath& directory, const std::string& pathPrefix)
+	{
+		for (const CPath& file : IFile::GetFilesInDir(directory))
+		{
+			// Never pack an older archive into the new one
+			if (IFile::IsHidden(file) || strcmp(file.FileExt(), ".cpak") == 0)
+			{
+				continue;
+			}
+
+			AddFile(file, pathPrefix + file.Filename());
+		}
+
+		for (const CPath& folder : IFile::GetFoldersInDir(directory))
+		{
+			CPath subDirectory = directory + folder;
+			if (IFile::IsHidden(subDirectory))
+			{
+				continue;
+			}
+
+			AddDirectory(subDirectory, pathPrefix + folder.Filename() + "/");
+		}
+	}
+
+	static void PadTo(std::ofstream& stream, uint64& offset, uint64 alignment)
+	{
+		static const char zeros[64] = {};
+		while (offset % alignment != 0)
+		{
+			uint64 padding = std::min<uint64>(alignment - (offset % alignment), sizeof(zeros));
+			stream.write(zeros, padding);
+			offset += padding;
+		}
+	}
+
+	bool PackArchiveWriter::Write(const CPath& outputPath, uint32 alignment, bool compressLz4)
+	{
+		if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+		{
+			Log::Warning("Pack alignment must be a power of two, got %d.", alignment);
+			return false;
+		}
+
+		std::sort(m_Files.begin(), m_Files.end(), [](const PendingFile& a, const PendingFile& b) { return a.m_Path < b.m_Path; });
+		for (size_t i = 1; i < m_Files.size(); i++)
+		{
+			if (m_Files[i].m_Path == m_Files[i - 1].m_Path)
+			{
+				Log::Warning("Pack archive contains '%s' twice.", m_Files[i].m_Path.c_str());
+				return false;
+			}
+		}
+
+		std::ofstream outStream(outputPath.Filepath(), std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!outStream.is_open())
+		{
+			Log::Warning("Could not open '%s' for writing.", outputPath.Filepath());
+			return false;
+		}
+
+		PackHeader header = {};
+		outStream.write((const char*)&header, sizeof(PackHeader));
+		uint64 offset = sizeof(PackHeader);
+
+		std::vector<PackEntry> entries;
+		std::string stringTable;
+		entries.reserve(m_Files.size());
+		for (const PendingFile& file : m_Files)
+		{
+			std::ifstream inStream(file.m_Source.Filepath(), std::ios::in | std::ios::binary);
+			if (!inStream.is_open())
+			{
+				Log::Warning("Could not read '%s' while packing.", file.m_Source.Filepath());
+				return false;
+			}
+			std::string data((std::istreambuf_iterator<char>(inStream)), std::istreambuf_iterator<char>());
+
+			PackEntry entry = {};
+			entry.m_PathHash = PackArchive::HashPath(file.m_Path);
+			entry.m_UncompressedSize = data.size();
+			entry.m_PathOffset = (uint32)stringTable.size();
+			entry.m_PathLength = (uint16)file.m_Path.size();
+			entry.m_Compression = PackCompression::None;
+			stringTable += file.m_Path;
+
+			// Only keep the compressed copy when it actually saves space
+			std::string compressed;
+			if (compressLz4 && data.size() > 0)
+			{
+				compressed.resize(Compression::Lz4CompressBound((int)data.size()));
+				int compressedSize = Compression::Lz4Compress((const uint8*)data.data(), (int)data.size(), (uint8*)&compressed[0], (int)compressed.size());
+				if (compressedSize > 0 && (size_t)compressedSize < data.size())
+				{
+					compressed.resize(compressedSize);
+					entry.m_Compression = PackCompression::Lz4;
+				}
+			}
+
+			const std::string& payload = entry.m_Compression == PackCompression::Lz4 ? compressed : data;
+			PadTo(outStream, offset, alignment);
+			entry.m_Offset = offset;
+			entry.m_Size = payload.size();
+			outStream.write(payload.data(), payload.size());
+			offset += payload.size();
+
+			entries.push_back(entry);
+		}
+
+		std::stable_sort(entries.begin(), entries.end(), [](const PackEntry& a, const PackEntry& b) { return a.m_PathHash < b.m_PathHash; });
+
+		PadTo(outStream, offset, alignof(PackEntry));
+		header.m_Magic = PackArchive::MAGIC;
+		header.m_Version = PackArchive::VERSION;
+		header.m_EntryCount = (uint32)entries.size();
+		header.m_Alignment = alignment;
+		header.m_TocOffset = offset;
+		outStream.write((const char*)entries.data(), entries.size() * sizeof(PackEntry));
+		offset += entries.size() * sizeof(PackEntry);
+
+		header.m_StringTableOffset = offset;
+		header.m_StringTableSize = stringTable.size();
+		outStream.write(stringTable.data(), stringTable.size());
+
+		outStream.seekp(0);
+		outStream.write((const char*)&header, sizeof(PackHeader));
+		outStream.close();
+
+		return !outStream.fail();
+	}
+}
@@ -0,0 +1,87 @@
+#include "cocoa/file/PathTable.h"
+#include "cocoa/util/Log.h"
+
+#include <deque>
+#include <mutex>
+
+namespace Cocoa
+{
+	struct PathHasher
+	{
+		size_t operator()(const CPath* path) const
+		{
+			return path->Hash();
+		}
+	};
+
+	struct PathEquals
+	{
+		bool operator()(const CPath* a, const CPath* b) const
+		{
+			return a->Equals(*b);
+		}
+	};
+
+	struct PathTableState
+	{
+		std::mutex m_Mutex;
+		// Index is id - 1. A deque never moves its elements, so the keys below and the references
+		// handed out by GetPath stay valid as the table grows
+		std::deque<CPath> m_Paths;
+		std::unordered_map<const CPath*, uint32, PathHasher, PathEquals> m_Ids;
+	};
+
+	// Created on first use so paths can be interned from static initializers, any thread, and before
+	// the engine has been initialized
+	PathTableState& PathTable::Get()
+	{
+		static PathTableState s_State;
+		return s_State;
+	}
+
+	PathId PathTable::Intern(const CPath& path)
+	{
+		PathTableState* state = &Get();
+		std::lock_guard<std::mutex> lock(state->m_Mutex);
+		auto it = state->m_Ids.find(&path);
+		if (it != state->m_Ids.end())
+		{
+			return PathId{ it->second };
+		}
+
+		state->m_Paths.emplace_back(path);
+		uint32 id = (uint32)state->m_Paths.size();
+		state->m_Ids.insert({ &state->m_Paths.back(), id });
+		return PathId{ id };
+	}
+
+	PathId PathTable::Find(const CPath& path)
+	{
+		PathTableState* state = &Get();
+		std::lock_guard<std::mutex> lock(state->m_Mutex);
+		auto it = state->m_Ids.find(&path);
+		return it != state->m_Ids.end() ? PathId{ it->second } : PathId{};
+	}
+
+	const CPath& PathTable::GetPath(PathId id)
+	{
+		static const CPath s_EmptyPath = CPath();
+
+		PathTableState* state = &Get();
+		std::lock_guard<std::mutex> lock(state->m_Mutex);
+		if (id.IsNull() || id.m_Id > state->m_Paths.size())
+		{
+			Log::Warning("Tried to get path for invalid path id %d.", id.m_Id);
+			return s_EmptyPath;
+		}
+
+		return state->m_Paths[id.m_Id - 1];
+	}
+
+	uint32 PathTable::Size()
+	{
+		PathTableState* state = &Get();
+		std::lock_guard<std::mutex> lock(state->m_Mutex);
+		return (uint32)state->m_Paths.size();
+	}
+}
@@ -0,0 +1,483 @@
+#ifndef _WIN32
+#include "cocoa/file/IFile.h"
+#include "cocoa/util/Log.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <thread>
+
+extern char** environ;
+
+namespace Cocoa
+{
+	File* PosixFile::ImplOpenFile(const CPath& filename)
+	{
+		File* file = new File();
+		file->m_Filename = filename.Filepath();
+
+		struct stat fileStat;
+		if (stat(filename.Filepath(), &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+		{
+			return file;
+		}
+
+		uint64 fileSize = (uint64)fileStat.st_size;
+		if (fileSize >= MIN_MAPPED_FILE_SIZE)
+		{
+			MemoryMappedFile* mapping = ImplMapFile(filename);
+			if (mapping->m_Open)
+			{
+				file->m_Mapping = mapping;
+				file->m_Data = std::string_view((const char*)mapping->m_Data, (size_t)mapping->m_Size);
+				file->m_Size = (uint32)mapping->m_Size;
+				file->m_Open = true;
+				return file;
+			}
+			ImplUnmapFile(mapping);
+		}
+
+		int fd = open(filename.Filepath(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+		{
+			return file;
+		}
+
+		file->m_Buffer.resize((size_t)fileSize);
+		size_t bytesRead = 0;
+		while (bytesRead < fileSize)
+		{
+			ssize_t result = read(fd, &file->m_Buffer[bytesRead], (size_t)fileSize - bytesRead);
+			if (result < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			if (result <= 0)
+			{
+				break;
+			}
+			bytesRead += (size_t)result;
+		}
+		close(fd);
+
+		file->m_Buffer.resize(bytesRead);
+		file->m_Data = file->m_Buffer;
+		file->m_Size = (uint32)bytesRead;
+		file->m_Open = true;
+		return file;
+	}
+
+	void PosixFile::ImplCloseFile(File* file)
+	{
+		if (file->m_Mapping != nullptr)
+		{
+			ImplUnmapFile(file->m_Mapping);
+		}
+		delete file;
+	}
+
+	bool PosixFile::ImplWriteFile(const char* data, const CPath& filename)
+	{
+		std::ofstream outStream(filename.Filepath());
+		outStream << data;
+		outStream.close();
+		return true;
+	}
+
+	bool PosixFile::ImplWriteFileAtomic(std::string_view data, const CPath& filename)
+	{
+		std::string tmpFilepath = std::string(filename.Filepath()) + ".tmp";
+		int fd = open(tmpFilepath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+		if (fd < 0)
+		{
+			Log::Warning("Could not open file '%s' for writing", tmpFilepath.c_str());
+			return false;
+		}
+
+		size_t bytesWritten = 0;
+		while (bytesWritten < data.size())
+		{
+			ssize_t result = write(fd, data.data() + bytesWritten, data.size() - bytesWritten);
+			if (result < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			if (result <= 0)
+			{
+				break;
+			}
+			bytesWritten += (size_t)result;
+		}
+
+		// The data has to be on disk before the rename is, otherwise a crash can still leave an empty file
+		bool res = bytesWritten == data.size() && fsync(fd) == 0;
+		close(fd);
+		res = res && rename(tmpFilepath.c_str(), filename.Filepath()) == 0;
+		if (!res)
+		{
+			unlink(tmpFilepath.c_str());
+			Log::Warning("Could not write file '%s'", filename.Filepath());
+		}
+
+		return res;
+	}
+
+	bool PosixFile::ImplAppendFile(std::string_view data, const CPath& filename)
+	{
+		int fd = open(filename.Filepath(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+		if (fd < 0)
+		{
+			Log::Warning("Could not open file '%s' for appending", filename.Filepath());
+			return false;
+		}
+
+		size_t bytesWritten = 0;
+		while (bytesWritten < data.size())
+		{
+			ssize_t result = write(fd, data.data() + bytesWritten, data.size() - bytesWritten);
+			if (result < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			if (result <= 0)
+			{
+				break;
+			}
+			bytesWritten += (size_t)result;
+		}
+
+		bool res = bytesWritten == data.size() && fsync(fd) == 0;
+		close(fd);
+		if (!res)
+		{
+			Log::Warning("Could not append to file '%s'", filename.Filepath());
+		}
+
+		return res;
+	}
+
+	bool PosixFile::ImplCreateFile(const CPath& filename, const char* extToAppend)
+	{
+		CPath fileToWrite = filename;
+		if (filename.FileExt() == nullptr || filename.FileExt()[0] == '\0')
+		{
+			fileToWrite = CPath(filename.Filepath() + std::string(extToAppend));
+		}
+
+		int fd = open(fileToWrite.Filepath(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+		bool res = fd >= 0;
+		if (res)
+		{
+			close(fd);
+		}
+		return res;
+	}
+
+	bool PosixFile::ImplDeleteFile(const CPath& filename)
+	{
+		return unlink(filename.Filepath()) == 0;
+	}
+
+	bool PosixFile::ImplCopyFile(const CPath& fileToCopy, const CPath& newFileLocation, const char* newFilename)
+	{
+		CPath newFilepath = newFileLocation + (std::string(newFilename) + fileToCopy.FileExt());
+		std::ifstream inStream(fileToCopy.Filepath(), std::ios::in | std::ios::binary);
+		std::ofstream outStream(newFilepath.Filepath(), std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!inStream.is_open() || !outStream.is_open())
+		{
+			Log::Warning("Could not copy file '%s' to '%s'", fileToCopy.Filepath(), newFilepath.Filepath());
+			return false;
+		}
+
+		outStream << inStream.rdbuf();
+		return !outStream.fail();
+	}
+
+	CPath PosixFile::ImplGetCwd()
+	{
+		char buffer[4096];
+		if (getcwd(buffer, sizeof(buffer)) == nullptr)
+		{
+			return CPath("");
+		}
+		return CPath(buffer);
+	}
+
+	CPath PosixFile::ImplGetSpecialAppFolder()
+	{
+		// Matches %APPDATA% on Windows, per the XDG base directory spec
+		const char* dataHome = getenv("XDG_DATA_HOME");
+		if (dataHome != nullptr && dataHome[0] != '\0')
+		{
+			return CPath(dataHome);
+		}
+
+		const char* home = getenv("HOME");
+		return CPath(std::string(home != nullptr ? home : "") + "/.local/share");
+	}
+
+	CPath PosixFile::ImplGetExecutableDirectory()
+	{
+		char buffer[4096];
+		ssize_t length = readlink("/proc/self/exe", buffer, sizeof(buffer) - 1);
+		if (length <= 0)
+		{
+			return ImplGetCwd();
+		}
+		buffer[length] = '\0';
+		return CPath(buffer);
+	}
+
+	std::vector<CPath> PosixFile::ImplGetFilesInDir(const CPath& directory)
+	{
+		std::vector<CPath> result;
+		DIR* dir = opendir(directory.Filepath());
+		if (dir == nullptr)
+		{
+			// No file found
+			return result;
+		}
+
+		while (dirent* entry = readdir(dir))
+		{
+			if (entry->d_name[0] == '.')
+			{
+				continue;
+			}
+
+			const CPath fullFilename = directory + CPath(entry->d_name);
+			if (ImplIsFile(fullFilename))
+			{
+				result.push_back(fullFilename);
+			}
+		}
+
+		closedir(dir);
+		return result;
+	}
+
+	std::vector<CPath> PosixFile::ImplGetFoldersInDir(const CPath& directory)
+	{
+		std::vector<CPath> result;
+		DIR* dir = opendir(directory.Filepath());
+		if (dir == nullptr)
+		{
+			// No file found
+			return result;
+		}
+
+		while (dirent* entry = readdir(dir))
+		{
+			if (entry->d_name[0] == '.')
+			{
+				continue;
+			}
+
+			if (ImplIsDirectory(directory + CPath(entry->d_name)))
+			{
+				result.push_back(CPath(entry->d_name));
+			}
+		}
+
+		closedir(dir);
+		return result;
+	}
+
+	void PosixFile::ImplCreateDirIfNotExists(const CPath& directory)
+	{
+		if (mkdir(directory.Filepath(), 0755) != 0 && errno != EEXIST)
+		{
+			Log::Assert(false, "Failed to create directory %s", directory.Filepath());
+		}
+	}
+
+	bool PosixFile::ImplIsFile(const CPath& filepath)
+	{
+		struct stat fileStat;
+		return stat(filepath.Filepath(), &fileStat) == 0 && S_ISREG(fileStat.st_mode);
+	}
+
+	bool PosixFile::ImplIsHidden(const CPath& filepath)
+	{
+		return filepath.Filename()[0] == '.';
+	}
+
+	bool PosixFile::ImplIsDirectory(const CPath& filepath)
+	{
+		struct stat fileStat;
+		return stat(filepath.Filepath(), &fileStat) == 0 && S_ISDIR(fileStat.st_mode);
+	}
+
+	CPath PosixFile::ImplGetAbsolutePath(const CPath& path)
+	{
+		// Like GetFullPathName this has to work for files that don't exist yet, so it can't use realpath
+		std::string input = path.Filepath();
+		if (input.size() == 0 || input[0] != '/')
+		{
+			input = std::string(ImplGetCwd().Filepath()) + "/" + input;
+		}
+
+		std::vector<std::string> segments;
+		size_t start = 0;
+		while (start <= input.size())
+		{
+			size_t end = input.find('/', start);
+			if (end == std::string::npos)
+			{
+				end = input.size();
+			}
+
+			std::string segment = input.substr(start, end - start);
+			if (segment == "..")
+			{
+				if (segments.size() > 0)
+				{
+					segments.pop_back();
+				}
+			}
+			else if (segment.size() > 0 && segment != ".")
+			{
+				segments.push_back(segment);
+			}
+			start = end + 1;
+		}
+
+		std::string result = "";
+		for (const std::string& segment : segments)
+		{
+			result += "/" + segment;
+		}
+		return CPath(result.size() > 0 ? result : "/");
+	}
+
+	// Splits a command line the way CreateProcess would, on whitespace outside double quotes, with \" for a
+	// literal quote. Nothing else is special, the arguments never go near a shell
+	static std::vector<std::string> SplitArguments(const char* cmdArguments)
+	{
+		std::vector<std::string> result;
+		std::string current;
+		bool inQuotes = false;
+		bool hasArgument = false;
+		for (const char* c = cmdArguments; *c != '\0'; c++)
+		{
+			if (*c == '\\' && *(c + 1) == '"')
+			{
+				current += '"';
+				hasArgument = true;
+				c++;
+			}
+			else if (*c == '"')
+			{
+				inQuotes = !inQuotes;
+				hasArgument = true;
+			}
+			else if ((*c == ' ' || *c == '\t') && !inQuotes)
+			{
+				if (hasArgument)
+				{
+					result.push_back(current);
+					current.clear();
+					hasArgument = false;
+				}
+			}
+			else
+			{
+				current += *c;
+				hasArgument = true;
+			}
+		}
+
+		if (hasArgument)
+		{
+			result.push_back(current);
+		}
+		return result;
+	}
+
+	bool PosixFile::ImplRunProgram(const CPath& pathToExe, const char* cmdArguments)
+	{
+		// Same contract as CreateProcess, the arguments are one string. They're split here and handed to the
+		// program as an argv, so quotes, $ and backticks in a path are never interpreted
+		std::vector<std::string> arguments = SplitArguments(cmdArguments);
+		std::vector<char*> argv;
+		argv.reserve(arguments.size() + 2);
+		argv.push_back((char*)pathToExe.Filepath());
+		for (std::string& argument : arguments)
+		{
+			argv.push_back(&argument[0]);
+		}
+		argv.push_back(nullptr);
+
+		pid_t pid;
+		bool res = posix_spawn(&pid, pathToExe.Filepath(), nullptr, nullptr, argv.data(), environ) == 0;
+		if (res)
+		{
+			// Like CreateProcess the caller doesn't wait, something still has to reap the child
+			std::thread([pid]() { waitpid(pid, nullptr, 0); }).detach();
+		}
+		else
+		{
+			Log::Warning("Unsuccessfully started process '%s'", pathToExe.Filepath());
+		}
+
+		return res;
+	}
+
+	MemoryMappedFile* PosixFile::ImplMapFile(const CPath& filename)
+	{
+		MemoryMappedFile* file = new MemoryMappedFile();
+
+		int fd = open(filename.Filepath(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+		{
+			Log::Warning("Could not open file '%s' for mapping.", filename.Filepath());
+			return file;
+		}
+
+		struct stat fileStat;
+		if (fstat(fd, &fileStat) != 0)
+		{
+			Log::Warning("Could not stat file '%s' for mapping.", filename.Filepath());
+			close(fd);
+			return file;
+		}
+
+		if (fileStat.st_size == 0)
+		{
+			// Empty files can't be mapped, hand back an open view with no data
+			file->m_Open = true;
+			close(fd);
+			return file;
+		}
+
+		void* view = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		// The mapping keeps its own reference to the file
+		close(fd);
+		if (view == MAP_FAILED)
+		{
+			Log::Warning("Could not map file '%s'.", filename.Filepath());
+			return file;
+		}
+
+		file->m_Data = (const uint8*)view;
+		file->m_Size = (uint64)fileStat.st_size;
+		file->m_Open = true;
+		return file;
+	}
+
+	void PosixFile::ImplUnmapFile(MemoryMappedFile* file)
+	{
+		if (file->m_Data != nullptr)
+		{
+			munmap((void*)file->m_Data, (size_t)file->m_Size);
+		}
+
+		delete file;
+	}
+}
+#endif
@@ -13,22 +13,48 @@ namespace Cocoa
 		File* file = new File();
 		file->m_Filename = filename.Filepath();
 
-		std::ifstream inputStream(filename.Filepath());
+		WIN32_FILE_ATTRIBUTE_DATA attributes;
+		if (!GetFileAttributesExA(filename.Filepath(), GetFileExInfoStandard, &attributes) || (attributes.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+		{
+			return file;
+		}
 
-		if (inputStream.is_open())
+		uint64 fileSize = ((uint64)attributes.nFileSizeHigh << 32) | (uint64)attributes.nFileSizeLow;
+		if (fileSize >= MIN_MAPPED_FILE_SIZE)
 		{
-			inputStream.seekg(0, std::ios::end);
-			file->m_Size = (uint32)inputStream.tellg();
-			file->m_Data.reserve(file->m_Size);
-			inputStream.seekg(0, std::ios::beg);
+			MemoryMappedFile* mapping = ImplMapFile(filename);
+			if (mapping->m_Open)
+			{
+				file->m_Mapping = mapping;
+				file->m_Data = std::string_view((const char*)mapping->m_Data, (size_t)mapping->m_Size);
+				file->m_Size = (uint32)mapping->m_Size;
+				file->m_Open = true;
+				return file;
+			}
+			ImplUnmapFile(mapping);
+		}
 
-			file->m_Data.assign((std::istreambuf_iterator<char>(inputStream)), std::istreambuf_iterator<char>());
+		HANDLE fileHandle = CreateFileA(filename.Filepath(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+		if (fileHandle == INVALID_HANDLE_VALUE)
+		{
+			return file;
+		}
+
+		file->m_Buffer.resize((size_t)fileSize);
+		DWORD bytesRead = 0;
+		bool success = fileSize == 0 || ::ReadFile(fileHandle, &file->m_Buffer[0], (DWORD)fileSize, &bytesRead, NULL);
+		CloseHandle(fileHandle);
+
+		if (success)
+		{
+			file->m_Buffer.resize(bytesRead);
+			file->m_Data = file->m_Buffer;
+			file->m_Size = (uint32)bytesRead;
+			file->m_Open = true;
 		}
 		else
 		{
-			file->m_Data = "";
-			file->m_Open = false;
-			file->m_Size = 0;
+			file->m_Buffer.clear();
 		}
 
 		return file;
@@ -36,6 +62,10 @@ namespace Cocoa
 
 	void Win32File::ImplCloseFile(File* file)
 	{
+		if (file->m_Mapping != nullptr)
+		{
+			ImplUnmapFile(file->m_Mapping);
+		}
 		delete file;
 	}
 
@@ -47,6 +77,55 @@ namespace Cocoa
 		return true;
 	}
 
+	bool Win32File::ImplWriteFileAtomic(std::string_view data, const CPath& filename)
+	{
+		std::string tmpFilepath = std::string(filename.Filepath()) + ".tmp";
+		HANDLE fileHandle = CreateFileA(tmpFilepath.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (fileHandle == INVALID_HANDLE_VALUE)
+		{
+			Log::Warning("Could not open file '%s' for writing", tmpFilepath.c_str());
+			return false;
+		}
+
+		// The data has to be on disk before the rename is, otherwise a crash can still leave an empty file
+		DWORD bytesWritten = 0;
+		bool res = ::WriteFile(fileHandle, data.data(), (DWORD)data.size(), &bytesWritten, NULL) &&
+			bytesWritten == (DWORD)data.size() &&
+			FlushFileBuffers(fileHandle);
+		CloseHandle(fileHandle);
+
+		res = res && MoveFileExA(tmpFilepath.c_str(), filename.Filepath(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+		if (!res)
+		{
+			DeleteFileA(tmpFilepath.c_str());
+			Log::Warning("Could not write file '%s'", filename.Filepath());
+		}
+
+		return res;
+	}
+
+	bool Win32File::ImplAppendFile(std::string_view data, const CPath& filename)
+	{
+		HANDLE fileHandle = CreateFileA(filename.Filepath(), FILE_APPEND_DATA, FILE_SHARE_READ, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (fileHandle == INVALID_HANDLE_VALUE)
+		{
+			Log::Warning("Could not open file '%s' for appending", filename.Filepath());
+			return false;
+		}
+
+		DWORD bytesWritten = 0;
+		bool res = ::WriteFile(fileHandle, data.data(), (DWORD)data.size(), &bytesWritten, NULL) &&
+			bytesWritten == (DWORD)data.size() &&
+			FlushFileBuffers(fileHandle);
+		CloseHandle(fileHandle);
+		if (!res)
+		{
+			Log::Warning("Could not append to file '%s'", filename.Filepath());
+		}
+
+		return res;
+	}
+
 	bool Win32File::ImplCreateFile(const CPath& filename, const char* extToAppend)
 	{
 		CPath fileToWrite = filename;
@@ -253,4 +332,69 @@ namespace Cocoa
 
 		return res;
 	}
+
+	MemoryMappedFile* Win32File::ImplMapFile(const CPath& filename)
+	{
+		MemoryMappedFile* file = new MemoryMappedFile();
+
+		HANDLE fileHandle = CreateFileA(filename.Filepath(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (fileHandle == INVALID_HANDLE_VALUE)
+		{
+			Log::Warning("Could not open file '%s' for mapping.", filename.Filepath());
+			return file;
+		}
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+		{
+			// Empty files can't be mapped, hand back an open view with no data
+			CloseHandle(fileHandle);
+			file->m_Open = fileSize.QuadPart == 0;
+			return file;
+		}
+
+		HANDLE mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mappingHandle == NULL)
+		{
+			Log::Warning("Could not create file mapping for '%s'.", filename.Filepath());
+			CloseHandle(fileHandle);
+			return file;
+		}
+
+		void* view = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+		if (view == nullptr)
+		{
+			Log::Warning("Could not map view of file '%s'.", filename.Filepath());
+			CloseHandle(mappingHandle);
+			CloseHandle(fileHandle);
+			return file;
+		}
+
+		file->m_Data = (const uint8*)view;
+		file->m_Size = (uint64)fileSize.QuadPart;
+		file->m_FileHandle = fileHandle;
+		file->m_MappingHandle = mappingHandle;
+		file->m_Open = true;
+		return file;
+	}
+
+	void Win32File::ImplUnmapFile(MemoryMappedFile* file)
+	{
+		if (file->m_Data != nullptr)
+		{
+			UnmapViewOfFile(file->m_Data);
+		}
+
+		if (file->m_MappingHandle != nullptr)
+		{
+			CloseHandle((HANDLE)file->m_MappingHandle);
+		}
+
+		if (file->m_FileHandle != nullptr)
+		{
+			CloseHandle((HANDLE)file->m_FileHandle);
+		}
+
+		delete file;
+	}
 }
\ No newline at end of file
@@ -3,8 +3,11 @@
 #include "cocoa/physics2d/Physics2D.h"
 #include "cocoa/components/components.h"
 #include "cocoa/components/Transform.h"
+#include "cocoa/components/TransformHierarchy.h"
 #include "cocoa/physics2d/rigidbody/CollisionDetector2D.h"
 #include "cocoa/core/Application.h"
+#include "cocoa/core/JobSystem.h"
+#include "cocoa/scenes/ChangeTracker.h"
 #include "cocoa/util/CMath.h"
 #include "cocoa/util/Settings.h"
 
@@ -57,15 +60,13 @@ namespace Cocoa
 
 	Entity Physics2D::OverlapPoint(const glm::vec2& point)
 	{
-		Physics2D* physics = Get();
-		auto group = physics->m_Scene->GetRegistry().group<AABB>(entt::get<Transform>);
-		for (Entity entity : group)
+		auto group = m_Scene->GetRegistry().group<AABB>(entt::get<Transform>);
+		for (entt::entity entity : group)
 		{
-			auto& aabb = entity.GetComponent<AABB>();
-			auto& transform = entity.GetComponent<Transform>();
-			if (CollisionDetector2D::PointInAABB(point, aabb))
+			auto [aabb, transform] = group.get<AABB, Transform>(entity);
+			if (CollisionDetector2D::PointInAABB(point, Physics2DSystem::ToWorld(aabb, transform)))
 			{
-				return entity;
+				return Entity(entity, m_Scene);
 			}
 		};
 
@@ -74,7 +75,6 @@ namespace Cocoa
 
 	bool Physics2D::PointInBox(const glm::vec2& point, const glm::vec2& halfSize, const glm::vec2& position, float rotationDegrees)
 	{
-		Physics2D* physics = Get();
 		b2PolygonShape shape;
 		shape.SetAsBox(halfSize.x, halfSize.y);
 		b2Transform transform = b2Transform(b2Vec2(position.x, position.y), b2Rot(CMath::ToRadians(rotationDegrees)));
@@ -83,14 +83,17 @@ namespace Cocoa
 
 	void Physics2D::AddEntity(Entity entity)
 	{
+		// Box2D can't add bodies while the world steps
+		FinishStep();
 		if (entity.HasComponent<Transform, Rigidbody2D>())
 		{
 			Transform& transform = entity.GetComponent<Transform>();
 			Rigidbody2D& rb = entity.GetComponent<Rigidbody2D>();
 
 			b2BodyDef bodyDef;
-			bodyDef.position.Set(transform.m_Position.x, transform.m_Position.y);
-			bodyDef.angle = CMath::ToRadians(transform.m_EulerRotation.z);
+			// Box2D works in world space, whatever the transform is parented to
+			bodyDef.position.Set(transform.m_WorldPosition.x, transform.m_WorldPosition.y);
+			bodyDef.angle = CMath::ToRadians(transform.m_WorldRotation);
 			bodyDef.angularDamping = rb.m_AngularDamping;
 			bodyDef.linearDamping = rb.m_LinearDamping;
 			bodyDef.fixedRotation = rb.m_FixedRotation;
@@ -111,14 +114,16 @@ namespace Cocoa
 
 			b2Body* body = m_World.CreateBody(&bodyDef);
 			rb.m_RawRigidbody = body;
+			rb.m_PreviousPosition = CMath::Vector2From3(transform.m_WorldPosition);
+			rb.m_PreviousRotation = transform.m_WorldRotation;
 
 			b2PolygonShape shape;
 			if (entity.HasComponent<Box2D>())
 			{
 				Box2D& box = entity.GetComponent<Box2D>();
-				shape.SetAsBox(box.m_HalfSize.x * transform.m_Scale.x, box.m_HalfSize.y * transform.m_Scale.y);
+				shape.SetAsBox(box.m_HalfSize.x * transform.m_WorldScale.x, box.m_HalfSize.y * transform.m_WorldScale.y);
 				b2Vec2 pos = bodyDef.position;
-				bodyDef.position.Set(pos.x - box.m_HalfSize.x * transform.m_Scale.x, pos.y - box.m_HalfSize.y * transform.m_Scale.y);
+				bodyDef.position.Set(pos.x - box.m_HalfSize.x * transform.m_WorldScale.x, pos.y - box.m_HalfSize.y * transform.m_WorldScale.y);
 			}
 			else if (entity.HasComponent<Circle>())
 			{
@@ -130,70 +135,195 @@ namespace Cocoa
 		}
 	}
 
+	void Physics2D::RemoveEntity(Entity entity)
+	{
+		// The pending step still holds the body
+		FinishStep();
+		if (!entity.HasComponent<Rigidbody2D>())
+		{
+			return;
+		}
+
+		Rigidbody2D& rb = entity.GetComponent<Rigidbody2D>();
+		if (rb.m_RawRigidbody != nullptr)
+		{
+			m_World.DestroyBody(static_cast<b2Body*>(rb.m_RawRigidbody));
+			rb.m_RawRigidbody = nullptr;
+		}
+	}
+
+	// Bodies per job when copying positions back, below this the jobs cost more than the copies
+	static const size_t SYNC_GRAIN_SIZE = 256;
+
 	void Physics2D::Update(float dt)
 	{
+		FinishStep();
+		SyncChangedBodies();
+
+		// Fixed steps keep the simulation the same at any frame rate. Past s_MaxSubsteps the time is dropped,
+		// otherwise every slow frame makes the next one slower
+		float timestep = Settings::Physics2D::s_Timestep;
 		m_PhysicsTime += dt;
-		while (m_PhysicsTime > 0.0f)
+		int steps = (int)(m_PhysicsTime / timestep);
+		m_PhysicsTime -= steps * timestep;
+		if (steps > Settings::Physics2D::s_MaxSubsteps)
 		{
-			m_World.Step(Settings::Physics2D::s_Timestep, Settings::Physics2D::s_VelocityIterations, Settings::Physics2D::s_PositionIterations);
-			m_PhysicsTime -= Settings::Physics2D::s_Timestep;
+			steps = Settings::Physics2D::s_MaxSubsteps;
+		}
+		m_InterpolationAlpha = m_PhysicsTime / timestep;
+		if (steps == 0)
+		{
+			return;
 		}
 
-		auto view = m_Scene->GetRegistry().view<Transform, Rigidbody2D>();
-		for (Entity entity : view)
+		entt::registry& registry = m_Scene->GetRegistry();
+		auto view = registry.view<Rigidbody2D>();
+		m_Poses.clear();
+		for (entt::entity entity : view)
 		{
-			Transform& transform = entity.GetComponent<Transform>();
-			Rigidbody2D& rb = entity.GetComponent<Rigidbody2D>();
-			b2Body* body = static_cast<b2Body*>(rb.m_RawRigidbody);
-			b2Vec2 position = body->GetPosition();
-			transform.m_Position.x = position.x;
-			transform.m_Position.y = position.y;
-			transform.m_EulerRotation.z = CMath::ToDegrees(body->GetAngle());
+			b2Body* body = static_cast<b2Body*>(view.get(entity).m_RawRigidbody);
+			if (body != nullptr && registry.has<Transform>(entity))
+			{
+				BodyPose pose;
+				pose.m_Entity = entity;
+				pose.m_Body = body;
+				m_Poses.push_back(pose);
+			}
+		}
+
+		m_StepPending = true;
+		if (Settings::Physics2D::s_RunAhead && JobSystem::IsInitialized())
+		{
+			JobSystem::Submit([this, steps]() { Step(steps); }, &m_StepCounter);
+		}
+		else
+		{
+			Step(steps);
+			FinishStep();
 		}
 	}
 
-	void Physics2D::Destroy()
+	void Physics2D::SyncChangedBodies()
 	{
-		auto view =  m_Scene->GetRegistry().view<Rigidbody2D>();// m_Registry.view<Rigidbody2D>();
-		for (Entity entity : view)
+		// Changes from earlier in the frame the last sync ran in come through again, setting them twice is harmless
+		const ChangeTracker& changes = m_Scene->GetChanges();
+		entt::registry& registry = m_Scene->GetRegistry();
+		changes.ForEachChangedSince<Rigidbody2D>(m_SyncedFrame, [&](entt::entity entity)
 		{
-			Rigidbody2D& rb = entity.GetComponent<Rigidbody2D>();
+			Rigidbody2D* rb = registry.valid(entity) ? registry.try_get<Rigidbody2D>(entity) : nullptr;
+			b2Body* body = rb != nullptr ? static_cast<b2Body*>(rb->m_RawRigidbody) : nullptr;
+			if (body == nullptr)
+			{
+				return;
+			}
 
-			// Manually destroy all bodies, in case the physics system would like
-			// to use this world again
-			m_World.DestroyBody(static_cast<b2Body*>(rb.m_RawRigidbody));
-			rb.m_RawRigidbody = nullptr;
-		}
+			body->SetLinearDamping(rb->m_LinearDamping);
+			body->SetAngularDamping(rb->m_AngularDamping);
+			body->SetFixedRotation(rb->m_FixedRotation);
+			body->SetBullet(rb->m_ContinuousCollision);
+		});
+		m_SyncedFrame = changes.GetFrame();
 	}
 
-	// -------------------------------------------------------------------------
-	// Should be called once at beginning of engine initialization
-	// -------------------------------------------------------------------------
-	std::unique_ptr<Physics2D> Physics2D::s_Instance = nullptr;
-	void Physics2D::Init()
+	void Physics2D::Step(int steps)
 	{
-		if (s_Instance == nullptr)
+		for (int i = 0; i < steps; i++)
 		{
-			s_Instance = std::make_unique<Physics2D>(nullptr);
+			// Only the last two steps are ever rendered
+			if (i == steps - 1)
+			{
+				for (BodyPose& pose : m_Poses)
+				{
+					b2Vec2 position = pose.m_Body->GetPosition();
+					pose.m_PreviousPosition = glm::vec2(position.x, position.y);
+					pose.m_PreviousRotation = CMath::ToDegrees(pose.m_Body->GetAngle());
+				}
+			}
+
+			m_World.Step(Settings::Physics2D::s_Timestep, Settings::Physics2D::s_VelocityIterations, Settings::Physics2D::s_PositionIterations);
 		}
-		else
+
+		for (BodyPose& pose : m_Poses)
 		{
-			Log::Error("Tried to reinitialize Physics2D.");
+			b2Vec2 position = pose.m_Body->GetPosition();
+			pose.m_Position = glm::vec2(position.x, position.y);
+			pose.m_Rotation = CMath::ToDegrees(pose.m_Body->GetAngle());
 		}
 	}
 
-	void Physics2D::SetScene(Scene* scene)
+	void Physics2D::FinishStep()
 	{
-		s_Instance->m_Scene = scene;
+		if (!m_StepPending)
+		{
+			return;
+		}
+
+		if (JobSystem::IsInitialized())
+		{
+			JobSystem::Wait(m_StepCounter);
+		}
+		m_StepPending = false;
+
+		// Every body only writes its own components, so the copy back is split over the job system
+		entt::registry& registry = m_Scene->GetRegistry();
+		JobSystem::ParallelFor(0, m_Poses.size(), SYNC_GRAIN_SIZE, [&](size_t first, size_t last)
+		{
+			for (size_t i = first; i < last; i++)
+			{
+				const BodyPose& pose = m_Poses[i];
+				// A step running ahead can outlive the entity it was started for
+				if (!registry.valid(pose.m_Entity) || !registry.has<Transform, Rigidbody2D>(pose.m_Entity))
+				{
+					continue;
+				}
+
+				Rigidbody2D& rb = registry.get<Rigidbody2D>(pose.m_Entity);
+				rb.m_PreviousPosition = pose.m_PreviousPosition;
+				rb.m_PreviousRotation = pose.m_PreviousRotation;
+
+				Transform& transform = registry.get<Transform>(pose.m_Entity);
+				// Only local values are written here, so reading the parent's cached world data from other ranges is safe
+				glm::vec3 position = TransformHierarchy::WorldToLocal(registry, transform, glm::vec3(pose.m_Position, transform.m_WorldPosition.z));
+				transform.m_Position.x = position.x;
+				transform.m_Position.y = position.y;
+				transform.m_EulerRotation.z = TransformHierarchy::WorldToLocalRotation(registry, transform, pose.m_Rotation);
+			}
+		});
 	}
 
-	Physics2D* Physics2D::Get()
+	void Physics2D::Destroy()
 	{
-		Log::Assert(s_Instance != nullptr, "Physics2D was never initialized.");
+		FinishStep();
+		m_Poses.clear();
+		m_PhysicsTime = 0.0f;
+		m_InterpolationAlpha = 1.0f;
+		m_SyncedFrame = 0;
 
-		return s_Instance.get();
+		auto view =  m_Scene->GetRegistry().view<Rigidbody2D>();// m_Registry.view<Rigidbody2D>();
+		for (entt::entity entity : view)
+		{
+			Rigidbody2D& rb = view.get(entity);
+			if (rb.m_RawRigidbody == nullptr)
+			{
+				continue;
+			}
+
+			// Manually destroy all bodies, in case the physics system would like
+			// to use this world again
+			m_World.DestroyBody(static_cast<b2Body*>(rb.m_RawRigidbody));
+			rb.m_RawRigidbody = nullptr;
+		}
 	}
 
 	Physics2D::Physics2D(Scene* scene) 
 		: m_Scene(scene) {}
+
+	Physics2D::~Physics2D()
+	{
+		// A step still running ahead uses this world, the scene it would copy back into may already be gone
+		if (m_StepPending && JobSystem::IsInitialized())
+		{
+			JobSystem::Wait(m_StepCounter);
+		}
+	}
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "externalLibs.h"
 
 #include "cocoa/physics2d/Physics2DSystem.h"
+#include "cocoa/physics2d/Physics2D.h"
 #include "cocoa/components/Transform.h"
 #include "cocoa/core/Application.h"
 #include "cocoa/util/CMath.h"
@@ -9,6 +10,19 @@
 
 namespace Cocoa
 {
+	// ----------------------------------------------------------------------------
+	// System
+	// ----------------------------------------------------------------------------
+	void Physics2DSystem::Update(float dt)
+	{
+		m_Scene->GetPhysics()->Update(dt);
+	}
+
+	void Physics2DSystem::DeclareAccess(SystemAccess& access)
+	{
+		access.Write<Transform>().Write<Rigidbody2D>().Read<Box2D>().Read<Circle>();
+	}
+
 	// ----------------------------------------------------------------------------
 	// Box2D Helpers
 	// ----------------------------------------------------------------------------
@@ -28,34 +42,27 @@ namespace Cocoa
 		return box;
 	}
 
-	glm::vec2 Physics2DSystem::GetMin(const Box2D& box)
+	WorldBox2D Physics2DSystem::ToWorld(const Box2D& box, const Transform& transform)
 	{
-		Entity entity = Entity::FromComponent(box);
-		Transform& transform = entity.GetComponent<Transform>();
-
-		glm::vec2 boxScale = transform.m_Scale;
-		glm::vec2 boxCenter = CMath::Vector2From3(transform.m_Position);// +(box.m_Offset * boxScale);
-		glm::vec2 boxHalfSize = box.m_HalfSize * boxScale;
-
-		return boxCenter - boxHalfSize;
+		WorldBox2D result;
+		result.m_Center = CMath::Vector2From3(transform.m_WorldPosition);
+		result.m_HalfSize = box.m_HalfSize * glm::vec2(transform.m_WorldScale);
+		result.m_Rotation = transform.m_WorldRotation;
+		return result;
 	}
 
-	glm::vec2 Physics2DSystem::GetMax(const Box2D& box)
+	glm::vec2 Physics2DSystem::GetMin(const WorldBox2D& box)
 	{
-		Entity entity = Entity::FromComponent(box);
-		Transform& transform = entity.GetComponent<Transform>();
-
-		glm::vec2 boxScale = transform.m_Scale;
-		glm::vec2 boxCenter = CMath::Vector2From3(transform.m_Position);// +(box.m_Offset * boxScale);
-		glm::vec2 boxHalfSize = box.m_HalfSize * boxScale;
+		return box.m_Center - box.m_HalfSize;
+	}
 
-		return boxCenter + boxHalfSize;
+	glm::vec2 Physics2DSystem::GetMax(const WorldBox2D& box)
+	{
+		return box.m_Center + box.m_HalfSize;
 	}
 
-	std::array<glm::vec2, 4> Physics2DSystem::GetVertices(const Box2D& box)
+	std::array<glm::vec2, 4> Physics2DSystem::GetVertices(const WorldBox2D& box)
 	{
-		glm::vec center = GetCenter(box);
-		float rotation = GetRotation(box);
 		glm::vec2 min = GetMin(box);
 		glm::vec2 max = GetMax(box);
 
@@ -64,31 +71,17 @@ namespace Cocoa
 			glm::vec2(max.x, max.y), glm::vec2(max.x, min.y)
 		};
 
-		if (!CMath::Compare(GetRotation(box), 0.0f))
+		if (!CMath::Compare(box.m_Rotation, 0.0f))
 		{
 			for (auto& vec : vertices)
 			{
-				CMath::Rotate(vec, rotation, center);
+				CMath::Rotate(vec, box.m_Rotation, box.m_Center);
 			}
 		}
 
 		return vertices;
 	}
 
-	glm::vec2 Physics2DSystem::GetCenter(const Box2D& box)
-	{
-		Entity entity = Entity::FromComponent(box);
-		Transform& transform = entity.GetComponent<Transform>();
-		return CMath::Vector2From3(transform.m_Position);
-	}
-
-	float Physics2DSystem::GetRotation(const Box2D& box)
-	{
-		Entity entity = Entity::FromComponent(box);
-		Transform& transform = entity.GetComponent<Transform>();
-		return transform.m_EulerRotation.z;
-	}
-
 	// ----------------------------------------------------------------------------
 	// AABB Helpers and BoundingBox Helpers
 	// ----------------------------------------------------------------------------
@@ -109,45 +102,27 @@ namespace Cocoa
 		return box;
 	}
 
-	glm::vec2 Physics2DSystem::GetMax(const AABB& box)
+	WorldAABB Physics2DSystem::ToWorld(const AABB& box, const Transform& transform)
 	{
-		Entity entity = Entity::FromComponent(box);
-		Transform& transform = entity.GetComponent<Transform>();
-
-		glm::vec2 boxScale = transform.m_Scale;
-		glm::vec2 boxCenter = CMath::Vector2From3(transform.m_Position) + (box.m_Offset * boxScale);
+		glm::vec2 boxScale = transform.m_WorldScale;
+		glm::vec2 boxCenter = CMath::Vector2From3(transform.m_WorldPosition) + (box.m_Offset * boxScale);
 		glm::vec2 boxHalfSize = box.m_HalfSize * boxScale;
 
-		return boxCenter + boxHalfSize;
-	}
-
-	glm::vec2 Physics2DSystem::GetMin(const AABB& box)
-	{
-		Entity entity = Entity::FromComponent(box);
-		Transform& transform = entity.GetComponent<Transform>();
-
-		glm::vec2 boxScale = transform.m_Scale;
-		glm::vec2 boxCenter = CMath::Vector2From3(transform.m_Position) + (box.m_Offset * boxScale);
-		glm::vec2 boxHalfSize = box.m_HalfSize * boxScale;
-
-		return boxCenter - boxHalfSize;
-	}
-
-	glm::vec2 Physics2DSystem::GetCenter(const AABB& box)
-	{
-		Entity entity = Entity::FromComponent(box);
-		Transform& transform = entity.GetComponent<Transform>();
-		return CMath::Vector2From3(transform.m_Position);
+		WorldAABB result;
+		result.m_Min = boxCenter - boxHalfSize;
+		result.m_Max = boxCenter + boxHalfSize;
+		return result;
 	}
 
 	// ----------------------------------------------------------------------------
 	// Circle Helpers
 	// ----------------------------------------------------------------------------
-	glm::vec2 Physics2DSystem::GetCenter(const Circle& circle)
+	WorldCircle Physics2DSystem::ToWorld(const Circle& circle, const Transform& transform)
 	{
-		Entity entity = Entity::FromComponent(circle);
-		Transform& transform = entity.GetComponent<Transform>();
-		return CMath::Vector2From3(transform.m_Position);
+		WorldCircle result;
+		result.m_Center = CMath::Vector2From3(transform.m_WorldPosition);
+		result.m_Radius = circle.m_Radius;
+		return result;
 	}
 
 	// ----------------------------------------------------------------------------
@@ -169,7 +144,7 @@ namespace Cocoa
 		ray.m_Origin = origin;
 		ray.m_Direction = direction;
 		ray.m_MaxDistance = maxDistance;
-		ray.m_Ignore = ignore;
+		ray.m_Ignore = Entity(ignore);
 		return ray;
 	}
 
@@ -11,7 +11,7 @@ namespace Cocoa
 		using JP2 = Cocoa::Physics2DSystem;
 
 		// Helper functions
-		static glm::vec2 GetInterval(const Box2D& box, const glm::vec2& axis)
+		static glm::vec2 GetInterval(const WorldBox2D& box, const glm::vec2& axis)
 		{
 			glm::vec2 normAxis = glm::normalize(axis);
 
@@ -39,7 +39,7 @@ namespace Cocoa
 			return result;
 		}
 
-		static float OverlapOnAxis(const Box2D& b1, const Box2D& b2, const glm::vec2& axis, const glm::vec2& toCenter)
+		static float OverlapOnAxis(const WorldBox2D& b1, const WorldBox2D& b2, const glm::vec2& axis, const glm::vec2& toCenter)
 		{
 			glm::vec2 interval1 = GetInterval(b1, axis);
 			glm::vec2 interval2 = GetInterval(b2, axis);
@@ -67,18 +67,18 @@ namespace Cocoa
 			return CMath::Compare(point.y, slope * point.x + yIntercept);
 		}
 
-		bool PointInCircle(const glm::vec2& point, const Circle& circle)
+		bool PointInCircle(const glm::vec2& point, const WorldCircle& circle)
 		{
-			glm::vec2 line = JP2::GetCenter(circle) - point;
+			glm::vec2 line = circle.m_Center - point;
 
 			return glm::length2(line) <= circle.m_Radius * circle.m_Radius;
 		}
 
-		bool PointInBox2D(const glm::vec2& point, const Box2D& box)
+		bool PointInBox2D(const glm::vec2& point, const WorldBox2D& box)
 		{
 			// Translate the point into local space, then try to clip the point to the rectangle
 			glm::vec2 pointLocalSpace = glm::vec2(point);
-			CMath::Rotate(pointLocalSpace, JP2::GetRotation(box), JP2::GetCenter(box));
+			CMath::Rotate(pointLocalSpace, -box.m_Rotation, box.m_Center);
 
 			glm::vec2 min = JP2::GetMin(box);
 			glm::vec2 max = JP2::GetMax(box);
@@ -87,10 +87,10 @@ namespace Cocoa
 				pointLocalSpace.x <= max.x && pointLocalSpace.y <= max.y;
 		}
 
-		bool PointInAABB(const glm::vec2& point, const AABB& box)
+		bool PointInAABB(const glm::vec2& point, const WorldAABB& box)
 		{
-			glm::vec2 min = JP2::GetMin(box);
-			glm::vec2 max = JP2::GetMax(box);
+			const glm::vec2& min = box.m_Min;
+			const glm::vec2& max = box.m_Max;
 
 			return min.x <= point.x && min.y <= point.y && point.x <= max.x && point.y <= max.y;
 		}
@@ -101,7 +101,7 @@ namespace Cocoa
 		}
 
 
-		bool LineAndCircle(const Line2D& line, const Circle& circle)
+		bool LineAndCircle(const Line2D& line, const WorldCircle& circle)
 		{
 			if (PointInCircle(line.GetStart(), circle) || PointInCircle(line.GetEnd(), circle))
 			{
@@ -112,7 +112,7 @@ namespace Cocoa
 
 			// Project point (circle position) onto ab (line segment), computing the parameterized
 			// position d(t) = a + t * (b - a)
-			float t = glm::dot(JP2::GetCenter(circle) - line.GetStart(), ab) / glm::dot(ab, ab);
+			float t = glm::dot(circle.m_Center - line.GetStart(), ab) / glm::dot(ab, ab);
 
 			// Clamp T to a 0-1 range. If t was < 0 or > 1
 			// then the closest point was outside the segment
@@ -124,61 +124,73 @@ namespace Cocoa
 			// Find teh closest point on the line segment
 			glm::vec2 closestPoint = line.GetStart() + (ab * t);
 
-			glm::vec2 circleToClosest = JP2::GetCenter(circle) - closestPoint;
+			glm::vec2 circleToClosest = circle.m_Center - closestPoint;
 			return glm::length2(circleToClosest) < circle.m_Radius * circle.m_Radius;
 		}
 
-		bool LineAndBox2D(const Line2D& line, const Box2D& box)
+		bool LineAndBox2D(const Line2D& line, const WorldBox2D& box)
 		{
-			float theta = -JP2::GetRotation(box);
-			glm::vec2 boxCenter = JP2::GetCenter(box);
+			float theta = -box.m_Rotation;
+			glm::vec2 boxCenter = box.m_Center;
 			glm::vec2 localStart = line.GetStart();
 			CMath::Rotate(localStart, theta, boxCenter);
 			glm::vec2 localEnd = line.GetEnd();
 			CMath::Rotate(localEnd, theta, boxCenter);
 			Line2D localLine { localStart, localEnd };
-			AABB localBox { JP2::GetMin(box), JP2::GetMin(box) };
+			WorldAABB localBox { JP2::GetMin(box), JP2::GetMax(box) };
 
 			return LineAndAABB(localLine, localBox);
 		}
 
-		bool LineAndAABB(const Line2D& line, const AABB& box)
+		bool LineAndAABB(const Line2D& line, const WorldAABB& box)
 		{
-			glm::vec2 normal = line.GetEnd() - line.GetStart();
-			glm::normalize(normal);
-			normal.x = (normal.x != 0.0f) ? 1.0f / normal.x : 0.0f;
-			normal.y = (normal.y != 0.0f) ? 1.0f / normal.y : 0.0f;
-
-			glm::vec2 min = JP2::GetMin(box) - (line.GetStart() * normal);
-			glm::vec2 max = JP2::GetMax(box) - (line.GetStart() * normal);
-
-			float tmin = std::max(std::min(min.x, max.x), std::min(min.y, max.y));
-			float tmax = std::min(std::max(min.x, max.x), std::max(min.y, max.y));
-			if (tmax < 0 || tmin > tmax)
+			// Clip the segment start + t * direction, t in [0, 1], against both slabs of the box
+			glm::vec2 start = line.GetStart();
+			glm::vec2 direction = line.GetEnd() - start;
+			float tmin = 0.0f;
+			float tmax = 1.0f;
+			for (int axis = 0; axis < 2; axis++)
 			{
-				return false;
+				if (direction[axis] == 0.0f)
+				{
+					// Parallel to this slab, it either runs inside it or misses the box
+					if (start[axis] < box.m_Min[axis] || start[axis] > box.m_Max[axis])
+					{
+						return false;
+					}
+					continue;
+				}
+
+				float t1 = (box.m_Min[axis] - start[axis]) / direction[axis];
+				float t2 = (box.m_Max[axis] - start[axis]) / direction[axis];
+				tmin = std::max(tmin, std::min(t1, t2));
+				tmax = std::min(tmax, std::max(t1, t2));
+				if (tmin > tmax)
+				{
+					return false;
+				}
 			}
-			float t = (tmin < 0.0f) ? tmax : tmin;
-			return t > 0.0f && t * t < glm::length2(line.GetEnd() - line.GetStart());
+
+			return true;
 		}
 
 
-		bool RayAndCircle(const Ray2D& ray, const Circle& circle)
+		bool RayAndCircle(const Ray2D& ray, const WorldCircle& circle)
 		{
 			// TODO: IMPLEMENT ME!!
 			return false;
 		}
 
-		bool RayAndBox2D(const Ray2D& ray, const Box2D& box)
+		bool RayAndBox2D(const Ray2D& ray, const WorldBox2D& box)
 		{
 			// TODO: IMPLEMENT ME!!
 			return false;
 		}
 
-		bool RayAndAABB(const Ray2D& ray, const AABB& box)
+		bool RayAndAABB(const Ray2D& ray, const WorldAABB& box)
 		{
-			glm::vec2 min = JP2::GetMin(box);
-			glm::vec2 max = JP2::GetMax(box);
+			glm::vec2 min = box.m_Min;
+			glm::vec2 max = box.m_Max;
 			glm::vec2 origin = ray.m_Origin;
 			glm::vec2 dir = ray.m_Direction;
 			float maxDistance = ray.m_MaxDistance;
@@ -208,32 +220,32 @@ namespace Cocoa
 		}
 
 
-		bool CircleAndLine(const Circle& circle, const Line2D& line)
+		bool CircleAndLine(const WorldCircle& circle, const Line2D& line)
 		{
 			return LineAndCircle(line, circle);
 		}
 
-		bool CircleAndRay(const Circle& circle, const Ray2D& ray)
+		bool CircleAndRay(const WorldCircle& circle, const Ray2D& ray)
 		{
 			return RayAndCircle(ray, circle);
 		}
 
-		bool CircleAndCircle(const Circle& c1, const Circle& c2)
+		bool CircleAndCircle(const WorldCircle& c1, const WorldCircle& c2)
 		{
-			glm::vec2 lineBetweenCenters = JP2::GetCenter(c1) - JP2::GetCenter(c2);
+			glm::vec2 lineBetweenCenters = c1.m_Center - c2.m_Center;
 			float radiiSum = c1.m_Radius + c2.m_Radius;
 			return glm::length2(lineBetweenCenters) <= radiiSum * radiiSum;
 		}
 
-		bool CircleAndBox2D(const Circle& circle, const Box2D& box)
+		bool CircleAndBox2D(const WorldCircle& circle, const WorldBox2D& box)
 		{
 			// Treat the box as if it was located at halfSize.x, halfSize.y
 			glm::vec2 min{};
 			glm::vec2 max = box.m_HalfSize * 2.0f;
 
 			// Create a circle in box's local space
-			glm::vec2 r = JP2::GetCenter(circle) - JP2::GetCenter(box);
-			CMath::Rotate(r, -JP2::GetRotation(box), glm::vec2{});
+			glm::vec2 r = circle.m_Center - box.m_Center;
+			CMath::Rotate(r, -box.m_Rotation, glm::vec2{});
 			glm::vec2 localCirclePos = r + box.m_HalfSize;
 
 			glm::vec2 closestPointToCircle = localCirclePos;
@@ -259,14 +271,14 @@ namespace Cocoa
 			return glm::length2(line) <= circle.m_Radius * circle.m_Radius;
 		}
 
-		bool CircleAndAABB(const Circle& circle, const AABB& box)
+		bool CircleAndAABB(const WorldCircle& circle, const WorldAABB& box)
 		{
 			// Treat the box as if it was located at halfSize.x, halfSize.y
 			glm::vec2 min{};
-			glm::vec2 max = box.m_HalfSize * 2.0f;
+			glm::vec2 max = box.m_Max - box.m_Min;
 
 			// Create a circle in box's local space
-			glm::vec2 localCirclePos = JP2::GetCenter(circle) - JP2::GetCenter(box);
+			glm::vec2 localCirclePos = circle.m_Center - box.m_Min;
 
 			glm::vec2 closestPointToCircle = localCirclePos;
 			if (closestPointToCircle.x < min.x)
@@ -292,71 +304,71 @@ namespace Cocoa
 		}
 
 
-		bool AABBAndCircle(const AABB& box, const Circle& circle)
+		bool AABBAndCircle(const WorldAABB& box, const WorldCircle& circle)
 		{
 			return CircleAndAABB(circle, box);
 		}
 
-		bool AABBAndRay(const AABB& box, const Ray2D& ray)
+		bool AABBAndRay(const WorldAABB& box, const Ray2D& ray)
 		{
 			return RayAndAABB(ray, box);
 		}
 
-		bool AABBAndLine(const AABB& box, const Line2D& line)
+		bool AABBAndLine(const WorldAABB& box, const Line2D& line)
 		{
 			return LineAndAABB(line, box);
 		}
 
-		bool AABBAndAABB(const AABB& b1, const AABB& b2)
+		bool AABBAndAABB(const WorldAABB& b1, const WorldAABB& b2)
 		{
 			// TODO: IMPLEMENT ME
 			return false;
 		}
 
-		bool AABBAndBox2D(const AABB& b1, const Box2D b2)
+		bool AABBAndBox2D(const WorldAABB& b1, const WorldBox2D& b2)
 		{
 			// TODO: IMPLEMENT ME
 			return false;
 		}
 
 
-		bool Box2DAndCircle(const Box2D& box, const Circle& circle)
+		bool Box2DAndCircle(const WorldBox2D& box, const WorldCircle& circle)
 		{
 			return CircleAndBox2D(circle, box);
 		}
 
-		bool Box2DAndRay(const Box2D& box, const Ray2D& ray)
+		bool Box2DAndRay(const WorldBox2D& box, const Ray2D& ray)
 		{
 			return RayAndBox2D(ray, box);
 		}
 
-		bool Box2DAndLine(const Box2D& box, const Line2D& line)
+		bool Box2DAndLine(const WorldBox2D& box, const Line2D& line)
 		{
 			return LineAndBox2D(line, box);
 		}
 
-		bool Box2DAndAABB(const Box2D& b1, const AABB& b2)
+		bool Box2DAndAABB(const WorldBox2D& b1, const WorldAABB& b2)
 		{
 			// TODO: IMPLEMENT ME
 			return false;
 		}
 
-		bool Box2DAndBox2D(const Box2D& b1, const Box2D& b2)
+		bool Box2DAndBox2D(const WorldBox2D& b1, const WorldBox2D& b2)
 		{
 			// Generate all the axes to test from box one and box two
 			glm::vec2 boxOneUp{ 0, b1.m_HalfSize.y };
 			glm::vec2 boxOneRight{ b1.m_HalfSize.x, 0 };
-			CMath::Rotate(boxOneUp, JP2::GetRotation(b1), glm::vec2{});
-			CMath::Rotate(boxOneRight, JP2::GetRotation(b1), glm::vec2{});
+			CMath::Rotate(boxOneUp, b1.m_Rotation, glm::vec2{});
+			CMath::Rotate(boxOneRight, b1.m_Rotation, glm::vec2{});
 
 			glm::vec2 boxTwoUp{ 0, b2.m_HalfSize.y };
 			glm::vec2 boxTwoRight{ b2.m_HalfSize.x, 0 };
-			CMath::Rotate(boxTwoUp, JP2::GetRotation(b2), glm::vec2{});
-			CMath::Rotate(boxTwoRight, JP2::GetRotation(b2), glm::vec2{});
+			CMath::Rotate(boxTwoUp, b2.m_Rotation, glm::vec2{});
+			CMath::Rotate(boxTwoRight, b2.m_Rotation, glm::vec2{});
 
 			// Test whether the boxes are intersecting on all axes (including global up and right axes)
 			std::array<glm::vec2, 4> axisToTest { boxOneUp, boxOneRight, boxTwoUp, boxTwoRight };
-			glm::vec2 toCenter = JP2::GetCenter(b2) - JP2::GetCenter(b1);
+			glm::vec2 toCenter = b2.m_Center - b1.m_Center;
 			int axis = -1;
 			float overlap = std::numeric_limits<float>::max();
 			for (int i = 0; i < axisToTest.size(); i++)
@@ -65,7 +65,12 @@ namespace Cocoa
 		glEnableVertexAttribArray(4);
 	}
 
-	void RenderBatch::Add(const Transform& transform, const SpriteRenderer& spr)
+	void RenderBatch::Add(entt::entity entity, const Transform& transform, const SpriteRenderer& spr)
+	{
+		Add(entity, transform, spr, transform.m_WorldPosition, transform.m_WorldRotation);
+	}
+
+	void RenderBatch::Add(entt::entity entity, const Transform& transform, const SpriteRenderer& spr, const glm::vec3& position, float rotationDegrees)
 	{
 		m_NumSprites++;
 
@@ -80,7 +85,7 @@ namespace Cocoa
 			}
 		}
 
-		LoadVertexProperties(transform, spr);
+		LoadVertexProperties(entity, transform, spr, position, rotationDegrees);
 	}
 
 	void RenderBatch::Add(const glm::vec2& min, const glm::vec2& max, const glm::vec3& color)
@@ -151,13 +156,12 @@ namespace Cocoa
 		LoadVertexProperties(vec3Pos, scale, size, &texCoords[0], rotation, vec4Color, texId);
 	}
 
-	void RenderBatch::LoadVertexProperties(const Transform& transform, const SpriteRenderer& spr)
+	void RenderBatch::LoadVertexProperties(entt::entity entity, const Transform& transform, const SpriteRenderer& spr, const glm::vec3& position, float rotationDegrees)
 	{
 		glm::vec4 color = spr.m_Color;
 		const Sprite& sprite = spr.m_Sprite;
 		const glm::vec2* texCoords = spr.m_Sprite.m_TexCoords;
 		glm::vec2 quadSize{ sprite.m_Width, sprite.m_Height };
-		float rotation = transform.m_EulerRotation.z;
 
 		int texId = 0;
 		if (sprite.m_Texture != TextureHandle::null)
@@ -172,8 +176,7 @@ namespace Cocoa
 			}
 		}
 
-		Entity res = Entity::FromComponent<Transform>(transform);
-		LoadVertexProperties(transform.m_Position, transform.m_Scale, quadSize, texCoords, rotation, color, texId, res.GetID());
+		LoadVertexProperties(position, transform.m_WorldScale, quadSize, texCoords, rotationDegrees, color, texId, (uint32)entt::to_integral(entity));
 	}
 
 	void RenderBatch::LoadVertexProperties(const glm::vec3& position, const glm::vec3& scale, const glm::vec2& quadSize, const glm::vec2* texCoords,
@@ -3,6 +3,7 @@
 #include "cocoa/renderer/Shader.h"
 #include "cocoa/util/Log.h"
 #include "cocoa/core/Core.h"
+#include "cocoa/file/IFile.h"
 
 namespace Cocoa
 {
@@ -17,26 +18,6 @@ namespace Cocoa
 		return 0;
 	}
 
-	static std::string ReadFile(const char* filepath)
-	{
-		std::string result;
-		std::ifstream in(filepath, std::ios::in | std::ios::binary);
-		if (in)
-		{
-			in.seekg(0, std::ios::end);
-			result.resize(in.tellg());
-			in.seekg(0, std::ios::beg);
-			in.read(&result[0], result.size());
-			in.close();
-		}
-		else
-		{
-			Log::Error("Could not open file: '%s'", filepath);
-		}
-
-		return result;
-	}
-
 	Shader::Shader(const CPath& resourceName)
 	{
 		m_BeingUsed = false;
@@ -45,24 +26,30 @@ namespace Cocoa
 
 	void Shader::Compile(const char* filepath)
 	{
-		std::string fileSource = ReadFile(filepath);
+		File* file = IFile::OpenFile(CPath(filepath));
+		if (!file->m_Open)
+		{
+			Log::Error("Could not open file: '%s'", filepath);
+		}
 
-		std::unordered_map<GLenum, std::string> shaderSources;
+		// Every stage is a view into the file, GL gets the lengths so nothing needs to be null terminated
+		std::string_view fileSource = file->m_Data;
+		std::unordered_map<GLenum, std::string_view> shaderSources;
 
 		const char* typeToken = "#type";
 		size_t typeTokenLength = strlen(typeToken);
 		size_t pos = fileSource.find(typeToken, 0);
-		while (pos != std::string::npos)
+		while (pos != std::string_view::npos)
 		{
 			size_t eol = fileSource.find_first_of("\r\n", pos);
-			Log::Assert(eol != std::string::npos, "Syntax error");
+			Log::Assert(eol != std::string_view::npos, "Syntax error");
 			size_t begin = pos + typeTokenLength + 1;
-			std::string type = fileSource.substr(begin, eol - begin);
+			std::string type = std::string(fileSource.substr(begin, eol - begin));
 			Log::Assert(ShaderTypeFromString(type), "Invalid shader type specified.");
 
 			size_t nextLinePos = fileSource.find_first_not_of("\r\n", eol);
 			pos = fileSource.find(typeToken, nextLinePos);
-			shaderSources[ShaderTypeFromString(type)] = fileSource.substr(nextLinePos, pos - (nextLinePos == std::string::npos ? fileSource.size() - 1 : nextLinePos));
+			shaderSources[ShaderTypeFromString(type)] = fileSource.substr(nextLinePos, pos - (nextLinePos == std::string_view::npos ? fileSource.size() - 1 : nextLinePos));
 		}
 
 		GLuint program = glCreateProgram();
@@ -73,15 +60,15 @@ namespace Cocoa
 		for (auto& kv : shaderSources)
 		{
 			GLenum shaderType = kv.first;
-			const std::string& source = kv.second;
+			std::string_view source = kv.second;
 
 			// Create an empty vertex shader handle
 			GLuint shader = glCreateShader(shaderType);
 
 			// Send the vertex shader source code to GL
-			// Note that std::string's .c_str is NULL character terminated.
-			const GLchar* sourceCStr = source.c_str();
-			glShaderSource(shader, 1, &sourceCStr, 0);
+			const GLchar* sourceCStr = source.data();
+			GLint sourceLength = (GLint)source.size();
+			glShaderSource(shader, 1, &sourceCStr, &sourceLength);
 
 			// Compile the vertex shader
 			glCompileShader(shader);
@@ -102,6 +89,7 @@ namespace Cocoa
 
 				Log::Error("%s", infoLog.data());
 				Log::Assert(false, "Shader compilation failed!");
+				IFile::CloseFile(file);
 				return;
 			}
 
@@ -109,6 +97,9 @@ namespace Cocoa
 			glShaderIDs[glShaderIDIndex++] = shader;
 		}
 
+		// GL keeps its own copy of the sources once glShaderSource returns
+		IFile::CloseFile(file);
+
 		// Link our program
 		glLinkProgram(program);
 
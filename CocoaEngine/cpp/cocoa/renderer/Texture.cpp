@@ -2,6 +2,8 @@
 
 #include "cocoa/renderer/Texture.h"
 #include "cocoa/util/Log.h"
+#include "cocoa/file/IFile.h"
+#include "cocoa/core/ImportCache.h"
 #include "cocoa/physics2d/Physics2D.h"
 #include "cocoa/physics2d/Physics2DSystem.h"
 
@@ -47,19 +49,28 @@ namespace Cocoa
 
 	void Texture::Load()
 	{
-		int channels;
-		int width;
-		int height;
+		// Decoding reads straight out of the mapped file (or the mapped pack archive when it's mounted)
+		File* sourceFile = IFile::OpenFile(m_Path);
+		std::string_view sourceData = sourceFile->m_Data;
 
-		m_PixelBuffer = stbi_load(m_Path.Filepath(), &width, &height, &channels, 0);
-		Log::Assert((m_PixelBuffer != nullptr), "STB failed to load image: %s\n-> STB Failure Reason: %s", m_Path.Filepath(), stbi_failure_reason());
+		// Unchanged textures skip decoding and the bounding box pass entirely
+		TextureImportData imported;
+		if (!ImportCache::LoadTexture(m_Path, sourceData, imported))
+		{
+			imported.m_Pixels = stbi_load_from_memory((const stbi_uc*)sourceData.data(), (int)sourceData.size(), &imported.m_Width, &imported.m_Height, &imported.m_Channels, 0);
+			Log::Assert((imported.m_Pixels != nullptr), "STB failed to load image: %s\n-> STB Failure Reason: %s", m_Path.Filepath(), stbi_failure_reason());
 
-		m_Width = width;
-		m_Height = height;
-		m_BytesPerPixel = channels;
+			// Generate bounding box for this texture, this can be attached to any object using this texture
+			imported.m_BoundingBox = Physics2D::GetBoundingBoxForPixels(imported.m_Pixels, imported.m_Width, imported.m_Height, imported.m_Channels);
+			ImportCache::StoreTexture(m_Path, sourceData, imported);
+		}
+		IFile::CloseFile(sourceFile);
 
-		// Generate bounding box for this texture, this can be attached to any object using this texture
-		m_BoundingBox = Physics2D::GetBoundingBoxForPixels(m_PixelBuffer, width, height, channels);
+		m_PixelBuffer = imported.m_Pixels;
+		m_Width = imported.m_Width;
+		m_Height = imported.m_Height;
+		m_BytesPerPixel = imported.m_Channels;
+		m_BoundingBox = imported.m_BoundingBox;
 
 		glGenTextures(1, &m_ID);
 		glBindTexture(GL_TEXTURE_2D, m_ID);
@@ -69,17 +80,17 @@ namespace Cocoa
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
-		if (channels == 4)
+		if (m_BytesPerPixel == 4)
 		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_PixelBuffer);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_PixelBuffer);
 		}
-		else if (channels == 3)
+		else if (m_BytesPerPixel == 3)
 		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, m_PixelBuffer);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, m_Width, m_Height, 0, GL_RGB, GL_UNSIGNED_BYTE, m_PixelBuffer);
 		}
 		else
 		{
-			Log::Assert(false, "Unknown number of channels '%d'. In File: '%s'", channels, m_Path.Filepath());
+			Log::Assert(false, "Unknown number of channels '%d'. In File: '%s'", m_BytesPerPixel, m_Path.Filepath());
 		}
 
 		GLenum error = glGetError();
@@ -0,0 +1,71 @@
+#include "cocoa/scenes/ChangeTracker.h"
+
+namespace Cocoa
+{
+	void ChangeTracker::Connect(entt::registry& registry)
+	{
+		SceneComponents::ForEach([&](auto tag)
+		{
+			using Component = typename decltype(tag)::Type;
+			registry.on_construct<Component>().template connect<&ChangeTracker::OnChanged<Component>>(*this);
+			registry.on_update<Component>().template connect<&ChangeTracker::OnChanged<Component>>(*this);
+			registry.on_destroy<Component>().template connect<&ChangeTracker::OnChanged<Component>>(*this);
+		});
+	}
+
+	void ChangeTracker::Disconnect(entt::registry& registry)
+	{
+		SceneComponents::ForEach([&](auto tag)
+		{
+			using Component = typename decltype(tag)::Type;
+			registry.on_construct<Component>().disconnect(*this);
+			registry.on_update<Component>().disconnect(*this);
+			registry.on_destroy<Component>().disconnect(*this);
+		});
+	}
+
+	void ChangeTracker::EndFrame()
+	{
+		m_Frame++;
+		for (ChangeSet& set : m_Sets)
+		{
+			set.m_Frames[m_Frame % HISTORY_FRAMES].clear();
+		}
+	}
+
+	void ChangeTracker::MarkChanged(entt::entity entity, uint32 componentMask)
+	{
+		for (size_t type = 0; type < SceneComponents::COUNT; type++)
+		{
+			if (componentMask & (1u << type))
+			{
+				Record(type, entity);
+			}
+		}
+	}
+
+	void ChangeTracker::Record(size_t type, entt::entity entity)
+	{
+		if (entity == entt::null)
+		{
+			return;
+		}
+
+		ChangeSet& set = m_Sets[type];
+		size_t index = IndexOf(entity);
+		if (index >= set.m_ByIndex.size())
+		{
+			set.m_ByIndex.resize(index + 1);
+		}
+
+		Change& change = set.m_ByIndex[index];
+		if (change.m_Entity == entity && change.m_Frame == m_Frame)
+		{
+			return;
+		}
+
+		change.m_Entity = entity;
+		change.m_Frame = m_Frame;
+		set.m_Frames[m_Frame % HISTORY_FRAMES].push_back(entity);
+	}
+}
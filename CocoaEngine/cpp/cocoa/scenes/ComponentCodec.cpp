@@ -0,0 +1,191 @@
+#include "cocoa/scenes/ComponentCodec.h"
+#include "cocoa/systems/RenderSystem.h"
+#include "cocoa/file/JsonWriter.h"
+#include "cocoa/util/CMath.h"
+#include "cocoa/util/Log.h"
+
+namespace Cocoa
+{
+	static void SetAxis(glm::vec2& vec, int axis, const json& value)
+	{
+		if (axis >= 0 && axis < 2) vec[axis] = value.get<float>();
+	}
+
+	static void SetAxis(glm::vec3& vec, int axis, const json& value)
+	{
+		if (axis >= 0 && axis < 3) vec[axis] = value.get<float>();
+	}
+
+	static void SetAxis(glm::vec4& vec, int axis, const json& value)
+	{
+		if (axis >= 0 && axis < 4) vec[axis] = value.get<float>();
+	}
+
+	// ===================================================================================
+	// Transform
+	// ===================================================================================
+	void ComponentCodec<Transform>::Write(JsonWriter& writer, uint32 entity, const Transform& transform, uint32 resourceId)
+	{
+		writer.Key("Entity");
+		writer.UInt(entity);
+		// Roots leave it out, so scenes without a hierarchy are saved exactly like before
+		if (transform.m_Parent != entt::null)
+		{
+			writer.Key("Parent");
+			writer.UInt((uint32)entt::to_integral(transform.m_Parent));
+		}
+		CMath::Serialize(writer, "Position", transform.m_Position);
+		CMath::Serialize(writer, "Rotation", transform.m_EulerRotation);
+		CMath::Serialize(writer, "Scale", transform.m_Scale);
+	}
+
+	void ComponentCodec<Transform>::ReadField(Transform& transform, uint32 field, int axis, const json& value, uint32& resourceId)
+	{
+		switch (field)
+		{
+		case HashComponentName("Parent"): transform.m_Parent = entt::entity(value.get<uint32>()); break;
+		case HashComponentName("Position"): SetAxis(transform.m_Position, axis, value); break;
+		case HashComponentName("Rotation"): SetAxis(transform.m_EulerRotation, axis, value); break;
+		case HashComponentName("Scale"): SetAxis(transform.m_Scale, axis, value); break;
+		}
+	}
+
+	// ===================================================================================
+	// Rigidbody2D
+	// ===================================================================================
+	void ComponentCodec<Rigidbody2D>::Write(JsonWriter& writer, uint32 entity, const Rigidbody2D& rigidbody, uint32 resourceId)
+	{
+		writer.Key("AngularDamping");
+		writer.Float(rigidbody.m_AngularDamping);
+		writer.Key("ContinousCollision");
+		writer.Bool(rigidbody.m_ContinuousCollision);
+		writer.Key("Entity");
+		writer.UInt(entity);
+		writer.Key("FixedRotation");
+		writer.Bool(rigidbody.m_FixedRotation);
+		writer.Key("LinearDamping");
+		writer.Float(rigidbody.m_LinearDamping);
+		writer.Key("Mass");
+		writer.Float(rigidbody.m_Mass);
+		CMath::Serialize(writer, "Velocity", rigidbody.m_Velocity);
+	}
+
+	void ComponentCodec<Rigidbody2D>::ReadField(Rigidbody2D& rigidbody, uint32 field, int axis, const json& value, uint32& resourceId)
+	{
+		switch (field)
+		{
+		case HashComponentName("AngularDamping"): rigidbody.m_AngularDamping = value.get<float>(); break;
+		case HashComponentName("ContinousCollision"): rigidbody.m_ContinuousCollision = value.get<bool>(); break;
+		case HashComponentName("FixedRotation"): rigidbody.m_FixedRotation = value.get<bool>(); break;
+		case HashComponentName("LinearDamping"): rigidbody.m_LinearDamping = value.get<float>(); break;
+		case HashComponentName("Mass"): rigidbody.m_Mass = value.get<float>(); break;
+		case HashComponentName("Velocity"): SetAxis(rigidbody.m_Velocity, axis, value); break;
+		}
+	}
+
+	// ===================================================================================
+	// Box2D
+	// ===================================================================================
+	void ComponentCodec<Box2D>::Write(JsonWriter& writer, uint32 entity, const Box2D& box, uint32 resourceId)
+	{
+		writer.Key("Entity");
+		writer.UInt(entity);
+		CMath::Serialize(writer, "HalfSize", box.m_HalfSize);
+	}
+
+	void ComponentCodec<Box2D>::ReadField(Box2D& box, uint32 field, int axis, const json& value, uint32& resourceId)
+	{
+		if (field == HashComponentName("HalfSize"))
+		{
+			SetAxis(box.m_HalfSize, axis, value);
+		}
+	}
+
+	// ===================================================================================
+	// SpriteRenderer
+	// ===================================================================================
+	void ComponentCodec<SpriteRenderer>::Write(JsonWriter& writer, uint32 entity, const SpriteRenderer& spriteRenderer, uint32 resourceId)
+	{
+		writer.Key("AssetId");
+		writer.UInt(resourceId);
+		CMath::Serialize(writer, "Color", spriteRenderer.m_Color);
+		writer.Key("Entity");
+		writer.UInt(entity);
+		writer.Key("ZIndex");
+		writer.Int(spriteRenderer.m_ZIndex);
+	}
+
+	void ComponentCodec<SpriteRenderer>::ReadField(SpriteRenderer& spriteRenderer, uint32 field, int axis, const json& value, uint32& resourceId)
+	{
+		switch (field)
+		{
+		case HashComponentName("AssetId"): resourceId = value.get<uint32>(); break;
+		case HashComponentName("Color"): SetAxis(spriteRenderer.m_Color, axis, value); break;
+		case HashComponentName("ZIndex"): spriteRenderer.m_ZIndex = value.get<int>(); break;
+		}
+	}
+
+	uint32 ComponentCodec<SpriteRenderer>::GetResourceId(const SpriteRenderer& spriteRenderer)
+	{
+		return RenderSystem::GetTextureResourceId(spriteRenderer);
+	}
+
+	void ComponentCodec<SpriteRenderer>::SetResourceId(SpriteRenderer& spriteRenderer, uint32 assetId)
+	{
+		spriteRenderer.m_Sprite.m_Texture = TextureHandle(assetId);
+	}
+
+	// ===================================================================================
+	// AABB
+	// ===================================================================================
+	void ComponentCodec<AABB>::Write(JsonWriter& writer, uint32 entity, const AABB& box, uint32 resourceId)
+	{
+		writer.Key("Entity");
+		writer.UInt(entity);
+		CMath::Serialize(writer, "HalfSize", box.m_HalfSize);
+		CMath::Serialize(writer, "Offset", box.m_Offset);
+	}
+
+	void ComponentCodec<AABB>::ReadField(AABB& box, uint32 field, int axis, const json& value, uint32& resourceId)
+	{
+		switch (field)
+		{
+		case HashComponentName("HalfSize"): SetAxis(box.m_HalfSize, axis, value); break;
+		case HashComponentName("Offset"): SetAxis(box.m_Offset, axis, value); break;
+		}
+	}
+
+	// ===================================================================================
+	// Registry
+	// ===================================================================================
+	int ComponentRegistry::Find(std::string_view name)
+	{
+		static const std::unordered_map<uint32, int> indices = []()
+		{
+			std::unordered_map<uint32, int> result;
+			int index = 0;
+			SceneComponents::ForEach([&](auto tag)
+			{
+				using Component = typename decltype(tag)::Type;
+				bool inserted = result.emplace(HashComponentName(ComponentCodec<Component>::NAME), index++).second;
+				Log::Assert(inserted, "Component name '%s' collides with another component.", ComponentCodec<Component>::NAME);
+			});
+			return result;
+		}();
+
+		auto it = indices.find(HashComponentName(name));
+		if (it == indices.end())
+		{
+			return -1;
+		}
+
+		// A script could still hash the same as an engine component
+		int index = it->second;
+		bool matches = false;
+		SceneComponents::Visit(index, [&](auto tag)
+		{
+			matches = name == ComponentCodec<typename decltype(tag)::Type>::NAME;
+		});
+		return matches ? index : -1;
+	}
+}
@@ -0,0 +1,82 @@
+#include "cocoa/scenes/Prefab.h"
+
+namespace Cocoa
+{
+	Prefab Prefab::FromEntity(const entt::registry& registry, entt::entity root)
+	{
+		Prefab prefab;
+		if (!registry.valid(root))
+		{
+			return prefab;
+		}
+
+		// One pass over the pool builds the child lists, then the walk down from root only visits its own
+		// descendants. Parents always come before their children
+		std::unordered_map<entt::entity, std::vector<entt::entity>> children;
+		auto view = registry.view<const Transform>();
+		const Transform* transforms = view.raw();
+		const entt::entity* transformEntities = view.data();
+		for (size_t i = 0; i < view.size(); i++)
+		{
+			if (transforms[i].m_Parent != entt::null)
+			{
+				children[transforms[i].m_Parent].push_back(transformEntities[i]);
+			}
+		}
+
+		std::unordered_map<entt::entity, uint32> indices;
+		std::vector<entt::entity> entities = { root };
+		indices[root] = 0;
+		for (size_t next = 0; next < entities.size(); next++)
+		{
+			auto it = children.find(entities[next]);
+			if (it == children.end())
+			{
+				continue;
+			}
+
+			for (entt::entity child : it->second)
+			{
+				// Loops are only cut at the next TransformHierarchy::Update
+				if (indices.find(child) == indices.end())
+				{
+					indices[child] = (uint32)entities.size();
+					entities.push_back(child);
+				}
+			}
+		}
+		prefab.m_EntityCount = (uint32)entities.size();
+
+		SceneComponents::ForEach([&](auto tag)
+		{
+			using Component = typename decltype(tag)::Type;
+			ComponentColumn<Component>& column = std::get<ComponentColumn<Component>>(prefab.m_Columns);
+			for (uint32 i = 0; i < prefab.m_EntityCount; i++)
+			{
+				const Component* component = registry.try_get<Component>(entities[i]);
+				if (component == nullptr)
+				{
+					continue;
+				}
+
+				column.m_Entities.push_back(entt::entity(i));
+				column.m_Components.push_back(*component);
+				Component& copy = column.m_Components.back();
+				if constexpr (std::is_same_v<Component, Transform>)
+				{
+					if (i > 0)
+					{
+						copy.m_Parent = entt::entity(indices[copy.m_Parent]);
+					}
+				}
+				else if constexpr (std::is_same_v<Component, Rigidbody2D>)
+				{
+					// Copies get bodies of their own
+					copy.m_RawRigidbody = nullptr;
+				}
+			}
+		});
+
+		return prefab;
+	}
+}
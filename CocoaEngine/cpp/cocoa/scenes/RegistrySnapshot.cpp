@@ -0,0 +1,108 @@
+#include "cocoa/scenes/RegistrySnapshot.h"
+#include "cocoa/scenes/Scene.h"
+#include "cocoa/scenes/SceneReader.h"
+#include "cocoa/systems/ScriptSystem.h"
+
+namespace Cocoa
+{
+	static size_t IndexOf(entt::entity entity)
+	{
+		return (size_t)(entt::to_integral(entity) & entt::entt_traits<std::underlying_type_t<entt::entity>>::entity_mask);
+	}
+
+	void RegistrySnapshot::Capture(entt::registry& registry, ScriptSystem* scriptSystem)
+	{
+		m_Entities.clear();
+		m_Entities.reserve(registry.alive());
+		registry.each([&](entt::entity entity)
+		{
+			m_Entities.push_back(entity);
+		});
+
+		RegistryComponents::ForEach([&](auto tag)
+		{
+			using Component = typename decltype(tag)::Type;
+			ComponentColumn<Component>& column = std::get<ComponentColumn<Component>>(m_Columns);
+			auto view = registry.view<Component>();
+			column.m_Entities.assign(view.data(), view.data() + view.size());
+			column.m_Components.assign(view.raw(), view.raw() + view.size());
+		});
+
+		m_Scripts = {
+			{"Size", 0},
+			{"Components", {}}
+		};
+		if (scriptSystem != nullptr)
+		{
+			scriptSystem->SaveScripts(m_Scripts);
+		}
+		m_Captured = true;
+	}
+
+	void RegistrySnapshot::Restore(Scene* scene, ScriptSystem* scriptSystem)
+	{
+		entt::registry& registry = scene->GetRegistry();
+
+		// Captured entities by index, anything alive that doesn't match was created after the capture
+		size_t maxIndex = 0;
+		for (entt::entity entity : m_Entities)
+		{
+			maxIndex = std::max(maxIndex, IndexOf(entity));
+		}
+		std::vector<entt::entity> captured(maxIndex + 1, entt::null);
+		for (entt::entity entity : m_Entities)
+		{
+			captured[IndexOf(entity)] = entity;
+		}
+
+		std::vector<entt::entity> created;
+		registry.each([&](entt::entity entity)
+		{
+			size_t index = IndexOf(entity);
+			if (index >= captured.size() || captured[index] != entity)
+			{
+				created.push_back(entity);
+			}
+		});
+		registry.destroy(created.begin(), created.end());
+
+		for (entt::entity entity : m_Entities)
+		{
+			if (!registry.valid(entity))
+			{
+				registry.create(entity);
+			}
+		}
+
+		RegistryComponents::ForEach([&](auto tag)
+		{
+			registry.clear<typename decltype(tag)::Type>();
+		});
+
+		// Whatever is left is script components and anything else the engine can't copy, the script
+		// module puts its components back below
+		for (entt::entity entity : m_Entities)
+		{
+			if (!registry.orphan(entity))
+			{
+				registry.remove_all(entity);
+			}
+		}
+
+		RegistryComponents::ForEach([&](auto tag)
+		{
+			using Component = typename decltype(tag)::Type;
+			const ComponentColumn<Component>& column = std::get<ComponentColumn<Component>>(m_Columns);
+			if (column.Size() > 0)
+			{
+				registry.insert<Component>(column.m_Entities.begin(), column.m_Entities.end(), column.m_Components.begin(), column.m_Components.end());
+			}
+		});
+
+		if (scriptSystem != nullptr)
+		{
+			SceneReader::InsertScripts(m_Scripts, scene, scriptSystem);
+		}
+		m_Captured = false;
+	}
+}
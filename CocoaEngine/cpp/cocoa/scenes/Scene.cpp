@@ -1,12 +1,23 @@
 #include "cocoa/scenes/Scene.h"
 
-#include "cocoa/file/OutputArchive.h"
 #include "cocoa/file/IFile.h"
 #include "cocoa/util/Settings.h"
 #include "cocoa/core/Entity.h"
 #include "cocoa/components/Transform.h"
 #include "cocoa/systems/ScriptSystem.h"
 #include "cocoa/scenes/SceneInitializer.h"
+#include "cocoa/scenes/SceneWriter.h"
+#include "cocoa/scenes/SceneBinary.h"
+#include "cocoa/scenes/SceneReader.h"
+#include "cocoa/scenes/SceneJournal.h"
+#include "cocoa/scenes/ChangeTracker.h"
+#include "cocoa/scenes/WorldPartition.h"
+#include "cocoa/scenes/Prefab.h"
+#include "cocoa/scenes/RegistrySnapshot.h"
+#include "cocoa/commands/CommandHistory.h"
+#include "cocoa/physics2d/Physics2D.h"
+#include "cocoa/renderer/DebugDraw.h"
+#include "cocoa/events/Input.h"
 
 #include <nlohmann/json.hpp>
 
@@ -19,16 +30,30 @@ namespace Cocoa
 		m_ShowDemoWindow = false;
 		m_Camera = nullptr;
 		m_IsPlaying = false;
+		m_NeedsFullSave = true;
 
 		m_Registry = entt::registry();
+		m_Changes = std::make_unique<ChangeTracker>();
+		m_Changes->Connect(m_Registry);
+		m_Physics = std::make_unique<Physics2D>(this);
+		m_Partition = std::make_unique<WorldPartition>(this);
+		m_PlaySnapshot = std::make_unique<RegistrySnapshot>();
 		m_Systems = std::vector<std::unique_ptr<System>>();
 	}
 
+	Scene::~Scene()
+	{
+		m_Partition.reset();
+		m_Physics.reset();
+		m_Changes->Disconnect(m_Registry);
+	}
+
 	Entity Scene::CreateEntity()
 	{
 		entt::entity e = m_Registry.create();
 		Entity entity = Entity(e, this);
 		entity.AddComponent<Transform>();
+		MarkDirty(e, SceneComponents::ALL_BITS);
 		return entity;
 	}
 
@@ -39,16 +64,22 @@ namespace Cocoa
 		glm::vec3 cameraPos = glm::vec3(0.0f, 0.0f, 0);
 		m_Camera = new Camera(cameraPos);
 
-		Physics2D::SetScene(this);
-		Input::SetScene(this);
-		Entity::SetScene(this);
-
 		m_Systems.emplace_back(std::make_unique<RenderSystem>("Render System", this));
 		m_Systems.emplace_back(std::make_unique<Physics2DSystem>("Physics2D System", this));
 		m_Systems.emplace_back(std::make_unique<ScriptSystem>("Script System", this));
 		m_SceneInitializer->Init(this, m_Systems);
 	}
 
+	void Scene::Activate()
+	{
+		Input::SetScene(this);
+		DebugDraw::Init(this);
+		CommandHistory::SetChangeCallback([this](uint32 entity, uint32 componentMask)
+		{
+			MarkDirty(entt::entity(entity), componentMask);
+		});
+	}
+
 	void Scene::Start()
 	{
 		for (const auto& system : m_Systems)
@@ -59,19 +90,32 @@ namespace Cocoa
 
 	void Scene::Update(float dt)
 	{
-		Physics2D::Get()->Update(dt);
-		for (const auto& system : m_Systems)
-		{
-			system->Update(dt);
-		}
+		UpdatePartition();
+		// Physics steps in Physics2DSystem::Update, which the scheduler runs ahead of the scripts
+		m_Scheduler.Update(m_Systems, dt);
+		// Once every system has moved what it moves, rendering reads the cached world data
+		m_TransformHierarchy.Update(m_Registry);
+		m_Changes->EndFrame();
 	}
 
 	void Scene::EditorUpdate(float dt)
 	{
+		UpdatePartition();
 		for (const auto& system : m_Systems)
 		{
 			system->EditorUpdate(dt);
 		}
+		m_TransformHierarchy.Update(m_Registry);
+		m_Changes->EndFrame();
+	}
+
+	void Scene::UpdatePartition()
+	{
+		if (m_Partition->IsOpen() && m_Camera != nullptr)
+		{
+			const glm::vec3& position = m_Camera->GetTransform().m_Position;
+			m_Partition->Update({ glm::vec2(position.x, position.y) });
+		}
 	}
 
 	void Scene::Render()
@@ -84,29 +128,90 @@ namespace Cocoa
 
 	Entity Scene::DuplicateEntity(Entity entity)
 	{
-		entt::entity newEntEntity = m_Registry.create();
-		Entity newEntity = Entity(newEntEntity, this);
-		if (entity.HasComponent<Transform>())
+		entt::entity copy = entt::null;
+		Instantiate(Prefab::FromEntity(m_Registry, entity.GetRawEntity()), 1, nullptr, &copy);
+		return Entity(copy, this);
+	}
+
+	void Scene::Instantiate(const Prefab& prefab, size_t count, const Transform* transforms, entt::entity* roots)
+	{
+		size_t size = prefab.GetEntityCount();
+		if (count == 0 || size == 0)
 		{
-			newEntity.AddComponent<Transform>(entity.GetComponent<Transform>());
+			return;
 		}
 
-		if (entity.HasComponent<SpriteRenderer>())
+		// Copy c's entity i ends up at c * size + i
+		std::vector<entt::entity> entities(count * size);
+		m_Registry.create(entities.begin(), entities.end());
+
+		SceneComponents::ForEach([&](auto tag)
 		{
-			newEntity.AddComponent<SpriteRenderer>(entity.GetComponent<SpriteRenderer>());
-		}
+			using Component = typename decltype(tag)::Type;
+			const ComponentColumn<Component>& prototypes = std::get<ComponentColumn<Component>>(prefab.m_Columns);
+			if (prototypes.Size() == 0)
+			{
+				return;
+			}
 
-		if (entity.HasComponent<Rigidbody2D>())
+			std::vector<entt::entity> columnEntities;
+			std::vector<Component> components;
+			columnEntities.reserve(prototypes.Size() * count);
+			components.reserve(prototypes.Size() * count);
+			for (size_t c = 0; c < count; c++)
+			{
+				const entt::entity* copy = entities.data() + c * size;
+				for (size_t i = 0; i < prototypes.Size(); i++)
+				{
+					uint32 index = (uint32)entt::to_integral(prototypes.m_Entities[i]);
+					columnEntities.push_back(copy[index]);
+					components.push_back(prototypes.m_Components[i]);
+					if constexpr (std::is_same_v<Component, Transform>)
+					{
+						Transform& transform = components.back();
+						if (index > 0)
+						{
+							transform.m_Parent = copy[entt::to_integral(transform.m_Parent)];
+						}
+						else if (transforms != nullptr)
+						{
+							transform = transforms[c];
+						}
+					}
+				}
+			}
+
+			m_Registry.reserve<Component>(m_Registry.size<Component>() + components.size());
+			m_Registry.insert<Component>(columnEntities.begin(), columnEntities.end(), components.begin(), components.end());
+		});
+
+		if (roots != nullptr)
 		{
-			newEntity.AddComponent<Rigidbody2D>(entity.GetComponent<Rigidbody2D>());
+			for (size_t c = 0; c < count; c++)
+			{
+				roots[c] = entities[c * size];
+			}
 		}
 
-		if (entity.HasComponent<Box2D>())
+		if (m_IsPlaying)
 		{
-			newEntity.AddComponent<Box2D>(entity.GetComponent<Box2D>());
+			// Bodies are created at their world pose. Nothing spawned during play is saved, so it isn't dirty
+			m_TransformHierarchy.Update(m_Registry);
+			for (entt::entity entity : entities)
+			{
+				if (m_Registry.has<Rigidbody2D>(entity))
+				{
+					m_Physics->AddEntity(Entity(entity, this));
+				}
+			}
+		}
+		else
+		{
+			for (entt::entity entity : entities)
+			{
+				MarkDirty(entity, SceneComponents::ALL_BITS);
+			}
 		}
-
-		return newEntity;
 	}
 
 	Entity Scene::GetEntity(uint32 id)
@@ -119,53 +224,180 @@ namespace Cocoa
 		return Entity(entity, this);
 	}
 
+	void Scene::MarkDirty(entt::entity entity, uint32 componentMask)
+	{
+		if (entity != entt::null && componentMask != 0)
+		{
+			m_DirtyComponents[entt::to_integral(entity)] |= componentMask;
+			m_Changes->MarkChanged(entity, componentMask);
+		}
+	}
+
 	void Scene::Play()
 	{
+		m_PlaySnapshot->Capture(m_Registry, GetScriptSystem());
+		m_PlayDirtyComponents = m_DirtyComponents;
+		m_PlayCells = m_Partition->GetActiveCells();
+
 		m_IsPlaying = true;
+		// Bodies are created at their world pose
+		m_TransformHierarchy.Update(m_Registry);
 		auto view = m_Registry.view<Transform>();
 		for (auto entity : view)
 		{
-			Physics2D::Get()->AddEntity(entity);
+			m_Physics->AddEntity(Entity(entity, this));
 		}
 	}
 
 	void Scene::Stop()
 	{
 		m_IsPlaying = false;
-		Physics2D::Get()->Destroy();
+		m_Physics->Destroy();
+		if (!m_PlaySnapshot->HasCapture())
+		{
+			return;
+		}
+
+		m_PlaySnapshot->Restore(this, GetScriptSystem());
+		m_DirtyComponents = m_PlayDirtyComponents;
+		m_Partition->RestoreActiveCells(m_PlayCells);
+	}
+
+	ScriptSystem* Scene::GetScriptSystem()
+	{
+		for (const auto& system : m_Systems)
+		{
+			if (strcmp(system->GetName(), "Script System") == 0)
+			{
+				return (ScriptSystem*)system.get();
+			}
+		}
+		return nullptr;
 	}
 
-	void Scene::Save(const CPath& filename)
+	void Scene::Save(const CPath& filename, bool compact)
 	{
 		Log::Info("Saving scene for %s", filename.Filepath());
-		m_SaveDataJson = {
-			{"Size", 0},
-			{"Components", {}},
-			{"Project", Settings::General::s_CurrentProject.Filepath()},
-			{"Assets", AssetManager::Serialize()}
-		};
 
-		OutputArchive output(m_SaveDataJson);
-		entt::snapshot{ m_Registry }
-			.entities(output)
-			.component<Transform, Rigidbody2D, Box2D, SpriteRenderer, AABB>(output);
+		// Only copy the data here, building the JSON and writing it happens on the scene writer thread
+		SceneSnapshot* snapshot = new SceneSnapshot();
+		snapshot->m_Filename = filename;
+		snapshot->m_Compact = compact;
+		snapshot->m_Project = Settings::General::s_CurrentProject.Filepath();
+		snapshot->m_Assets = AssetManager::Serialize();
 
+		SceneSnapshotArchive archive(*snapshot);
+		SceneComponents::Snapshot(m_Registry, archive);
+
+		// Scripts live in the script module, which may be unloaded by the time the writer gets to this
+		snapshot->m_Scripts = {
+			{"Size", 0},
+			{"Components", {}}
+		};
 		for (const auto& system : m_Systems)
 		{
 			if (strcmp(system.get()->GetName(), "Script System") == 0)
 			{
 				ScriptSystem* scriptSystem = (ScriptSystem*)system.get();
-				scriptSystem->SaveScripts(m_SaveDataJson);
+				scriptSystem->SaveScripts(snapshot->m_Scripts);
 				break;
 			}
 		}
 
-		IFile::WriteFile(m_SaveDataJson.dump(4).c_str(), filename);
+		// Entities in cells are saved with their cell
+		m_Partition->Save(snapshot->m_Scripts);
+		m_Partition->Strip(*snapshot);
+
+		SceneWriter::Submit(snapshot);
+
+		m_DirtyComponents.clear();
+		m_SavedFilename = filename;
+		m_NeedsFullSave = false;
+	}
+
+	bool Scene::HasUnsavedChanges() const
+	{
+		return m_DirtyComponents.size() > 0 || SceneJournal::NeedsFullSave(m_SavedFilename);
+	}
+
+	void Scene::SaveChanges(const CPath& filename)
+	{
+		bool scriptsChanged = false;
+		for (const auto& [entity, mask] : m_DirtyComponents)
+		{
+			scriptsChanged = scriptsChanged || (mask & SCRIPT_CHANGES);
+		}
+
+		// The journal only describes the scene file, cells are rewritten whole
+		// A broken journal drops every record after the broken one, and a failed append already lost its
+		// edits from m_DirtyComponents. A full save snapshots the whole registry, so it covers both
+		if (m_NeedsFullSave || scriptsChanged || m_Partition->IsOpen() || !m_SavedFilename.Equals(filename) || !IFile::IsFile(filename)
+			|| SceneJournal::NeedsFullSave(filename))
+		{
+			Save(filename);
+			return;
+		}
+
+		if (m_DirtyComponents.size() == 0)
+		{
+			return;
+		}
+
+		SceneSnapshot* delta = new SceneSnapshot();
+		delta->m_Filename = filename;
+		delta->m_Delta = true;
+		delta->m_Project = Settings::General::s_CurrentProject.Filepath();
+		delta->m_Assets = AssetManager::Serialize();
+
+		// Dirty components that are gone by now were removed, the journal has to say so
+		SceneSnapshotArchive archive(*delta);
+		for (const auto& [id, mask] : m_DirtyComponents)
+		{
+			entt::entity entity = entt::entity(id);
+			bool valid = m_Registry.valid(entity);
+			uint32 removed = 0;
+			SceneComponents::ForEach([&](auto tag)
+			{
+				using Component = typename decltype(tag)::Type;
+				if (!(mask & SceneComponents::Bit<Component>()))
+				{
+					return;
+				}
+
+				if (valid && m_Registry.has<Component>(entity))
+				{
+					archive(entity, m_Registry.get<Component>(entity));
+				}
+				else
+				{
+					removed |= SceneComponents::Bit<Component>();
+				}
+			});
+
+			if (removed != 0)
+			{
+				delta->m_Removed.emplace_back(entity, removed);
+			}
+		}
+
+		Log::Info("Saving changes to %d entities for %s", (int)m_DirtyComponents.size(), filename.Filepath());
+		m_DirtyComponents.clear();
+		SceneWriter::Submit(delta);
 	}
 
 	void Scene::Reset()
 	{
-		AssetManager::Clear();
+		AssetManager::ReleaseSceneAssets();
+		AssetManager::UnloadUnreferenced();
+		ResetEntities();
+		m_DirtyComponents.clear();
+		m_NeedsFullSave = true;
+	}
+
+	void Scene::ResetEntities()
+	{
+		m_Physics->Destroy();
+		m_Partition->Close();
 		auto view = m_Registry.view<Transform>();
 		m_Registry.destroy(view.begin(), view.end());
 
@@ -189,30 +421,26 @@ namespace Cocoa
 		auto asset = AssetManager::LoadTextureFromFile(Settings::General::s_EngineAssetsPath + "images/gizmos.png", true);
 	}
 
-	static Entity FindOrCreateEntity(int id, Scene* scene, entt::registry& registry)
-	{
-		Entity entity;
-		if (registry.valid(entt::entity(id)))
-		{
-			entity = Entity(entt::entity(id), scene);
-		}
-		else
-		{
-			entity = Entity(registry.create(entt::entity(id)), scene);
-		}
-
-		return entity;
-	}
-
 	void Scene::Load(const CPath& filename)
 	{
-		Reset();
+		// Drop this scene's asset references but keep the assets resident until the new scene
+		// has had a chance to claim the ones it shares with us
+		AssetManager::ReleaseSceneAssets();
+		ResetEntities();
 		Log::Info("Loading scene %s", filename.Filepath());
 
 		Settings::General::s_CurrentScene = filename;
+		m_DirtyComponents.clear();
+		m_SavedFilename = filename;
+		m_NeedsFullSave = true;
+
+		// The file may still be waiting on the writer, e.g. the scene saved right before play mode
+		SceneWriter::Flush();
 		File* file = IFile::OpenFile(filename);
 		if (file->m_Data.size() <= 0)
 		{
+			IFile::CloseFile(file);
+			AssetManager::UnloadUnreferenced();
 			return;
 		}
 
@@ -226,59 +454,103 @@ namespace Cocoa
 			}
 		}
 
-		std::unordered_map<uint32, uint32> resourceIdMap{};
-		json j = json::parse(file->m_Data);
+		bool loaded = false;
+		if (SceneJournal::HasJournal(filename))
+		{
+			SceneSnapshot snapshot;
+			loaded = SceneJournal::Read(file->m_Data, filename, snapshot);
+			if (loaded)
+			{
+				SceneReader::Insert(snapshot, this, scriptSystem);
+			}
+		}
+		else
+		{
+			loaded = SceneBinary::IsBinary(file->m_Data)
+				? SceneBinary::Load(file->m_Data, this, scriptSystem)
+				: SceneReader::Load(file->m_Data, this, scriptSystem);
+		}
 
-		if (!j["Assets"].is_null())
+		if (!loaded)
+		{
+			Log::Warning("Failed to load scene '%s'", filename.Filepath());
+		}
+		m_NeedsFullSave = !loaded;
+		if (loaded && WorldPartition::HasPartition(filename))
 		{
-			resourceIdMap = AssetManager::LoadFrom(j["Assets"]);
+			m_Partition->Open(filename);
 		}
 
-		int size = j["Size"].is_null() || j["Components"].is_null() ? 0 : j["Size"];
-		for (int i=0; i < size; i++)
+		IFile::CloseFile(file);
+		AssetManager::UnloadUnreferenced();
+	}
+
+	bool Scene::Stream(const CPath& filename)
+	{
+		m_SavedFilename = filename;
+		File* file = IFile::OpenFile(filename);
+		if (file->m_Data.size() <= 0)
 		{
-			json::iterator it = j["Components"][i].begin();
-			json component = j["Components"][i];
-			if (it.key() == "SpriteRenderer")
-			{
-				Entity entity = FindOrCreateEntity(component["SpriteRenderer"]["Entity"], this, m_Registry);
-				const json& originalId = component["SpriteRenderer"]["AssetId"];
-				if (!originalId.is_null() && (uint32)originalId != std::numeric_limits<uint32>::max())
-					component["SpriteRenderer"]["AssetId"] = resourceIdMap[(uint32)originalId];
-				RenderSystem::Deserialize(component, entity);
-			}
-			else if (it.key() == "Transform")
-			{
-				Entity entity = FindOrCreateEntity(component["Transform"]["Entity"], this, m_Registry);
-				Transform::Deserialize(component, entity);
-			}
-			else if (it.key() == "Rigidbody2D")
-			{
-				Entity entity = FindOrCreateEntity(component["Rigidbody2D"]["Entity"], this, m_Registry);
-				Physics2DSystem::DeserializeRigidbody2D(component, entity);
-			}
-			else if (it.key() == "Box2D")
-			{
-				Entity entity = FindOrCreateEntity(component["Box2D"]["Entity"], this, m_Registry);
-				Physics2DSystem::DeserializeBox2D(component, entity);
-			}
-			else if (it.key() == "AABB")
-			{
-				Entity entity = FindOrCreateEntity(component["AABB"]["Entity"], this, m_Registry);
-				Physics2DSystem::DeserializeAABB(component, entity);
-			}
-			else
+			IFile::CloseFile(file);
+			return false;
+		}
+
+		std::unique_ptr<SceneSnapshot> snapshot = std::make_unique<SceneSnapshot>();
+		bool loaded = false;
+		if (SceneJournal::HasJournal(filename))
+		{
+			loaded = SceneJournal::Read(file->m_Data, filename, *snapshot);
+		}
+		else if (SceneBinary::IsBinary(file->m_Data))
+		{
+			loaded = SceneBinary::Read(file->m_Data, *snapshot);
+		}
+		else
+		{
+			loaded = SceneReader::Read(file->m_Data, *snapshot);
+		}
+		IFile::CloseFile(file);
+
+		if (loaded)
+		{
+			SceneReader::InsertComponents(*snapshot, m_Registry);
+			m_StreamedSnapshot = std::move(snapshot);
+		}
+		return loaded;
+	}
+
+	void Scene::FinishStreaming()
+	{
+		Log::Info("Finished streaming scene %s", m_SavedFilename.Filepath());
+		Settings::General::s_CurrentScene = m_SavedFilename;
+		m_DirtyComponents.clear();
+		m_NeedsFullSave = m_StreamedSnapshot == nullptr;
+		if (m_StreamedSnapshot == nullptr)
+		{
+			Log::Warning("Failed to load scene '%s'", m_SavedFilename.Filepath());
+			return;
+		}
+
+		ScriptSystem* scriptSystem = nullptr;
+		for (auto& system : m_Systems)
+		{
+			if (strcmp(system->GetName(), "Script System") == 0)
 			{
-				Entity entity = FindOrCreateEntity(component.front()["Entity"], this, m_Registry);
-				scriptSystem->Deserialize(component, entity);
+				scriptSystem = (ScriptSystem*)system.get();
 			}
 		}
 
-		IFile::CloseFile(file);
+		SceneReader::InsertAssetsAndScripts(*m_StreamedSnapshot, this, scriptSystem);
+		m_StreamedSnapshot.reset();
+		if (WorldPartition::HasPartition(m_SavedFilename))
+		{
+			m_Partition->Open(m_SavedFilename);
+		}
 	}
 
 	void Scene::LoadScriptsOnly(const CPath& filename)
 	{
+		SceneWriter::Flush();
 		File* file = IFile::OpenFile(filename);
 		if (file->m_Data.size() <= 0)
 		{
@@ -295,17 +567,13 @@ namespace Cocoa
 		}
 
 		Log::Info("Loading scripts only for %s", filename.Filepath());
-		json j = json::parse(file->m_Data);
-		int size = j["Size"].is_null() || j["Components"].is_null() ? 0 : j["Size"];
-		for (int i = 0; i < size; i++)
+		if (SceneBinary::IsBinary(file->m_Data))
 		{
-			json::iterator it = j["Components"][i].begin();
-			json component = j["Components"][i];
-			if (it.key() != "SpriteRenderer" && it.key() != "Transform" && it.key() != "Rigidbody2D" && it.key() != "Box2D" && it.key() != "AABB")
-			{
-				Entity entity = FindOrCreateEntity(component.front()["Entity"], this, m_Registry);
-				scriptSystem->Deserialize(component, entity);
-			}
+			SceneBinary::Load(file->m_Data, this, scriptSystem, true);
+		}
+		else
+		{
+			SceneReader::Load(file->m_Data, this, scriptSystem, true);
 		}
 
 		IFile::CloseFile(file);
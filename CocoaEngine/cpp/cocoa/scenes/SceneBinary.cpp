@@ -0,0 +1,612 @@
+#include "cocoa/scenes/SceneBinary.h"
+#include "cocoa/scenes/SceneReader.h"
+#include "cocoa/scenes/Scene.h"
+#include "cocoa/systems/ScriptSystem.h"
+#include "cocoa/core/AssetManager.h"
+#include "cocoa/file/IFile.h"
+#include "cocoa/util/Log.h"
+
+#include <cstddef>
+
+namespace Cocoa
+{
+	static const uint8 SCENE_MAGIC[4] = { 'C', 'S', 'C', 'N' };
+	static const char* BINARY_SCENE_EXTENSION = ".cocoabin";
+
+	// On disk records. Only the fields the JSON format stores are written, everything else is
+	// derived when the component is created, exactly like the JSON deserializers do. Fields added in a
+	// later version go at the end and need a default for files that don't have them
+	struct TransformRecord
+	{
+		float m_Position[3];
+		float m_Scale[3];
+		float m_EulerRotation[3];
+		// Version 2
+		uint32 m_Parent = (uint32)entt::to_integral(entt::entity(entt::null));
+	};
+
+	struct SpriteRendererRecord
+	{
+		float m_Color[4];
+		uint32 m_AssetId;
+		int32 m_ZIndex;
+	};
+
+	struct Rigidbody2DRecord
+	{
+		float m_Velocity[2];
+		float m_AngularDamping;
+		float m_LinearDamping;
+		float m_Mass;
+		uint8 m_ContinuousCollision;
+		uint8 m_FixedRotation;
+		uint8 m_Reserved[2];
+	};
+
+	struct Box2DRecord
+	{
+		float m_HalfSize[2];
+	};
+
+	struct AABBRecord
+	{
+		float m_HalfSize[2];
+		float m_Offset[2];
+	};
+
+	// Record layout and section of every component in SceneComponents. V1_SIZE is the size of the record
+	// in version 1 files
+	template<typename Component>
+	struct SceneRecord;
+
+	template<>
+	struct SceneRecord<Transform>
+	{
+		using Type = TransformRecord;
+		static constexpr SceneSectionType SECTION = SceneSectionType::Transform;
+		static constexpr size_t V1_SIZE = offsetof(TransformRecord, m_Parent);
+	};
+
+	template<>
+	struct SceneRecord<SpriteRenderer>
+	{
+		using Type = SpriteRendererRecord;
+		static constexpr SceneSectionType SECTION = SceneSectionType::SpriteRenderer;
+		static constexpr size_t V1_SIZE = sizeof(SpriteRendererRecord);
+	};
+
+	template<>
+	struct SceneRecord<Rigidbody2D>
+	{
+		using Type = Rigidbody2DRecord;
+		static constexpr SceneSectionType SECTION = SceneSectionType::Rigidbody2D;
+		static constexpr size_t V1_SIZE = sizeof(Rigidbody2DRecord);
+	};
+
+	template<>
+	struct SceneRecord<Box2D>
+	{
+		using Type = Box2DRecord;
+		static constexpr SceneSectionType SECTION = SceneSectionType::Box2D;
+		static constexpr size_t V1_SIZE = sizeof(Box2DRecord);
+	};
+
+	template<>
+	struct SceneRecord<AABB>
+	{
+		using Type = AABBRecord;
+		static constexpr SceneSectionType SECTION = SceneSectionType::AABB;
+		static constexpr size_t V1_SIZE = sizeof(AABBRecord);
+	};
+
+	// ===================================================================================
+	// Record conversions, derived fields are filled in by ComponentCodec::FinishRead
+	// ===================================================================================
+	static TransformRecord ToRecord(const Transform& transform, uint32 resourceId)
+	{
+		return TransformRecord{
+			{ transform.m_Position.x, transform.m_Position.y, transform.m_Position.z },
+			{ transform.m_Scale.x, transform.m_Scale.y, transform.m_Scale.z },
+			{ transform.m_EulerRotation.x, transform.m_EulerRotation.y, transform.m_EulerRotation.z },
+			(uint32)entt::to_integral(transform.m_Parent)
+		};
+	}
+
+	static void FromRecord(const TransformRecord& record, Transform& transform, uint32& resourceId)
+	{
+		transform.m_Position = glm::vec3(record.m_Position[0], record.m_Position[1], record.m_Position[2]);
+		transform.m_Scale = glm::vec3(record.m_Scale[0], record.m_Scale[1], record.m_Scale[2]);
+		transform.m_EulerRotation = glm::vec3(record.m_EulerRotation[0], record.m_EulerRotation[1], record.m_EulerRotation[2]);
+		transform.m_Parent = entt::entity(record.m_Parent);
+	}
+
+	static SpriteRendererRecord ToRecord(const SpriteRenderer& spriteRenderer, uint32 resourceId)
+	{
+		const glm::vec4& color = spriteRenderer.m_Color;
+		return SpriteRendererRecord{ { color.r, color.g, color.b, color.a }, resourceId, spriteRenderer.m_ZIndex };
+	}
+
+	static void FromRecord(const SpriteRendererRecord& record, SpriteRenderer& spriteRenderer, uint32& resourceId)
+	{
+		spriteRenderer.m_Color = glm::vec4(record.m_Color[0], record.m_Color[1], record.m_Color[2], record.m_Color[3]);
+		spriteRenderer.m_ZIndex = record.m_ZIndex;
+		resourceId = record.m_AssetId;
+	}
+
+	static Rigidbody2DRecord ToRecord(const Rigidbody2D& rigidbody, uint32 resourceId)
+	{
+		return Rigidbody2DRecord{
+			{ rigidbody.m_Velocity.x, rigidbody.m_Velocity.y },
+			rigidbody.m_AngularDamping,
+			rigidbody.m_LinearDamping,
+			rigidbody.m_Mass,
+			(uint8)rigidbody.m_ContinuousCollision,
+			(uint8)rigidbody.m_FixedRotation,
+			{ 0, 0 }
+		};
+	}
+
+	static void FromRecord(const Rigidbody2DRecord& record, Rigidbody2D& rigidbody, uint32& resourceId)
+	{
+		rigidbody.m_Velocity = glm::vec2(record.m_Velocity[0], record.m_Velocity[1]);
+		rigidbody.m_AngularDamping = record.m_AngularDamping;
+		rigidbody.m_LinearDamping = record.m_LinearDamping;
+		rigidbody.m_Mass = record.m_Mass;
+		rigidbody.m_ContinuousCollision = record.m_ContinuousCollision != 0;
+		rigidbody.m_FixedRotation = record.m_FixedRotation != 0;
+	}
+
+	static Box2DRecord ToRecord(const Box2D& box, uint32 resourceId)
+	{
+		return Box2DRecord{ { box.m_HalfSize.x, box.m_HalfSize.y } };
+	}
+
+	static void FromRecord(const Box2DRecord& record, Box2D& box, uint32& resourceId)
+	{
+		box.m_HalfSize = glm::vec2(record.m_HalfSize[0], record.m_HalfSize[1]);
+	}
+
+	static AABBRecord ToRecord(const AABB& box, uint32 resourceId)
+	{
+		return AABBRecord{ { box.m_HalfSize.x, box.m_HalfSize.y }, { box.m_Offset.x, box.m_Offset.y } };
+	}
+
+	static void FromRecord(const AABBRecord& record, AABB& box, uint32& resourceId)
+	{
+		box.m_HalfSize = glm::vec2(record.m_HalfSize[0], record.m_HalfSize[1]);
+		box.m_Offset = glm::vec2(record.m_Offset[0], record.m_Offset[1]);
+	}
+
+	// ===================================================================================
+	// Writing
+	// ===================================================================================
+	class SceneBinaryBuilder
+	{
+	public:
+		void AddBlob(SceneSectionType type, uint32 count, const std::string& blob)
+		{
+			SceneBinarySection& section = BeginSection(type, count, 0);
+			m_Data.append(blob);
+			section.m_Size = blob.size();
+		}
+
+		void AddEntities(const std::vector<uint32>& entities)
+		{
+			SceneBinarySection& section = BeginSection(SceneSectionType::Entities, (uint32)entities.size(), sizeof(uint32));
+			Append(entities.data(), entities.size() * sizeof(uint32));
+			section.m_Size = entities.size() * sizeof(uint32);
+		}
+
+		template<typename Component>
+		void AddColumn(const ComponentColumn<Component>& column)
+		{
+			using Record = typename SceneRecord<Component>::Type;
+			if (column.Size() == 0)
+			{
+				return;
+			}
+
+			SceneBinarySection& section = BeginSection(SceneRecord<Component>::SECTION, (uint32)column.Size(), sizeof(Record));
+			for (entt::entity entity : column.m_Entities)
+			{
+				uint32 id = (uint32)entt::to_integral(entity);
+				Append(&id, sizeof(uint32));
+			}
+
+			for (size_t i = 0; i < column.Size(); i++)
+			{
+				uint32 resourceId = ComponentCodec<Component>::REFERENCES_ASSET ? column.m_ResourceIds[i] : std::numeric_limits<uint32>::max();
+				Record record = ToRecord(column.m_Components[i], resourceId);
+				Append(&record, sizeof(Record));
+			}
+			section.m_Size = column.Size() * (sizeof(uint32) + sizeof(Record));
+		}
+
+		std::string Finish(uint32 version)
+		{
+			SceneBinaryHeader header;
+			memcpy(header.m_Magic, SCENE_MAGIC, sizeof(SCENE_MAGIC));
+			header.m_Version = version;
+			header.m_SectionCount = (uint32)m_Sections.size();
+			header.m_Reserved = 0;
+
+			uint64 tableSize = sizeof(SceneBinaryHeader) + m_Sections.size() * sizeof(SceneBinarySection);
+			std::string result;
+			result.reserve(tableSize + m_Data.size());
+			result.append((const char*)&header, sizeof(SceneBinaryHeader));
+			for (SceneBinarySection section : m_Sections)
+			{
+				// Offsets were relative to the data block while it was being built
+				section.m_Offset += tableSize;
+				result.append((const char*)&section, sizeof(SceneBinarySection));
+			}
+			result.append(m_Data);
+			return result;
+		}
+
+	private:
+		SceneBinarySection& BeginSection(SceneSectionType type, uint32 count, uint32 stride)
+		{
+			// The header and section table are a multiple of 8 bytes, so aligning the data block
+			// aligns the file
+			while (m_Data.size() % 8 != 0)
+			{
+				m_Data.push_back('\0');
+			}
+
+			m_Sections.push_back(SceneBinarySection{ (uint32)type, count, stride, 0, m_Data.size(), 0 });
+			return m_Sections.back();
+		}
+
+		void Append(const void* data, size_t size)
+		{
+			m_Data.append((const char*)data, size);
+		}
+
+	private:
+		std::vector<SceneBinarySection> m_Sections;
+		std::string m_Data;
+	};
+
+	static uint32 GetScriptEntity(const json& component)
+	{
+		const json& entity = component.front()["Entity"];
+		return entity.is_number() ? (uint32)entity : std::numeric_limits<uint32>::max();
+	}
+
+	bool SceneBinary::IsBinaryPath(const CPath& path)
+	{
+		return strcmp(path.FileExt(), BINARY_SCENE_EXTENSION) == 0;
+	}
+
+	bool SceneBinary::IsBinary(std::string_view data)
+	{
+		return data.size() >= sizeof(SceneBinaryHeader) && memcmp(data.data(), SCENE_MAGIC, sizeof(SCENE_MAGIC)) == 0;
+	}
+
+	std::string SceneBinary::Write(const SceneSnapshot& snapshot)
+	{
+		std::vector<uint32> entities;
+		SceneComponents::ForEach([&](auto tag)
+		{
+			for (entt::entity entity : snapshot.Column<typename decltype(tag)::Type>().m_Entities)
+			{
+				entities.push_back((uint32)entt::to_integral(entity));
+			}
+		});
+
+		json scripts = json::array();
+		if (snapshot.m_Scripts.contains("Components") && snapshot.m_Scripts["Components"].is_array())
+		{
+			scripts = snapshot.m_Scripts["Components"];
+		}
+		for (const json& component : scripts)
+		{
+			entities.push_back(GetScriptEntity(component));
+		}
+
+		std::sort(entities.begin(), entities.end());
+		entities.erase(std::unique(entities.begin(), entities.end()), entities.end());
+		if (entities.size() > 0 && entities.back() == std::numeric_limits<uint32>::max())
+		{
+			entities.pop_back();
+		}
+
+		SceneBinaryBuilder builder;
+		builder.AddEntities(entities);
+		builder.AddBlob(SceneSectionType::Project, 1, snapshot.m_Project);
+		builder.AddBlob(SceneSectionType::Assets, 1, snapshot.m_Assets.dump());
+		builder.AddBlob(SceneSectionType::Scripts, (uint32)scripts.size(), scripts.dump());
+
+		SceneComponents::ForEach([&](auto tag)
+		{
+			builder.AddColumn(snapshot.Column<typename decltype(tag)::Type>());
+		});
+
+		return builder.Finish(VERSION);
+	}
+
+	// ===================================================================================
+	// Reading
+	// ===================================================================================
+	// Validated view of a binary scene's sections
+	class SceneBinaryReader
+	{
+	public:
+		// Opens any version up to and including maxVersion
+		bool Open(std::string_view data, uint32 maxVersion)
+		{
+			m_Data = data;
+			if (!SceneBinary::IsBinary(data))
+			{
+				Log::Warning("Scene data is not a binary scene.");
+				return false;
+			}
+
+			SceneBinaryHeader header;
+			memcpy(&header, data.data(), sizeof(SceneBinaryHeader));
+			if (header.m_Version == 0 || header.m_Version > maxVersion)
+			{
+				Log::Warning("Unsupported binary scene version %d, expected %d or older.", header.m_Version, maxVersion);
+				return false;
+			}
+			m_Version = header.m_Version;
+
+			uint64 tableEnd = sizeof(SceneBinaryHeader) + (uint64)header.m_SectionCount * sizeof(SceneBinarySection);
+			if (tableEnd > data.size())
+			{
+				Log::Warning("Binary scene section table is truncated.");
+				return false;
+			}
+
+			m_Sections.resize(header.m_SectionCount);
+			memcpy(m_Sections.data(), data.data() + sizeof(SceneBinaryHeader), header.m_SectionCount * sizeof(SceneBinarySection));
+			for (const SceneBinarySection& section : m_Sections)
+			{
+				if (section.m_Offset > data.size() || section.m_Size > data.size() - section.m_Offset)
+				{
+					Log::Warning("Binary scene section %d runs past the end of the file.", section.m_Type);
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		const SceneBinarySection* Find(SceneSectionType type) const
+		{
+			for (const SceneBinarySection& section : m_Sections)
+			{
+				if (section.m_Type == (uint32)type)
+				{
+					return &section;
+				}
+			}
+
+			return nullptr;
+		}
+
+		std::string_view GetBlob(SceneSectionType type) const
+		{
+			const SceneBinarySection* section = Find(type);
+			return section != nullptr ? m_Data.substr(section->m_Offset, section->m_Size) : std::string_view();
+		}
+
+		// Calls fn(entityId, record) for every record of a component column
+		template<typename Component, typename Fn>
+		bool ForEachRecord(Fn fn) const
+		{
+			using Record = typename SceneRecord<Component>::Type;
+			const SceneBinarySection* section = Find(SceneRecord<Component>::SECTION);
+			if (section == nullptr)
+			{
+				return true;
+			}
+
+			// Newer versions may only ever append fields to a record, so older files have shorter ones
+			size_t minStride = m_Version == 1 ? SceneRecord<Component>::V1_SIZE : sizeof(Record);
+			size_t copySize = std::min((size_t)section->m_Stride, sizeof(Record));
+			if (section->m_Stride < minStride || section->m_Size < (uint64)section->m_Count * (sizeof(uint32) + section->m_Stride))
+			{
+				Log::Warning("Binary scene column %d is malformed.", section->m_Type);
+				return false;
+			}
+
+			const char* ids = m_Data.data() + section->m_Offset;
+			const char* records = ids + (uint64)section->m_Count * sizeof(uint32);
+			for (uint32 i = 0; i < section->m_Count; i++)
+			{
+				// memcpy since mapped data makes no alignment promises to the compiler
+				uint32 id;
+				Record record{};
+				memcpy(&id, ids + i * sizeof(uint32), sizeof(uint32));
+				memcpy(&record, records + (uint64)i * section->m_Stride, copySize);
+				fn(id, record);
+			}
+
+			return true;
+		}
+
+		uint32 GetCount(SceneSectionType type) const
+		{
+			const SceneBinarySection* section = Find(type);
+			return section != nullptr ? section->m_Count : 0;
+		}
+
+	private:
+		std::string_view m_Data;
+		std::vector<SceneBinarySection> m_Sections;
+		uint32 m_Version = 0;
+	};
+
+	static json ParseBlob(std::string_view blob, const json& fallback)
+	{
+		if (blob.size() == 0)
+		{
+			return fallback;
+		}
+
+		json result = json::parse(blob.begin(), blob.end(), nullptr, false);
+		return result.is_discarded() ? fallback : result;
+	}
+
+	template<typename Component>
+	static bool ReadColumn(const SceneBinaryReader& reader, ComponentColumn<Component>& column)
+	{
+		using Record = typename SceneRecord<Component>::Type;
+		uint32 count = reader.GetCount(SceneRecord<Component>::SECTION);
+		column.m_Entities.reserve(count);
+		column.m_Components.reserve(count);
+		return reader.ForEachRecord<Component>([&](uint32 id, const Record& record)
+		{
+			uint32 resourceId = std::numeric_limits<uint32>::max();
+			column.m_Entities.push_back(entt::entity(id));
+			column.m_Components.emplace_back();
+			FromRecord(record, column.m_Components.back(), resourceId);
+			ComponentCodec<Component>::FinishRead(column.m_Components.back());
+			if constexpr (ComponentCodec<Component>::REFERENCES_ASSET)
+			{
+				column.m_ResourceIds.push_back(resourceId);
+			}
+		});
+	}
+
+	bool SceneBinary::Read(std::string_view data, SceneSnapshot& snapshot)
+	{
+		SceneBinaryReader reader;
+		if (!reader.Open(data, VERSION))
+		{
+			return false;
+		}
+
+		snapshot.m_Project = std::string(reader.GetBlob(SceneSectionType::Project));
+		snapshot.m_Assets = ParseBlob(reader.GetBlob(SceneSectionType::Assets), json());
+		json scripts = ParseBlob(reader.GetBlob(SceneSectionType::Scripts), json::array());
+		snapshot.m_Scripts = {
+			{"Size", scripts.size()},
+			{"Components", scripts}
+		};
+
+		bool success = true;
+		SceneComponents::ForEach([&](auto tag)
+		{
+			success = success && ReadColumn(reader, snapshot.Column<typename decltype(tag)::Type>());
+		});
+
+		return success;
+	}
+
+	// ===================================================================================
+	// Loading into a scene
+	// ===================================================================================
+	template<typename Component>
+	static bool InsertColumn(const SceneBinaryReader& reader, entt::registry& registry, const std::unordered_map<uint32, uint32>& resourceIdMap)
+	{
+		ComponentColumn<Component> column;
+		if (!ReadColumn(reader, column))
+		{
+			return false;
+		}
+
+		ApplyResourceIds(column, resourceIdMap);
+
+		registry.insert<Component>(column.m_Entities.begin(), column.m_Entities.end(), column.m_Components.begin(), column.m_Components.end());
+		return true;
+	}
+
+	bool SceneBinary::Load(std::string_view data, Scene* scene, ScriptSystem* scriptSystem, bool scriptsOnly)
+	{
+		SceneBinaryReader reader;
+		if (!reader.Open(data, VERSION))
+		{
+			return false;
+		}
+
+		entt::registry& registry = scene->GetRegistry();
+		const SceneBinarySection* entitySection = reader.Find(SceneSectionType::Entities);
+		if (entitySection != nullptr && entitySection->m_Size >= (uint64)entitySection->m_Count * sizeof(uint32))
+		{
+			const char* ids = data.data() + entitySection->m_Offset;
+			for (uint32 i = 0; i < entitySection->m_Count; i++)
+			{
+				uint32 id;
+				memcpy(&id, ids + i * sizeof(uint32), sizeof(uint32));
+				if (!registry.valid(entt::entity(id)))
+				{
+					registry.create(entt::entity(id));
+				}
+			}
+		}
+
+		bool success = true;
+		if (!scriptsOnly)
+		{
+			std::unordered_map<uint32, uint32> resourceIdMap{};
+			json assets = ParseBlob(reader.GetBlob(SceneSectionType::Assets), json());
+			if (!assets.is_null())
+			{
+				resourceIdMap = AssetManager::LoadFrom(assets);
+			}
+
+			SceneComponents::ForEach([&](auto tag)
+			{
+				success = success && InsertColumn<typename decltype(tag)::Type>(reader, registry, resourceIdMap);
+			});
+		}
+
+		if (scriptSystem != nullptr && reader.GetCount(SceneSectionType::Scripts) > 0)
+		{
+			json scripts = ParseBlob(reader.GetBlob(SceneSectionType::Scripts), json::array());
+			for (json& component : scripts)
+			{
+				scriptSystem->Deserialize(component, Entity(entt::entity(GetScriptEntity(component)), scene));
+			}
+		}
+
+		return success;
+	}
+
+	bool SceneBinary::ConvertFile(const CPath& input, const CPath& output)
+	{
+		File* file = IFile::OpenFile(input);
+		if (file->m_Data.size() == 0)
+		{
+			Log::Warning("Cannot convert scene '%s', the file is empty or missing.", input.Filepath());
+			IFile::CloseFile(file);
+			return false;
+		}
+
+		SceneSnapshot snapshot;
+		bool toJson = IsBinary(file->m_Data);
+		bool success = true;
+		if (toJson)
+		{
+			success = Read(file->m_Data, snapshot);
+		}
+		else
+		{
+			success = SceneReader::Read(file->m_Data, snapshot);
+		}
+		IFile::CloseFile(file);
+
+		if (success)
+		{
+			std::string result;
+			if (toJson)
+			{
+				SceneWriter::Write(snapshot, result);
+			}
+			else
+			{
+				result = Write(snapshot);
+			}
+			success = IFile::WriteFileAtomic(result, output);
+		}
+
+		if (!success)
+		{
+			Log::Warning("Failed to convert scene '%s' to '%s'.", input.Filepath(), output.Filepath());
+		}
+		return success;
+	}
+}
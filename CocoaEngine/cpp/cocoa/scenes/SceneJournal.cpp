@@ -0,0 +1,341 @@
+#include "cocoa/scenes/SceneJournal.h"
+#include "cocoa/scenes/SceneBinary.h"
+#include "cocoa/scenes/SceneReader.h"
+#include "cocoa/file/IFile.h"
+#include "cocoa/util/Log.h"
+
+#include <mutex>
+#include <unordered_set>
+
+namespace Cocoa
+{
+	struct JournalSizes
+	{
+		uint64 m_SceneSize = 0;
+		uint64 m_JournalSize = 0;
+	};
+
+	// Sizes of the journals appended to this session, keyed by scene file, so appending never has to stat
+	// or read anything to decide whether it's time to compact
+	static std::unordered_map<std::string, JournalSizes> s_Sizes;
+	// Scene files whose journal can't be appended to until the next full save
+	static std::unordered_set<std::string> s_Broken;
+	static std::mutex s_SizesMutex;
+
+	static void MarkBroken(const CPath& sceneFile)
+	{
+		std::lock_guard<std::mutex> lock(s_SizesMutex);
+		s_Broken.insert(sceneFile.Filepath());
+	}
+
+	static uint64 FileSize(const CPath& path)
+	{
+		if (!IFile::IsFile(path))
+		{
+			return 0;
+		}
+
+		File* file = IFile::OpenFile(path);
+		uint64 size = file->m_Data.size();
+		IFile::CloseFile(file);
+		return size;
+	}
+
+	// Cuts off a record that was only partly written, otherwise the next append would land on the same line
+	// and be thrown away with it. Returns the size of the journal afterwards
+	static bool TrimTornRecord(const CPath& journalPath, uint64& outSize)
+	{
+		outSize = 0;
+		if (!IFile::IsFile(journalPath))
+		{
+			return true;
+		}
+
+		File* file = IFile::OpenFile(journalPath);
+		std::string_view data = file->m_Data;
+		size_t intactSize = SceneJournal::GetIntactSize(data);
+		bool res = true;
+		if (intactSize != data.size())
+		{
+			Log::Warning("Dropping a partly written record from the end of scene journal '%s'", journalPath.Filepath());
+			res = IFile::WriteFileAtomic(std::string(data.substr(0, intactSize)), journalPath);
+		}
+		outSize = intactSize;
+		IFile::CloseFile(file);
+		return res;
+	}
+
+	template<typename Component>
+	static void ApplyColumn(ComponentColumn<Component>& column, const ComponentColumn<Component>& changes, const std::vector<std::pair<entt::entity, uint32>>& removed)
+	{
+		const uint32 bit = SceneComponents::Bit<Component>();
+		bool removesAny = false;
+		for (const auto& [entity, mask] : removed)
+		{
+			removesAny = removesAny || (mask & bit);
+		}
+		if (changes.Size() == 0 && !removesAny)
+		{
+			return;
+		}
+
+		std::unordered_map<uint32, size_t> rows;
+		rows.reserve(column.Size() + changes.Size());
+		for (size_t i = 0; i < column.Size(); i++)
+		{
+			rows[(uint32)column.m_Entities[i]] = i;
+		}
+
+		for (size_t i = 0; i < changes.Size(); i++)
+		{
+			auto it = rows.find((uint32)changes.m_Entities[i]);
+			size_t row = it != rows.end() ? it->second : column.Size();
+			if (row == column.Size())
+			{
+				rows[(uint32)changes.m_Entities[i]] = row;
+				column.m_Entities.push_back(changes.m_Entities[i]);
+				column.m_Components.push_back(changes.m_Components[i]);
+				if constexpr (ComponentCodec<Component>::REFERENCES_ASSET)
+				{
+					column.m_ResourceIds.push_back(changes.m_ResourceIds[i]);
+				}
+			}
+			else
+			{
+				column.m_Components[row] = changes.m_Components[i];
+				if constexpr (ComponentCodec<Component>::REFERENCES_ASSET)
+				{
+					column.m_ResourceIds[row] = changes.m_ResourceIds[i];
+				}
+			}
+		}
+
+		if (!removesAny)
+		{
+			return;
+		}
+
+		// A record never sets and removes the same component, so removals can go last
+		std::vector<bool> erase(column.Size(), false);
+		for (const auto& [entity, mask] : removed)
+		{
+			auto it = rows.find((uint32)entity);
+			if ((mask & bit) && it != rows.end())
+			{
+				erase[it->second] = true;
+			}
+		}
+
+		size_t kept = 0;
+		for (size_t i = 0; i < column.Size(); i++)
+		{
+			if (erase[i])
+			{
+				continue;
+			}
+
+			if (kept != i)
+			{
+				column.m_Entities[kept] = column.m_Entities[i];
+				column.m_Components[kept] = column.m_Components[i];
+				if constexpr (ComponentCodec<Component>::REFERENCES_ASSET)
+				{
+					column.m_ResourceIds[kept] = column.m_ResourceIds[i];
+				}
+			}
+			kept++;
+		}
+		column.m_Entities.resize(kept);
+		column.m_Components.resize(kept);
+		if constexpr (ComponentCodec<Component>::REFERENCES_ASSET)
+		{
+			column.m_ResourceIds.resize(kept);
+		}
+	}
+
+	CPath SceneJournal::GetPath(const CPath& sceneFile)
+	{
+		return CPath(std::string(sceneFile.Filepath()) + ".journal");
+	}
+
+	bool SceneJournal::HasJournal(const CPath& sceneFile)
+	{
+		return IFile::IsFile(GetPath(sceneFile));
+	}
+
+	bool SceneJournal::Append(const SceneSnapshot& delta)
+	{
+		std::string record;
+		SceneWriter::Write(delta, record, true);
+		record += '\n';
+
+		CPath journalPath = GetPath(delta.m_Filename);
+		bool firstAppend = false;
+		{
+			std::lock_guard<std::mutex> lock(s_SizesMutex);
+			firstAppend = s_Sizes.find(delta.m_Filename.Filepath()) == s_Sizes.end();
+		}
+
+		JournalSizes firstSizes;
+		if (firstAppend)
+		{
+			// First append this session, the journal may be left over from the last one and end in a torn record
+			firstSizes.m_SceneSize = FileSize(delta.m_Filename);
+			if (!TrimTornRecord(journalPath, firstSizes.m_JournalSize))
+			{
+				Log::Error("Failed to repair scene journal '%s'", journalPath.Filepath());
+				MarkBroken(delta.m_Filename);
+				return false;
+			}
+		}
+
+		if (!IFile::AppendFile(record, journalPath))
+		{
+			Log::Error("Failed to append to scene journal '%s'", journalPath.Filepath());
+			MarkBroken(delta.m_Filename);
+			return false;
+		}
+
+		bool compact = false;
+		{
+			std::lock_guard<std::mutex> lock(s_SizesMutex);
+			auto it = s_Sizes.emplace(delta.m_Filename.Filepath(), firstSizes).first;
+			it->second.m_JournalSize += record.size();
+
+			const JournalSizes& sizes = it->second;
+			compact = sizes.m_JournalSize > MIN_COMPACT_SIZE && sizes.m_JournalSize > sizes.m_SceneSize / COMPACT_RATIO;
+		}
+
+		if (compact)
+		{
+			return Compact(delta.m_Filename);
+		}
+		return true;
+	}
+
+	bool SceneJournal::Compact(const CPath& sceneFile)
+	{
+		File* file = IFile::OpenFile(sceneFile);
+		SceneSnapshot snapshot;
+		bool read = file->m_Data.size() > 0 && Read(file->m_Data, sceneFile, snapshot);
+		IFile::CloseFile(file);
+		if (!read)
+		{
+			Log::Warning("Failed to compact scene journal for '%s', keeping the journal.", sceneFile.Filepath());
+			return false;
+		}
+
+		std::string data;
+		if (SceneBinary::IsBinaryPath(sceneFile))
+		{
+			data = SceneBinary::Write(snapshot);
+		}
+		else
+		{
+			SceneWriter::Write(snapshot, data);
+		}
+
+		if (!IFile::WriteFileAtomic(data, sceneFile))
+		{
+			Log::Error("Failed to compact scene journal into '%s'", sceneFile.Filepath());
+			return false;
+		}
+
+		Discard(sceneFile, data.size());
+		return true;
+	}
+
+	void SceneJournal::Discard(const CPath& sceneFile, uint64 sceneSize)
+	{
+		{
+			std::lock_guard<std::mutex> lock(s_SizesMutex);
+			JournalSizes& sizes = s_Sizes[sceneFile.Filepath()];
+			sizes.m_SceneSize = sceneSize;
+			sizes.m_JournalSize = 0;
+			s_Broken.erase(sceneFile.Filepath());
+		}
+
+		CPath journalPath = GetPath(sceneFile);
+		if (IFile::IsFile(journalPath) && !IFile::DeleteFile(journalPath))
+		{
+			Log::Warning("Failed to delete scene journal '%s'", journalPath.Filepath());
+		}
+	}
+
+	bool SceneJournal::NeedsFullSave(const CPath& sceneFile)
+	{
+		std::lock_guard<std::mutex> lock(s_SizesMutex);
+		return s_Broken.find(sceneFile.Filepath()) != s_Broken.end();
+	}
+
+	size_t SceneJournal::GetIntactSize(std::string_view journal)
+	{
+		size_t lastNewline = journal.rfind('\n');
+		return lastNewline == std::string_view::npos ? 0 : lastNewline + 1;
+	}
+
+	bool SceneJournal::Apply(std::string_view journal, SceneSnapshot& snapshot)
+	{
+		size_t start = 0;
+		while (start < journal.size())
+		{
+			size_t end = journal.find('\n', start);
+			if (end == std::string_view::npos)
+			{
+				end = journal.size();
+			}
+
+			std::string_view line = journal.substr(start, end - start);
+			start = end + 1;
+			if (line.find_first_not_of(" \t\r") == std::string_view::npos)
+			{
+				continue;
+			}
+
+			SceneSnapshot record;
+			if (!SceneReader::Read(line, record))
+			{
+				Log::Warning("Stopped applying scene journal at a broken record, later edits are lost.");
+				return false;
+			}
+
+			// Every record carries the whole asset list as it was when the record was written
+			snapshot.m_Project = std::move(record.m_Project);
+			if (!record.m_Assets.is_null())
+			{
+				snapshot.m_Assets = std::move(record.m_Assets);
+			}
+
+			SceneComponents::ForEach([&](auto tag)
+			{
+				using Component = typename decltype(tag)::Type;
+				ApplyColumn(snapshot.Column<Component>(), record.Column<Component>(), record.m_Removed);
+			});
+		}
+
+		return true;
+	}
+
+	bool SceneJournal::Read(std::string_view data, const CPath& sceneFile, SceneSnapshot& snapshot)
+	{
+		bool read = SceneBinary::IsBinary(data)
+			? SceneBinary::Read(data, snapshot)
+			: SceneReader::Read(data, snapshot);
+		if (!read)
+		{
+			return false;
+		}
+
+		CPath journalPath = GetPath(sceneFile);
+		if (IFile::IsFile(journalPath))
+		{
+			File* journal = IFile::OpenFile(journalPath);
+			if (!Apply(journal->m_Data, snapshot))
+			{
+				MarkBroken(sceneFile);
+			}
+			IFile::CloseFile(journal);
+		}
+		return true;
+	}
+}
@@ -0,0 +1,545 @@
+#include "cocoa/scenes/SceneReader.h"
+#include "cocoa/scenes/Scene.h"
+#include "cocoa/core/Entity.h"
+#include "cocoa/systems/ScriptSystem.h"
+#include "cocoa/core/AssetManager.h"
+#include "cocoa/util/Log.h"
+
+namespace Cocoa
+{
+	// Nesting depth of the interesting parts of a scene file:
+	//   1: { "Assets", "Components", "Project", "Size" }
+	//   2: "Components": [ ... ]
+	//   3: { "Transform": ... }
+	//   4: { "Entity", "Position", ... }
+	//   5: { "X", "Y", "Z", "W" }
+	static const int ROOT_DEPTH = 1;
+	static const int COMPONENTS_DEPTH = 2;
+	static const int WRAPPER_DEPTH = 3;
+	static const int BODY_DEPTH = 4;
+	static const int VECTOR_DEPTH = 5;
+
+	enum class SceneRootKey : uint8
+	{
+		None,
+		Assets,
+		Components,
+		Project,
+		Removed
+	};
+
+	// ComponentRegistry::Find gives -1 for keys without a codec, these are handed to the script module
+	static const int SCRIPT_COMPONENT = -1;
+	// No key read yet in the current component
+	static const int NO_COMPONENT = -2;
+
+	static const uint32 ENTITY_FIELD = HashComponentName("Entity");
+
+	static int AxisFromKey(const std::string& key)
+	{
+		if (key.size() != 1)
+		{
+			return -1;
+		}
+
+		switch (key[0])
+		{
+		case 'X': return 0;
+		case 'Y': return 1;
+		case 'Z': return 2;
+		case 'W': return 3;
+		default: return -1;
+		}
+	}
+
+	// Builds a json value from SAX events, used for the parts of the file that stay json
+	class SaxDomBuilder
+	{
+	public:
+		void Begin(json* root, const std::string* key = nullptr)
+		{
+			m_Root = root;
+			m_Stack.clear();
+			if (key != nullptr)
+			{
+				// Picking up inside an object that has already started
+				m_Stack.push_back(root);
+				m_Key = *key;
+			}
+		}
+
+		void Key(const std::string& key) { m_Key = key; }
+
+		// Returns true once the value that was started is complete
+		bool Value(json&& value)
+		{
+			Add(std::move(value));
+			return m_Stack.empty();
+		}
+
+		void BeginContainer(json&& container)
+		{
+			m_Stack.push_back(Add(std::move(container)));
+		}
+
+		bool EndContainer()
+		{
+			m_Stack.pop_back();
+			return m_Stack.empty();
+		}
+
+	private:
+		json* Add(json&& value)
+		{
+			if (m_Stack.empty())
+			{
+				*m_Root = std::move(value);
+				return m_Root;
+			}
+
+			json& parent = *m_Stack.back();
+			if (parent.is_array())
+			{
+				parent.push_back(std::move(value));
+				return &parent.back();
+			}
+
+			json& slot = parent[m_Key];
+			slot = std::move(value);
+			return &slot;
+		}
+
+	private:
+		json* m_Root = nullptr;
+		// Only ever holds the chain of open containers, appending to the innermost one never moves its parents
+		std::vector<json*> m_Stack;
+		std::string m_Key;
+	};
+
+	// Handler for json::sax_parse. The callback names are the ones nlohmann looks for
+	class SceneSaxHandler
+	{
+	public:
+		SceneSaxHandler(SceneSnapshot& snapshot)
+			: m_Snapshot(snapshot)
+		{
+		}
+
+		bool null() { return Scalar(json()); }
+		bool boolean(bool value) { return Scalar(json(value)); }
+		bool number_integer(json::number_integer_t value) { return Scalar(json(value)); }
+		bool number_unsigned(json::number_unsigned_t value) { return Scalar(json(value)); }
+		bool number_float(json::number_float_t value, const json::string_t& text) { return Scalar(json(value)); }
+		bool string(json::string_t& value) { return Scalar(json(std::move(value))); }
+
+		template<typename Binary>
+		bool binary(Binary& value)
+		{
+			return Scalar(json());
+		}
+
+		bool start_object(std::size_t count)
+		{
+			m_Depth++;
+			if (m_Capturing)
+			{
+				m_Builder.BeginContainer(json::object());
+			}
+			else if (m_Depth == WRAPPER_DEPTH && m_InComponents)
+			{
+				m_Index = NO_COMPONENT;
+				m_BodyActive = false;
+				m_HasEntity = false;
+			}
+			return true;
+		}
+
+		bool end_object()
+		{
+			m_Depth--;
+			if (m_Capturing)
+			{
+				if (m_Builder.EndContainer())
+				{
+					EndCapture();
+				}
+			}
+			else if (m_Depth == COMPONENTS_DEPTH && m_InComponents)
+			{
+				CommitComponent();
+			}
+			return true;
+		}
+
+		bool start_array(std::size_t count)
+		{
+			m_Depth++;
+			if (m_Capturing)
+			{
+				m_Builder.BeginContainer(json::array());
+			}
+			else if (m_Depth == COMPONENTS_DEPTH && m_RootKey == SceneRootKey::Components)
+			{
+				m_InComponents = true;
+			}
+			return true;
+		}
+
+		bool end_array()
+		{
+			m_Depth--;
+			if (m_Capturing)
+			{
+				if (m_Builder.EndContainer())
+				{
+					EndCapture();
+				}
+			}
+			else if (m_Depth == ROOT_DEPTH)
+			{
+				m_InComponents = false;
+			}
+			return true;
+		}
+
+		bool key(json::string_t& key)
+		{
+			if (m_Capturing)
+			{
+				m_Builder.Key(key);
+				return true;
+			}
+
+			if (m_Depth == ROOT_DEPTH)
+			{
+				m_RootKey = key == "Assets" ? SceneRootKey::Assets
+					: key == "Components" ? SceneRootKey::Components
+					: key == "Project" ? SceneRootKey::Project
+					: key == "Removed" ? SceneRootKey::Removed
+					: SceneRootKey::None;
+				if (m_RootKey == SceneRootKey::Assets || m_RootKey == SceneRootKey::Removed)
+				{
+					// Both are tiny next to the components
+					m_Capturing = true;
+					m_CapturingScript = false;
+					m_Builder.Begin(m_RootKey == SceneRootKey::Assets ? &m_Snapshot.m_Assets : &m_Removed);
+				}
+			}
+			else if (m_InComponents && m_Depth == WRAPPER_DEPTH)
+			{
+				// Like the DOM loader, the first key decides what the component is and anything after it is ignored
+				m_BodyActive = m_Index == NO_COMPONENT;
+				if (!m_BodyActive)
+				{
+					return true;
+				}
+
+				m_Index = ComponentRegistry::Find(key);
+				m_Field = 0;
+				if (m_Index == SCRIPT_COMPONENT)
+				{
+					// Scripts are handed to the script module as json, so the rest of this component becomes a DOM
+					m_ScriptComponent = json::object();
+					m_Capturing = true;
+					m_CapturingScript = true;
+					m_Builder.Begin(&m_ScriptComponent, &key);
+				}
+				else
+				{
+					m_ResourceId = std::numeric_limits<uint32>::max();
+					SceneComponents::Visit(m_Index, [this](auto tag)
+					{
+						using Component = typename decltype(tag)::Type;
+						std::get<Component>(m_Components) = Component();
+					});
+				}
+			}
+			else if (m_InComponents && m_BodyActive && m_Depth == BODY_DEPTH)
+			{
+				m_Field = HashComponentName(key);
+				m_Axis = -1;
+			}
+			else if (m_InComponents && m_BodyActive && m_Depth == VECTOR_DEPTH)
+			{
+				m_Axis = AxisFromKey(key);
+			}
+			return true;
+		}
+
+		template<typename Exception>
+		bool parse_error(std::size_t position, const std::string& lastToken, const Exception& exception)
+		{
+			Log::Warning("Failed to parse scene at byte %d: %s", (int)position, exception.what());
+			return false;
+		}
+
+		void Finish()
+		{
+			m_Snapshot.m_Scripts = {
+				{"Size", m_Scripts.size()},
+				{"Components", std::move(m_Scripts)}
+			};
+
+			// Only journal records have these
+			if (m_Removed.is_array())
+			{
+				for (const json& removed : m_Removed)
+				{
+					if (removed.is_object() && removed.contains("Entity") && removed["Entity"].is_number()
+						&& removed.contains("Mask") && removed["Mask"].is_number())
+					{
+						m_Snapshot.m_Removed.emplace_back(entt::entity((uint32)removed["Entity"]), (uint32)removed["Mask"]);
+					}
+				}
+			}
+		}
+
+	private:
+		bool Scalar(json&& value)
+		{
+			if (m_Capturing)
+			{
+				if (m_Builder.Value(std::move(value)))
+				{
+					EndCapture();
+				}
+				return true;
+			}
+
+			if (m_Depth == ROOT_DEPTH && m_RootKey == SceneRootKey::Project && value.is_string())
+			{
+				m_Snapshot.m_Project = std::move(value.get_ref<std::string&>());
+			}
+			else if (m_InComponents && m_BodyActive && (value.is_number() || value.is_boolean()))
+			{
+				if (m_Depth == BODY_DEPTH && m_Field == ENTITY_FIELD)
+				{
+					if (value.is_number())
+					{
+						m_Entity = value.get<uint32>();
+						m_HasEntity = true;
+					}
+				}
+				else if (m_Depth == BODY_DEPTH || (m_Depth == VECTOR_DEPTH && m_Axis >= 0 && value.is_number()))
+				{
+					int axis = m_Depth == VECTOR_DEPTH ? m_Axis : -1;
+					SceneComponents::Visit(m_Index, [&](auto tag)
+					{
+						using Component = typename decltype(tag)::Type;
+						ComponentCodec<Component>::ReadField(std::get<Component>(m_Components), m_Field, axis, value, m_ResourceId);
+					});
+				}
+			}
+			return true;
+		}
+
+		void CommitComponent()
+		{
+			if (m_Index < 0)
+			{
+				return;
+			}
+
+			if (!m_HasEntity)
+			{
+				Log::Warning("Skipping scene component without an entity.");
+				return;
+			}
+
+			SceneComponents::Visit(m_Index, [this](auto tag)
+			{
+				using Component = typename decltype(tag)::Type;
+				Component& component = std::get<Component>(m_Components);
+				ComponentCodec<Component>::FinishRead(component);
+
+				ComponentColumn<Component>& column = m_Snapshot.Column<Component>();
+				column.m_Entities.push_back(entt::entity(m_Entity));
+				column.m_Components.push_back(component);
+				if constexpr (ComponentCodec<Component>::REFERENCES_ASSET)
+				{
+					column.m_ResourceIds.push_back(m_ResourceId);
+				}
+			});
+		}
+
+		void EndCapture()
+		{
+			m_Capturing = false;
+			if (m_CapturingScript)
+			{
+				m_Scripts.emplace_back(std::move(m_ScriptComponent));
+				m_CapturingScript = false;
+			}
+		}
+
+	private:
+		SceneSnapshot& m_Snapshot;
+
+		int m_Depth = 0;
+		SceneRootKey m_RootKey = SceneRootKey::None;
+		bool m_InComponents = false;
+
+		bool m_Capturing = false;
+		bool m_CapturingScript = false;
+		SaxDomBuilder m_Builder;
+		json m_ScriptComponent;
+		json m_Scripts = json::array();
+		json m_Removed;
+
+		// The engine component currently being parsed
+		int m_Index = NO_COMPONENT;
+		uint32 m_Field = 0;
+		int m_Axis = -1;
+		bool m_BodyActive = false;
+		bool m_HasEntity = false;
+		uint32 m_Entity = 0;
+		uint32 m_ResourceId = std::numeric_limits<uint32>::max();
+		SceneComponents::Values m_Components;
+	};
+
+	bool SceneReader::Read(std::string_view data, SceneSnapshot& snapshot)
+	{
+		SceneSaxHandler handler(snapshot);
+		if (!json::sax_parse(data.data(), data.data() + data.size(), &handler))
+		{
+			return false;
+		}
+
+		handler.Finish();
+		return true;
+	}
+
+	template<typename Component>
+	static void CreateEntities(entt::registry& registry, const ComponentColumn<Component>& column)
+	{
+		for (entt::entity entity : column.m_Entities)
+		{
+			if (!registry.valid(entity))
+			{
+				registry.create(entity);
+			}
+		}
+	}
+
+	template<typename Component>
+	static void InsertColumn(entt::registry& registry, ComponentColumn<Component>& column, const std::unordered_map<uint32, uint32>& resourceIdMap)
+	{
+		if (column.Size() == 0)
+		{
+			return;
+		}
+
+		ApplyResourceIds(column, resourceIdMap);
+
+		registry.insert<Component>(column.m_Entities.begin(), column.m_Entities.end(), column.m_Components.begin(), column.m_Components.end());
+	}
+
+	bool SceneReader::Load(std::string_view data, Scene* scene, ScriptSystem* scriptSystem, bool scriptsOnly)
+	{
+		SceneSnapshot snapshot;
+		if (!Read(data, snapshot))
+		{
+			return false;
+		}
+
+		Insert(snapshot, scene, scriptSystem, scriptsOnly);
+		return true;
+	}
+
+	void SceneReader::InsertScripts(json& scripts, Scene* scene, ScriptSystem* scriptSystem)
+	{
+		entt::registry& registry = scene->GetRegistry();
+		for (json& component : scripts["Components"])
+		{
+			const json& body = component.front();
+			if (!body.is_object() || !body.contains("Entity") || !body["Entity"].is_number())
+			{
+				Log::Warning("Skipping script component without an entity.");
+				continue;
+			}
+
+			entt::entity entity = entt::entity((uint32)body["Entity"]);
+			if (!registry.valid(entity))
+			{
+				registry.create(entity);
+			}
+			scriptSystem->Deserialize(component, Entity(entity, scene));
+		}
+	}
+
+	void SceneReader::Insert(SceneSnapshot& snapshot, Scene* scene, ScriptSystem* scriptSystem, bool scriptsOnly)
+	{
+		entt::registry& registry = scene->GetRegistry();
+		if (!scriptsOnly)
+		{
+			std::unordered_map<uint32, uint32> resourceIdMap{};
+			if (!snapshot.m_Assets.is_null())
+			{
+				resourceIdMap = AssetManager::LoadFrom(snapshot.m_Assets);
+			}
+
+			SceneComponents::ForEach([&](auto tag)
+			{
+				CreateEntities(registry, snapshot.Column<typename decltype(tag)::Type>());
+			});
+			SceneComponents::ForEach([&](auto tag)
+			{
+				InsertColumn(registry, snapshot.Column<typename decltype(tag)::Type>(), resourceIdMap);
+			});
+		}
+
+		if (scriptSystem != nullptr)
+		{
+			InsertScripts(snapshot.m_Scripts, scene, scriptSystem);
+		}
+	}
+
+	void SceneReader::InsertComponents(SceneSnapshot& snapshot, entt::registry& registry)
+	{
+		static const std::unordered_map<uint32, uint32> noResources{};
+		SceneComponents::ForEach([&](auto tag)
+		{
+			CreateEntities(registry, snapshot.Column<typename decltype(tag)::Type>());
+		});
+		SceneComponents::ForEach([&](auto tag)
+		{
+			using Component = typename decltype(tag)::Type;
+			ComponentColumn<Component>& column = snapshot.Column<Component>();
+			InsertColumn(registry, column, noResources);
+			// The registry has its own copy now, only the entities and resource ids are needed later
+			std::vector<Component>().swap(column.m_Components);
+		});
+	}
+
+	void SceneReader::InsertAssetsAndScripts(SceneSnapshot& snapshot, Scene* scene, ScriptSystem* scriptSystem, bool resolveAssets)
+	{
+		entt::registry& registry = scene->GetRegistry();
+		std::unordered_map<uint32, uint32> resourceIdMap{};
+		if (!snapshot.m_Assets.is_null())
+		{
+			resourceIdMap = resolveAssets ? AssetManager::ResolveFrom(snapshot.m_Assets) : AssetManager::LoadFrom(snapshot.m_Assets);
+		}
+
+		SceneComponents::ForEach([&](auto tag)
+		{
+			using Component = typename decltype(tag)::Type;
+			if constexpr (ComponentCodec<Component>::REFERENCES_ASSET)
+			{
+				const ComponentColumn<Component>& column = snapshot.Column<Component>();
+				for (size_t i = 0; i < column.m_ResourceIds.size(); i++)
+				{
+					if (column.m_ResourceIds[i] != std::numeric_limits<uint32>::max() && registry.has<Component>(column.m_Entities[i]))
+					{
+						auto it = resourceIdMap.find(column.m_ResourceIds[i]);
+						ComponentCodec<Component>::SetResourceId(registry.get<Component>(column.m_Entities[i]), it != resourceIdMap.end() ? it->second : 0);
+					}
+				}
+			}
+		});
+
+		if (scriptSystem != nullptr)
+		{
+			InsertScripts(snapshot.m_Scripts, scene, scriptSystem);
+		}
+	}
+}
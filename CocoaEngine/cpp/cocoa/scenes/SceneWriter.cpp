@@ -0,0 +1,230 @@
+#include "cocoa/scenes/SceneWriter.h"
+#include "cocoa/scenes/SceneBinary.h"
+#include "cocoa/scenes/SceneJournal.h"
+#include "cocoa/file/IFile.h"
+#include "cocoa/file/JsonWriter.h"
+#include "cocoa/util/Log.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace Cocoa
+{
+	struct SceneWriterState
+	{
+		std::thread m_Thread;
+		std::mutex m_Mutex;
+		std::condition_variable m_WorkCondition;
+		std::condition_variable m_IdleCondition;
+		std::vector<SceneSnapshot*> m_Pending;
+		bool m_Writing = false;
+		bool m_Stopping = false;
+	};
+
+	SceneWriterState* SceneWriter::s_Instance = nullptr;
+
+	static void WriteSnapshot(SceneSnapshot* snapshot)
+	{
+		if (snapshot->m_Delta)
+		{
+			SceneJournal::Append(*snapshot);
+			delete snapshot;
+			return;
+		}
+
+		std::string data;
+		if (SceneBinary::IsBinaryPath(snapshot->m_Filename))
+		{
+			data = SceneBinary::Write(*snapshot);
+		}
+		else
+		{
+			SceneWriter::Write(*snapshot, data, snapshot->m_Compact);
+		}
+
+		if (!IFile::WriteFileAtomic(data, snapshot->m_Filename))
+		{
+			Log::Error("Failed to save scene '%s'", snapshot->m_Filename.Filepath());
+		}
+		else
+		{
+			// Everything the journal held is in the file now
+			SceneJournal::Discard(snapshot->m_Filename, data.size());
+		}
+
+		delete snapshot;
+	}
+
+	static void WriterMain(SceneWriterState* state)
+	{
+		while (true)
+		{
+			SceneSnapshot* snapshot = nullptr;
+			{
+				std::unique_lock<std::mutex> lock(state->m_Mutex);
+				state->m_WorkCondition.wait(lock, [state]() { return state->m_Stopping || state->m_Pending.size() > 0; });
+				if (state->m_Pending.size() == 0)
+				{
+					return;
+				}
+
+				snapshot = state->m_Pending.front();
+				state->m_Pending.erase(state->m_Pending.begin());
+				state->m_Writing = true;
+			}
+
+			WriteSnapshot(snapshot);
+
+			{
+				std::lock_guard<std::mutex> lock(state->m_Mutex);
+				state->m_Writing = false;
+				if (state->m_Pending.size() == 0)
+				{
+					state->m_IdleCondition.notify_all();
+				}
+			}
+		}
+	}
+
+	void SceneWriter::Init()
+	{
+		Log::Assert(s_Instance == nullptr, "SceneWriter already initialized.");
+		s_Instance = new SceneWriterState();
+		s_Instance->m_Thread = std::thread(WriterMain, s_Instance);
+	}
+
+	void SceneWriter::Destroy()
+	{
+		if (s_Instance == nullptr)
+		{
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(s_Instance->m_Mutex);
+			s_Instance->m_Stopping = true;
+		}
+		s_Instance->m_WorkCondition.notify_one();
+		s_Instance->m_Thread.join();
+
+		delete s_Instance;
+		s_Instance = nullptr;
+	}
+
+	void SceneWriter::Submit(SceneSnapshot* snapshot)
+	{
+		if (s_Instance == nullptr)
+		{
+			WriteSnapshot(snapshot);
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(s_Instance->m_Mutex);
+			if (!snapshot->m_Delta)
+			{
+				// Only the newest state of a file is worth writing, it already holds every pending delta
+				std::vector<SceneSnapshot*>& pending = s_Instance->m_Pending;
+				pending.erase(std::remove_if(pending.begin(), pending.end(), [snapshot](SceneSnapshot* other)
+				{
+					if (other->m_Filename == snapshot->m_Filename)
+					{
+						delete other;
+						return true;
+					}
+					return false;
+				}), pending.end());
+			}
+
+			s_Instance->m_Pending.push_back(snapshot);
+		}
+		s_Instance->m_WorkCondition.notify_one();
+	}
+
+	void SceneWriter::Flush()
+	{
+		if (s_Instance == nullptr)
+		{
+			return;
+		}
+
+		std::unique_lock<std::mutex> lock(s_Instance->m_Mutex);
+		s_Instance->m_IdleCondition.wait(lock, []() { return s_Instance->m_Pending.size() == 0 && !s_Instance->m_Writing; });
+	}
+
+	template<typename Component>
+	static void WriteColumn(JsonWriter& writer, const ComponentColumn<Component>& column)
+	{
+		for (size_t i = 0; i < column.Size(); i++)
+		{
+			uint32 resourceId = ComponentCodec<Component>::REFERENCES_ASSET ? column.m_ResourceIds[i] : std::numeric_limits<uint32>::max();
+			writer.BeginObject();
+			writer.Key(ComponentCodec<Component>::NAME);
+			writer.BeginObject();
+			ComponentCodec<Component>::Write(writer, (uint32)entt::to_integral(column.m_Entities[i]), column.m_Components[i], resourceId);
+			writer.EndObject();
+			writer.EndObject();
+		}
+	}
+
+	void SceneWriter::Write(const SceneSnapshot& snapshot, std::string& output, bool compact)
+	{
+		const json* scripts = snapshot.m_Scripts.contains("Components") ? &snapshot.m_Scripts["Components"] : nullptr;
+		size_t scriptCount = scripts && snapshot.m_Scripts.contains("Size") ? (size_t)snapshot.m_Scripts["Size"] : 0;
+		size_t componentCount = scriptCount;
+		SceneComponents::ForEach([&](auto tag)
+		{
+			componentCount += snapshot.Column<typename decltype(tag)::Type>().Size();
+		});
+		output.reserve(output.size() + componentCount * (compact ? 160 : 400) + 1024);
+
+		// Keys are written in sorted order, that is how json::dump always laid the file out
+		JsonWriter writer(output, !compact);
+		writer.BeginObject();
+		writer.Key("Assets");
+		writer.Value(snapshot.m_Assets);
+
+		writer.Key("Components");
+		if (componentCount == 0)
+		{
+			writer.Null();
+		}
+		else
+		{
+			// Same order entt::snapshot visits the pools in, so the output matches what Scene::Save always wrote
+			writer.BeginArray();
+			SceneComponents::ForEach([&](auto tag)
+			{
+				WriteColumn(writer, snapshot.Column<typename decltype(tag)::Type>());
+			});
+
+			for (size_t i = 0; i < scriptCount; i++)
+			{
+				writer.Value(i < scripts->size() ? (*scripts)[i] : json());
+			}
+			writer.EndArray();
+		}
+
+		writer.Key("Project");
+		writer.String(snapshot.m_Project);
+		if (snapshot.m_Removed.size() > 0)
+		{
+			writer.Key("Removed");
+			writer.BeginArray();
+			for (const auto& [entity, mask] : snapshot.m_Removed)
+			{
+				writer.BeginObject();
+				writer.Key("Entity");
+				writer.UInt(entt::to_integral(entity));
+				writer.Key("Mask");
+				writer.UInt(mask);
+				writer.EndObject();
+			}
+			writer.EndArray();
+		}
+		writer.Key("Size");
+		writer.Int((int64)componentCount);
+		writer.EndObject();
+	}
+}
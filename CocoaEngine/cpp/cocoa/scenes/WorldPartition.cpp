@@ -0,0 +1,732 @@
+#include "cocoa/scenes/WorldPartition.h"
+#include "cocoa/scenes/Scene.h"
+#include "cocoa/scenes/SceneWriter.h"
+#include "cocoa/scenes/SceneBinary.h"
+#include "cocoa/scenes/SceneReader.h"
+#include "cocoa/physics2d/Physics2D.h"
+#include "cocoa/systems/ScriptSystem.h"
+#include "cocoa/components/Transform.h"
+#include "cocoa/core/AssetManager.h"
+#include "cocoa/file/AsyncIO.h"
+#include "cocoa/file/IFile.h"
+#include "cocoa/util/JsonExtended.h"
+#include "cocoa/util/Settings.h"
+#include "cocoa/util/Log.h"
+
+namespace Cocoa
+{
+	static const uint32 INDEX_VERSION = 1;
+
+	// Script components as ScriptSystem::SaveScripts writes them, only the ones of entities keep accepts
+	template<typename Predicate>
+	static json FilterScripts(const json& scripts, Predicate keep)
+	{
+		json res = {
+			{"Size", 0},
+			{"Components", json::array()}
+		};
+		if (!scripts.is_object() || !scripts.contains("Components"))
+		{
+			return res;
+		}
+
+		for (const json& component : scripts["Components"])
+		{
+			if (!component.is_object() || component.empty())
+			{
+				continue;
+			}
+
+			const json& body = component.front();
+			if (body.is_object() && body.contains("Entity") && body["Entity"].is_number() && keep(entt::entity((uint32)body["Entity"])))
+			{
+				res["Components"].push_back(component);
+			}
+		}
+		res["Size"] = res["Components"].size();
+		return res;
+	}
+
+	WorldPartition::WorldPartition(Scene* scene)
+		: m_Scene(scene)
+	{
+	}
+
+	WorldPartition::~WorldPartition()
+	{
+		// The registry goes away with the scene, only the background work has to be waited on
+		for (Cell* cell : m_LoadedCells)
+		{
+			Finish(*cell);
+		}
+	}
+
+	CPath WorldPartition::GetDirectory(const CPath& sceneFile)
+	{
+		return CPath(std::string(sceneFile.Filepath()) + ".cells");
+	}
+
+	bool WorldPartition::HasPartition(const CPath& sceneFile)
+	{
+		return IFile::IsFile(GetDirectory(sceneFile) + "index.json");
+	}
+
+	uint64 WorldPartition::KeyOf(int32 x, int32 y)
+	{
+		return ((uint64)(uint32)x << 32) | (uint64)(uint32)y;
+	}
+
+	glm::ivec2 WorldPartition::CellOf(const glm::vec2& position) const
+	{
+		return glm::ivec2((int32)glm::floor(position.x / m_CellSize), (int32)glm::floor(position.y / m_CellSize));
+	}
+
+	CPath WorldPartition::GetCellPath(const Cell& cell) const
+	{
+		return GetDirectory(m_SceneFile) + ("cell_" + std::to_string(cell.m_X) + "_" + std::to_string(cell.m_Y) + ".cocoabin");
+	}
+
+	WorldPartition::Cell& WorldPartition::GetOrCreateCell(int32 x, int32 y)
+	{
+		std::unique_ptr<Cell>& cell = m_Cells[KeyOf(x, y)];
+		if (cell == nullptr)
+		{
+			cell = std::make_unique<Cell>();
+			cell->m_X = x;
+			cell->m_Y = y;
+		}
+		return *cell;
+	}
+
+	entt::entity WorldPartition::RootOf(entt::entity entity) const
+	{
+		const entt::registry& registry = m_Scene->GetRegistry();
+		size_t steps = 0;
+		size_t maxSteps = registry.size<Transform>();
+		const Transform* transform = registry.try_get<Transform>(entity);
+		while (transform != nullptr && transform->m_Parent != entt::null && registry.valid(transform->m_Parent) && steps <= maxSteps)
+		{
+			const Transform* parent = registry.try_get<Transform>(transform->m_Parent);
+			if (parent == nullptr)
+			{
+				break;
+			}
+
+			entity = transform->m_Parent;
+			transform = parent;
+			steps++;
+		}
+		return entity;
+	}
+
+	uint64 WorldPartition::CurrentKeyOf(entt::entity entity) const
+	{
+		const Transform& root = m_Scene->GetRegistry().get<Transform>(RootOf(entity));
+		glm::ivec2 cell = CellOf(glm::vec2(root.m_WorldPosition.x, root.m_WorldPosition.y));
+		return KeyOf(cell.x, cell.y);
+	}
+
+	bool WorldPartition::IsWithin(const Cell& cell, const std::vector<glm::ivec2>& sourceCells, int radius) const
+	{
+		for (const glm::ivec2& source : sourceCells)
+		{
+			if (glm::abs(cell.m_X - source.x) <= radius && glm::abs(cell.m_Y - source.y) <= radius)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool WorldPartition::HasUnsavedChanges(const Cell& cell) const
+	{
+		if (m_Scene->IsPlaying())
+		{
+			return false;
+		}
+
+		for (entt::entity entity : cell.m_Entities)
+		{
+			if (m_Scene->IsDirty(entity))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void WorldPartition::SetRadii(int loadRadius, int unloadRadius)
+	{
+		m_LoadRadius = loadRadius < 0 ? 0 : loadRadius;
+		m_UnloadRadius = unloadRadius > m_LoadRadius ? unloadRadius : m_LoadRadius + 1;
+	}
+
+	bool WorldPartition::Build(const CPath& sceneFile, float cellSize)
+	{
+		if (IsOpen())
+		{
+			Log::Warning("Scene '%s' is already partitioned.", m_SceneFile.Filepath());
+			return false;
+		}
+		if (cellSize <= 0.0f)
+		{
+			Log::Warning("Cannot partition a scene into cells of size %2.3f.", cellSize);
+			return false;
+		}
+
+		m_SceneFile = sceneFile;
+		m_CellSize = cellSize;
+
+		auto view = m_Scene->GetRegistry().view<Transform>();
+		for (entt::entity entity : view)
+		{
+			uint64 key = CurrentKeyOf(entity);
+			Cell& cell = GetOrCreateCell((int32)(key >> 32), (int32)(uint32)key);
+			cell.m_Entities.push_back(entity);
+			m_Owners[entity] = key;
+		}
+
+		json scripts = {
+			{"Size", 0},
+			{"Components", {}}
+		};
+		if (ScriptSystem* scriptSystem = m_Scene->GetScriptSystem())
+		{
+			scriptSystem->SaveScripts(scripts);
+		}
+
+		IFile::CreateDirIfNotExists(GetDirectory(m_SceneFile));
+		for (auto& [key, cell] : m_Cells)
+		{
+			cell->m_State = CellState::Active;
+			m_LoadedCells.push_back(cell.get());
+			WriteCell(*cell, scripts);
+		}
+		WriteIndex();
+
+		Log::Info("Partitioned %d entities of %s into %d cells", (int)m_Owners.size(), sceneFile.Filepath(), (int)m_Cells.size());
+		return true;
+	}
+
+	bool WorldPartition::Open(const CPath& sceneFile)
+	{
+		Close();
+
+		File* indexFile = IFile::OpenFile(GetDirectory(sceneFile) + "index.json");
+		json j = indexFile->m_Data.size() > 0
+			? json::parse(indexFile->m_Data.begin(), indexFile->m_Data.end(), nullptr, false)
+			: json();
+		IFile::CloseFile(indexFile);
+
+		uint32 version = 0;
+		float cellSize = 0.0f;
+		if (!j.is_discarded())
+		{
+			JsonExtended::AssignIfNotNull(j["Version"], version);
+			JsonExtended::AssignIfNotNull(j["CellSize"], cellSize);
+		}
+		if (version != INDEX_VERSION || cellSize <= 0.0f)
+		{
+			Log::Warning("Cell index of '%s' is missing or unreadable.", sceneFile.Filepath());
+			return false;
+		}
+
+		m_SceneFile = sceneFile;
+		m_CellSize = cellSize;
+		int loadRadius = m_LoadRadius;
+		int unloadRadius = m_UnloadRadius;
+		JsonExtended::AssignIfNotNull(j["LoadRadius"], loadRadius);
+		JsonExtended::AssignIfNotNull(j["UnloadRadius"], unloadRadius);
+		SetRadii(loadRadius, unloadRadius);
+
+		entt::registry& registry = m_Scene->GetRegistry();
+		for (const json& cellJson : j["Cells"])
+		{
+			int32 x = 0;
+			int32 y = 0;
+			JsonExtended::AssignIfNotNull(cellJson["X"], x);
+			JsonExtended::AssignIfNotNull(cellJson["Y"], y);
+			Cell& cell = GetOrCreateCell(x, y);
+			uint64 key = KeyOf(x, y);
+
+			for (const json& id : cellJson["Entities"])
+			{
+				entt::entity entity = entt::entity((uint32)id);
+				// Keeps the id taken while the cell is out, so nothing created meanwhile can end up with it
+				if (!registry.valid(entity) && registry.create(entity) != entity)
+				{
+					Log::Warning("Entity %d of cell (%d, %d) is taken by another entity.", (uint32)id, x, y);
+					continue;
+				}
+
+				cell.m_Entities.push_back(entity);
+				m_Owners[entity] = key;
+			}
+		}
+
+		Log::Info("Opened %d cells of %s", (int)m_Cells.size(), sceneFile.Filepath());
+		return true;
+	}
+
+	void WorldPartition::Close()
+	{
+		if (!IsOpen())
+		{
+			return;
+		}
+
+		for (Cell* cell : m_LoadedCells)
+		{
+			Finish(*cell);
+			if (cell->m_State == CellState::Active)
+			{
+				Deactivate(*cell);
+			}
+		}
+
+		entt::registry& registry = m_Scene->GetRegistry();
+		for (const auto& [entity, key] : m_Owners)
+		{
+			if (registry.valid(entity))
+			{
+				registry.destroy(entity);
+			}
+		}
+
+		m_LoadedCells.clear();
+		m_Cells.clear();
+		m_Owners.clear();
+		m_CellSize = 0.0f;
+	}
+
+	void WorldPartition::Update(const std::vector<glm::vec2>& sources)
+	{
+		if (!IsOpen())
+		{
+			return;
+		}
+
+		std::vector<glm::ivec2> sourceCells;
+		sourceCells.reserve(sources.size());
+		for (const glm::vec2& source : sources)
+		{
+			glm::ivec2 center = CellOf(source);
+			sourceCells.push_back(center);
+
+			// Only the cells around the source are looked up, a huge level costs nothing more here
+			for (int32 y = center.y - m_LoadRadius; y <= center.y + m_LoadRadius; y++)
+			{
+				for (int32 x = center.x - m_LoadRadius; x <= center.x + m_LoadRadius; x++)
+				{
+					auto it = m_Cells.find(KeyOf(x, y));
+					if (it != m_Cells.end() && it->second->m_State == CellState::Unloaded)
+					{
+						Request(*it->second);
+					}
+				}
+			}
+		}
+
+		int activations = 0;
+		for (Cell* cell : m_LoadedCells)
+		{
+			Poll(*cell);
+			bool keep = IsWithin(*cell, sourceCells, m_UnloadRadius);
+			if (cell->m_State == CellState::Ready)
+			{
+				if (!keep)
+				{
+					Drop(*cell);
+				}
+				else if (activations < m_ActivationsPerFrame)
+				{
+					Activate(*cell);
+					activations++;
+				}
+			}
+			else if (cell->m_State == CellState::Active && !keep && !HasUnsavedChanges(*cell))
+			{
+				// Edited cells stay until the next save writes them, unloading would throw the edits away.
+				// Play mode edits are thrown away on Stop anyway
+				Deactivate(*cell);
+			}
+			// Cells still reading or parsing can't be cancelled, they're dropped once they get to Ready
+		}
+
+		m_LoadedCells.erase(std::remove_if(m_LoadedCells.begin(), m_LoadedCells.end(), [](const Cell* cell)
+		{
+			return cell->m_State == CellState::Unloaded || cell->m_State == CellState::Failed;
+		}), m_LoadedCells.end());
+	}
+
+	void WorldPartition::Request(Cell& cell)
+	{
+		CPath path = GetCellPath(cell);
+		cell.m_State = CellState::Reading;
+		m_LoadedCells.push_back(&cell);
+		if (AsyncIO::IsInitialized())
+		{
+			cell.m_Read = AsyncIO::ReadAsync(path, IOPriority::Streaming);
+		}
+		else
+		{
+			std::promise<File*> read;
+			read.set_value(IFile::OpenFile(path));
+			cell.m_Read = read.get_future();
+		}
+	}
+
+	void WorldPartition::Poll(Cell& cell)
+	{
+		if (cell.m_State == CellState::Reading && cell.m_Read.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+		{
+			File* file = cell.m_Read.get();
+			cell.m_Snapshot = std::make_unique<SceneSnapshot>();
+			cell.m_Parsed = false;
+			cell.m_State = CellState::Parsing;
+
+			Cell* parsing = &cell;
+			auto parse = [parsing, file]()
+			{
+				parsing->m_Parsed = SceneBinary::Read(file->m_Data, *parsing->m_Snapshot);
+				IFile::CloseFile(file);
+			};
+
+			if (JobSystem::IsInitialized())
+			{
+				JobSystem::Submit(parse, &cell.m_Parsing);
+			}
+			else
+			{
+				parse();
+			}
+		}
+
+		if (cell.m_State == CellState::Parsing && cell.m_Parsing.IsDone())
+		{
+			cell.m_State = CellState::Ready;
+			if (!cell.m_Parsed)
+			{
+				Fail(cell);
+			}
+		}
+	}
+
+	void WorldPartition::Finish(Cell& cell)
+	{
+		if (cell.m_State == CellState::Reading)
+		{
+			IFile::CloseFile(cell.m_Read.get());
+			cell.m_State = CellState::Unloaded;
+		}
+		else if (cell.m_State == CellState::Parsing)
+		{
+			JobSystem::Wait(cell.m_Parsing);
+			cell.m_State = CellState::Unloaded;
+		}
+		else if (cell.m_State == CellState::Ready)
+		{
+			cell.m_State = CellState::Unloaded;
+		}
+		cell.m_Snapshot.reset();
+	}
+
+	void WorldPartition::Activate(Cell& cell)
+	{
+		// The ids are reserved already, so this only inserts the component columns
+		SceneReader::InsertComponents(*cell.m_Snapshot, m_Scene->GetRegistry());
+		SceneReader::InsertAssetsAndScripts(*cell.m_Snapshot, m_Scene, m_Scene->GetScriptSystem(), true);
+		cell.m_Snapshot.reset();
+		cell.m_State = CellState::Active;
+
+		if (m_Scene->IsPlaying())
+		{
+			entt::registry& registry = m_Scene->GetRegistry();
+			for (entt::entity entity : cell.m_Entities)
+			{
+				if (registry.has<Rigidbody2D>(entity))
+				{
+					m_Scene->GetPhysics()->AddEntity(Entity(entity, m_Scene));
+				}
+			}
+		}
+	}
+
+	void WorldPartition::Deactivate(Cell& cell)
+	{
+		entt::registry& registry = m_Scene->GetRegistry();
+		ScriptSystem* scriptSystem = m_Scene->GetScriptSystem();
+		for (entt::entity entity : cell.m_Entities)
+		{
+			if (!registry.valid(entity))
+			{
+				continue;
+			}
+
+			if (registry.has<Rigidbody2D>(entity))
+			{
+				m_Scene->GetPhysics()->RemoveEntity(Entity(entity, m_Scene));
+			}
+
+			// The entity itself stays, that's what keeps its id from being reused
+			SceneComponents::ForEach([&](auto tag)
+			{
+				registry.remove_if_exists<typename decltype(tag)::Type>(entity);
+			});
+			registry.remove_if_exists<TransformMatrix>(entity);
+			registry.remove_if_exists<EntityName>(entity);
+			// Scripts live in the script module's registry, they'd keep updating without their entity
+			if (scriptSystem != nullptr)
+			{
+				scriptSystem->RemoveScripts(entity);
+			}
+		}
+		cell.m_State = CellState::Unloaded;
+	}
+
+	void WorldPartition::Drop(Cell& cell)
+	{
+		cell.m_Snapshot.reset();
+		cell.m_State = CellState::Unloaded;
+	}
+
+	void WorldPartition::Fail(Cell& cell)
+	{
+		// Reading it again would fail the same way every frame the camera is near it
+		Log::Warning("Failed to read cell '%s', skipping it until the scene is reopened", GetCellPath(cell).Filepath());
+		cell.m_Snapshot.reset();
+		cell.m_State = CellState::Failed;
+	}
+
+	std::vector<uint64> WorldPartition::GetActiveCells() const
+	{
+		std::vector<uint64> keys;
+		for (const Cell* cell : m_LoadedCells)
+		{
+			if (cell->m_State == CellState::Active)
+			{
+				keys.push_back(KeyOf(cell->m_X, cell->m_Y));
+			}
+		}
+		return keys;
+	}
+
+	void WorldPartition::RestoreActiveCells(const std::vector<uint64>& keys)
+	{
+		// The registry already holds exactly these cells' components, only the bookkeeping changes
+		for (Cell* cell : m_LoadedCells)
+		{
+			Finish(*cell);
+			cell->m_State = CellState::Unloaded;
+		}
+		m_LoadedCells.clear();
+
+		for (uint64 key : keys)
+		{
+			auto it = m_Cells.find(key);
+			if (it != m_Cells.end())
+			{
+				it->second->m_State = CellState::Active;
+				m_LoadedCells.push_back(it->second.get());
+			}
+		}
+	}
+
+	void WorldPartition::Save(const json& scripts)
+	{
+		if (!IsOpen())
+		{
+			return;
+		}
+
+		Rebucket();
+		IFile::CreateDirIfNotExists(GetDirectory(m_SceneFile));
+		for (Cell* cell : m_LoadedCells)
+		{
+			if (cell->m_State == CellState::Active)
+			{
+				WriteCell(*cell, scripts);
+			}
+		}
+		WriteIndex();
+	}
+
+	void WorldPartition::Rebucket()
+	{
+		entt::registry& registry = m_Scene->GetRegistry();
+
+		// What's in the loaded cells is all there is to go on, an unloaded cell's contents are only on disk
+		std::vector<entt::entity> moving;
+		for (Cell* cell : m_LoadedCells)
+		{
+			if (cell->m_State != CellState::Active)
+			{
+				continue;
+			}
+
+			auto it = std::remove_if(cell->m_Entities.begin(), cell->m_Entities.end(), [&](entt::entity entity)
+			{
+				if (!registry.valid(entity) || !registry.has<Transform>(entity))
+				{
+					m_Owners.erase(entity);
+					return true;
+				}
+				return false;
+			});
+			cell->m_Entities.erase(it, cell->m_Entities.end());
+		}
+
+		auto view = registry.view<Transform>();
+		for (entt::entity entity : view)
+		{
+			uint64 key = CurrentKeyOf(entity);
+			auto owner = m_Owners.find(entity);
+			if (owner != m_Owners.end() && owner->second == key)
+			{
+				continue;
+			}
+
+			auto destination = m_Cells.find(key);
+			bool destinationLoaded = destination != m_Cells.end() && destination->second->m_State == CellState::Active;
+			if (!destinationLoaded)
+			{
+				// Entities created in empty space start a new cell, anything else waits for its cell to load
+				if (owner != m_Owners.end() || destination != m_Cells.end())
+				{
+					continue;
+				}
+			}
+
+			if (owner != m_Owners.end())
+			{
+				std::vector<entt::entity>& from = m_Cells[owner->second]->m_Entities;
+				from.erase(std::remove(from.begin(), from.end(), entity), from.end());
+			}
+
+			Cell& cell = GetOrCreateCell((int32)(key >> 32), (int32)(uint32)key);
+			if (cell.m_State == CellState::Unloaded && cell.m_Entities.empty())
+			{
+				cell.m_State = CellState::Active;
+				m_LoadedCells.push_back(&cell);
+			}
+			cell.m_Entities.push_back(entity);
+			m_Owners[entity] = key;
+		}
+	}
+
+	void WorldPartition::Strip(SceneSnapshot& snapshot) const
+	{
+		if (m_Owners.empty())
+		{
+			return;
+		}
+
+		SceneComponents::ForEach([&](auto tag)
+		{
+			using Component = typename decltype(tag)::Type;
+			ComponentColumn<Component>& column = snapshot.Column<Component>();
+			size_t kept = 0;
+			for (size_t i = 0; i < column.Size(); i++)
+			{
+				if (Owns(column.m_Entities[i]))
+				{
+					continue;
+				}
+
+				column.m_Entities[kept] = column.m_Entities[i];
+				column.m_Components[kept] = column.m_Components[i];
+				if constexpr (ComponentCodec<Component>::REFERENCES_ASSET)
+				{
+					column.m_ResourceIds[kept] = column.m_ResourceIds[i];
+				}
+				kept++;
+			}
+
+			column.m_Entities.resize(kept);
+			column.m_Components.resize(kept);
+			if constexpr (ComponentCodec<Component>::REFERENCES_ASSET)
+			{
+				column.m_ResourceIds.resize(kept);
+			}
+		});
+
+		snapshot.m_Scripts = FilterScripts(snapshot.m_Scripts, [this](entt::entity entity) { return !Owns(entity); });
+	}
+
+	void WorldPartition::WriteCell(const Cell& cell, const json& scripts)
+	{
+		const entt::registry& registry = m_Scene->GetRegistry();
+		SceneSnapshot* snapshot = new SceneSnapshot();
+		snapshot->m_Filename = GetCellPath(cell);
+		snapshot->m_Project = Settings::General::s_CurrentProject.Filepath();
+		uint64 key = KeyOf(cell.m_X, cell.m_Y);
+		snapshot->m_Scripts = FilterScripts(scripts, [this, key](entt::entity entity)
+		{
+			auto it = m_Owners.find(entity);
+			return it != m_Owners.end() && it->second == key;
+		});
+
+		SceneSnapshotArchive archive(*snapshot);
+		for (entt::entity entity : cell.m_Entities)
+		{
+			SceneComponents::ForEach([&](auto tag)
+			{
+				using Component = typename decltype(tag)::Type;
+				if (const Component* component = registry.try_get<Component>(entity))
+				{
+					archive(entity, *component);
+				}
+			});
+		}
+
+		// Only the assets this cell uses, the rest of the scene's table would be loaded again on every activation
+		std::vector<uint32> resourceIds;
+		SceneComponents::ForEach([&](auto tag)
+		{
+			using Component = typename decltype(tag)::Type;
+			if constexpr (ComponentCodec<Component>::REFERENCES_ASSET)
+			{
+				for (uint32 resourceId : snapshot->Column<Component>().m_ResourceIds)
+				{
+					if (resourceId != std::numeric_limits<uint32>::max())
+					{
+						resourceIds.push_back(resourceId);
+					}
+				}
+			}
+		});
+		snapshot->m_Assets = AssetManager::Serialize(resourceIds);
+
+		SceneWriter::Submit(snapshot);
+	}
+
+	void WorldPartition::WriteIndex()
+	{
+		json j;
+		j["Version"] = INDEX_VERSION;
+		j["CellSize"] = m_CellSize;
+		j["LoadRadius"] = m_LoadRadius;
+		j["UnloadRadius"] = m_UnloadRadius;
+		j["Cells"] = json::array();
+		for (const auto& [key, cell] : m_Cells)
+		{
+			if (cell->m_Entities.empty())
+			{
+				continue;
+			}
+
+			json entities = json::array();
+			for (entt::entity entity : cell->m_Entities)
+			{
+				entities.push_back(entt::to_integral(entity));
+			}
+			j["Cells"].push_back({
+				{"X", cell->m_X},
+				{"Y", cell->m_Y},
+				{"Entities", entities}
+			});
+		}
+
+		IFile::WriteFileAtomic(j.dump(), GetDirectory(m_SceneFile) + "index.json");
+	}
+}
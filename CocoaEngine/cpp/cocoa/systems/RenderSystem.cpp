@@ -6,6 +6,7 @@
 #include "cocoa/components/components.h"
 #include "cocoa/commands/ICommand.h"
 #include "cocoa/util/CMath.h"
+#include "cocoa/physics2d/Physics2D.h"
 
 #include <nlohmann/json.hpp>
 
@@ -13,7 +14,7 @@ namespace Cocoa
 {
 	std::shared_ptr<Shader> RenderSystem::s_Shader = nullptr;
 
-	void RenderSystem::AddEntity(const Transform& transform, const SpriteRenderer& spr)
+	void RenderSystem::AddEntity(entt::entity entity, const Transform& transform, const SpriteRenderer& spr, const glm::vec3& position, float rotationDegrees)
 	{
 		const Sprite& sprite = spr.m_Sprite;
 		bool wasAdded = false;
@@ -24,7 +25,7 @@ namespace Cocoa
 				TextureHandle tex = sprite.m_Texture;
 				if (!tex || batch->HasTexture(tex) || batch->HasTextureRoom())
 				{
-					batch->Add(transform, spr);
+					batch->Add(entity, transform, spr, position, rotationDegrees);
 					wasAdded = true;
 					break;
 				}
@@ -35,7 +36,7 @@ namespace Cocoa
 		{
 			std::shared_ptr<RenderBatch> newBatch = std::make_shared<RenderBatch>(MAX_BATCH_SIZE, spr.m_ZIndex);
 			newBatch->Start();
-			newBatch->Add(transform, spr);
+			newBatch->Add(entity, transform, spr, position, rotationDegrees);
 			m_Batches.emplace_back(newBatch);
 			std::sort(m_Batches.begin(), m_Batches.end(), RenderBatch::Compare);
 		}
@@ -43,9 +44,23 @@ namespace Cocoa
 
 	void RenderSystem::Render()
 	{
-		m_Scene->GetRegistry().group<SpriteRenderer>(entt::get<Transform>).each([this](auto entity, auto& spr, auto& transform)
+		// Physics only moves bodies in fixed steps, drawing them between the last two keeps motion smooth at any refresh rate
+		entt::registry& registry = m_Scene->GetRegistry();
+		bool interpolate = m_Scene->IsPlaying();
+		float alpha = m_Scene->GetPhysics()->GetInterpolationAlpha();
+		registry.group<SpriteRenderer>(entt::get<Transform>).each([&](auto entity, auto& spr, auto& transform)
 		{
-			this->AddEntity(transform, spr);
+			const Rigidbody2D* rb = interpolate ? registry.try_get<Rigidbody2D>(entity) : nullptr;
+			if (rb != nullptr && rb->m_RawRigidbody != nullptr)
+			{
+				glm::vec2 position = glm::mix(rb->m_PreviousPosition, CMath::Vector2From3(transform.m_WorldPosition), alpha);
+				float rotation = glm::mix(rb->m_PreviousRotation, transform.m_WorldRotation, alpha);
+				this->AddEntity(entity, transform, spr, glm::vec3(position.x, position.y, transform.m_WorldPosition.z), rotation);
+			}
+			else
+			{
+				this->AddEntity(entity, transform, spr, transform.m_WorldPosition, transform.m_WorldRotation);
+			}
 		});
 
 		Log::Assert((s_Shader != nullptr), "Must bind shader before render call");
@@ -66,14 +81,15 @@ namespace Cocoa
 	}
 
 	void RenderSystem::Serialize(json& j, Entity entity, const SpriteRenderer& spriteRenderer)
+	{
+		Serialize(j, entity, spriteRenderer, GetTextureResourceId(spriteRenderer));
+	}
+
+	void RenderSystem::Serialize(json& j, Entity entity, const SpriteRenderer& spriteRenderer, uint32 textureResourceId)
 	{
 		json color = CMath::Serialize("Color", spriteRenderer.m_Color);
-		json assetId = { "AssetId", (uint32)std::numeric_limits<uint32>::max() };
+		json assetId = { "AssetId", textureResourceId };
 		json zIndex = { "ZIndex", spriteRenderer.m_ZIndex };
-		if (spriteRenderer.m_Sprite.m_Texture)
-		{
-			assetId = { "AssetId", spriteRenderer.m_Sprite.m_Texture.Get()->GetResourceId() };
-		}
 
 		int size = j["Size"];
 		j["Components"][size] = {
@@ -88,6 +104,16 @@ namespace Cocoa
 		j["Size"] = size + 1;
 	}
 
+	uint32 RenderSystem::GetTextureResourceId(const SpriteRenderer& spriteRenderer)
+	{
+		if (spriteRenderer.m_Sprite.m_Texture)
+		{
+			return spriteRenderer.m_Sprite.m_Texture.Get()->GetResourceId();
+		}
+
+		return std::numeric_limits<uint32>::max();
+	}
+
 	void RenderSystem::Deserialize(json& j, Entity entity)
 	{
 		SpriteRenderer spriteRenderer;
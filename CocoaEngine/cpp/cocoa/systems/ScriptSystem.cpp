@@ -13,6 +13,7 @@ namespace Cocoa
 	static void UpdateScriptStub(float, Scene*) {}
 	static void EditorUpdateScriptStub(float, Scene*) { Log::Info("STUB UPDATE;"); }
 	static void AddComponentFromStringStub(std::string, entt::entity, entt::registry&) {}
+	static void RemoveScriptsStub(entt::entity) {}
 
 	static FARPROC __stdcall TryLoadFunction(HMODULE module, const char* functionName)
 	{
@@ -66,6 +67,7 @@ namespace Cocoa
 				m_UpdateScripts = (UpdateScriptFn)TryLoadFunction(m_Module, "UpdateScripts");
 				m_EditorUpdateScripts = (UpdateScriptFn)TryLoadFunction(m_Module, "EditorUpdateScripts");
 				m_AddComponentFromString = (AddComponentFromStringFn)TryLoadFunction(m_Module, "AddComponent");
+				m_RemoveScripts = (RemoveScriptsFn)TryLoadFunction(m_Module, "RemoveScripts");
 				m_InitScripts = (InitScriptsFn)TryLoadFunction(m_Module, "InitScripts");
 				m_InitImGui = (InitImGuiFn)TryLoadFunction(m_Module, "InitImGui");
 				m_ImGui = (ImGuiFn)TryLoadFunction(m_Module, "ImGui");
@@ -92,6 +94,7 @@ namespace Cocoa
 		m_UpdateScripts = UpdateScriptStub;
 		m_EditorUpdateScripts = EditorUpdateScriptStub;
 		m_AddComponentFromString = AddComponentFromStringStub;
+		m_RemoveScripts = RemoveScriptsStub;
 		m_InitScripts = InitScriptsStub;
 		m_InitImGui = InitImGuiStub;
 		m_ImGui = ImGuiStub;
@@ -133,6 +136,14 @@ namespace Cocoa
 		}
 	}
 
+	void ScriptSystem::RemoveScripts(entt::entity entity)
+	{
+		if (m_RemoveScripts)
+		{
+			m_RemoveScripts(entity);
+		}
+	}
+
 	void ScriptSystem::Deserialize(json& j, Entity entity)
 	{
 		if (m_LoadScript)
@@ -0,0 +1,133 @@
+#include "cocoa/systems/SystemScheduler.h"
+#include "cocoa/systems/System.h"
+#include "cocoa/core/JobSystem.h"
+
+#include <chrono>
+
+namespace Cocoa
+{
+	// How much of the average a single frame moves, the editor shows the average so it doesn't flicker
+	static const float TIMING_SMOOTHING = 0.05f;
+
+	static bool Intersects(const std::vector<uint32>& a, const std::vector<uint32>& b)
+	{
+		for (uint32 id : a)
+		{
+			if (std::find(b.begin(), b.end(), id) != b.end())
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool SystemAccess::ConflictsWith(const SystemAccess& other) const
+	{
+		if (m_Exclusive || other.m_Exclusive)
+		{
+			return true;
+		}
+
+		return Intersects(m_Writes, other.m_Writes) || Intersects(m_Writes, other.m_Reads) || Intersects(m_Reads, other.m_Writes);
+	}
+
+	void SystemScheduler::BuildGraph(const std::vector<std::unique_ptr<System>>& systems)
+	{
+		// Timings carry over as long as the same system sits at the same index
+		std::vector<SystemNode> nodes(systems.size());
+		for (size_t i = 0; i < systems.size(); i++)
+		{
+			SystemNode& node = nodes[i];
+			node.m_System = systems[i].get();
+			node.m_System->DeclareAccess(node.m_Access);
+			// Nothing else runs next to an exclusive system, so keeping it on the main thread costs nothing
+			node.m_Access.m_MainThread = node.m_Access.m_MainThread || node.m_Access.m_Exclusive;
+			if (i < m_Nodes.size() && m_Nodes[i].m_System == node.m_System)
+			{
+				node.m_LastMilliseconds = m_Nodes[i].m_LastMilliseconds;
+				node.m_AverageMilliseconds = m_Nodes[i].m_AverageMilliseconds;
+			}
+
+			for (size_t j = 0; j < i; j++)
+			{
+				if (node.m_Access.ConflictsWith(nodes[j].m_Access))
+				{
+					node.m_Dependencies.push_back((int)j);
+					nodes[j].m_Dependents.push_back((int)i);
+				}
+			}
+		}
+
+		m_Nodes = std::move(nodes);
+		m_Remaining.reset(new std::atomic<int32>[m_Nodes.size()]);
+		for (size_t i = 0; i < m_Nodes.size(); i++)
+		{
+			m_Remaining[i].store((int32)m_Nodes[i].m_Dependencies.size(), std::memory_order_relaxed);
+		}
+	}
+
+	void SystemScheduler::RunNode(int index, float dt)
+	{
+		SystemNode& node = m_Nodes[index];
+		auto start = std::chrono::high_resolution_clock::now();
+		node.m_System->Update(dt);
+		auto elapsed = std::chrono::high_resolution_clock::now() - start;
+
+		node.m_LastMilliseconds = std::chrono::duration<float, std::milli>(elapsed).count();
+		node.m_AverageMilliseconds += (node.m_LastMilliseconds - node.m_AverageMilliseconds) * TIMING_SMOOTHING;
+	}
+
+	void SystemScheduler::Launch(int index, float dt)
+	{
+		JobFunction job = [this, index, dt]()
+		{
+			RunNode(index, dt);
+
+			// Dependents are submitted before this job counts as done, so the frame can't finish early
+			for (int dependent : m_Nodes[index].m_Dependents)
+			{
+				if (m_Remaining[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+				{
+					Launch(dependent, dt);
+				}
+			}
+		};
+
+		if (m_Nodes[index].m_Access.m_MainThread)
+		{
+			JobSystem::SubmitMainThread(std::move(job), m_FrameCounter);
+		}
+		else
+		{
+			JobSystem::Submit(std::move(job), m_FrameCounter);
+		}
+	}
+
+	void SystemScheduler::Update(const std::vector<std::unique_ptr<System>>& systems, float dt)
+	{
+		BuildGraph(systems);
+
+		if (!JobSystem::IsInitialized())
+		{
+			for (size_t i = 0; i < m_Nodes.size(); i++)
+			{
+				RunNode((int)i, dt);
+			}
+			return;
+		}
+
+		JobCounter frame;
+		m_FrameCounter = &frame;
+		for (size_t i = 0; i < m_Nodes.size(); i++)
+		{
+			if (m_Nodes[i].m_Dependencies.size() == 0)
+			{
+				Launch((int)i, dt);
+			}
+		}
+
+		// Main thread systems run in here, Update is only ever called from the main thread
+		JobSystem::Wait(frame);
+		m_FrameCounter = nullptr;
+	}
+}
@@ -1,6 +1,7 @@
 #include "externalLibs.h"
 
 #include "cocoa/util/CMath.h"
+#include "cocoa/file/JsonWriter.h"
 
 #include <nlohmann/json.hpp>
 
@@ -149,5 +150,45 @@ namespace Cocoa
 			success = !j["X"].is_null() && !j["Y"].is_null();
 			return DeserializeVec2(j);
 		}
+
+		// Keys go out in the sorted order json::dump would print them in
+		void CMath::Serialize(JsonWriter& writer, std::string_view name, const glm::vec4& vec)
+		{
+			writer.Key(name);
+			writer.BeginObject();
+			writer.Key("W");
+			writer.Float(vec.w);
+			writer.Key("X");
+			writer.Float(vec.x);
+			writer.Key("Y");
+			writer.Float(vec.y);
+			writer.Key("Z");
+			writer.Float(vec.z);
+			writer.EndObject();
+		}
+
+		void CMath::Serialize(JsonWriter& writer, std::string_view name, const glm::vec3& vec)
+		{
+			writer.Key(name);
+			writer.BeginObject();
+			writer.Key("X");
+			writer.Float(vec.x);
+			writer.Key("Y");
+			writer.Float(vec.y);
+			writer.Key("Z");
+			writer.Float(vec.z);
+			writer.EndObject();
+		}
+
+		void CMath::Serialize(JsonWriter& writer, std::string_view name, const glm::vec2& vec)
+		{
+			writer.Key(name);
+			writer.BeginObject();
+			writer.Key("X");
+			writer.Float(vec.x);
+			writer.Key("Y");
+			writer.Float(vec.y);
+			writer.EndObject();
+		}
 	}
 }
\ No newline at end of file
@@ -0,0 +1,186 @@
+#include "cocoa/util/Compression.h"
+
+namespace Cocoa
+{
+	namespace Compression
+	{
+		static const int kMinMatch = 4;
+		static const int kLastLiterals = 5;
+		static const int kMatchFindLimit = 12;
+		static const int kMaxDistance = 65535;
+		static const int kHashLog = 12;
+
+		static inline uint32 Read32(const uint8* ptr)
+		{
+			uint32 value;
+			std::memcpy(&value, ptr, sizeof(uint32));
+			return value;
+		}
+
+		static inline uint32 Hash(uint32 sequence)
+		{
+			return (sequence * 2654435761u) >> (32 - kHashLog);
+		}
+
+		static inline void WriteLength(uint8*& op, int length)
+		{
+			while (length >= 255)
+			{
+				*op++ = 255;
+				length -= 255;
+			}
+			*op++ = (uint8)length;
+		}
+
+		int Lz4CompressBound(int srcSize)
+		{
+			return srcSize + (srcSize / 255) + 16;
+		}
+
+		int Lz4Compress(const uint8* src, int srcSize, uint8* dst, int dstCapacity)
+		{
+			if (srcSize < 0 || dstCapacity < Lz4CompressBound(srcSize))
+			{
+				return 0;
+			}
+
+			uint8* op = dst;
+			const uint8* anchor = src;
+			const uint8* srcEnd = src + srcSize;
+
+			if (srcSize >= kMatchFindLimit + 1)
+			{
+				int hashTable[1 << kHashLog];
+				for (int i = 0; i < (1 << kHashLog); i++)
+				{
+					hashTable[i] = -1;
+				}
+
+				const uint8* matchLimit = srcEnd - kLastLiterals;
+				const uint8* ip = src;
+				while (ip < srcEnd - kMatchFindLimit)
+				{
+					uint32 h = Hash(Read32(ip));
+					int candidate = hashTable[h];
+					hashTable[h] = (int)(ip - src);
+
+					if (candidate < 0 || (ip - src) - candidate > kMaxDistance || Read32(src + candidate) != Read32(ip))
+					{
+						ip++;
+						continue;
+					}
+
+					const uint8* match = src + candidate;
+					const uint8* matchEnd = ip + kMinMatch;
+					const uint8* ref = match + kMinMatch;
+					while (matchEnd < matchLimit && *matchEnd == *ref)
+					{
+						matchEnd++;
+						ref++;
+					}
+
+					int literalLength = (int)(ip - anchor);
+					int matchLength = (int)(matchEnd - ip) - kMinMatch;
+					uint8* token = op++;
+					*token = (uint8)((literalLength >= 15 ? 15 : literalLength) << 4);
+					if (literalLength >= 15)
+					{
+						WriteLength(op, literalLength - 15);
+					}
+					std::memcpy(op, anchor, literalLength);
+					op += literalLength;
+
+					uint16 offset = (uint16)(ip - match);
+					*op++ = (uint8)(offset & 0xFF);
+					*op++ = (uint8)(offset >> 8);
+
+					*token |= (uint8)(matchLength >= 15 ? 15 : matchLength);
+					if (matchLength >= 15)
+					{
+						WriteLength(op, matchLength - 15);
+					}
+
+					ip = matchEnd;
+					anchor = ip;
+				}
+			}
+
+			// The last sequence is literals only
+			int literalLength = (int)(srcEnd - anchor);
+			uint8* token = op++;
+			*token = (uint8)((literalLength >= 15 ? 15 : literalLength) << 4);
+			if (literalLength >= 15)
+			{
+				WriteLength(op, literalLength - 15);
+			}
+			std::memcpy(op, anchor, literalLength);
+			op += literalLength;
+
+			return (int)(op - dst);
+		}
+
+		int Lz4Decompress(const uint8* src, int srcSize, uint8* dst, int dstCapacity)
+		{
+			const uint8* ip = src;
+			const uint8* srcEnd = src + srcSize;
+			uint8* op = dst;
+			uint8* dstEnd = dst + dstCapacity;
+
+			while (ip < srcEnd)
+			{
+				uint8 token = *ip++;
+
+				int literalLength = token >> 4;
+				if (literalLength == 15)
+				{
+					uint8 byte;
+					do
+					{
+						if (ip >= srcEnd) return -1;
+						byte = *ip++;
+						literalLength += byte;
+					} while (byte == 255);
+				}
+
+				if (literalLength > srcEnd - ip || literalLength > dstEnd - op) return -1;
+				std::memcpy(op, ip, literalLength);
+				op += literalLength;
+				ip += literalLength;
+
+				if (ip >= srcEnd)
+				{
+					break;
+				}
+
+				if (srcEnd - ip < 2) return -1;
+				int offset = ip[0] | (ip[1] << 8);
+				ip += 2;
+				if (offset == 0 || offset > op - dst) return -1;
+
+				int matchLength = token & 0x0F;
+				if (matchLength == 15)
+				{
+					uint8 byte;
+					do
+					{
+						if (ip >= srcEnd) return -1;
+						byte = *ip++;
+						matchLength += byte;
+					} while (byte == 255);
+				}
+				matchLength += kMinMatch;
+
+				if (matchLength > dstEnd - op) return -1;
+				// Matches may overlap the output, so this has to be a forward byte copy
+				const uint8* match = op - offset;
+				for (int i = 0; i < matchLength; i++)
+				{
+					op[i] = match[i];
+				}
+				op += matchLength;
+			}
+
+			return (int)(op - dst);
+		}
+	}
+}
@@ -66,6 +66,14 @@ namespace Cocoa
 		}
 	}
 
+	void JsonExtended::AssignIfNotNull(const json& j, uint64& value)
+	{
+		if (!j.is_null())
+		{
+			value = j;
+		}
+	}
+
 	void JsonExtended::AssignIfNotNull(const json& j, int& value)
 	{
 		if (!j.is_null())
@@ -21,6 +21,7 @@ namespace Cocoa
         CPath General::s_WorkingDirectory = "";
         CPath General::s_EditorSaveData = "EditorSaveData.json";
         CPath General::s_EditorStyleData = "EditorStyle.json";
+        float General::s_AutosaveInterval = 5.0f;
 
         // =======================================================================
         // Physics Settings
@@ -28,5 +29,7 @@ namespace Cocoa
         int Physics2D::s_PositionIterations = 3;
         int Physics2D::s_VelocityIterations = 8;
         float Physics2D::s_Timestep = 1.0f / 60.0f;
+        int Physics2D::s_MaxSubsteps = 5;
+        bool Physics2D::s_RunAhead = false;
     }
 }
\ No newline at end of file
@@ -10,9 +10,25 @@ namespace Cocoa {
         static void Undo();
         static void Redo();
 
+        // Commands added until ClearTarget edit this entity's components, componentMask holds their
+        // SceneComponents bits. Whenever a targeted command runs, is undone or redone the change callback
+        // gets its target, that is how the scene knows what to put in its next delta save
+        static void SetTarget(uint32 entity, uint32 componentMask);
+        static void ClearTarget();
+        static void SetChangeCallback(std::function<void(uint32 entity, uint32 componentMask)> callback);
+        // For edits of the target that don't go through a command, like checkboxes and drag and drop
+        static void NotifyTargetChanged();
+
+    private:
+        static void NotifyChanged(ICommand* cmd);
+
     private:
         static ICommand* m_Commands[1000];
         static int m_CommandSize;
         static int m_CommandPtr;
+
+        static uint32 s_TargetEntity;
+        static uint32 s_TargetMask;
+        static std::function<void(uint32, uint32)> s_ChangeCallback;
     };
 }
\ No newline at end of file
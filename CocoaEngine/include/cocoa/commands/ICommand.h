@@ -14,11 +14,18 @@ namespace Cocoa {
         void SetNoMerge() { m_CanMerge = false; }
         bool CanMerge() const { return m_CanMerge; }
 
+        // The entity and SceneComponents bits this command edits, set by CommandHistory when it's added
+        void SetTarget(uint32 entity, uint32 componentMask) { m_TargetEntity = entity; m_TargetMask = componentMask; }
+        uint32 GetTargetEntity() const { return m_TargetEntity; }
+        uint32 GetTargetMask() const { return m_TargetMask; }
+
     private:
         static int64 m_Id;
 
     protected:
         bool m_CanMerge = true;
+        uint32 m_TargetEntity = std::numeric_limits<uint32>::max();
+        uint32 m_TargetMask = 0;
     };
 }
 
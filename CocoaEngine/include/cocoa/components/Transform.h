@@ -5,55 +5,54 @@ namespace Cocoa
 {
     class Entity;
 
+    // Only what render, physics and the hierarchy touch every frame, so iterating transforms stays
+    // cheap. Everything else lives in the optional components below
     struct Transform
     {
         Transform()
+            : Transform(glm::vec3(0), glm::vec3(1), glm::vec3(0))
         {
-            Init(glm::vec3(0), glm::vec3(1), glm::vec3(0));
         }
 
-        Transform(glm::vec3 position, glm::vec3 scale, glm::vec3 eulerRotation, const char* name = "New GameObject")
+        Transform(glm::vec3 position, glm::vec3 scale, glm::vec3 eulerRotation)
+            : m_Position(position), m_Scale(scale), m_EulerRotation(eulerRotation),
+            m_WorldPosition(position), m_WorldScale(scale), m_WorldRotation(eulerRotation.z)
         {
-            Init(position, scale, eulerRotation, name);
-        }
-
-        void UpdateMatrices()
-        {
-            m_ModelMatrix = glm::translate(glm::mat4(1.0f), m_Position);
-            m_ModelMatrix = m_ModelMatrix * glm::toMat4(m_Orientation);
-            m_ModelMatrix = glm::scale(m_ModelMatrix, m_Scale);
         }
 
         static void Serialize(json& j, Entity entity, const Transform& transform);
         static void Deserialize(json& j, Entity entity);
 
+        // Relative to the parent. Sprites only rotate around z, x and y are there for the camera
         glm::vec3 m_Position;
         glm::vec3 m_Scale;
         glm::vec3 m_EulerRotation;
-        glm::quat m_Orientation;
 
-        glm::vec3 m_Forward;
-        glm::vec3 m_Up;
-        glm::vec3 m_Right;
+        // World space, cached by TransformHierarchy::Update. Render and physics read these instead of
+        // combining the local values with every parent themselves
+        glm::vec3 m_WorldPosition;
+        glm::vec3 m_WorldScale;
+        float m_WorldRotation;
 
-        glm::mat4 m_ModelMatrix;
-        glm::mat4 m_InverseModelMatrix;
-        const char* m_Name;
-
-    private:
-        void Init(glm::vec3 position, glm::vec3 scale, glm::vec3 eulerRotation, const char* name = "New GameObject")
-        {
-            m_Position = position;
-            m_Scale = scale;
-            m_EulerRotation = eulerRotation;
-            m_Orientation = glm::toQuat(glm::orientate3(m_EulerRotation));
+        // Set it through TransformHierarchy::SetParent, which keeps the world pose. Null for roots
+        entt::entity m_Parent = entt::null;
+        // Whether the world data changed in the last TransformHierarchy::Update
+        bool m_WorldChanged = true;
+    };
 
-            m_Forward = glm::vec3(0, 0, 1) * m_Orientation;
-            m_Up = glm::vec3(0, 1, 0) * m_Orientation;
-            m_Right = glm::vec3(1, 0, 0) * m_Orientation;
-            m_Name = name;
+    // Entities that want full matrices get this next to their Transform, TransformHierarchy::Update
+    // rebuilds it whenever the world data changes, and once after it's added
+    struct TransformMatrix
+    {
+        glm::mat4 m_ModelMatrix = glm::mat4(1.0f);
+        glm::mat4 m_InverseModelMatrix = glm::mat4(1.0f);
+        // Not built from the world data yet
+        bool m_Stale = true;
+    };
 
-            this->UpdateMatrices();
-        }
+    // Editor facing name, entities without one show up by id
+    struct EntityName
+    {
+        const char* m_Name = "New GameObject";
     };
-}
\ No newline at end of file
+}
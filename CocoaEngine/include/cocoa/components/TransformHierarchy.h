@@ -0,0 +1,46 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/core/Core.h"
+
+#include "cocoa/components/Transform.h"
+
+#include <entt/entt.hpp>
+
+namespace Cocoa
+{
+	// Keeps the cached world data of every Transform up to date. Roots are refreshed in one pass straight
+	// over the Transform pool, children after them from a list sorted by depth, so a parent is always
+	// done before its children. Composing 2D poses is cheaper than checking whether they changed, so that
+	// runs for everything. What changed is flagged in Transform::m_WorldChanged, and only those entities
+	// get their TransformMatrix rebuilt
+	class COCOA TransformHierarchy
+	{
+	public:
+		// Call once a frame, after everything that moves transforms and before anything reads the world data
+		void Update(entt::registry& registry);
+
+		// Null parent makes child a root again. The child stays where it is in the world. Fails if parent
+		// is child itself or one of its descendants
+		static bool SetParent(entt::registry& registry, entt::entity child, entt::entity parent);
+		static bool IsDescendantOf(const entt::registry& registry, entt::entity entity, entt::entity ancestor);
+
+		// Converts a world space pose into the local space of transform's parent
+		static glm::vec3 WorldToLocal(const entt::registry& registry, const Transform& transform, const glm::vec3& worldPosition);
+		static float WorldToLocalRotation(const entt::registry& registry, const Transform& transform, float worldRotation);
+
+	private:
+		struct ChildNode
+		{
+			entt::entity m_Entity;
+			entt::entity m_Parent;
+			uint32 m_Depth;
+		};
+
+		void Rebuild(entt::registry& registry);
+		bool UpdateChildren(entt::registry& registry);
+
+	private:
+		// Every transform with a parent, sorted by depth
+		std::vector<ChildNode> m_Children;
+	};
+}
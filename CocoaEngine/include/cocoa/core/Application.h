@@ -6,6 +6,8 @@
 #include "cocoa/core/CWindow.h"
 #include "cocoa/events/Event.h"
 #include "cocoa/events/WindowEvent.h"
+#include "cocoa/core/JobSystem.h"
+#include "cocoa/file/CPath.h"
 
 namespace Cocoa
 {
@@ -32,6 +34,10 @@ namespace Cocoa
 
 		Framebuffer* GetFramebuffer() const;
 		void ChangeScene(SceneInitializer* scene);
+		// Loads filename into a new scene on a worker while the current one keeps running, and swaps them at
+		// the start of the first frame after it's done. Every layer is pointed at the new scene
+		void ChangeSceneAsync(SceneInitializer* scene, const CPath& filename);
+		inline bool IsChangingScene() const { return m_StreamingScene != nullptr; }
 		CWindow* GetWindow() const;
 
 		static Application* Get();
@@ -42,6 +48,7 @@ namespace Cocoa
 
 	private:
 		bool OnWindowClose(WindowCloseEvent& e);
+		void FinishSceneChange();
 
 		static Application* s_Instance;
 
@@ -56,6 +63,11 @@ namespace Cocoa
 
 		float m_LastFrameTime = 0;
 
+		// The scene ChangeSceneAsync is loading, nothing but the streaming job touches it until it's done
+		Scene* m_StreamingScene = nullptr;
+		JobCounter m_StreamingCounter;
+		CPath m_StreamingFilename;
+
 	protected:
 		Framebuffer* m_Framebuffer = nullptr;
 		Scene* m_CurrentScene = nullptr;
@@ -1,6 +1,7 @@
 #pragma once
 #include "externalLibs.h"
 #include "cocoa/file/CPath.h"
+#include "cocoa/file/PathTable.h"
 #include "cocoa/util/Log.h"
 
 #include <entt/entt.hpp>
@@ -24,6 +25,7 @@ namespace Cocoa
 		uint32 GetResourceId() { return m_ResourceId; }
 		const CPath& GetPath() { return m_Path; }
 		uint32 GetType() { return m_Type; }
+		uint32 GetRefCount() { return m_RefCount; }
 		void SetResourceId(uint32 id) { m_ResourceId = id; }
 		bool IsNull() { return GetType() == Asset::GetResourceTypeId<NullAsset>(); }
 		json Serialize();
@@ -44,6 +46,7 @@ namespace Cocoa
 		uint32 m_Type = 0;
 		uint32 m_Scene = 0;
 		uint32 m_ResourceId = 0;
+		uint32 m_RefCount = 0;
 		CPath m_Path;
 		bool m_Loaded;
 		bool m_IsDefault = false;
@@ -67,6 +70,9 @@ namespace Cocoa
 		static std::shared_ptr<Asset> GetAsset(uint32 resourceID);
 		static std::shared_ptr<Asset> GetAsset(const CPath& path);
 		static std::shared_ptr<Asset> LoadTextureFromFile(const CPath& path, bool isDefault=false);
+		// For the editor adding a texture to the open scene. The scene holds one reference per asset, so a
+		// texture it already uses is returned without taking another one
+		static std::shared_ptr<Asset> ImportTexture(const CPath& path);
 
 		template<typename T>
 		static std::vector<std::shared_ptr<T>> GetAllAssets(uint32 scene)
@@ -93,11 +99,24 @@ namespace Cocoa
 		static void Clear();
 		static void Init(uint32 scene);
 
+		// Assets are reference counted by the scenes that use them. Releasing the current scene's
+		// assets only drops the references, the actual unload happens in UnloadUnreferenced so that
+		// assets shared with the next scene stay resident across a scene change.
+		static void ReleaseSceneAssets();
+		static void UnloadUnreferenced();
+
 		static uint32 GetScene() { return Get()->m_CurrentScene; }
-		static void SetScene(uint32 scene) { Get()->m_CurrentScene = scene; }
+		static void SetScene(uint32 scene) { Get()->m_CurrentScene = scene; Get()->m_Version++; }
+		// Changes whenever assets are added or removed, so callers can cache asset lists
+		static uint32 GetVersion() { return Get()->m_Version; }
 
 		static std::unordered_map<uint32, uint32> LoadFrom(const json& j);
+		// Maps the ids in j to the scene's resident assets, for partition cells. Assets the scene already
+		// references are reused without taking another reference, and the import stats are left alone
+		static std::unordered_map<uint32, uint32> ResolveFrom(const json& j);
 		static json Serialize();
+		// Only the listed assets, for partition cells that reference a few of the scene's assets
+		static json Serialize(const std::vector<uint32>& resourceIds);
 
 	private:
 		AssetManager(int scene)
@@ -106,14 +125,20 @@ namespace Cocoa
 		}
 
 		static AssetManager* Get();
+		static std::shared_ptr<Asset> FindAsset(PathId absolutePath);
+		static std::unordered_map<uint32, uint32> LoadAssetList(const json& j, bool reuseResident);
 		static std::unique_ptr<AssetManager> s_Instance;
 
 	protected:
 		uint32 m_CurrentScene;
 		uint32 m_ResourceCount;
+		uint32 m_Version = 0;
 
 		// Map from scene -> AssetID -> Asset
 		std::unordered_map<uint32, std::unordered_map<uint32, std::shared_ptr<Asset>>> m_Assets;
+		// Map from scene -> interned absolute path -> AssetID, so path lookups don't have to
+		// resolve and compare every asset's path
+		std::unordered_map<uint32, std::unordered_map<PathId, uint32>> m_AssetIdsByPath;
 		std::unordered_map<uint32, std::shared_ptr<Asset>> m_EmptyAssetContainer{};
 	};
 
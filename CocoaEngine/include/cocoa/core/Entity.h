@@ -13,8 +13,8 @@ namespace Cocoa
 	public:
 		Entity();
 		Entity(entt::entity handle, Scene* scene);
-		Entity(entt::entity& other);
-		Entity(const entt::entity& other);
+		// Without a scene it's only good for ids and comparisons, the components can't be reached
+		explicit Entity(entt::entity handle);
 		Entity(const Entity& other) = default;
 
 		template<typename T, typename ... Args>
@@ -22,34 +22,43 @@ namespace Cocoa
 		{
 			Log::Assert(!HasComponent<T>(), "Entity already has component.");
 
-			return s_Scene->m_Registry.emplace<T>(m_EntityHandle, std::forward<Args>(args)...);
+			return m_Scene->m_Registry.emplace<T>(m_EntityHandle, std::forward<Args>(args)...);
 		}
 
 		template<typename T>
 		T& GetComponent()
 		{
 			Log::Assert(HasComponent<T>(), "Entity does not have component.");
-			return s_Scene->m_Registry.get<T>(m_EntityHandle);
+			return m_Scene->m_Registry.get<T>(m_EntityHandle);
 		}
 
 		template<typename T>
 		const T& GetComponent() const
 		{
 			Log::Assert(HasComponent<T>(), "Entity does not have component.");
-			return s_Scene->m_Registry.get<T>(m_EntityHandle);
+			return m_Scene->m_Registry.get<T>(m_EntityHandle);
+		}
+
+		// Edits the component through fn(T&) so anything watching for changes hears about it, writes through
+		// GetComponent go unnoticed
+		template<typename T, typename... Func>
+		T& PatchComponent(Func&&... func)
+		{
+			Log::Assert(HasComponent<T>(), "Entity does not have component.");
+			return m_Scene->m_Registry.patch<T>(m_EntityHandle, std::forward<Func>(func)...);
 		}
 
 		template<typename... Component>
 		bool HasComponent() const
 		{
-			return s_Scene->m_Registry.has<Component...>(m_EntityHandle);
+			return m_Scene->m_Registry.has<Component...>(m_EntityHandle);
 		}
 
 		template<typename T>
 		void RemoveComponent()
 		{
 			Log::Assert(HasComponent<T>(), "Entity does not have component.");
-			s_Scene->m_Registry.remove<T>(m_EntityHandle);
+			m_Scene->m_Registry.remove<T>(m_EntityHandle);
 		}
 
 		inline bool IsNull() const
@@ -62,14 +71,6 @@ namespace Cocoa
 			return (uint32)(entt::to_integral(m_EntityHandle));
 		}
 
-		template<typename T>
-		static Entity FromComponent(const T& component)
-		{
-			size_t offset = &component - s_Scene->m_Registry.raw<T>();
-			Log::Assert(offset < s_Scene->m_Registry.size(), "Tried to get nonexistent entity.");
-			return Entity(*(s_Scene->m_Registry.data<T>() + offset), s_Scene); // { m_Registry, * (m_Registry.data<T>() + offset) };
-		}
-
 		entt::entity GetRawEntity()
 		{
 			return m_EntityHandle;
@@ -77,19 +78,19 @@ namespace Cocoa
 
 		entt::registry& GetRegistry()
 		{
-			return s_Scene->GetRegistry();
+			return m_Scene->GetRegistry();
 		}
 
+		inline Scene* GetScene() const { return m_Scene; }
+
 		bool operator==(const Entity& other) const;
 		bool operator==(Entity& other) const;
 
-		static void SetScene(Scene* currentScene);
-
 	public:
 		static Entity Null;
 
 	private:
-		static Scene* s_Scene;
 		entt::entity m_EntityHandle;
+		Scene* m_Scene;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/file/CPath.h"
+#include "cocoa/physics2d/Physics2DSystem.h"
+
+namespace Cocoa
+{
+	struct TextureImportData
+	{
+		int m_Width = 0;
+		int m_Height = 0;
+		int m_Channels = 0;
+		AABB m_BoundingBox;
+
+		// Allocated with malloc so it can be released with stbi_image_free like a freshly decoded image
+		uint8* m_Pixels = nullptr;
+	};
+
+	struct ImportCacheStats
+	{
+		uint32 m_Hits = 0;
+		uint32 m_Misses = 0;
+		// Misses where an entry existed but the source content or importer version had changed
+		uint32 m_Stale = 0;
+		uint32 m_Evictions = 0;
+		uint64 m_BytesRead = 0;
+		uint64 m_BytesWritten = 0;
+	};
+
+	// Persistent cache of derived asset data, stored in the project directory. Entries are keyed by
+	// the source path and validated against a hash of the source content and the importer version,
+	// so editing an asset or changing an importer invalidates its entry automatically. When the cache
+	// grows past its size budget the least recently used entries are evicted.
+	class COCOA ImportCache
+	{
+	public:
+		static void Init(const CPath& cacheDirectory, uint64 maxSizeBytes = DEFAULT_MAX_SIZE);
+		static void Destroy();
+		static bool IsInitialized() { return s_Instance != nullptr; }
+
+		static bool LoadTexture(const CPath& source, std::string_view sourceData, TextureImportData& outData);
+		static void StoreTexture(const CPath& source, std::string_view sourceData, const TextureImportData& data);
+
+		static void Evict();
+		static void Clear();
+
+		static const ImportCacheStats& GetStats();
+		static void ResetStats();
+		static void LogStats(const char* label);
+
+		static uint64 HashContent(std::string_view data);
+
+		static const uint64 DEFAULT_MAX_SIZE = 512ull * 1024ull * 1024ull;
+		// Bump this whenever texture import produces different results, it invalidates every entry
+		static const uint32 TEXTURE_IMPORTER_VERSION = 1;
+
+	private:
+		ImportCache(const CPath& cacheDirectory, uint64 maxSizeBytes)
+			: m_Directory(cacheDirectory), m_MaxSize(maxSizeBytes)
+		{
+		}
+
+		void LoadIndex();
+		void SaveIndex();
+		void Touch(const std::string& entryName, uint64 size);
+		void RemoveEntry(const std::string& entryName);
+		std::string GetEntryName(const CPath& source, const char* extension) const;
+		CPath GetEntryPath(const std::string& entryName) const;
+
+	private:
+		struct IndexEntry
+		{
+			uint64 m_Size = 0;
+			uint64 m_LastUsed = 0;
+		};
+
+		static ImportCache* s_Instance;
+		static ImportCacheStats s_Stats;
+
+		CPath m_Directory;
+		uint64 m_MaxSize;
+		uint64 m_TotalSize = 0;
+		uint64 m_UseCounter = 0;
+		bool m_IndexDirty = false;
+		std::unordered_map<std::string, IndexEntry> m_Index;
+	};
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/core/Core.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace Cocoa
+{
+	using JobFunction = std::function<void()>;
+
+	struct Job;
+	struct JobSystemState;
+
+	// Counts unfinished jobs. Every job submitted with a counter adds one to it and takes one off once it
+	// has run. Jobs can be held back until a counter reaches zero, that is how dependencies are expressed.
+	// A counter has to outlive every job submitted with it or waiting on it
+	class COCOA JobCounter
+	{
+	public:
+		JobCounter() = default;
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		bool IsDone() const { return m_Count.load(std::memory_order_acquire) == 0; }
+		int32 GetCount() const { return m_Count.load(std::memory_order_acquire); }
+
+	private:
+		std::atomic<int32> m_Count{ 0 };
+		// Guards the transition to zero, so a job can't start waiting right as its dependency finishes
+		std::mutex m_Mutex;
+		std::vector<Job*> m_Waiting;
+
+		friend class JobSystem;
+	};
+
+	// Runs small jobs on a pool of worker threads. Every worker owns a deque, jobs a worker submits go
+	// on the back of its own deque and it takes them back from there, so related work stays on the same
+	// core. Idle workers steal from the front of everybody else's deque. GL calls and anything else that
+	// has to stay on the main thread go through SubmitMainThread and run from DispatchMainThread
+	class COCOA JobSystem
+	{
+	public:
+		// 0 workers picks one less than the number of hardware threads, the main thread is the other one
+		static void Init(int numWorkers = 0);
+		// Runs everything still queued before returning
+		static void Destroy();
+		static bool IsInitialized() { return s_Instance != nullptr; }
+		static int GetWorkerCount();
+
+		// counter is optional, see JobCounter. The job won't start before dependency, also optional, reaches zero
+		static void Submit(JobFunction job, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+		static void SubmitMainThread(JobFunction job, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+
+		// Calls fn(first, last) over [begin, end) split into ranges of at least grainSize elements and returns
+		// once every range is done. The calling thread works on ranges too. Without Init it all runs inline
+		static void ParallelFor(size_t begin, size_t end, size_t grainSize, const std::function<void(size_t first, size_t last)>& fn);
+
+		// Runs other jobs until counter reaches zero. Workers run whatever is queued. Threads outside the pool
+		// only run jobs submitted with counter, like the ranges of a ParallelFor, and otherwise yield, so a
+		// frame never ends up running a long background job inline. Main thread jobs are only picked up when
+		// this is called from the main thread, so a worker must never wait on one
+		static void Wait(JobCounter& counter);
+
+		// Runs the main thread jobs queued so far, call this once per frame
+		static void DispatchMainThread();
+
+	private:
+		static void SubmitJob(JobFunction&& function, JobCounter* counter, JobCounter* dependency, bool mainThread);
+		static void RunJob(Job* job);
+		static void WorkerMain(JobSystemState* state, int index);
+
+	private:
+		static JobSystemState* s_Instance;
+	};
+}
@@ -24,6 +24,9 @@ namespace Cocoa
 
 		virtual void OnEvent(Event& e) {}
 
+		// Called when the application swaps scenes, layers holding on to more of the old one override it
+		virtual void SetScene(Scene* scene) { m_Scene = scene; }
+
 	protected:
 		std::string m_DebugName;
 		Scene* m_Scene = nullptr;
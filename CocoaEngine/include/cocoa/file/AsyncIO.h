@@ -0,0 +1,55 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/file/CPath.h"
+#include "cocoa/file/IFile.h"
+
+#include <future>
+
+namespace Cocoa
+{
+	// Higher priorities are always picked first. Streaming requests are also never allowed to occupy
+	// every worker, so a save issued while a level streams in still gets a thread straight away.
+	enum class IOPriority : uint8
+	{
+		High = 0,      // User initiated work that someone is waiting on, e.g. saving
+		Normal = 1,    // Asset loads
+		Streaming = 2, // Background scene streaming
+		Length
+	};
+
+	// Read completions receive a File that is closed as soon as the callback returns. Use the
+	// future returning overloads to keep the file around, the caller then owns it and must close it.
+	using AsyncReadCallback = std::function<void(File* file)>;
+	using AsyncBatchReadCallback = std::function<void(const std::vector<File*>& files)>;
+	using AsyncWriteCallback = std::function<void(bool success)>;
+
+	struct AsyncIOState;
+
+	class COCOA AsyncIO
+	{
+	public:
+		static void Init(int numWorkers = 2);
+		static void Destroy();
+		static bool IsInitialized() { return s_Instance != nullptr; }
+
+		static std::future<File*> ReadAsync(const CPath& filepath, IOPriority priority = IOPriority::Normal);
+		static void ReadAsync(const CPath& filepath, AsyncReadCallback callback, IOPriority priority = IOPriority::Normal);
+		// All files in a batch are submitted together and complete with a single callback
+		static void ReadBatchAsync(const std::vector<CPath>& filepaths, AsyncBatchReadCallback callback, IOPriority priority = IOPriority::Normal);
+
+		// Writes replace the file atomically, see IFile::WriteFileAtomic. Writes to the same path never overlap and
+		// land in the order they were issued, whatever their priority
+		static std::future<bool> WriteAsync(const CPath& filepath, std::string data, IOPriority priority = IOPriority::High);
+		static void WriteAsync(const CPath& filepath, std::string data, AsyncWriteCallback callback, IOPriority priority = IOPriority::High);
+
+		// Runs the callbacks of every finished request, call this from the main thread once per frame
+		static void DispatchCompletions();
+		// Blocks until every queued request has finished. Callbacks still need DispatchCompletions
+		static void WaitIdle();
+
+		static const char* GetBackendName();
+
+	private:
+		static AsyncIOState* s_Instance;
+	};
+}
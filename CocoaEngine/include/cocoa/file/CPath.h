@@ -8,12 +8,17 @@ namespace Cocoa
 	public:
 		CPath(bool forceLinuxStylePath=false)
 		{
-			m_Filepath = "";
+			m_PathSeparator = forceLinuxStylePath ? '/' : CPath::PATH_SEPARATOR;
+			m_Data = m_Inline;
+			m_Data[0] = '\0';
+			m_Size = 0;
+			m_Capacity = INLINE_CAPACITY - 1;
+			m_Hash = HASH_SEED;
 			m_FilenameOffset = 0;
 			m_FileExtOffset = 0;
 		}
 
-		CPath(std::string path, bool forceLinuxStylePath=false);
+		CPath(const std::string& path, bool forceLinuxStylePath=false);
 		CPath(const char* path, bool forceLinuxStylePath=false);
 		CPath(const CPath& other);
 		CPath(CPath&& other) noexcept;
@@ -22,12 +27,14 @@ namespace Cocoa
 		CPath& operator=(CPath&& other) noexcept;
 		CPath& operator=(const CPath& other);
 
-		inline int FilenameSize() const { return (int)(m_Filepath.size() - m_FilenameOffset); }
-		inline int FileExtSize() const { return (int)(m_Filepath.size() - m_FileExtOffset); }
-		inline int Size() const { return (int)m_Filepath.size(); }
-		inline const char* Filename() const { return &m_Filepath[m_FilenameOffset]; }
-		inline const char* Filepath() const { return m_Filepath.c_str(); }
-		inline const char* FileExt()  const { return &m_Filepath[m_FileExtOffset]; }
+		inline int FilenameSize() const { return m_Size - m_FilenameOffset; }
+		inline int FileExtSize() const { return m_Size - m_FileExtOffset; }
+		inline int Size() const { return m_Size; }
+		inline const char* Filename() const { return m_Data + m_FilenameOffset; }
+		inline const char* Filepath() const { return m_Data; }
+		inline const char* FileExt()  const { return m_Data + m_FileExtOffset; }
+		// Hash of the sanitized path, kept up to date on every modification so hashing a path is free
+		inline uint32 Hash() const { return m_Hash; }
 		inline bool IsFile() const;
 		inline bool IsDirectory();
 		std::string GetDirectory(int level) const;
@@ -36,7 +43,10 @@ namespace Cocoa
 		void Join(const CPath& other);
 		bool Contains(const char* pathSegment) const;
 
-		CPath operator+(std::string other) const;
+		// Exact comparison of the sanitized paths, unlike operator== this never touches the file system
+		bool Equals(const CPath& other) const;
+
+		CPath operator+(const std::string& other) const;
 		CPath operator+(const CPath& other) const;
 		CPath operator+(const char* other) const;
 		bool operator==(const CPath& other) const;
@@ -54,15 +64,37 @@ namespace Cocoa
 		}
 
 		void Init(const char* path, int pathSize);
+		void Append(const char* data, int size);
+		void Reserve(int capacity);
+		void CopyFrom(const CPath& other);
+		void MoveFrom(CPath& other);
+
+		static inline uint32 HashBytes(uint32 hash, const char* data, int size)
+		{
+			// FNV-1a, which can be continued from a previous result so joins only hash what they append
+			for (int i = 0; i < size; i++)
+			{
+				hash = (hash ^ (uint8)data[i]) * 16777619u;
+			}
+			return hash;
+		}
 
 	private:
 		static const char WIN_SEPARTOR = '\\';
 		static const char UNIX_SEPARATOR = '/';
+		static const uint32 HASH_SEED = 2166136261u;
+		// Most paths fit in here, only longer ones go to the heap
+		static const int INLINE_CAPACITY = 128;
 
 		char m_PathSeparator;
-		std::string m_Filepath;
+		// Points at m_Inline or a heap block, always null terminated
+		char* m_Data;
+		int m_Size;
+		int m_Capacity;
+		uint32 m_Hash;
 		int m_FilenameOffset;
 		int m_FileExtOffset;
+		char m_Inline[INLINE_CAPACITY];
 	};
 
 #ifdef _WIN32
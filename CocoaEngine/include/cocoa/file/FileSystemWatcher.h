@@ -4,6 +4,7 @@
 #include "cocoa/core/Core.h"
 #include "CPath.h"
 
+#include <chrono>
 #include <thread>
 #ifdef _WIN32
 #include <Windows.h>
@@ -23,12 +24,28 @@ namespace Cocoa
 		Security = 256
 	};
 
+	enum class FileSystemEventType : uint8
+	{
+		Created,
+		Changed,
+		Deleted,
+		Renamed
+	};
+
+	struct FileSystemEvent
+	{
+		FileSystemEventType m_Type;
+		// Relative to the watched directory
+		CPath m_Path;
+	};
+
 	class COCOA FileSystemWatcher
 	{
 	public:
 		FileSystemWatcher();
 		~FileSystemWatcher() { Stop(); }
 		void Start();
+		// Events still inside the debounce window are delivered on the watcher thread before this returns
 		void Stop();
 
 	public:
@@ -36,26 +53,69 @@ namespace Cocoa
 		typedef void (*OnRenamed)(const CPath& file);
 		typedef void (*OnDeleted)(const CPath& file);
 		typedef void (*OnCreated)(const CPath& file);
+		typedef void (*OnBatch)(const std::vector<FileSystemEvent>& events);
 
 		OnChanged m_OnChanged = nullptr;
 		OnRenamed m_OnRenamed = nullptr;
 		OnDeleted m_OnDeleted = nullptr;
 		OnCreated m_OnCreated = nullptr;
+		// When set this receives every event of a flush at once, instead of the per event callbacks
+		OnBatch m_OnBatch = nullptr;
 
 		int m_NotifyFilters = 0;
 		bool m_IncludeSubdirectories = false;
 		std::string m_Filter = "";
 		CPath m_Path = "";
+		// Events for the same path are held back until the path has been quiet for this long, so one
+		// editor save comes out as a single event instead of a burst of them
+		int m_DebounceMilliseconds = 100;
 
 	private:
+		struct PendingEvent
+		{
+			FileSystemEventType m_Type;
+			std::chrono::steady_clock::time_point m_FirstSeen;
+			std::chrono::steady_clock::time_point m_LastSeen;
+		};
+
+		struct FileSnapshot
+		{
+			int64 m_ModifiedTime;
+			uint64 m_Size;
+		};
+
 		bool m_EnableRaisingEvents = true;
 		std::thread m_Thread;
+		std::unordered_map<std::string, PendingEvent> m_PendingEvents;
+		// What the watched tree looked like as of the last flush, diffed against after an overflow
+		std::unordered_map<std::string, FileSnapshot> m_Snapshot;
 
 #ifdef _WIN32
-		HANDLE hStopEvent;
+		HANDLE hStopEvent = NULL;
+#elif defined(__linux__)
+		int m_InotifyFd = -1;
+		int m_StopFd = -1;
+		std::unordered_map<int, std::string> m_WatchDirectories;
 #endif
 
 	private:
 		void StartThread();
+
+		bool MatchesFilter(const std::string& path) const;
+		void QueueEvent(FileSystemEventType type, const std::string& path);
+		void FlushEvents(bool force);
+		// Milliseconds until the next pending event is due, -1 if nothing is pending
+		int GetFlushTimeout() const;
+		void DeliverEvents(const std::vector<FileSystemEvent>& events);
+
+		void SnapshotDirectory(const std::string& relativeDirectory, std::unordered_map<std::string, FileSnapshot>& snapshot) const;
+		bool SnapshotFile(const std::string& path, FileSnapshot& outSnapshot) const;
+		// Events were dropped, compare the tree against the last snapshot and raise whatever changed
+		void Rescan();
+
+#ifdef __linux__
+		void AddWatchRecursive(const std::string& relativeDirectory, bool queueExistingFiles);
+		void RemoveWatchesUnder(const std::string& relativeDirectory);
+#endif
 	};
-}
\ No newline at end of file
+}
@@ -4,23 +4,48 @@
 
 namespace Cocoa
 {
+	struct MemoryMappedFile
+	{
+		const uint8* m_Data = nullptr;
+		uint64 m_Size = 0;
+		bool m_Open = false;
+		void* m_FileHandle = nullptr;
+		void* m_MappingHandle = nullptr;
+	};
+
 	struct File
 	{
 		const char* m_Filename = nullptr;
-		std::string m_Data = "";
+		// Read-only view of the file contents, valid until the file is closed. Large files are
+		// memory mapped, small ones are read into m_Buffer in one go since mapping them costs more
+		// than the copy.
+		std::string_view m_Data = "";
 		uint32 m_Size = 0;
 		bool m_Open = false;
+
+		std::string m_Buffer = "";
+		MemoryMappedFile* m_Mapping = nullptr;
 	};
 
+	class PackArchive;
+
 	class COCOA IFile
 	{
 	public:
+		virtual ~IFile();
+
 		static void Init();
 		static void Destroy();
 
-		static File* OpenFile(const CPath& filename) { return Get()->ImplOpenFile(filename); }
+		static File* OpenFile(const CPath& filename);
 		static void CloseFile(File* file) { Get()->ImplCloseFile(file); }
 		static bool WriteFile(const char* data, const CPath& filename) { return Get()->ImplWriteFile(data, filename); }
+		// Writes to a temporary file next to filename and renames it over the original, so a crash
+		// mid-write leaves either the old or the new contents on disk and never half of each
+		static bool WriteFileAtomic(std::string_view data, const CPath& filename) { return Get()->ImplWriteFileAtomic(data, filename); }
+		// Appends data to the end of filename, creating it if needed, and flushes it to disk before returning.
+		// A crash mid-append can leave a partial tail, readers of append-only files have to expect that
+		static bool AppendFile(std::string_view data, const CPath& filename) { return Get()->ImplAppendFile(data, filename); }
 		static bool CreateFile(const CPath& filename, const char* extToAppend = "") { return Get()->ImplCreateFile(filename, extToAppend); }
 		static bool DeleteFile(const CPath& filename) { return Get()->ImplDeleteFile(filename); }
 		static bool CopyFile(const CPath& fileToCopy, const CPath& newFileLocation, const char* newFilename = "") { return Get()->ImplCopyFile(fileToCopy, newFileLocation, newFilename); }
@@ -30,7 +55,7 @@ namespace Cocoa
 		static std::vector<CPath> GetFilesInDir(const CPath& directory) { return Get()->ImplGetFilesInDir(directory); }
 		static std::vector<CPath> GetFoldersInDir(const CPath& directory) { return Get()->ImplGetFoldersInDir(directory); }
 		static void CreateDirIfNotExists(const CPath& directory) { Get()->ImplCreateDirIfNotExists(directory); }
-		static bool IsFile(const CPath& filepath) { return Get()->ImplIsFile(filepath); }
+		static bool IsFile(const CPath& filepath);
 		static bool IsHidden(const CPath& filepath) { return Get()->ImplIsHidden(filepath); }
 		static bool IsDirectory(const CPath& directory) { return Get()->ImplIsDirectory(directory); }
 		static CPath GetAbsolutePath(const CPath& path) { return Get()->ImplGetAbsolutePath(path); }
@@ -38,10 +63,23 @@ namespace Cocoa
 		static bool RunProgram(const CPath& pathToExe, const char* cmdArgs = "") { return Get()->ImplRunProgram(pathToExe, cmdArgs); }
 		static bool RunProgram(const CPath& pathToExe, const std::string& cmdArgs = "") { return Get()->ImplRunProgram(pathToExe, cmdArgs.c_str()); }
 
+		// Read-only views of a whole file. The view stays valid until UnmapFile is called
+		static MemoryMappedFile* MapFile(const CPath& filename) { return Get()->ImplMapFile(filename); }
+		static void UnmapFile(MemoryMappedFile* file) { Get()->ImplUnmapFile(file); }
+
+		// Files inside a mounted archive shadow the files on disk under mountPoint. OpenFile and IsFile
+		// resolve through mounts, GetMountedFile hands out the archive bytes without copying them
+		static void Mount(PackArchive* archive, const CPath& mountPoint);
+		static void Unmount(PackArchive* archive);
+		static void UnmountAll();
+		static bool GetMountedFile(const CPath& filepath, std::string_view& outData);
+
 	protected:
 		virtual File* ImplOpenFile(const CPath& filename) = 0;
 		virtual void ImplCloseFile(File* file) = 0;
 		virtual bool ImplWriteFile(const char* data, const CPath& filename) = 0;
+		virtual bool ImplWriteFileAtomic(std::string_view data, const CPath& filename) = 0;
+		virtual bool ImplAppendFile(std::string_view data, const CPath& filename) = 0;
 		virtual bool ImplCreateFile(const CPath& filename, const char* extToAppend) = 0;
 		virtual bool ImplDeleteFile(const CPath& filename) = 0;
 		virtual bool ImplCopyFile(const CPath& fileToCopy, const CPath& newFileLocation, const char* newFilename) = 0;
@@ -58,11 +96,25 @@ namespace Cocoa
 		
 		virtual bool ImplRunProgram(const CPath& pathToExe, const char* cmdArgs) = 0;
 
+		virtual MemoryMappedFile* ImplMapFile(const CPath& filename) = 0;
+		virtual void ImplUnmapFile(MemoryMappedFile* file) = 0;
+
+	protected:
+		// Files smaller than this are read into a buffer instead of being mapped
+		static const uint64 MIN_MAPPED_FILE_SIZE = 64 * 1024;
+
 	private:
 		static IFile* Get();
 
 	private:
+		struct MountedArchive
+		{
+			std::string m_MountPoint;
+			PackArchive* m_Archive;
+		};
+
 		static IFile* s_Instance;
+		static std::vector<MountedArchive> s_Mounts;
 	};
 
 #ifdef _WIN32
@@ -77,6 +129,8 @@ namespace Cocoa
 		virtual File* ImplOpenFile(const CPath& filename) override;
 		virtual void ImplCloseFile(File* file) override;
 		virtual bool ImplWriteFile(const char* data, const CPath& filename) override;
+		virtual bool ImplWriteFileAtomic(std::string_view data, const CPath& filename) override;
+		virtual bool ImplAppendFile(std::string_view data, const CPath& filename) override;
 		virtual bool ImplCreateFile(const CPath& filename, const char* extToAppend) override;
 		virtual bool ImplDeleteFile(const CPath& filename) override;
 		virtual bool ImplCopyFile(const CPath& fileToCopy, const CPath& newFileLocation, const char* newFilename) override;
@@ -92,6 +146,42 @@ namespace Cocoa
 		virtual CPath ImplGetAbsolutePath(const CPath& path) override;
 
 		virtual bool ImplRunProgram(const CPath& pathToExe, const char* cmdArgs) override;
+
+		virtual MemoryMappedFile* ImplMapFile(const CPath& filename) override;
+		virtual void ImplUnmapFile(MemoryMappedFile* file) override;
+	};
+#else
+	class COCOA PosixFile : public IFile
+	{
+	public:
+		static IFile* Create()
+		{
+			return new PosixFile();
+		}
+
+		virtual File* ImplOpenFile(const CPath& filename) override;
+		virtual void ImplCloseFile(File* file) override;
+		virtual bool ImplWriteFile(const char* data, const CPath& filename) override;
+		virtual bool ImplWriteFileAtomic(std::string_view data, const CPath& filename) override;
+		virtual bool ImplAppendFile(std::string_view data, const CPath& filename) override;
+		virtual bool ImplCreateFile(const CPath& filename, const char* extToAppend) override;
+		virtual bool ImplDeleteFile(const CPath& filename) override;
+		virtual bool ImplCopyFile(const CPath& fileToCopy, const CPath& newFileLocation, const char* newFilename) override;
+		virtual CPath ImplGetCwd() override;
+		virtual CPath ImplGetSpecialAppFolder() override;
+		virtual CPath ImplGetExecutableDirectory() override;
+		virtual std::vector<CPath> ImplGetFilesInDir(const CPath& directory) override;
+		virtual std::vector<CPath> ImplGetFoldersInDir(const CPath& directory) override;
+		virtual void ImplCreateDirIfNotExists(const CPath& directory) override;
+		virtual bool ImplIsFile(const CPath& filepath) override;
+		virtual bool ImplIsHidden(const CPath& filepath) override;
+		virtual bool ImplIsDirectory(const CPath& filepath) override;
+		virtual CPath ImplGetAbsolutePath(const CPath& path) override;
+
+		virtual bool ImplRunProgram(const CPath& pathToExe, const char* cmdArgs) override;
+
+		virtual MemoryMappedFile* ImplMapFile(const CPath& filename) override;
+		virtual void ImplUnmapFile(MemoryMappedFile* file) override;
 	};
 #endif
 }
\ No newline at end of file
@@ -1,19 +0,0 @@
-#pragma once
-#include "externalLibs.h"
-
-#include "jade/systems/RenderSystem.h"
-#include "jade/util/Log.h"
-
-
-
-namespace Jade
-{
-	class COCOA InputArchive
-	{
-	public:
-		void Load(const std::string& filename)
-		{
-
-		}
-	};
-}
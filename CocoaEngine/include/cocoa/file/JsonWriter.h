@@ -0,0 +1,44 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/core/Core.h"
+
+namespace Cocoa
+{
+	// Writes JSON text straight into a string without building a json DOM first. Pretty output is
+	// byte for byte what json::dump(4) produces for the same document, provided object keys are
+	// written in sorted order, which is the order nlohmann stores them in
+	class COCOA JsonWriter
+	{
+	public:
+		JsonWriter(std::string& output, bool pretty = true);
+
+		void BeginObject();
+		void EndObject();
+		void BeginArray();
+		void EndArray();
+		void Key(std::string_view key);
+
+		void Null();
+		void Bool(bool value);
+		void Int(int64 value);
+		void UInt(uint64 value);
+		void Float(double value);
+		void String(std::string_view value);
+		// For the small parts of a document that are still built as a DOM elsewhere
+		void Value(const json& value);
+
+	private:
+		void BeginValue();
+		void BeginScope(char open);
+		void EndScope(char close);
+		void NewLine();
+		void WriteString(std::string_view str);
+
+	private:
+		std::string& m_Output;
+		bool m_Pretty;
+		bool m_AfterKey;
+		// One entry per open object or array, true while it is still empty
+		std::vector<bool> m_Empty;
+	};
+}
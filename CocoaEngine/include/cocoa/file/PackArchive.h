@@ -0,0 +1,105 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/file/CPath.h"
+#include "cocoa/file/IFile.h"
+
+#include <mutex>
+
+namespace Cocoa
+{
+	// On-disk layout of a .cpak archive:
+	//   PackHeader | entry data (each entry aligned to m_Alignment) | PackEntry[m_EntryCount] | string table
+	// The table of contents is sorted by path hash so lookups are a binary search straight out of
+	// the mapped file. Paths are stored normalized, see PackArchive::NormalizePath.
+	enum class PackCompression : uint8
+	{
+		None = 0,
+		Lz4 = 1
+	};
+
+	struct PackHeader
+	{
+		uint32 m_Magic;
+		uint32 m_Version;
+		uint32 m_EntryCount;
+		uint32 m_Alignment;
+		uint64 m_TocOffset;
+		uint64 m_StringTableOffset;
+		uint64 m_StringTableSize;
+	};
+
+	struct PackEntry
+	{
+		uint64 m_PathHash;
+		uint64 m_Offset;
+		uint64 m_Size;
+		uint64 m_UncompressedSize;
+		uint32 m_PathOffset;
+		uint16 m_PathLength;
+		PackCompression m_Compression;
+		uint8 m_Padding;
+	};
+
+	static_assert(sizeof(PackHeader) == 40, "PackHeader layout is part of the archive format.");
+	static_assert(sizeof(PackEntry) == 40, "PackEntry layout is part of the archive format.");
+
+	class COCOA PackArchive
+	{
+	public:
+		PackArchive() = default;
+		~PackArchive();
+		PackArchive(const PackArchive&) = delete;
+		PackArchive& operator=(const PackArchive&) = delete;
+
+		bool Open(const CPath& archivePath);
+		void Close();
+		inline bool IsOpen() const { return m_Header != nullptr; }
+
+		const PackEntry* FindEntry(const std::string& path) const;
+		std::string GetEntryPath(const PackEntry& entry) const;
+		inline uint32 GetEntryCount() const { return m_Header ? m_Header->m_EntryCount : 0; }
+		inline const PackEntry* GetEntries() const { return m_Toc; }
+
+		// Uncompressed entries point straight into the mapped archive. Compressed entries are
+		// decompressed once and cached for the lifetime of the archive. Safe to call from the AsyncIO
+		// workers.
+		bool Read(const PackEntry* entry, std::string_view& outData);
+		bool Read(const std::string& path, std::string_view& outData);
+
+		static std::string NormalizePath(const std::string& path);
+		static uint64 HashPath(const std::string& normalizedPath);
+
+		static const uint32 MAGIC = 0x4B415043; // 'CPAK'
+		static const uint32 VERSION = 1;
+
+	private:
+		MemoryMappedFile* m_File = nullptr;
+		const PackHeader* m_Header = nullptr;
+		const PackEntry* m_Toc = nullptr;
+		const char* m_StringTable = nullptr;
+		// Nodes never move, so views into a cached entry stay valid after the lock is released
+		std::unordered_map<uint64, std::string> m_DecompressedEntries;
+		std::mutex m_DecompressedMutex;
+	};
+
+	class COCOA PackArchiveWriter
+	{
+	public:
+		void AddFile(const CPath& filepath, const std::string& pathInArchive);
+		// Adds every file under directory, stored relative to it. Hidden files, folders and other archives are skipped
+		void AddDirectory(const CPath& directory, const std::string& pathPrefix = "");
+
+		bool Write(const CPath& outputPath, uint32 alignment = 16, bool compressLz4 = false);
+
+		inline size_t GetFileCount() const { return m_Files.size(); }
+
+	private:
+		struct PendingFile
+		{
+			CPath m_Source;
+			std::string m_Path;
+		};
+
+		std::vector<PendingFile> m_Files;
+	};
+}
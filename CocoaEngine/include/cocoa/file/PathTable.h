@@ -0,0 +1,48 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/file/CPath.h"
+
+namespace Cocoa
+{
+	// Handle to a path in the global PathTable. Two ids are equal exactly when the paths they were
+	// interned from are spelled the same, so comparing and hashing them is a single integer operation
+	struct PathId
+	{
+		uint32 m_Id = 0;
+
+		inline bool IsNull() const { return m_Id == 0; }
+		inline bool operator==(const PathId& other) const { return m_Id == other.m_Id; }
+		inline bool operator!=(const PathId& other) const { return m_Id != other.m_Id; }
+	};
+
+	struct PathTableState;
+
+	// Global table of interned paths. Interning compares the sanitized spelling only, so callers that
+	// need two spellings of the same file to collide should intern the absolute path. Entries are never
+	// removed, intern asset and settings paths rather than arbitrary user input
+	class COCOA PathTable
+	{
+	public:
+		static PathId Intern(const CPath& path);
+		// Like Intern, but returns a null id instead of adding paths that aren't in the table yet
+		static PathId Find(const CPath& path);
+		// The reference stays valid for the lifetime of the program
+		static const CPath& GetPath(PathId id);
+		static uint32 Size();
+
+	private:
+		static PathTableState& Get();
+	};
+}
+
+namespace std
+{
+	template<>
+	struct hash<Cocoa::PathId>
+	{
+		size_t operator()(const Cocoa::PathId& id) const
+		{
+			return id.m_Id;
+		}
+	};
+}
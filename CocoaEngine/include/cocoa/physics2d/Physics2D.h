@@ -4,28 +4,50 @@
 #include "cocoa/physics2d/Physics2DSystem.h"
 #include "cocoa/core/Core.h"
 #include "cocoa/core/Entity.h"
+#include "cocoa/core/JobSystem.h"
 
 namespace Cocoa
 {
 	class Scene;
+	// Every scene owns one, with its own Box2D world, see Scene::GetPhysics
 	class COCOA Physics2D
 	{
 	public:
 		Physics2D(Scene* scene);
+		~Physics2D();
 
 		static AABB GetBoundingBoxForPixels(uint8* pixels, int width, int height, int channels);
-
-		static Entity OverlapPoint(const glm::vec2& point);
 		static bool PointInBox(const glm::vec2& point, const glm::vec2& halfSize, const glm::vec2& position, float rotationDegrees);
 
-		static Physics2D* Get();
-		static void Init();
-		static void SetScene(Scene* scene);
+		Entity OverlapPoint(const glm::vec2& point);
 
 		void AddEntity(Entity entity);
+		// Destroys the entity's body, for entities leaving the simulation before Destroy
+		void RemoveEntity(Entity entity);
+		// Steps the world at Settings::Physics2D::s_Timestep, as many times as dt covers up to s_MaxSubsteps
 		void Update(float dt);
 		void Destroy();
 
+		// How far rendering is between the last two steps, 0 is the previous step and 1 the latest
+		float GetInterpolationAlpha() const { return m_InterpolationAlpha; }
+
+	private:
+		struct BodyPose
+		{
+			entt::entity m_Entity;
+			b2Body* m_Body;
+			glm::vec2 m_PreviousPosition;
+			float m_PreviousRotation;
+			glm::vec2 m_Position;
+			float m_Rotation;
+		};
+
+		// Passes Rigidbody2D settings edited since the last update on to their bodies
+		void SyncChangedBodies();
+		void Step(int steps);
+		// Waits for a step running ahead and copies its poses into the registry
+		void FinishStep();
+
 	private:
 		Scene* m_Scene;
 
@@ -33,7 +55,12 @@ namespace Cocoa
 		b2Vec2 m_Gravity { 0.0f, -10.0f };
 		b2World m_World { m_Gravity };
 		float m_PhysicsTime = 0.0f;
+		float m_InterpolationAlpha = 1.0f;
+		uint64 m_SyncedFrame = 0;
 
-		static std::unique_ptr<Physics2D> s_Instance;
+		// Gathered from the registry before stepping, the step itself never touches the registry so it can run as a job
+		std::vector<BodyPose> m_Poses;
+		JobCounter m_StepCounter;
+		bool m_StepPending = false;
 	};
 }
\ No newline at end of file
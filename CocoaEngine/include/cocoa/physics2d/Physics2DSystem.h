@@ -4,6 +4,7 @@
 
 #include "cocoa/systems/System.h"
 #include "cocoa/core/Entity.h"
+#include "cocoa/components/Transform.h"
 
 namespace Cocoa
 {
@@ -57,6 +58,33 @@ namespace Cocoa
         bool m_ContinuousCollision = false;
 
         void* m_RawRigidbody = nullptr;
+        // Pose one step before the one in the Transform, rendering interpolates between the two
+        glm::vec2 m_PreviousPosition = glm::vec2();
+        float m_PreviousRotation = 0.0f;
+    };
+
+    // ----------------------------------------------------------------------------
+    // World Space Shapes
+    // ----------------------------------------------------------------------------
+    // A collider placed by its entity's Transform. Systems build these from the group or view they're already
+    // iterating, so the collision tests never have to find the Transform again
+    struct WorldBox2D
+    {
+        glm::vec2 m_Center = glm::vec2();
+        glm::vec2 m_HalfSize = glm::vec2();
+        float m_Rotation = 0.0f;
+    };
+
+    struct WorldAABB
+    {
+        glm::vec2 m_Min = glm::vec2();
+        glm::vec2 m_Max = glm::vec2();
+    };
+
+    struct WorldCircle
+    {
+        glm::vec2 m_Center = glm::vec2();
+        float m_Radius = 1.0f;
     };
 
     class COCOA Physics2DSystem : public System
@@ -64,31 +92,33 @@ namespace Cocoa
     public:
         Physics2DSystem(const char* name, Scene* scene)
             : System(name, scene) { }
+
+        // Steps the Box2D world and copies the bodies back into their transforms
+        virtual void Update(float dt) override;
+        virtual void DeclareAccess(SystemAccess& access) override;
          
         // ----------------------------------------------------------------------------
         // Box2D Helpers
         // ----------------------------------------------------------------------------
         static Box2D Box2DFrom(glm::vec2 size);
         static Box2D Box2DFrom(glm::vec2 min, glm::vec2 max);
-        static glm::vec2 GetMin(const Box2D& box);
-        static glm::vec2 GetMax(const Box2D& box);
-        static std::array<glm::vec2, 4> GetVertices(const Box2D& box);
-        static glm::vec2 GetCenter(const Box2D& box);
-        static float GetRotation(const Box2D& box);
+        static WorldBox2D ToWorld(const Box2D& box, const Transform& transform);
+        // Corners of the box before it's rotated
+        static glm::vec2 GetMin(const WorldBox2D& box);
+        static glm::vec2 GetMax(const WorldBox2D& box);
+        static std::array<glm::vec2, 4> GetVertices(const WorldBox2D& box);
 
         // ----------------------------------------------------------------------------
         // AABB Helpers
         // ----------------------------------------------------------------------------
         static AABB AABBFrom(glm::vec2 min, glm::vec2 max);
         static AABB AABBFrom(glm::vec2 min, glm::vec2 max, glm::vec2 offset);
-        static glm::vec2 GetMin(const AABB& box);
-        static glm::vec2 GetMax(const AABB& box);
-        static glm::vec2 GetCenter(const AABB& box);
+        static WorldAABB ToWorld(const AABB& box, const Transform& transform);
 
         // ----------------------------------------------------------------------------
         // Circle Helpers
         // ----------------------------------------------------------------------------
-        static glm::vec2 GetCenter(const Circle& circle);
+        static WorldCircle ToWorld(const Circle& circle, const Transform& transform);
 
         // ----------------------------------------------------------------------------
         // Ray2D Helpers
@@ -22,7 +22,10 @@ namespace Cocoa
 
         void Clear();
         void Start();
-        void Add(const Transform& transform, const SpriteRenderer& spr);
+        // The entity comes straight from the caller's view, it's what ends up in the picking buffer
+        void Add(entt::entity entity, const Transform& transform, const SpriteRenderer& spr);
+        // Draws the sprite at a world position and rotation instead of where the transform is, for interpolated bodies
+        void Add(entt::entity entity, const Transform& transform, const SpriteRenderer& spr, const glm::vec3& position, float rotationDegrees);
         void Add(const glm::vec2& min, const glm::vec2& max, const glm::vec3& color);
         void Add(const glm::vec2* vertices, const glm::vec3& color);
         void Add(TextureHandle textureHandle, const glm::vec2& size, const glm::vec2& position, 
@@ -51,7 +54,7 @@ namespace Cocoa
         }
 
     private:
-        void LoadVertexProperties(const Transform& transform, const SpriteRenderer& spr);
+        void LoadVertexProperties(entt::entity entity, const Transform& transform, const SpriteRenderer& spr, const glm::vec3& position, float rotationDegrees);
         void LoadVertexProperties(const glm::vec3& position, 
             const glm::vec3& scale, const glm::vec2& quadSize, const glm::vec2* texCoords, 
             float rotationDegrees, const glm::vec4& color, int texId, uint32 entityId = -1);
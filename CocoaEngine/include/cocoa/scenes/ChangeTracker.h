@@ -0,0 +1,118 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/core/Core.h"
+
+#include "cocoa/scenes/ComponentCodec.h"
+
+#include <entt/entt.hpp>
+
+namespace Cocoa
+{
+	// Remembers the frame every SceneComponents component of every entity last changed in. Adding, removing
+	// and registry.patch/replace are picked up through entt's signals. Anything that writes through a plain
+	// reference, like the commands, has to call MarkChanged. Every component type has its own set, and the
+	// scheduler never runs two systems writing the same type side by side, so the sets don't need locks
+	class COCOA ChangeTracker
+	{
+	public:
+		void Connect(entt::registry& registry);
+		void Disconnect(entt::registry& registry);
+
+		// Moves on to the next frame. The oldest frame's list is emptied for it but keeps its memory
+		void EndFrame();
+		// Frames start at 1, ChangedSince(0) is true for anything that ever changed
+		inline uint64 GetFrame() const { return m_Frame; }
+
+		// componentMask holds SceneComponents::Bit<Component>() bits, anything else is ignored
+		void MarkChanged(entt::entity entity, uint32 componentMask);
+
+		template<typename Component>
+		void MarkChanged(entt::entity entity)
+		{
+			Record(SceneComponents::IndexOf<Component>(), entity);
+		}
+
+		template<typename Component>
+		bool ChangedSince(entt::entity entity, uint64 frame) const
+		{
+			const ChangeSet& set = m_Sets[SceneComponents::IndexOf<Component>()];
+			size_t index = IndexOf(entity);
+			return index < set.m_ByIndex.size() && set.m_ByIndex[index].m_Entity == entity && set.m_ByIndex[index].m_Frame >= frame;
+		}
+
+		// Calls fn(entity) once for every entity whose Component changed in frame or after. Removed components
+		// and destroyed entities count as changes, so check the entity still has it. Only the last HISTORY_FRAMES
+		// frames are cheap, anything older scans every entity that ever changed
+		template<typename Component, typename Fn>
+		void ForEachChangedSince(uint64 frame, Fn&& fn) const
+		{
+			const ChangeSet& set = m_Sets[SceneComponents::IndexOf<Component>()];
+			if (frame > m_Frame)
+			{
+				return;
+			}
+			if (m_Frame - frame < HISTORY_FRAMES)
+			{
+				// An entity is in the list of every frame it changed in, it's only visited in the last one
+				for (uint64 f = std::max<uint64>(frame, 1); f <= m_Frame; f++)
+				{
+					for (entt::entity entity : set.m_Frames[f % HISTORY_FRAMES])
+					{
+						const Change& change = set.m_ByIndex[IndexOf(entity)];
+						if (change.m_Entity == entity && change.m_Frame == f)
+						{
+							fn(entity);
+						}
+					}
+				}
+				return;
+			}
+
+			// Indices no entity ever changed at are left as null entries by the resize in Record
+			for (const Change& change : set.m_ByIndex)
+			{
+				if (change.m_Entity != entt::null && change.m_Frame >= frame)
+				{
+					fn(change.m_Entity);
+				}
+			}
+		}
+
+	public:
+		// Frames whose changes can be listed without scanning everything, syncing once a frame only needs 2
+		static const uint64 HISTORY_FRAMES = 4;
+
+	private:
+		struct Change
+		{
+			entt::entity m_Entity = entt::null;
+			uint64 m_Frame = 0;
+		};
+
+		struct ChangeSet
+		{
+			// Indexed by the entity part of the id, recycled ids overwrite their old entry
+			std::vector<Change> m_ByIndex;
+			// Every entity that changed in each of the last HISTORY_FRAMES frames, once per frame, indexed by
+			// frame % HISTORY_FRAMES
+			std::vector<entt::entity> m_Frames[HISTORY_FRAMES];
+		};
+
+		template<typename Component>
+		void OnChanged(entt::registry& registry, entt::entity entity)
+		{
+			Record(SceneComponents::IndexOf<Component>(), entity);
+		}
+
+		void Record(size_t type, entt::entity entity);
+
+		static inline size_t IndexOf(entt::entity entity)
+		{
+			return (size_t)(entt::to_integral(entity) & entt::entt_traits<std::underlying_type_t<entt::entity>>::entity_mask);
+		}
+
+	private:
+		ChangeSet m_Sets[SceneComponents::COUNT];
+		uint64 m_Frame = 1;
+	};
+}
@@ -0,0 +1,198 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/core/Core.h"
+
+#include "cocoa/components/Transform.h"
+#include "cocoa/components/components.h"
+#include "cocoa/physics2d/Physics2DSystem.h"
+
+#include <tuple>
+
+namespace Cocoa
+{
+	class JsonWriter;
+
+	// FNV-1a, constexpr so field names can be used as case labels
+	constexpr uint32 HashComponentName(std::string_view name)
+	{
+		uint32 hash = 2166136261u;
+		for (char c : name)
+		{
+			hash = (hash ^ (uint8)c) * 16777619u;
+		}
+		return hash;
+	}
+
+	// Every component of one type in a scene, stored as parallel arrays so whole columns can be
+	// handed to registry.insert
+	template<typename Component>
+	struct ComponentColumn
+	{
+		std::vector<entt::entity> m_Entities;
+		std::vector<Component> m_Components;
+		// Resource id of the asset each component references, only used by codecs with REFERENCES_ASSET
+		std::vector<uint32> m_ResourceIds;
+
+		size_t Size() const { return m_Entities.size(); }
+	};
+
+	// Defaults for ComponentCodec specializations
+	struct ComponentCodecBase
+	{
+		// Components that reference an asset keep its resource id in ComponentColumn::m_ResourceIds
+		static constexpr bool REFERENCES_ASSET = false;
+
+		// Runs on the main thread while a scene is saved, the AssetManager isn't safe to use anywhere else
+		template<typename Component>
+		static uint32 GetResourceId(const Component& component) { return std::numeric_limits<uint32>::max(); }
+		// Runs on the main thread once the scene's assets are loaded
+		template<typename Component>
+		static void SetResourceId(Component& component, uint32 assetId) {}
+		// Derives whatever isn't stored in the file once every field has been read
+		template<typename Component>
+		static void FinishRead(Component& component) {}
+	};
+
+	// A component is saved and loaded with scenes by specializing this once and listing it in SceneComponents:
+	//   NAME       the key the component is stored under in JSON scenes
+	//   Write      writes the fields of the component object, "Entity" included, in sorted key order
+	//   ReadField  sets one field. field is HashComponentName(key), axis is the index of the X/Y/Z/W
+	//              key for vector fields and -1 otherwise, value is always a number or a bool
+	// Binary scenes also need a record layout in SceneBinary.cpp. A codec only ever touches its own
+	// component type, so columns of different types can be written and read on different threads
+	template<typename Component>
+	struct ComponentCodec;
+
+	template<>
+	struct ComponentCodec<Transform> : public ComponentCodecBase
+	{
+		static constexpr const char* NAME = "Transform";
+		static void Write(JsonWriter& writer, uint32 entity, const Transform& transform, uint32 resourceId);
+		static void ReadField(Transform& transform, uint32 field, int axis, const json& value, uint32& resourceId);
+	};
+
+	template<>
+	struct ComponentCodec<Rigidbody2D> : public ComponentCodecBase
+	{
+		static constexpr const char* NAME = "Rigidbody2D";
+		static void Write(JsonWriter& writer, uint32 entity, const Rigidbody2D& rigidbody, uint32 resourceId);
+		static void ReadField(Rigidbody2D& rigidbody, uint32 field, int axis, const json& value, uint32& resourceId);
+	};
+
+	template<>
+	struct ComponentCodec<Box2D> : public ComponentCodecBase
+	{
+		static constexpr const char* NAME = "Box2D";
+		static void Write(JsonWriter& writer, uint32 entity, const Box2D& box, uint32 resourceId);
+		static void ReadField(Box2D& box, uint32 field, int axis, const json& value, uint32& resourceId);
+		static void FinishRead(Box2D& box) { box.m_Size = box.m_HalfSize * 2.0f; }
+	};
+
+	template<>
+	struct ComponentCodec<SpriteRenderer> : public ComponentCodecBase
+	{
+		static constexpr const char* NAME = "SpriteRenderer";
+		static constexpr bool REFERENCES_ASSET = true;
+		static void Write(JsonWriter& writer, uint32 entity, const SpriteRenderer& spriteRenderer, uint32 resourceId);
+		static void ReadField(SpriteRenderer& spriteRenderer, uint32 field, int axis, const json& value, uint32& resourceId);
+		static uint32 GetResourceId(const SpriteRenderer& spriteRenderer);
+		static void SetResourceId(SpriteRenderer& spriteRenderer, uint32 assetId);
+	};
+
+	template<>
+	struct ComponentCodec<AABB> : public ComponentCodecBase
+	{
+		static constexpr const char* NAME = "AABB";
+		static void Write(JsonWriter& writer, uint32 entity, const AABB& box, uint32 resourceId);
+		static void ReadField(AABB& box, uint32 field, int axis, const json& value, uint32& resourceId);
+		static void FinishRead(AABB& box) { box.m_Size = box.m_HalfSize * 2.0f; }
+	};
+
+	// Points the components of a column at the assets they referenced when the scene was saved. resourceIdMap
+	// maps saved resource ids to the ids AssetManager::LoadFrom gave them
+	template<typename Component>
+	void ApplyResourceIds(ComponentColumn<Component>& column, const std::unordered_map<uint32, uint32>& resourceIdMap)
+	{
+		if constexpr (ComponentCodec<Component>::REFERENCES_ASSET)
+		{
+			for (size_t i = 0; i < column.Size(); i++)
+			{
+				if (column.m_ResourceIds[i] != std::numeric_limits<uint32>::max())
+				{
+					auto it = resourceIdMap.find(column.m_ResourceIds[i]);
+					ComponentCodec<Component>::SetResourceId(column.m_Components[i], it != resourceIdMap.end() ? it->second : 0);
+				}
+			}
+		}
+	}
+
+	template<typename Component>
+	struct ComponentTag
+	{
+		using Type = Component;
+	};
+
+	template<typename... Components>
+	struct ComponentList
+	{
+		using Columns = std::tuple<ComponentColumn<Components>...>;
+		using Values = std::tuple<Components...>;
+		static constexpr size_t COUNT = sizeof...(Components);
+
+		// Position of Component in the list, COUNT if it isn't in it
+		template<typename Component>
+		static constexpr size_t IndexOf()
+		{
+			size_t index = 0;
+			bool found = false;
+			((found = found || std::is_same_v<Component, Components>, index += found ? 0 : 1), ...);
+			return index;
+		}
+
+		// Bit of Component in masks over the list, like Scene's dirty masks
+		template<typename Component>
+		static constexpr uint32 Bit()
+		{
+			static_assert(IndexOf<Component>() < COUNT, "Component is not in the list.");
+			return 1u << IndexOf<Component>();
+		}
+
+		static constexpr uint32 ALL_BITS = (1u << COUNT) - 1;
+
+		// Calls fn(ComponentTag<Component>{}) for every component, in list order
+		template<typename Fn>
+		static void ForEach(Fn&& fn)
+		{
+			(fn(ComponentTag<Components>{}), ...);
+		}
+
+		// Passes every component to an entt::snapshot archive, in list order
+		template<typename Archive>
+		static void Snapshot(const entt::registry& registry, Archive& archive)
+		{
+			entt::snapshot{ registry }
+				.entities(archive)
+				.template component<Components...>(archive);
+		}
+
+		// Calls fn(ComponentTag<Component>{}) for the component at index, through a jump table
+		template<typename Fn>
+		static void Visit(size_t index, Fn&& fn)
+		{
+			using Thunk = void(*)(Fn&);
+			static const Thunk thunks[] = { [](Fn& f) { f(ComponentTag<Components>{}); }... };
+			thunks[index](fn);
+		}
+	};
+
+	// Every component scenes save and load. The order is the order they're written in
+	using SceneComponents = ComponentList<Transform, Rigidbody2D, Box2D, SpriteRenderer, AABB>;
+
+	class COCOA ComponentRegistry
+	{
+	public:
+		// Index into SceneComponents of the component stored under this JSON key, -1 for anything
+		// else, which scenes treat as a script component
+		static int Find(std::string_view name);
+	};
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/core/Core.h"
+
+#include "cocoa/scenes/ComponentCodec.h"
+
+#include <entt/entt.hpp>
+
+namespace Cocoa
+{
+	// Prototype entities copied out of a scene, kept as one column per component so Scene::Instantiate can
+	// insert any number of copies in bulk. The first entity is the root, the rest are its descendants
+	class COCOA Prefab
+	{
+	public:
+		// Copies root, everything parented under it and every SceneComponents component they have
+		static Prefab FromEntity(const entt::registry& registry, entt::entity root);
+
+		inline size_t GetEntityCount() const { return m_EntityCount; }
+		inline bool IsEmpty() const { return m_EntityCount == 0; }
+
+	private:
+		// Entities in the columns are positions in the prefab, 0 being the root. So are the Transform
+		// parents, except the root's, which still points at whatever it was parented to in the scene
+		SceneComponents::Columns m_Columns;
+		uint32 m_EntityCount = 0;
+
+		friend class Scene;
+	};
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/core/Core.h"
+
+#include "cocoa/scenes/ComponentCodec.h"
+
+#include <entt/entt.hpp>
+#include <nlohmann/json.hpp>
+
+namespace Cocoa
+{
+	class Scene;
+	class ScriptSystem;
+
+	// Every engine component a registry can hold, the scene components plus the ones scenes don't save
+	using RegistryComponents = ComponentList<Transform, Rigidbody2D, Box2D, SpriteRenderer, AABB, TransformMatrix, EntityName>;
+
+	// In-memory copy of a scene's registry, taken when play starts and put back when it stops. Engine
+	// components are copied straight out of their pools a column at a time. Script components go through
+	// the script module's serializer, since only it knows their types, but stay in memory. Capturing
+	// again reuses the memory of the last capture
+	class COCOA RegistrySnapshot
+	{
+	public:
+		void Capture(entt::registry& registry, ScriptSystem* scriptSystem);
+		// Destroys entities created since the capture, brings back the ones destroyed since, and replaces
+		// every component with its captured copy. Physics bodies have to be gone already. Each capture is
+		// only restored once
+		void Restore(Scene* scene, ScriptSystem* scriptSystem);
+
+		// A capture of an empty registry still counts, restoring it destroys everything created since
+		inline bool HasCapture() const { return m_Captured; }
+
+	private:
+		bool m_Captured = false;
+		std::vector<entt::entity> m_Entities;
+		RegistryComponents::Columns m_Columns;
+		json m_Scripts;
+	};
+}
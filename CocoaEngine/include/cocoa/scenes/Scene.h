@@ -6,6 +6,7 @@
 #include "cocoa/core/AssetManager.h"
 #include "cocoa/core/AssetManager.h"
 #include "cocoa/scenes/SceneInitializer.h"
+#include "cocoa/components/TransformHierarchy.h"
 
 #include <entt/entt.hpp>
 
@@ -13,51 +14,112 @@ namespace Cocoa
 {
 	class SceneInitializer;
 	class Entity;
+	class ChangeTracker;
+	class Physics2D;
+	class WorldPartition;
+	class Prefab;
+	class RegistrySnapshot;
+	class ScriptSystem;
+	struct SceneSnapshot;
 	class COCOA Scene
 	{
 	public:
 		Scene(SceneInitializer* sceneInitializer);
+		~Scene();
 
 		void Init();
+		// Points everything that works on the scene on screen at this one: input, debug drawing and the
+		// undo history. Any number of scenes can exist, only one is active
+		void Activate();
 		void Start();
 		void Update(float dt);
 		void EditorUpdate(float dt);
 		void Render();
 
+		// Play keeps a copy of the registry in memory and Stop puts it back, nothing is saved or loaded
 		void Play();
 		void Stop();
-		void Save(const CPath& filename);
+		// Compact saves skip the indentation, for files nobody reads by hand
+		void Save(const CPath& filename, bool compact = false);
+		// Appends only what changed since the last Save or Load to the scene's journal, far cheaper than
+		// Save for big scenes. Falls back to Save when the journal can't describe the changes
+		void SaveChanges(const CPath& filename);
 		void Load(const CPath& filename);
+		// Loading split in two for background loads. Stream reads the file and fills this scene's registry,
+		// it may run on a worker as long as nothing else touches the scene meanwhile. FinishStreaming runs on
+		// the main thread after Init and Start, loads the assets and scripts and points the components at them
+		bool Stream(const CPath& filename);
+		void FinishStreaming();
 		void LoadScriptsOnly(const CPath& filename);
 		void Reset();
 
 		Entity CreateEntity();
+		// Copies the entity and everything parented under it
 		Entity DuplicateEntity(Entity entity);
+		// Inserts count copies of prefab, one column per component. transforms holds the root Transform of
+		// every copy, parent included, nullptr keeps the prefab's. roots gets the root of every copy
+		void Instantiate(const Prefab& prefab, size_t count, const Transform* transforms = nullptr, entt::entity* roots = nullptr);
 		Entity GetEntity(uint32 id);
 
+		// componentMask holds SceneComponents::Bit<Component>() bits, or SCRIPT_CHANGES for script components.
+		// The change tracker hears about it too
+		void MarkDirty(entt::entity entity, uint32 componentMask);
+		// Also true when the writer failed to journal edits that were already handed to it
+		bool HasUnsavedChanges() const;
+		inline bool IsDirty(entt::entity entity) const { return m_DirtyComponents.find(entt::to_integral(entity)) != m_DirtyComponents.end(); }
+
 		inline Camera* GetCamera() { return m_Camera; }
 		inline const std::vector<std::unique_ptr<System>>& GetSystems() { return m_Systems; }
+		inline const SystemScheduler& GetScheduler() const { return m_Scheduler; }
 		inline entt::registry& GetRegistry() { return m_Registry; }
+		inline Physics2D* GetPhysics() { return m_Physics.get(); }
+		// Open for scenes saved in cells, see WorldPartition. Streams around the camera every update
+		inline WorldPartition* GetPartition() { return m_Partition.get(); }
+		// Include cocoa/scenes/ChangeTracker.h to use it, it needs every component and this header can't have that
+		inline const ChangeTracker& GetChanges() const { return *m_Changes; }
 
 		// TODO: TEMPORARY GET BETTER SYSTEM THAN THESE!!!
-		inline json& GetSaveDataJson() { return m_SaveDataJson; }
 		inline void ShowDemoWindow() { m_ShowDemoWindow = true; }
 		inline bool IsPlaying() { return m_IsPlaying; }
 
 	protected:
 		void LoadDefaultAssets();
+		void ResetEntities();
+		void UpdatePartition();
+		ScriptSystem* GetScriptSystem();
 
 	protected:
 		bool m_ShowDemoWindow;
 		bool m_IsPlaying;
 		std::vector<std::unique_ptr<System>> m_Systems;
+		SystemScheduler m_Scheduler;
+		TransformHierarchy m_TransformHierarchy;
 
+		std::unique_ptr<ChangeTracker> m_Changes;
 		entt::registry m_Registry;
-		json m_SaveDataJson;
+		std::unique_ptr<Physics2D> m_Physics;
+		std::unique_ptr<WorldPartition> m_Partition;
+
+		// The scene as it was when play started
+		std::unique_ptr<RegistrySnapshot> m_PlaySnapshot;
+		std::unordered_map<uint32, uint32> m_PlayDirtyComponents;
+		std::vector<uint64> m_PlayCells;
+		// What Stream read, until FinishStreaming is done with it
+		std::unique_ptr<SceneSnapshot> m_StreamedSnapshot;
 
 		Camera* m_Camera;
 		SceneInitializer* m_SceneInitializer;
 
+		// Entity id to the SceneComponents bits changed since the last save
+		std::unordered_map<uint32, uint32> m_DirtyComponents;
+		// The file the dirty bits are relative to, deltas for any other file need a full save
+		CPath m_SavedFilename;
+		bool m_NeedsFullSave;
+
 		friend class Entity;
+
+	public:
+		// Script components aren't journaled, changing one makes the next SaveChanges a full save
+		static const uint32 SCRIPT_CHANGES = 1u << 31;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/core/Core.h"
+
+#include "cocoa/file/CPath.h"
+#include "cocoa/scenes/SceneWriter.h"
+
+#include <nlohmann/json.hpp>
+
+namespace Cocoa
+{
+	class Scene;
+	class ScriptSystem;
+
+	// Binary scene files, little endian throughout:
+	//
+	//   SceneBinaryHeader
+	//   SceneBinarySection[header.m_SectionCount]
+	//   section data, every section starts on an 8 byte boundary
+	//
+	// Component sections hold m_Count entity ids (uint32) followed by m_Count packed records of
+	// m_Stride bytes each, one section per component type. The entity section holds every entity id
+	// in the scene. Project, asset and script sections hold m_Size bytes of JSON text, those are tiny
+	// next to the component data and are passed straight on to code that already speaks JSON
+	enum class SceneSectionType : uint32
+	{
+		Entities = 0,
+		Project,
+		Assets,
+		Scripts,
+		Transform,
+		SpriteRenderer,
+		Rigidbody2D,
+		Box2D,
+		AABB,
+		Length
+	};
+
+	struct SceneBinaryHeader
+	{
+		uint8 m_Magic[4];
+		uint32 m_Version;
+		uint32 m_SectionCount;
+		uint32 m_Reserved;
+	};
+
+	struct SceneBinarySection
+	{
+		uint32 m_Type;
+		uint32 m_Count;
+		uint32 m_Stride;
+		uint32 m_Reserved;
+		uint64 m_Offset;
+		uint64 m_Size;
+	};
+
+	class COCOA SceneBinary
+	{
+	public:
+		// Scenes saved with this extension are written in the binary format. Loading looks at the
+		// file contents instead, so either format loads no matter what the file is called
+		static bool IsBinaryPath(const CPath& path);
+		static bool IsBinary(std::string_view data);
+
+		static std::string Write(const SceneSnapshot& snapshot);
+		static bool Read(std::string_view data, SceneSnapshot& snapshot);
+
+		// Bulk inserts every component column into the scene's registry. The data can be a mapped
+		// file, nothing is copied out of it besides the components themselves
+		static bool Load(std::string_view data, Scene* scene, ScriptSystem* scriptSystem, bool scriptsOnly = false);
+
+		// Converts a scene file between formats, the input format is detected from its contents
+		static bool ConvertFile(const CPath& input, const CPath& output);
+
+	private:
+		// Files from any earlier version still load. 2 added Transform parents
+		static const uint32 VERSION = 2;
+	};
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/core/Core.h"
+
+#include "cocoa/file/CPath.h"
+#include "cocoa/scenes/SceneWriter.h"
+
+namespace Cocoa
+{
+	// Append-only log of delta saves kept next to a scene file as <scene>.journal. Every record is one
+	// line of compact scene JSON holding only the entities edited since the previous save, plus the
+	// components that were removed from them. Loading applies the records to the scene file in order.
+	// Once a journal grows past a fraction of its scene file the writer thread folds it back in
+	class COCOA SceneJournal
+	{
+	public:
+		static CPath GetPath(const CPath& sceneFile);
+		static bool HasJournal(const CPath& sceneFile);
+
+		// Writer thread only, see SceneWriter::Submit
+		static bool Append(const SceneSnapshot& delta);
+		// Rewrites the scene file with its journal applied, then deletes the journal
+		static bool Compact(const CPath& sceneFile);
+		// Deletes the journal once a full save made it redundant. sceneSize is the size of the file just written
+		static void Discard(const CPath& sceneFile, uint64 sceneSize);
+		// True once an append failed or the journal was found broken on load. Records after a broken one are
+		// never applied, so the scene has to be saved in full before anything else goes into the journal
+		static bool NeedsFullSave(const CPath& sceneFile);
+
+		// Applies every record in journal to a snapshot of the scene file. Stops at the first record that
+		// doesn't parse, which is normally the tail of an append that was cut short, and returns false
+		static bool Apply(std::string_view journal, SceneSnapshot& snapshot);
+		// Reads a scene file from either format, with its journal applied if it has one. A broken journal
+		// still loads as far as it goes, see NeedsFullSave
+		static bool Read(std::string_view data, const CPath& sceneFile, SceneSnapshot& snapshot);
+		// Bytes up to and including the last complete record, anything after is an append that was cut short
+		static size_t GetIntactSize(std::string_view journal);
+
+	private:
+		// Journals are compacted once they're bigger than the scene file divided by this
+		static const uint64 COMPACT_RATIO = 2;
+		// Small scenes aren't worth compacting every few records
+		static const uint64 MIN_COMPACT_SIZE = 64 * 1024;
+	};
+}
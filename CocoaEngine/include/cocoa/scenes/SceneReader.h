@@ -0,0 +1,35 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/core/Core.h"
+
+#include "cocoa/scenes/SceneWriter.h"
+
+namespace Cocoa
+{
+	class Scene;
+	class ScriptSystem;
+
+	// Loads JSON scenes with nlohmann's SAX interface. Engine components are filled in field by field
+	// as they are parsed, no DOM is built for them. Only the asset list and script components are
+	// built as json, since the AssetManager and script module take json
+	class COCOA SceneReader
+	{
+	public:
+		// Returns false if the data isn't valid JSON
+		static bool Read(std::string_view data, SceneSnapshot& snapshot);
+
+		// Bulk inserts every component column into the scene's registry
+		static bool Load(std::string_view data, Scene* scene, ScriptSystem* scriptSystem, bool scriptsOnly = false);
+		// Same for a snapshot that was already read, from either format, like a scene with its journal applied
+		static void Insert(SceneSnapshot& snapshot, Scene* scene, ScriptSystem* scriptSystem, bool scriptsOnly = false);
+
+		// Insert in two halves, for scenes streamed in the background. InsertComponents only touches registry, so it
+		// runs on any thread nothing else uses that registry from. InsertAssetsAndScripts runs on the main thread
+		// afterwards and points the inserted components at their assets. With resolveAssets the assets are
+		// looked up in the open scene instead of loaded as a new scene's, see AssetManager::ResolveFrom
+		static void InsertComponents(SceneSnapshot& snapshot, entt::registry& registry);
+		static void InsertAssetsAndScripts(SceneSnapshot& snapshot, Scene* scene, ScriptSystem* scriptSystem, bool resolveAssets = false);
+		// Hands every script component in scripts, as ScriptSystem::SaveScripts wrote them, to the script module
+		static void InsertScripts(json& scripts, Scene* scene, ScriptSystem* scriptSystem);
+	};
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/core/Core.h"
+
+#include "cocoa/file/CPath.h"
+#include "cocoa/scenes/ComponentCodec.h"
+
+#include <nlohmann/json.hpp>
+
+namespace Cocoa
+{
+	// Plain copies of everything Scene::Save writes out. Taking one only copies component data, the
+	// JSON is built from it later on the writer thread
+	struct SceneSnapshot
+	{
+		CPath m_Filename;
+		// JSON scenes only, writes the file without indentation
+		bool m_Compact = false;
+		std::string m_Project;
+		json m_Assets;
+		// Filled in by the script module on the main thread, appended after the engine components
+		json m_Scripts;
+
+		// Delta snapshots only hold the entities edited since the last save and are appended to the
+		// scene's journal instead of replacing the file, see SceneJournal
+		bool m_Delta = false;
+		// Entities and SceneComponents bits of the components removed since the last save, deltas only
+		std::vector<std::pair<entt::entity, uint32>> m_Removed;
+
+		// One column per entry in SceneComponents. Resource ids are resolved on the main thread, the
+		// AssetManager isn't safe to use from the writer
+		SceneComponents::Columns m_Columns;
+
+		template<typename Component>
+		ComponentColumn<Component>& Column() { return std::get<ComponentColumn<Component>>(m_Columns); }
+		template<typename Component>
+		const ComponentColumn<Component>& Column() const { return std::get<ComponentColumn<Component>>(m_Columns); }
+	};
+
+	// entt::snapshot archive that copies components into a SceneSnapshot
+	class COCOA SceneSnapshotArchive
+	{
+	public:
+		SceneSnapshotArchive(SceneSnapshot& snapshot)
+			: m_Snapshot(snapshot) {}
+
+		void operator()(entt::entity entity) {}
+		void operator()(std::underlying_type_t<entt::entity> underlyingType) {}
+
+		template<typename Component>
+		void operator()(entt::entity entity, const Component& component)
+		{
+			ComponentColumn<Component>& column = m_Snapshot.Column<Component>();
+			column.m_Entities.push_back(entity);
+			column.m_Components.push_back(component);
+			if constexpr (ComponentCodec<Component>::REFERENCES_ASSET)
+			{
+				column.m_ResourceIds.push_back(ComponentCodec<Component>::GetResourceId(component));
+			}
+		}
+
+	private:
+		SceneSnapshot& m_Snapshot;
+	};
+
+	struct SceneWriterState;
+
+	// Serializes scene snapshots and writes them to disk on a background thread. The JSON is streamed
+	// straight into the output, no json DOM is built for the components
+	class COCOA SceneWriter
+	{
+	public:
+		static void Init();
+		// Writes out everything still pending before returning
+		static void Destroy();
+		static bool IsInitialized() { return s_Instance != nullptr; }
+
+		// Takes ownership of the snapshot. A full snapshot drops everything for the same file that hasn't
+		// started writing yet, deltas are always kept and written in order. Without Init the snapshot is
+		// written straight away
+		static void Submit(SceneSnapshot* snapshot);
+		// Blocks until every submitted snapshot is on disk
+		static void Flush();
+
+		// Appends the scene JSON to output, same bytes json::dump(4) gave for the old DOM based writer
+		static void Write(const SceneSnapshot& snapshot, std::string& output, bool compact = false);
+
+	private:
+		static SceneWriterState* s_Instance;
+	};
+}
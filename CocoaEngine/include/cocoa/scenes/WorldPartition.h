@@ -0,0 +1,136 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/core/Core.h"
+
+#include "cocoa/file/CPath.h"
+#include "cocoa/core/JobSystem.h"
+
+#include <entt/entt.hpp>
+#include <future>
+
+namespace Cocoa
+{
+	class Scene;
+	struct SceneSnapshot;
+	struct File;
+
+	// Splits a scene into square cells of world space, each stored as its own binary chunk in <scene>.cells/
+	// next to an index of the cells and the entities in them. Only cells near a streaming source have their
+	// components in the registry. Cells are read and parsed in the background once a source comes within
+	// the load radius, and unloaded once every source is further away than the unload radius, so a camera
+	// going back and forth over a border doesn't keep reloading the same cells.
+	//
+	// Entity ids don't change when a cell comes and goes. Every id in the index is reserved in the registry
+	// when the partition opens, and unloading a cell only removes the components, so references to an
+	// entity in another cell stay valid while it's out. Children always go in their root's cell
+	class COCOA WorldPartition
+	{
+	public:
+		WorldPartition(Scene* scene);
+		~WorldPartition();
+
+		static CPath GetDirectory(const CPath& sceneFile);
+		static bool HasPartition(const CPath& sceneFile);
+
+		// Puts every entity with a Transform into cells of cellSize world units and writes them out. They all
+		// stay loaded until the next Update
+		bool Build(const CPath& sceneFile, float cellSize = DEFAULT_CELL_SIZE);
+		// Reads the index of a partitioned scene and reserves the entity ids in it. No cell loads until Update
+		bool Open(const CPath& sceneFile);
+		// Destroys the entities of every cell, loaded or not, and forgets the partition
+		void Close();
+		inline bool IsOpen() const { return m_CellSize > 0.0f; }
+
+		// Writes the loaded cells back out. Entities that moved go to the cell they're in now, as long as
+		// that one is loaded too. Entities created since the cells loaded are picked up the same way.
+		// scripts are the whole scene's, as ScriptSystem::SaveScripts writes them, each cell keeps its own
+		void Save(const json& scripts);
+		// Removes everything the cells own from a snapshot of the whole scene, scripts included, the cells
+		// save those
+		void Strip(SceneSnapshot& snapshot) const;
+		inline bool Owns(entt::entity entity) const { return m_Owners.find(entity) != m_Owners.end(); }
+
+		// Sources are world positions, normally just the camera. Call once a frame on the main thread
+		void Update(const std::vector<glm::vec2>& sources);
+
+		// Distances in cells. unloadRadius is always at least loadRadius + 1, that gap is the hysteresis
+		void SetRadii(int loadRadius, int unloadRadius);
+		// Inserting a cell is the part that shows up in the frame time, more than this many wait a frame
+		inline void SetActivationsPerFrame(int count) { m_ActivationsPerFrame = count; }
+
+		// Play mode puts the registry back the way it was when play started, these keep the cells in step
+		std::vector<uint64> GetActiveCells() const;
+		void RestoreActiveCells(const std::vector<uint64>& keys);
+
+		inline size_t GetCellCount() const { return m_Cells.size(); }
+		inline size_t GetLoadedCellCount() const { return m_LoadedCells.size(); }
+
+	public:
+		static constexpr float DEFAULT_CELL_SIZE = 2048.0f;
+
+	private:
+		enum class CellState : uint8
+		{
+			Unloaded,
+			Reading,
+			Parsing,
+			Ready,
+			Active,
+			// Its file couldn't be read, it isn't asked for again until the partition is reopened
+			Failed
+		};
+
+		struct Cell
+		{
+			int32 m_X = 0;
+			int32 m_Y = 0;
+			CellState m_State = CellState::Unloaded;
+			std::vector<entt::entity> m_Entities;
+
+			// In flight while loading, m_Snapshot is only touched by the parse job until m_Parsing is done
+			std::future<File*> m_Read;
+			std::unique_ptr<SceneSnapshot> m_Snapshot;
+			bool m_Parsed = false;
+			JobCounter m_Parsing;
+		};
+
+		static uint64 KeyOf(int32 x, int32 y);
+		glm::ivec2 CellOf(const glm::vec2& position) const;
+		CPath GetCellPath(const Cell& cell) const;
+		Cell& GetOrCreateCell(int32 x, int32 y);
+		entt::entity RootOf(entt::entity entity) const;
+		// Cell the entity's root is in right now
+		uint64 CurrentKeyOf(entt::entity entity) const;
+		bool IsWithin(const Cell& cell, const std::vector<glm::ivec2>& sourceCells, int radius) const;
+		// Whether the editor has edits in the cell that only exist in the registry so far
+		bool HasUnsavedChanges(const Cell& cell) const;
+
+		void Request(Cell& cell);
+		// Moves a loading cell on as far as its background work allows
+		void Poll(Cell& cell);
+		// Blocks until the cell's background work is done, for Close and the destructor
+		void Finish(Cell& cell);
+		void Activate(Cell& cell);
+		void Deactivate(Cell& cell);
+		void Drop(Cell& cell);
+		void Fail(Cell& cell);
+
+		void Rebucket();
+		void WriteCell(const Cell& cell, const json& scripts);
+		void WriteIndex();
+
+	private:
+		Scene* m_Scene;
+		CPath m_SceneFile;
+		float m_CellSize = 0.0f;
+		int m_LoadRadius = 1;
+		int m_UnloadRadius = 2;
+		int m_ActivationsPerFrame = 2;
+
+		std::unordered_map<uint64, std::unique_ptr<Cell>> m_Cells;
+		// Entity to the key of the cell it's saved in
+		std::unordered_map<entt::entity, uint64> m_Owners;
+		// Every cell that isn't Unloaded or Failed, so Update never has to walk the whole map
+		std::vector<Cell*> m_LoadedCells;
+	};
+}
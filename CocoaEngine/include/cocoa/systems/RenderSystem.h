@@ -21,12 +21,17 @@ namespace Cocoa
 			m_Camera = m_Scene->GetCamera();
 		}
 
-		void AddEntity(const Transform& transform, const SpriteRenderer& spr);
+		void AddEntity(entt::entity entity, const Transform& transform, const SpriteRenderer& spr, const glm::vec3& position, float rotationDegrees);
 		virtual void Render() override;
+		// Only renders, Update doesn't touch anything
+		virtual void DeclareAccess(SystemAccess& access) override { access.None(); }
 
 		Camera& GetCamera() const { return *m_Camera; }
 
 		static void Serialize(json& j, Entity entity, const SpriteRenderer& spriteRenderer);
+		// Doesn't touch the AssetManager, so it's safe to call off the main thread with a resource id looked up beforehand
+		static void Serialize(json& j, Entity entity, const SpriteRenderer& spriteRenderer, uint32 textureResourceId);
+		static uint32 GetTextureResourceId(const SpriteRenderer& spriteRenderer);
 		static void Deserialize(json& json, Entity entity);
 		static void BindShader(std::shared_ptr<Shader> shader) { s_Shader = shader; }
 		static void UploadUniform1ui(const char* name, uint32 val) { s_Shader->UploadUInt(name, val); }
@@ -23,6 +23,7 @@ namespace Cocoa
     typedef void (*UpdateScriptFn)(float, Scene*);
     typedef void (*EditorUpdateScriptFn)(float, Scene*);
     typedef void (*AddComponentFromStringFn)(std::string, entt::entity, entt::registry&);
+    typedef void (*RemoveScriptsFn)(entt::entity);
 
     class COCOA ScriptSystem : public System
     {
@@ -44,6 +45,8 @@ namespace Cocoa
 
         bool FreeScriptLibrary();
         void AddComponentFromString(std::string className, entt::entity entity, entt::registry& registry);
+        // Removes every script component of the entity, for world partition cells going out
+        void RemoveScripts(entt::entity entity);
 
     public:
         InitImGuiFn m_InitImGui = nullptr;
@@ -56,6 +59,7 @@ namespace Cocoa
         InitScriptsFn m_InitScripts = nullptr;
         EditorUpdateScriptFn m_EditorUpdateScripts = nullptr;
         AddComponentFromStringFn m_AddComponentFromString = nullptr;
+        RemoveScriptsFn m_RemoveScripts = nullptr;
         ImGuiFn m_ImGui = nullptr;
 
         bool m_IsLoaded = false;
@@ -2,6 +2,7 @@
 #include "externalLibs.h"
 
 #include "cocoa/events/Event.h"
+#include "cocoa/systems/SystemScheduler.h"
 
 namespace Cocoa
 {
@@ -27,6 +28,13 @@ namespace Cocoa
 
 		}
 
+		// Declares which components Update reads and writes, so the scheduler knows which systems can
+		// update at the same time. Leaving it alone keeps the system exclusive
+		virtual void DeclareAccess(SystemAccess& access)
+		{
+
+		}
+
 		virtual void EditorUpdate(float dt)
 		{
 
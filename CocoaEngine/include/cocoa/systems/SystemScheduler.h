@@ -0,0 +1,85 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/core/Core.h"
+
+#include <atomic>
+#include <entt/entt.hpp>
+
+namespace Cocoa
+{
+	class System;
+	class JobCounter;
+
+	// Components a system touches in Update. Systems that don't declare anything are exclusive, they
+	// never run next to another system and always run on the main thread, like user scripts
+	struct SystemAccess
+	{
+		std::vector<uint32> m_Reads;
+		std::vector<uint32> m_Writes;
+		// Touches anything at all
+		bool m_Exclusive = true;
+		// Has to run on the main thread, for GL calls or code that isn't safe anywhere else
+		bool m_MainThread = false;
+
+		template<typename Component>
+		SystemAccess& Read()
+		{
+			m_Exclusive = false;
+			m_Reads.push_back((uint32)entt::type_info<Component>().id());
+			return *this;
+		}
+
+		template<typename Component>
+		SystemAccess& Write()
+		{
+			m_Exclusive = false;
+			m_Writes.push_back((uint32)entt::type_info<Component>().id());
+			return *this;
+		}
+
+		// Touches no components, e.g. systems that only render
+		SystemAccess& None()
+		{
+			m_Exclusive = false;
+			return *this;
+		}
+
+		bool ConflictsWith(const SystemAccess& other) const;
+	};
+
+	struct SystemNode
+	{
+		System* m_System = nullptr;
+		SystemAccess m_Access;
+		// Earlier systems this one conflicts with, it only starts once they're all done
+		std::vector<int> m_Dependencies;
+		std::vector<int> m_Dependents;
+
+		float m_LastMilliseconds = 0.0f;
+		float m_AverageMilliseconds = 0.0f;
+	};
+
+	// Runs Scene::Update over the job system. Every frame the systems' declared access is turned into a
+	// graph: two systems that conflict run in the order they were added to the scene, everything else
+	// runs at the same time. Systems can split their own work further with JobSystem::ParallelFor
+	class COCOA SystemScheduler
+	{
+	public:
+		// Blocks until every system has updated. Without a job system the systems run one after another
+		void Update(const std::vector<std::unique_ptr<System>>& systems, float dt);
+
+		// The graph and timings of the last frame, for the editor
+		const std::vector<SystemNode>& GetNodes() const { return m_Nodes; }
+
+	private:
+		void BuildGraph(const std::vector<std::unique_ptr<System>>& systems);
+		void RunNode(int index, float dt);
+		void Launch(int index, float dt);
+
+	private:
+		std::vector<SystemNode> m_Nodes;
+		// Dependencies each node is still waiting on this frame
+		std::unique_ptr<std::atomic<int32>[]> m_Remaining;
+		JobCounter* m_FrameCounter = nullptr;
+	};
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "externalLibs.h"
+
+#include "TestFactory.h"
+#include "cocoa/scenes/ChangeTracker.h"
+#include "cocoa/util/Log.h"
+
+namespace Cocoa
+{
+	namespace ChangeTrackerTester
+	{
+		template<typename Component>
+		static std::vector<entt::entity> ChangedSince(const ChangeTracker& tracker, uint64 frame)
+		{
+			std::vector<entt::entity> entities;
+			tracker.ForEachChangedSince<Component>(frame, [&](entt::entity entity) { entities.push_back(entity); });
+			std::sort(entities.begin(), entities.end());
+			return entities;
+		}
+
+		COCOA_TEST(changedSinceShouldFollowEndFrame)
+		{
+			ChangeTracker tracker;
+			entt::entity first = entt::entity(1);
+			entt::entity second = entt::entity(2);
+			tracker.MarkChanged<Transform>(first);
+			uint64 firstFrame = tracker.GetFrame();
+			tracker.EndFrame();
+			tracker.MarkChanged<Transform>(second);
+			tracker.MarkChanged(second, SceneComponents::Bit<Box2D>());
+
+			bool res = tracker.GetFrame() == firstFrame + 1;
+			res = res && tracker.ChangedSince<Transform>(first, 0) && tracker.ChangedSince<Transform>(first, firstFrame)
+				&& !tracker.ChangedSince<Transform>(first, tracker.GetFrame());
+			res = res && tracker.ChangedSince<Transform>(second, tracker.GetFrame()) && tracker.ChangedSince<Box2D>(second, tracker.GetFrame())
+				&& !tracker.ChangedSince<Box2D>(first, 0);
+			// A recycled id is a different entity
+			uint32 nextVersion = entt::entt_traits<std::underlying_type_t<entt::entity>>::entity_mask + 1;
+			res = res && !tracker.ChangedSince<Transform>(entt::entity(1 + nextVersion), 0);
+			Log::Assert(res, "ChangedSince should only see changes from the asked frame onwards.");
+			return res;
+		}
+
+		COCOA_TEST(forEachChangedSinceShouldVisitEachEntityOnce)
+		{
+			ChangeTracker tracker;
+			const std::vector<entt::entity> both = { entt::entity(1), entt::entity(2) };
+			uint64 start = tracker.GetFrame();
+			tracker.MarkChanged<Transform>(entt::entity(1));
+			tracker.MarkChanged<Transform>(entt::entity(1));
+			tracker.EndFrame();
+			tracker.MarkChanged<Transform>(entt::entity(2));
+			tracker.EndFrame();
+			tracker.MarkChanged<Transform>(entt::entity(1));
+
+			bool res = ChangedSince<Transform>(tracker, start) == both && ChangedSince<Transform>(tracker, 0) == both;
+			res = res && ChangedSince<Transform>(tracker, start + 1) == both;
+			res = res && ChangedSince<Transform>(tracker, tracker.GetFrame()) == std::vector<entt::entity>{ entt::entity(1) };
+			res = res && ChangedSince<Transform>(tracker, tracker.GetFrame() + 1).empty() && ChangedSince<Box2D>(tracker, 0).empty();
+
+			// Past the history it falls back to scanning, which has to give the same answer
+			for (uint64 i = 0; i < ChangeTracker::HISTORY_FRAMES; i++)
+			{
+				tracker.EndFrame();
+			}
+			tracker.MarkChanged<Transform>(entt::entity(3));
+			res = res && ChangedSince<Transform>(tracker, start) == std::vector<entt::entity>{ entt::entity(1), entt::entity(2), entt::entity(3) };
+			// Index 0 never changed, the scan must not hand out its empty entry
+			res = res && ChangedSince<Transform>(tracker, 0) == std::vector<entt::entity>{ entt::entity(1), entt::entity(2), entt::entity(3) };
+			res = res && ChangedSince<Transform>(tracker, tracker.GetFrame()) == std::vector<entt::entity>{ entt::entity(3) };
+			Log::Assert(res, "ForEachChangedSince should visit every changed entity exactly once.");
+			return res;
+		}
+	}
+}
@@ -80,6 +80,74 @@ namespace Cocoa
             return !res;
         }
 
+
+        // =========================================================================================================
+        // Box2D and AABB tests
+        // =========================================================================================================
+        // Long thin box turned 45 degrees, it covers (12, 12) but not (13, 10), the unrotated box is the other way round
+        static WorldBox2D RotatedBox()
+        {
+            return WorldBox2D{ glm::vec2{10, 10}, glm::vec2{4, 1}, 45.0f };
+        }
+
+        COCOA_TEST(pointInRotatedBox2DShouldReturnTrue)
+        {
+            bool res = CollisionDetector2D::PointInBox2D(glm::vec2{12, 12}, RotatedBox());
+            Log::Assert(res, "Point should be inside the rotated box.");
+            return res;
+        }
+
+        COCOA_TEST(pointInRotatedBox2DShouldReturnFalse)
+        {
+            bool res = !CollisionDetector2D::PointInBox2D(glm::vec2{13, 10}, RotatedBox());
+            Log::Assert(res, "Point should be outside the rotated box.");
+            return res;
+        }
+
+        COCOA_TEST(circleAndOffsetAABBShouldReturnTrue)
+        {
+            WorldAABB box{ glm::vec2{10, 10}, glm::vec2{14, 12} };
+            WorldCircle circle{ glm::vec2{15, 11}, 1.5f };
+
+            bool res = CollisionDetector2D::CircleAndAABB(circle, box);
+            Log::Assert(res, "Circle should overlap the AABB away from the origin.");
+            return res;
+        }
+
+        COCOA_TEST(circleAndOffsetAABBShouldReturnFalse)
+        {
+            WorldAABB box{ glm::vec2{10, 10}, glm::vec2{14, 12} };
+            WorldCircle nearMin{ glm::vec2{8, 11}, 1.5f };
+            WorldCircle nearOrigin{ glm::vec2{1, 1}, 1.0f };
+
+            bool res = !CollisionDetector2D::CircleAndAABB(nearMin, box) && !CollisionDetector2D::CircleAndAABB(nearOrigin, box);
+            Log::Assert(res, "Circles should miss the AABB away from the origin.");
+            return res;
+        }
+
+        COCOA_TEST(lineThroughBox2DShouldReturnTrue)
+        {
+            Line2D straight{ glm::vec2{0, 10}, glm::vec2{20, 10} };
+            Line2D unrotated{ glm::vec2{5, 10}, glm::vec2{15, 10} };
+            WorldBox2D box{ glm::vec2{10, 10}, glm::vec2{2, 2}, 0.0f };
+
+            bool res = CollisionDetector2D::LineAndBox2D(straight, RotatedBox()) && CollisionDetector2D::LineAndBox2D(unrotated, box);
+            Log::Assert(res, "Lines through the middle of a box should hit it.");
+            return res;
+        }
+
+        COCOA_TEST(lineBesideBox2DShouldReturnFalse)
+        {
+            // Would cross the box if it weren't rotated
+            Line2D beside{ glm::vec2{13, 5}, glm::vec2{13, 9.5f} };
+            Line2D above{ glm::vec2{5, 20}, glm::vec2{15, 20} };
+            WorldBox2D box{ glm::vec2{10, 10}, glm::vec2{2, 2}, 0.0f };
+
+            bool res = !CollisionDetector2D::LineAndBox2D(beside, RotatedBox()) && !CollisionDetector2D::LineAndBox2D(above, box);
+            Log::Assert(res, "Lines that miss a box shouldn't hit it.");
+            return res;
+        }
+
         
         //    COCOA_TEST(closestPointToLineTestOne)
         //{
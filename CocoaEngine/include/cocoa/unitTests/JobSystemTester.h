@@ -0,0 +1,285 @@
+#pragma once
+#include "externalLibs.h"
+
+#include "TestFactory.h"
+#include "cocoa/core/JobSystem.h"
+#include "cocoa/util/Log.h"
+
+#include <chrono>
+#include <thread>
+
+namespace Cocoa
+{
+	namespace JobSystemTester
+	{
+		static const int WORKER_COUNT = 4;
+		// The correctness checks run at every Debug startup, so they stay small
+		static const int JOB_COUNT = 1000;
+		static const int NESTED_JOB_COUNT = 32;
+		static const int BENCHMARK_JOB_COUNT = 20000;
+		static const int STRESS_ROUNDS = 50;
+		static const size_t BENCHMARK_SIZE = 1 << 20;
+		static const int ITERATIONS = 5;
+
+		static double MillisecondsSince(std::chrono::high_resolution_clock::time_point start)
+		{
+			auto elapsed = std::chrono::high_resolution_clock::now() - start;
+			return std::chrono::duration<double, std::milli>(elapsed).count();
+		}
+
+		// Tests run before the application starts the job system, each one brings up its own
+		struct ScopedJobSystem
+		{
+			ScopedJobSystem()
+			{
+				m_Owns = !JobSystem::IsInitialized();
+				if (m_Owns)
+				{
+					JobSystem::Init(WORKER_COUNT);
+				}
+			}
+
+			~ScopedJobSystem()
+			{
+				if (m_Owns)
+				{
+					JobSystem::Destroy();
+				}
+			}
+
+			bool m_Owns;
+		};
+
+		// =========================================================================================================
+		// Correctness
+		// =========================================================================================================
+		COCOA_TEST(jobSystemShouldRunEveryJob)
+		{
+			ScopedJobSystem jobSystem;
+			std::atomic<int> ran{ 0 };
+			JobCounter counter;
+			for (int i = 0; i < JOB_COUNT; i++)
+			{
+				JobSystem::Submit([&ran]() { ran.fetch_add(1, std::memory_order_relaxed); }, &counter);
+			}
+			JobSystem::Wait(counter);
+
+			bool res = ran.load() == JOB_COUNT && counter.IsDone();
+			Log::Assert(res, "Ran %d of %d jobs.", ran.load(), JOB_COUNT);
+			return res;
+		}
+
+		COCOA_TEST(jobsSubmittedFromJobsShouldFinishBeforeTheirCounter)
+		{
+			ScopedJobSystem jobSystem;
+			std::atomic<int> ran{ 0 };
+			JobCounter counter;
+			for (int i = 0; i < NESTED_JOB_COUNT; i++)
+			{
+				JobSystem::Submit([&ran, &counter]()
+				{
+					for (int j = 0; j < NESTED_JOB_COUNT; j++)
+					{
+						JobSystem::Submit([&ran]() { ran.fetch_add(1, std::memory_order_relaxed); }, &counter);
+					}
+				}, &counter);
+			}
+			JobSystem::Wait(counter);
+
+			bool res = ran.load() == NESTED_JOB_COUNT * NESTED_JOB_COUNT;
+			Log::Assert(res, "Nested jobs ran %d times, expected %d.", ran.load(), NESTED_JOB_COUNT * NESTED_JOB_COUNT);
+			return res;
+		}
+
+		COCOA_TEST(jobsShouldWaitForTheirDependency)
+		{
+			ScopedJobSystem jobSystem;
+			const int stageSize = 64;
+			std::atomic<int> firstStage{ 0 };
+			std::atomic<int> secondStage{ 0 };
+			std::atomic<int> outOfOrder{ 0 };
+			JobCounter firstDone;
+			JobCounter secondDone;
+			JobCounter thirdDone;
+			for (int i = 0; i < stageSize; i++)
+			{
+				JobSystem::Submit([&]()
+				{
+					std::this_thread::sleep_for(std::chrono::microseconds(50));
+					firstStage.fetch_add(1);
+				}, &firstDone);
+			}
+			for (int i = 0; i < stageSize; i++)
+			{
+				JobSystem::Submit([&]()
+				{
+					if (firstStage.load() != stageSize) outOfOrder.fetch_add(1);
+					secondStage.fetch_add(1);
+				}, &secondDone, &firstDone);
+			}
+			JobSystem::Submit([&]()
+			{
+				if (secondStage.load() != stageSize) outOfOrder.fetch_add(1);
+			}, &thirdDone, &secondDone);
+			JobSystem::Wait(thirdDone);
+
+			bool res = outOfOrder.load() == 0 && firstDone.IsDone() && secondDone.IsDone();
+			Log::Assert(res, "%d jobs started before their dependency finished.", outOfOrder.load());
+			return res;
+		}
+
+		COCOA_TEST(parallelForShouldVisitEveryIndexOnce)
+		{
+			ScopedJobSystem jobSystem;
+			std::vector<std::atomic<uint8>> visits(10007);
+			for (auto& visit : visits) visit.store(0);
+
+			JobSystem::ParallelFor(0, visits.size(), 100, [&](size_t first, size_t last)
+			{
+				for (size_t i = first; i < last; i++)
+				{
+					visits[i].fetch_add(1, std::memory_order_relaxed);
+				}
+			});
+
+			bool res = true;
+			for (auto& visit : visits) res = res && visit.load() == 1;
+			int emptyCalls = 0;
+			JobSystem::ParallelFor(10, 10, 1, [&](size_t, size_t) { emptyCalls++; });
+			res = res && emptyCalls == 0;
+			Log::Assert(res, "ParallelFor should visit every index exactly once.");
+			return res;
+		}
+
+		COCOA_TEST(mainThreadJobsShouldRunOnTheMainThread)
+		{
+			ScopedJobSystem jobSystem;
+			std::thread::id mainThread = std::this_thread::get_id();
+			std::atomic<int> wrongThread{ 0 };
+			std::atomic<int> ran{ 0 };
+			JobCounter workerDone;
+			JobCounter mainDone;
+			for (int i = 0; i < 16; i++)
+			{
+				JobSystem::Submit([&ran]() { ran.fetch_add(1); }, &workerDone);
+			}
+			// Main thread jobs can depend on worker jobs, like uploading what a worker decoded
+			for (int i = 0; i < 16; i++)
+			{
+				JobSystem::SubmitMainThread([&]()
+				{
+					if (std::this_thread::get_id() != mainThread || ran.load() != 16) wrongThread.fetch_add(1);
+				}, &mainDone, &workerDone);
+			}
+			JobSystem::Wait(mainDone);
+
+			bool res = wrongThread.load() == 0;
+			Log::Assert(res, "%d main thread jobs ran on another thread or too early.", wrongThread.load());
+			return res;
+		}
+
+		COCOA_TEST(mainThreadWaitShouldOnlyRunItsOwnJobs)
+		{
+			ScopedJobSystem jobSystem;
+			std::thread::id mainThread = std::this_thread::get_id();
+			std::atomic<bool> waitingOnMine{ false };
+			std::atomic<int> wrongJobs{ 0 };
+			std::atomic<int> ran{ 0 };
+			JobCounter other;
+			JobCounter mine;
+			for (int i = 0; i < 64; i++)
+			{
+				JobSystem::Submit([&]()
+				{
+					if (waitingOnMine.load() && std::this_thread::get_id() == mainThread) wrongJobs.fetch_add(1);
+					std::this_thread::sleep_for(std::chrono::microseconds(50));
+				}, &other);
+			}
+			for (int i = 0; i < 64; i++)
+			{
+				JobSystem::Submit([&ran]() { ran.fetch_add(1); }, &mine);
+			}
+
+			waitingOnMine = true;
+			JobSystem::Wait(mine);
+			waitingOnMine = false;
+			JobSystem::Wait(other);
+
+			bool res = wrongJobs.load() == 0 && ran.load() == 64;
+			Log::Assert(res, "The main thread ran %d unrelated jobs while waiting.", wrongJobs.load());
+			return res;
+		}
+
+		// =========================================================================================================
+		// Stress tests and benchmarks, run with --benchmark. These only fail if the results are wrong, timings are
+		// logged for comparison
+		// =========================================================================================================
+		COCOA_BENCHMARK(jobSystemStressTest)
+		{
+			ScopedJobSystem jobSystem;
+			bool res = true;
+			for (int round = 0; res && round < STRESS_ROUNDS; round++)
+			{
+				std::atomic<int64> sum{ 0 };
+				JobCounter first;
+				JobCounter second;
+				for (int i = 0; i < 200; i++)
+				{
+					JobSystem::Submit([&sum, i]() { sum.fetch_add(i); }, &first);
+					JobSystem::Submit([&sum]()
+					{
+						JobSystem::ParallelFor(0, 64, 8, [&sum](size_t a, size_t b) { sum.fetch_add((int64)(b - a)); });
+					}, &second, &first);
+				}
+				JobSystem::Wait(second);
+				res = sum.load() == (int64)(199 * 200 / 2) + 200 * 64;
+			}
+
+			Log::Assert(res, "Mixed jobs, dependencies and nested ParallelFor should add up.");
+			return res;
+		}
+
+		static void Work(std::vector<float>& output, size_t first, size_t last)
+		{
+			for (size_t i = first; i < last; i++)
+			{
+				float x = (float)i * 0.001f;
+				output[i] = std::sqrt(x) * std::sin(x) + std::cos(x * 0.5f);
+			}
+		}
+
+		COCOA_BENCHMARK(jobSystemParallelForBenchmark)
+		{
+			ScopedJobSystem jobSystem;
+			std::vector<float> serial(BENCHMARK_SIZE);
+			std::vector<float> parallel(BENCHMARK_SIZE);
+
+			auto start = std::chrono::high_resolution_clock::now();
+			for (int i = 0; i < ITERATIONS; i++)
+			{
+				Work(serial, 0, serial.size());
+			}
+			double serialTime = MillisecondsSince(start);
+
+			start = std::chrono::high_resolution_clock::now();
+			for (int i = 0; i < ITERATIONS; i++)
+			{
+				JobSystem::ParallelFor(0, parallel.size(), 4096, [&parallel](size_t first, size_t last) { Work(parallel, first, last); });
+			}
+			double parallelTime = MillisecondsSince(start);
+
+			start = std::chrono::high_resolution_clock::now();
+			JobCounter counter;
+			for (int i = 0; i < BENCHMARK_JOB_COUNT; i++)
+			{
+				JobSystem::Submit([]() {}, &counter);
+			}
+			JobSystem::Wait(counter);
+			double emptyJobTime = MillisecondsSince(start);
+
+			Log::Info("ParallelFor (%d elements, %d workers): serial %.2f ms, jobs %.2f ms. %d empty jobs %.2f ms",
+				(int)BENCHMARK_SIZE, JobSystem::GetWorkerCount(), serialTime / ITERATIONS, parallelTime / ITERATIONS, BENCHMARK_JOB_COUNT, emptyJobTime);
+			return serial == parallel;
+		}
+	}
+}
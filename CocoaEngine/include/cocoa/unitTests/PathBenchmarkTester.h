@@ -0,0 +1,126 @@
+#pragma once
+#include "externalLibs.h"
+
+#include "TestFactory.h"
+#include "cocoa/file/CPath.h"
+#include "cocoa/file/PathTable.h"
+#include "cocoa/util/Log.h"
+
+#include <chrono>
+
+namespace Cocoa
+{
+	namespace PathBenchmarkTester
+	{
+		static const int ITERATIONS = 100000;
+		static const char* BENCHMARK_DIRECTORY = "C:/dev/Projects/SomeProject/assets/images/";
+		static const char* BENCHMARK_FILE = "spritesheets/characterSheet.png";
+
+		static double MicrosecondsSince(std::chrono::high_resolution_clock::time_point start)
+		{
+			auto elapsed = std::chrono::high_resolution_clock::now() - start;
+			return std::chrono::duration<double, std::micro>(elapsed).count();
+		}
+
+		// =========================================================================================================
+		// Correctness
+		// =========================================================================================================
+		COCOA_TEST(pathJoinShouldMatchConstructedPath)
+		{
+			CPath joined = CPath(BENCHMARK_DIRECTORY, true) + BENCHMARK_FILE;
+			CPath constructed = CPath(std::string(BENCHMARK_DIRECTORY) + BENCHMARK_FILE, true);
+
+			bool res = joined.Equals(constructed) && joined.Hash() == constructed.Hash()
+				&& strcmp(joined.Filename(), "characterSheet.png") == 0 && strcmp(joined.FileExt(), ".png") == 0;
+			Log::Assert(res, "Joined path '%s' should match '%s'.", joined.Filepath(), constructed.Filepath());
+			return res;
+		}
+
+		COCOA_TEST(longPathsShouldSpillToTheHeap)
+		{
+			CPath path = CPath("C:/dev/Projects", true);
+			std::string expected = path.Filepath();
+			for (int i = 0; i < 16; i++)
+			{
+				path += CPath("someFolder", true);
+				expected += "/someFolder";
+			}
+
+			CPath moved = std::move(path);
+			bool res = expected == moved.Filepath() && moved.Hash() == CPath(expected, true).Hash() && path.Size() == 0;
+			Log::Assert(res, "Long path should survive growing and moving.");
+			return res;
+		}
+
+		COCOA_TEST(internedPathsShouldShareIds)
+		{
+			PathId a = PathTable::Intern(CPath(BENCHMARK_DIRECTORY, true) + BENCHMARK_FILE);
+			PathId b = PathTable::Intern(CPath(std::string(BENCHMARK_DIRECTORY) + BENCHMARK_FILE, true));
+			PathId c = PathTable::Intern(CPath(BENCHMARK_DIRECTORY, true));
+
+			bool res = !a.IsNull() && a == b && a != c && PathTable::GetPath(a).Equals(CPath(BENCHMARK_DIRECTORY, true) + BENCHMARK_FILE);
+			Log::Assert(res, "Equal paths should intern to the same id.");
+			return res;
+		}
+
+		// =========================================================================================================
+		// Benchmarks, run with --benchmark. These only fail if the results are wrong, timings are logged for comparison
+		// =========================================================================================================
+		COCOA_BENCHMARK(pathConstructionBenchmark)
+		{
+			auto start = std::chrono::high_resolution_clock::now();
+			int totalSize = 0;
+			for (int i = 0; i < ITERATIONS; i++)
+			{
+				CPath path = CPath(BENCHMARK_DIRECTORY);
+				totalSize += path.Size();
+			}
+
+			Log::Info("CPath construction: %.3f us per path", MicrosecondsSince(start) / ITERATIONS);
+			return totalSize == (int)strlen(BENCHMARK_DIRECTORY) * ITERATIONS;
+		}
+
+		COCOA_BENCHMARK(pathJoinBenchmark)
+		{
+			CPath directory = CPath(BENCHMARK_DIRECTORY);
+			CPath file = CPath(BENCHMARK_FILE);
+
+			auto start = std::chrono::high_resolution_clock::now();
+			int totalSize = 0;
+			for (int i = 0; i < ITERATIONS; i++)
+			{
+				CPath joined = directory + file;
+				totalSize += joined.Size();
+			}
+
+			Log::Info("CPath join: %.3f us per join", MicrosecondsSince(start) / ITERATIONS);
+			return totalSize == (directory.Size() + file.Size()) * ITERATIONS;
+		}
+
+		COCOA_BENCHMARK(pathCompareBenchmark)
+		{
+			CPath a = CPath(BENCHMARK_DIRECTORY) + BENCHMARK_FILE;
+			CPath b = CPath(BENCHMARK_DIRECTORY) + BENCHMARK_FILE;
+			PathId aId = PathTable::Intern(a);
+			PathId bId = PathTable::Intern(b);
+
+			auto start = std::chrono::high_resolution_clock::now();
+			int matches = 0;
+			for (int i = 0; i < ITERATIONS; i++)
+			{
+				matches += a.Equals(b) ? 1 : 0;
+			}
+			double compareTime = MicrosecondsSince(start);
+
+			start = std::chrono::high_resolution_clock::now();
+			for (int i = 0; i < ITERATIONS; i++)
+			{
+				matches += aId == bId ? 1 : 0;
+			}
+			double idCompareTime = MicrosecondsSince(start);
+
+			Log::Info("CPath compare: %.4f us, PathId compare: %.4f us", compareTime / ITERATIONS, idCompareTime / ITERATIONS);
+			return matches == ITERATIONS * 2;
+		}
+	}
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include "externalLibs.h"
+
+#include "TestFactory.h"
+#include "cocoa/scenes/SceneJournal.h"
+#include "cocoa/scenes/SceneWriter.h"
+#include "cocoa/util/Log.h"
+
+namespace Cocoa
+{
+	namespace SceneJournalTester
+	{
+		static Transform MakeTransform(float x)
+		{
+			Transform transform;
+			transform.m_Position = glm::vec3(x, x * 2.0f, 0.0f);
+			return transform;
+		}
+
+		// Entities 0, 1 and 2 with a transform each, entity 1 also has a box
+		static SceneSnapshot CreateBase()
+		{
+			SceneSnapshot base;
+			SceneSnapshotArchive archive(base);
+			for (uint32 i = 0; i < 3; i++)
+			{
+				archive(entt::entity(i), MakeTransform((float)i));
+			}
+			Box2D box;
+			box.m_HalfSize = glm::vec2(1.0f, 2.0f);
+			archive(entt::entity(1), box);
+			return base;
+		}
+
+		static std::string CreateRecord(const SceneSnapshot& delta)
+		{
+			std::string record;
+			SceneWriter::Write(delta, record, true);
+			record += '\n';
+			return record;
+		}
+
+		// Moves entity 0, adds entity 3 and removes entity 1's box
+		static SceneSnapshot CreateFirstDelta()
+		{
+			SceneSnapshot delta;
+			delta.m_Delta = true;
+			SceneSnapshotArchive archive(delta);
+			archive(entt::entity(0), MakeTransform(10.0f));
+			archive(entt::entity(3), MakeTransform(3.0f));
+			delta.m_Removed.emplace_back(entt::entity(1), SceneComponents::Bit<Box2D>());
+			return delta;
+		}
+
+		// Moves entity 2
+		static SceneSnapshot CreateSecondDelta()
+		{
+			SceneSnapshot delta;
+			delta.m_Delta = true;
+			SceneSnapshotArchive archive(delta);
+			archive(entt::entity(2), MakeTransform(20.0f));
+			return delta;
+		}
+
+		static bool HasTransform(const SceneSnapshot& snapshot, uint32 entity, float x)
+		{
+			const ComponentColumn<Transform>& column = snapshot.Column<Transform>();
+			for (size_t i = 0; i < column.Size(); i++)
+			{
+				if (column.m_Entities[i] == entt::entity(entity))
+				{
+					return column.m_Components[i].m_Position == MakeTransform(x).m_Position;
+				}
+			}
+			return false;
+		}
+
+		COCOA_TEST(sceneJournalShouldRoundTrip)
+		{
+			std::string journal = CreateRecord(CreateFirstDelta()) + CreateRecord(CreateSecondDelta());
+			SceneSnapshot snapshot = CreateBase();
+
+			bool res = SceneJournal::Apply(journal, snapshot);
+			res = res && snapshot.Column<Transform>().Size() == 4 && snapshot.Column<Box2D>().Size() == 0;
+			res = res && HasTransform(snapshot, 0, 10.0f) && HasTransform(snapshot, 1, 1.0f) && HasTransform(snapshot, 2, 20.0f)
+				&& HasTransform(snapshot, 3, 3.0f);
+			res = res && SceneJournal::GetIntactSize(journal) == journal.size();
+			Log::Assert(res, "Applying a scene journal should give back every edit in it.");
+			return res;
+		}
+
+		COCOA_TEST(sceneJournalShouldStopAtTornRecord)
+		{
+			std::string first = CreateRecord(CreateFirstDelta());
+			std::string second = CreateRecord(CreateSecondDelta());
+			std::string journal = first + second.substr(0, second.size() / 2);
+			SceneSnapshot snapshot = CreateBase();
+
+			bool res = !SceneJournal::Apply(journal, snapshot);
+			res = res && HasTransform(snapshot, 0, 10.0f) && HasTransform(snapshot, 2, 2.0f) && HasTransform(snapshot, 3, 3.0f);
+			res = res && SceneJournal::GetIntactSize(journal) == first.size() && SceneJournal::GetIntactSize(second.substr(0, 4)) == 0;
+			Log::Assert(res, "A torn scene journal should apply up to the last complete record, and no further.");
+			return res;
+		}
+	}
+}
@@ -0,0 +1,262 @@
+#pragma once
+#include "externalLibs.h"
+
+#include "TestFactory.h"
+#include "cocoa/scenes/SceneReader.h"
+#include "cocoa/util/CMath.h"
+#include "cocoa/util/Log.h"
+
+#include <chrono>
+
+namespace Cocoa
+{
+	namespace SceneLoadBenchmarkTester
+	{
+		// The correctness checks run at every Debug startup, so they get a small scene
+		static const int TEST_ENTITY_COUNT = 200;
+		static const int ENTITY_COUNT = 5000;
+		static const int ITERATIONS = 5;
+
+		static double MillisecondsSince(std::chrono::high_resolution_clock::time_point start)
+		{
+			auto elapsed = std::chrono::high_resolution_clock::now() - start;
+			return std::chrono::duration<double, std::milli>(elapsed).count();
+		}
+
+		// Same layout Scene::Save writes, every entity gets a transform and sprite, every other one a rigidbody
+		// and box, every tenth one a script
+		static std::string CreateScene(int entityCount)
+		{
+			json j = {
+				{"Size", 0},
+				{"Project", "C:/dev/Projects/SomeProject/SomeProject.cprj"},
+				{"Assets", {
+					{"SceneID", 0},
+					{"AssetCount", 1},
+					{"AssetList", {
+						{"3", {{"Filepath", "assets/images/characterSheet.png"}, {"Type", 1}}}
+					}}
+				}}
+			};
+
+			int size = 0;
+			for (int i = 0; i < entityCount; i++)
+			{
+				float f = (float)i;
+				j["Components"][size++] = {
+					{"Transform", {
+						{"Entity", (uint32)i},
+						CMath::Serialize("Position", glm::vec3(f, f * 0.5f, 0.0f)),
+						CMath::Serialize("Scale", glm::vec3(1.0f, 2.0f, 1.0f)),
+						CMath::Serialize("Rotation", glm::vec3(0.0f, 0.0f, f * 0.25f))
+					}}
+				};
+				j["Components"][size++] = {
+					{"SpriteRenderer", {
+						{"Entity", (uint32)i},
+						{"AssetId", (uint32)3},
+						{"ZIndex", i % 4},
+						CMath::Serialize("Color", glm::vec4(0.5f, 1.0f, 1.0f, 1.0f))
+					}}
+				};
+
+				if (i % 2 == 0)
+				{
+					j["Components"][size++] = {
+						{"Rigidbody2D", {
+							{"Entity", (uint32)i},
+							{"AngularDamping", 0.1f},
+							{"LinearDamping", 0.5f},
+							{"Mass", f},
+							CMath::Serialize("Velocity", glm::vec2(1.0f, -1.0f)),
+							{"ContinousCollision", false},
+							{"FixedRotation", true}
+						}}
+					};
+					j["Components"][size++] = {
+						{"Box2D", {
+							{"Entity", (uint32)i},
+							CMath::Serialize("HalfSize", glm::vec2(0.5f, f))
+						}}
+					};
+				}
+
+				if (i % 10 == 0)
+				{
+					j["Components"][size++] = {
+						{"PlayerController", {
+							{"Entity", (uint32)i},
+							{"Speed", f},
+							{"Name", "Player"}
+						}}
+					};
+				}
+			}
+			j["Size"] = size;
+
+			return j.dump(4);
+		}
+
+		template<typename Component>
+		static void Push(SceneSnapshot& snapshot, const json& entity, const Component& component)
+		{
+			snapshot.Column<Component>().m_Entities.push_back(entt::entity((uint32)entity));
+			snapshot.Column<Component>().m_Components.push_back(component);
+		}
+
+		// What Scene::Load used to do before it moved to SceneReader, minus adding the components to a registry
+		static void DomRead(const std::string& data, SceneSnapshot& snapshot)
+		{
+			json j = json::parse(data.begin(), data.end());
+			snapshot.m_Project = j["Project"];
+			snapshot.m_Assets = j["Assets"];
+			json scripts = json::array();
+
+			int size = j["Size"];
+			for (int i = 0; i < size; i++)
+			{
+				json::iterator it = j["Components"][i].begin();
+				json component = j["Components"][i];
+				if (it.key() == "Transform")
+				{
+					Transform transform;
+					transform.m_Position = CMath::DeserializeVec3(component["Transform"]["Position"]);
+					transform.m_Scale = CMath::DeserializeVec3(component["Transform"]["Scale"]);
+					transform.m_EulerRotation = CMath::DeserializeVec3(component["Transform"]["Rotation"]);
+					Push(snapshot, component["Transform"]["Entity"], transform);
+				}
+				else if (it.key() == "SpriteRenderer")
+				{
+					SpriteRenderer spriteRenderer;
+					spriteRenderer.m_Color = CMath::DeserializeVec4(component["SpriteRenderer"]["Color"]);
+					spriteRenderer.m_ZIndex = component["SpriteRenderer"]["ZIndex"];
+					Push(snapshot, component["SpriteRenderer"]["Entity"], spriteRenderer);
+					snapshot.Column<SpriteRenderer>().m_ResourceIds.push_back(component["SpriteRenderer"]["AssetId"]);
+				}
+				else if (it.key() == "Rigidbody2D")
+				{
+					Rigidbody2D rigidbody;
+					rigidbody.m_AngularDamping = component["Rigidbody2D"]["AngularDamping"];
+					rigidbody.m_LinearDamping = component["Rigidbody2D"]["LinearDamping"];
+					rigidbody.m_Mass = component["Rigidbody2D"]["Mass"];
+					rigidbody.m_Velocity = CMath::DeserializeVec2(component["Rigidbody2D"]["Velocity"]);
+					rigidbody.m_ContinuousCollision = component["Rigidbody2D"]["ContinousCollision"];
+					rigidbody.m_FixedRotation = component["Rigidbody2D"]["FixedRotation"];
+					Push(snapshot, component["Rigidbody2D"]["Entity"], rigidbody);
+				}
+				else if (it.key() == "Box2D")
+				{
+					Box2D box;
+					box.m_HalfSize = CMath::DeserializeVec2(component["Box2D"]["HalfSize"]);
+					box.m_Size = box.m_HalfSize * 2.0f;
+					Push(snapshot, component["Box2D"]["Entity"], box);
+				}
+				else
+				{
+					scripts.push_back(component);
+				}
+			}
+
+			snapshot.m_Scripts = {
+				{"Size", scripts.size()},
+				{"Components", scripts}
+			};
+		}
+
+		// =========================================================================================================
+		// Correctness
+		// =========================================================================================================
+		COCOA_TEST(sceneReaderShouldMatchDomLoader)
+		{
+			std::string data = CreateScene(TEST_ENTITY_COUNT);
+			SceneSnapshot expected;
+			SceneSnapshot actual;
+			DomRead(data, expected);
+			bool res = SceneReader::Read(data, actual);
+
+			res = res && actual.m_Project == expected.m_Project && actual.m_Assets == expected.m_Assets && actual.m_Scripts == expected.m_Scripts;
+			const auto& actualTransforms = actual.Column<Transform>();
+			const auto& expectedTransforms = expected.Column<Transform>();
+			const auto& actualSprites = actual.Column<SpriteRenderer>();
+			const auto& expectedSprites = expected.Column<SpriteRenderer>();
+			const auto& actualRigidbodies = actual.Column<Rigidbody2D>();
+			const auto& expectedRigidbodies = expected.Column<Rigidbody2D>();
+			const auto& actualBoxes = actual.Column<Box2D>();
+			const auto& expectedBoxes = expected.Column<Box2D>();
+
+			res = res && actualTransforms.Size() == expectedTransforms.Size() && actualSprites.Size() == expectedSprites.Size()
+				&& actualRigidbodies.Size() == expectedRigidbodies.Size() && actualBoxes.Size() == expectedBoxes.Size();
+			res = res && actualTransforms.m_Entities == expectedTransforms.m_Entities && actualSprites.m_Entities == expectedSprites.m_Entities
+				&& actualRigidbodies.m_Entities == expectedRigidbodies.m_Entities && actualBoxes.m_Entities == expectedBoxes.m_Entities
+				&& actualSprites.m_ResourceIds == expectedSprites.m_ResourceIds;
+			for (size_t i = 0; res && i < actualTransforms.Size(); i++)
+			{
+				const Transform& a = actualTransforms.m_Components[i];
+				const Transform& b = expectedTransforms.m_Components[i];
+				res = a.m_Position == b.m_Position && a.m_Scale == b.m_Scale && a.m_EulerRotation == b.m_EulerRotation;
+			}
+			for (size_t i = 0; res && i < actualSprites.Size(); i++)
+			{
+				const SpriteRenderer& a = actualSprites.m_Components[i];
+				const SpriteRenderer& b = expectedSprites.m_Components[i];
+				res = a.m_Color == b.m_Color && a.m_ZIndex == b.m_ZIndex;
+			}
+			for (size_t i = 0; res && i < actualRigidbodies.Size(); i++)
+			{
+				const Rigidbody2D& a = actualRigidbodies.m_Components[i];
+				const Rigidbody2D& b = expectedRigidbodies.m_Components[i];
+				res = a.m_AngularDamping == b.m_AngularDamping && a.m_LinearDamping == b.m_LinearDamping && a.m_Mass == b.m_Mass
+					&& a.m_Velocity == b.m_Velocity && a.m_ContinuousCollision == b.m_ContinuousCollision && a.m_FixedRotation == b.m_FixedRotation;
+			}
+			for (size_t i = 0; res && i < actualBoxes.Size(); i++)
+			{
+				res = actualBoxes.m_Components[i].m_HalfSize == expectedBoxes.m_Components[i].m_HalfSize
+					&& actualBoxes.m_Components[i].m_Size == expectedBoxes.m_Components[i].m_Size;
+			}
+
+			Log::Assert(res, "SceneReader should read the same scene the DOM loader does.");
+			return res;
+		}
+
+		COCOA_TEST(sceneReaderShouldRejectBrokenJson)
+		{
+			std::string data = CreateScene(TEST_ENTITY_COUNT);
+			data.resize(data.size() / 2);
+			SceneSnapshot snapshot;
+			bool res = !SceneReader::Read(data, snapshot);
+			Log::Assert(res, "SceneReader should fail on truncated scenes.");
+			return res;
+		}
+
+		// =========================================================================================================
+		// Benchmarks, run with --benchmark. These only fail if the results are wrong, timings are logged for comparison
+		// =========================================================================================================
+		COCOA_BENCHMARK(sceneLoadBenchmark)
+		{
+			std::string data = CreateScene(ENTITY_COUNT);
+			size_t domCount = 0;
+			size_t saxCount = 0;
+
+			auto start = std::chrono::high_resolution_clock::now();
+			for (int i = 0; i < ITERATIONS; i++)
+			{
+				SceneSnapshot snapshot;
+				DomRead(data, snapshot);
+				domCount += snapshot.Column<Transform>().Size();
+			}
+			double domTime = MillisecondsSince(start);
+
+			start = std::chrono::high_resolution_clock::now();
+			for (int i = 0; i < ITERATIONS; i++)
+			{
+				SceneSnapshot snapshot;
+				SceneReader::Read(data, snapshot);
+				saxCount += snapshot.Column<Transform>().Size();
+			}
+			double saxTime = MillisecondsSince(start);
+
+			Log::Info("Scene load (%d KB): DOM %.2f ms, SceneReader %.2f ms", (int)(data.size() / 1024), domTime / ITERATIONS, saxTime / ITERATIONS);
+			return domCount == saxCount && saxCount == (size_t)ENTITY_COUNT * ITERATIONS;
+		}
+	}
+}
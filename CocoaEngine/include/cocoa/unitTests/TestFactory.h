@@ -7,6 +7,13 @@
 			static bool test_##name##_registered = TestFactory::Register(#name, &test_##name); \
 			bool test_##name()
 
+// Timing runs. They only fail if their results are wrong, and only run when the application is started with
+// --benchmark, never with the tests on every Debug launch
+#define COCOA_BENCHMARK(name) \
+			bool benchmark_##name(); \
+			static bool benchmark_##name##_registered = TestFactory::RegisterBenchmark(#name, &benchmark_##name); \
+			bool benchmark_##name()
+
 namespace Cocoa
 {
 	class TestFactory
@@ -14,11 +21,14 @@ namespace Cocoa
 	public:
 		friend class TestMain;
 		static bool Register(std::string name, std::function<bool()> func);
+		static bool RegisterBenchmark(std::string name, std::function<bool()> func);
 	private:
 		static std::unordered_map<std::string, std::function<bool()>> Tests;
+		static std::unordered_map<std::string, std::function<bool()>> Benchmarks;
 	};
 
 	std::unordered_map<std::string, std::function<bool()>> TestFactory::Tests;
+	std::unordered_map<std::string, std::function<bool()>> TestFactory::Benchmarks;
 
 	bool TestFactory::Register(std::string name, std::function<bool()> func)
 	{
@@ -30,4 +40,15 @@ namespace Cocoa
 		}
 		return false;
 	}
+
+	bool TestFactory::RegisterBenchmark(std::string name, std::function<bool()> func)
+	{
+		auto it = Benchmarks.find(name);
+		if (it == Benchmarks.end())
+		{
+			Benchmarks[name] = std::move(func);
+			return true;
+		}
+		return false;
+	}
 }
\ No newline at end of file
@@ -1,7 +1,13 @@
 #pragma once
 
 #include "TestFactory.h"
+#include "ChangeTrackerTester.h"
 #include "CollisionDetector2DTester.h"
+#include "JobSystemTester.h"
+#include "PathBenchmarkTester.h"
+#include "SceneJournalTester.h"
+#include "SceneLoadBenchmarkTester.h"
+#include "TransformBenchmarkTester.h"
 
 namespace Cocoa
 {
@@ -9,6 +15,7 @@ namespace Cocoa
 	{
 	public:
 		static bool Test();
+		static bool Benchmark();
 	};
 
 	bool TestMain::Test()
@@ -23,4 +30,17 @@ namespace Cocoa
 		}
 		return true;
 	}
+
+	bool TestMain::Benchmark()
+	{
+		for (auto it = TestFactory::Benchmarks.begin(); it != TestFactory::Benchmarks.end(); it++)
+		{
+			if (!it->second())
+			{
+				Log::Error("Benchmark failed: '%s'", it->first.c_str());
+				return false;
+			}
+		}
+		return true;
+	}
 }
\ No newline at end of file
@@ -0,0 +1,163 @@
+#pragma once
+#include "externalLibs.h"
+
+#include "TestFactory.h"
+#include "cocoa/components/Transform.h"
+#include "cocoa/components/TransformHierarchy.h"
+#include "cocoa/util/CMath.h"
+#include "cocoa/util/Log.h"
+
+#include <chrono>
+
+namespace Cocoa
+{
+	namespace TransformBenchmarkTester
+	{
+		static const int ENTITY_COUNT = 50000;
+		static const int ITERATIONS = 20;
+
+		static double MillisecondsSince(std::chrono::high_resolution_clock::time_point start)
+		{
+			auto elapsed = std::chrono::high_resolution_clock::now() - start;
+			return std::chrono::duration<double, std::milli>(elapsed).count();
+		}
+
+		// The layout Transform had before the matrices and name moved out of it
+		struct LegacyTransform
+		{
+			glm::vec3 m_Position;
+			glm::vec3 m_Scale;
+			glm::vec3 m_EulerRotation;
+			glm::quat m_Orientation;
+
+			glm::vec3 m_Forward;
+			glm::vec3 m_Up;
+			glm::vec3 m_Right;
+
+			glm::mat4 m_ModelMatrix;
+			glm::mat4 m_InverseModelMatrix;
+			glm::vec3 m_WorldPosition;
+			glm::vec3 m_WorldScale;
+			float m_WorldRotation;
+			const char* m_Name;
+
+			entt::entity m_Parent;
+
+			glm::mat4 m_LocalMatrix;
+			glm::vec3 m_CachedPosition;
+			glm::vec3 m_CachedScale;
+			glm::vec3 m_CachedEulerRotation;
+			bool m_WorldChanged;
+		};
+
+		// Reads exactly what RenderBatch reads for a quad, so the only difference between the runs is the stride
+		template<typename T>
+		static double RenderLikeSweep(const std::vector<T>& transforms)
+		{
+			double sum = 0.0;
+			for (const T& transform : transforms)
+			{
+				sum += transform.m_WorldPosition.x + transform.m_WorldPosition.y + transform.m_WorldPosition.z;
+				sum += transform.m_WorldScale.x + transform.m_WorldScale.y;
+				sum += transform.m_WorldRotation;
+			}
+			return sum;
+		}
+
+		template<typename T>
+		static void Fill(std::vector<T>& transforms)
+		{
+			transforms.resize(ENTITY_COUNT);
+			for (int i = 0; i < ENTITY_COUNT; i++)
+			{
+				float f = (float)i;
+				transforms[i].m_WorldPosition = glm::vec3(f, f * 0.5f, 0.0f);
+				transforms[i].m_WorldScale = glm::vec3(1.0f, 2.0f, 1.0f);
+				transforms[i].m_WorldRotation = f * 0.25f;
+			}
+		}
+
+		// =========================================================================================================
+		// Correctness
+		// =========================================================================================================
+		COCOA_TEST(orphanedTransformShouldKeepWorldPose)
+		{
+			entt::registry registry;
+			TransformHierarchy hierarchy;
+			entt::entity parent = registry.create();
+			entt::entity child = registry.create();
+			registry.emplace<Transform>(parent, glm::vec3(10.0f, 0.0f, 0.0f), glm::vec3(2.0f), glm::vec3(0.0f, 0.0f, 90.0f));
+			Transform& transform = registry.emplace<Transform>(child, glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(1.0f), glm::vec3(0.0f));
+			transform.m_Parent = parent;
+			hierarchy.Update(registry);
+
+			glm::vec3 worldPosition = registry.get<Transform>(child).m_WorldPosition;
+			registry.destroy(parent);
+			hierarchy.Update(registry);
+
+			const Transform& orphan = registry.get<Transform>(child);
+			bool res = orphan.m_Parent == entt::null && CMath::Compare(worldPosition, glm::vec3(10.0f, 2.0f, 0.0f), 0.001f)
+				&& orphan.m_Position == worldPosition && orphan.m_WorldPosition == worldPosition
+				&& orphan.m_Scale == glm::vec3(2.0f) && orphan.m_EulerRotation.z == 90.0f;
+			Log::Assert(res, "A child whose parent is destroyed should stay where it was in the world.");
+			return res;
+		}
+
+		COCOA_TEST(transformMatrixAddedLaterShouldBeBuilt)
+		{
+			entt::registry registry;
+			TransformHierarchy hierarchy;
+			entt::entity entity = registry.create();
+			registry.emplace<Transform>(entity, glm::vec3(3.0f, 4.0f, 0.0f), glm::vec3(2.0f), glm::vec3(0.0f));
+			hierarchy.Update(registry);
+			hierarchy.Update(registry);
+
+			// The entity hasn't moved since the last update, the matrix still has to match where it is
+			registry.emplace<TransformMatrix>(entity);
+			hierarchy.Update(registry);
+
+			const TransformMatrix& matrix = registry.get<TransformMatrix>(entity);
+			glm::vec4 corner = matrix.m_ModelMatrix * glm::vec4(1.0f, 1.0f, 0.0f, 1.0f);
+			glm::vec4 back = matrix.m_InverseModelMatrix * corner;
+			bool res = !registry.get<Transform>(entity).m_WorldChanged && !matrix.m_Stale
+				&& CMath::Compare(glm::vec3(corner), glm::vec3(5.0f, 6.0f, 0.0f), 0.001f)
+				&& CMath::Compare(glm::vec3(back), glm::vec3(1.0f, 1.0f, 0.0f), 0.001f);
+			Log::Assert(res, "A TransformMatrix added to a stationary entity should be built on the next update.");
+			return res;
+		}
+
+		// =========================================================================================================
+		// Benchmarks, run with --benchmark. These only fail if the results are wrong, timings are logged for comparison
+		// =========================================================================================================
+		COCOA_BENCHMARK(transformIterationBenchmark)
+		{
+			std::vector<LegacyTransform> legacy;
+			std::vector<Transform> compact;
+			Fill(legacy);
+			Fill(compact);
+
+			double legacySum = 0.0;
+			auto start = std::chrono::high_resolution_clock::now();
+			for (int i = 0; i < ITERATIONS; i++)
+			{
+				legacySum += RenderLikeSweep(legacy);
+			}
+			double legacyTime = MillisecondsSince(start) / ITERATIONS;
+
+			double compactSum = 0.0;
+			start = std::chrono::high_resolution_clock::now();
+			for (int i = 0; i < ITERATIONS; i++)
+			{
+				compactSum += RenderLikeSweep(compact);
+			}
+			double compactTime = MillisecondsSince(start) / ITERATIONS;
+
+			Log::Info("Transform sweep over %d entities: %.3f ms with %d byte transforms, %.3f ms with %d byte transforms",
+				ENTITY_COUNT, legacyTime, (int)sizeof(LegacyTransform), compactTime, (int)sizeof(Transform));
+
+			bool res = legacySum == compactSum && sizeof(Transform) < sizeof(LegacyTransform);
+			Log::Assert(res, "Both transform layouts should add up to the same values.");
+			return res;
+		}
+	}
+}
@@ -3,6 +3,8 @@
 
 namespace Cocoa
 {
+	class JsonWriter;
+
 	namespace CMath
 	{
 		// Float Comparison functions, using custom epsilon
@@ -32,5 +34,10 @@ namespace Cocoa
 		COCOA json Serialize(const std::string& name, const glm::vec2& vec);
 		COCOA glm::vec2 DeserializeVec2(const json& json);
 		COCOA glm::vec2 DeserializeVec2(const json& json, bool& success);
+
+		// Streaming versions, these write the same keys as the ones above
+		COCOA void Serialize(JsonWriter& writer, std::string_view name, const glm::vec4& vec);
+		COCOA void Serialize(JsonWriter& writer, std::string_view name, const glm::vec3& vec);
+		COCOA void Serialize(JsonWriter& writer, std::string_view name, const glm::vec2& vec);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,14 @@
+#pragma once
+#include "externalLibs.h"
+
+namespace Cocoa
+{
+	namespace Compression
+	{
+		// LZ4 block format (no frame header). Compressed blocks are readable by any standard
+		// LZ4_decompress_safe implementation and vice versa.
+		COCOA int Lz4CompressBound(int srcSize);
+		COCOA int Lz4Compress(const uint8* src, int srcSize, uint8* dst, int dstCapacity);
+		COCOA int Lz4Decompress(const uint8* src, int srcSize, uint8* dst, int dstCapacity);
+	}
+}
@@ -9,6 +9,7 @@ namespace Cocoa
 		COCOA void AssignIfNotNull(const json& j, uint8& val);
 		COCOA void AssignIfNotNull(const json& j, uint16& val);
 		COCOA void AssignIfNotNull(const json& j, uint32& val);
+		COCOA void AssignIfNotNull(const json& j, uint64& val);
 		COCOA void AssignIfNotNull(const json& j, int& val);
 		COCOA void AssignIfNotNull(const json& j, float& val);
 		COCOA void AssignIfNotNull(const json& j, glm::vec2& vec);
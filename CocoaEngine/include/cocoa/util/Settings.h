@@ -24,6 +24,8 @@ namespace Cocoa
 			static CPath s_EditorSaveData;
 			static CPath s_EditorStyleData;
 			static CPath s_EditorStyle;
+			// Seconds between editor autosaves of the scene's changes, 0 turns autosave off
+			static float s_AutosaveInterval;
 		};
 
 		class COCOA Physics2D
@@ -32,6 +34,10 @@ namespace Cocoa
 			static int s_VelocityIterations;
 			static int s_PositionIterations;
 			static float s_Timestep;
+			// Most steps taken in one frame, a slow frame drops the rest instead of making the next one slower
+			static int s_MaxSubsteps;
+			// Steps the world on a worker while the rest of the frame runs. Rendering is a frame further behind
+			static bool s_RunAhead;
 		};
 	}
 }
\ No newline at end of file
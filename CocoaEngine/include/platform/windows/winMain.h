@@ -9,10 +9,20 @@
 #include "cocoa/core/AssetManager.h"
 
 #include <Windows.h>
+#include <cstring>
 
 extern Cocoa::Application* Cocoa::CreateApplication();
 
-int main() {
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--benchmark") == 0)
+        {
+            Cocoa::Log::Info("Running benchmarks!");
+            return Cocoa::TestMain::Benchmark() ? 0 : 1;
+        }
+    }
+
 #ifdef _COCOA_DEBUG
     Cocoa::Log::Info("Running tests!");
     if (!Cocoa::TestMain::Test())
@@ -0,0 +1,72 @@
+#include "externalLibs.h"
+#include "cocoa/file/IFile.h"
+#include "cocoa/file/PackArchive.h"
+#include "cocoa/util/Log.h"
+
+using namespace Cocoa;
+
+static void PrintUsage()
+{
+	printf("Usage: CocoaPacker <projectDirectory> <output.cpak> [--lz4] [--align <bytes>]\n");
+	printf("  --lz4           Compress entries with LZ4 when it makes them smaller\n");
+	printf("  --align <bytes> Alignment of every entry in the archive, must be a power of two (default 16)\n");
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	bool compressLz4 = false;
+	uint32 alignment = 16;
+	for (int i = 3; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--lz4") == 0)
+		{
+			compressLz4 = true;
+		}
+		else if (strcmp(argv[i], "--align") == 0 && i + 1 < argc)
+		{
+			alignment = (uint32)atoi(argv[++i]);
+		}
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	IFile::Init();
+
+	CPath projectDirectory = IFile::GetAbsolutePath(CPath(argv[1]));
+	CPath outputPath = IFile::GetAbsolutePath(CPath(argv[2]));
+	if (!IFile::IsDirectory(projectDirectory))
+	{
+		Log::Error("'%s' is not a directory.", projectDirectory.Filepath());
+		IFile::Destroy();
+		return 1;
+	}
+
+	PackArchiveWriter writer;
+	writer.AddDirectory(projectDirectory);
+	Log::Info("Packing %d files from '%s' into '%s'.", (int)writer.GetFileCount(), projectDirectory.Filepath(), outputPath.Filepath());
+
+	bool success = writer.Write(outputPath, alignment, compressLz4);
+	if (success)
+	{
+		// Read the archive back so a broken pack never ships silently
+		PackArchive archive;
+		success = archive.Open(outputPath) && archive.GetEntryCount() == (uint32)writer.GetFileCount();
+	}
+
+	if (!success)
+	{
+		Log::Error("Failed to write pack archive '%s'.", outputPath.Filepath());
+	}
+
+	IFile::Destroy();
+	return success ? 0 : 1;
+}
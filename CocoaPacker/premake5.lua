@@ -0,0 +1,67 @@
+project "CocoaPacker"
+    kind "ConsoleApp"
+    language "C++"
+    cppdialect "C++17"	
+    staticruntime "off"
+
+    targetdir ("../bin/" .. outputdir .. "/%{prj.name}")
+    objdir ("../bin-int/" .. outputdir .. "/%{prj.name}")
+
+    files {
+        "cpp/**.cpp"
+    }
+
+    disablewarnings { 
+        "4251" 
+    }
+
+    includedirs {
+        "../CocoaEngine",
+        "../CocoaEngine/include",
+        "../CocoaEngine/vendor",
+        "../%{IncludeDir.glm}",
+        "../%{IncludeDir.entt}",
+        "../%{IncludeDir.Glad}",
+        "../%{IncludeDir.Box2D}",
+        "../%{IncludeDir.Json}",
+        "../%{IncludeDir.GLFW}",
+    }
+
+    links {
+        "CocoaEngine"
+    }
+
+    defines {
+        "ENTT_API_IMPORT"
+    }
+
+    filter { "system:windows", "configurations:Debug" }
+        buildoptions "/MDd"        
+
+    filter { "system:windows", "configurations:Release" }
+        buildoptions "/MD"
+
+    filter "system:windows"
+        systemversion "latest"		
+
+        defines {
+            "_COCOA_PLATFORM_WINDOWS"
+        }
+
+    filter "configurations:Debug"
+        defines {
+			"_COCOA_DEBUG",
+			"_COCOA_ENABLE_ASSERTS"
+		}
+        runtime "Debug"
+        symbols "on"
+
+    filter "configurations:Release"
+        defines "_COCOA_RELEASE"
+        runtime "Release"
+        optimize "on"
+
+    filter "configurations:Dist"
+        defines "_COCOA_DIST"
+        runtime "Release"
+        optimize "on"
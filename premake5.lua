@@ -24,6 +24,7 @@ IncludeDir["Json"] = "CocoaEngine/vendor/nlohmann-json/single_include"
 
 include "CocoaEngine"
 include "CocoaEditor"
+include "CocoaPacker"
 
 include "CocoaEngine/vendor/GLFW"
 include "CocoaEngine/vendor/glad"